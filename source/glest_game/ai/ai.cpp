@@ -16,6 +16,7 @@
 #include "unit.h"
 #include "map.h"
 #include "faction_type.h"
+#include "config.h"
 #include "leak_dumper.h"
 
 using namespace
@@ -485,6 +486,14 @@ namespace
       aiRules.push_back (new AiRuleExpand (this));
       aiRules.push_back (new AiRuleRepair (this));
       aiRules.push_back (new AiRuleRepair (this));
+
+      rulePending.assign (aiRules.size (), false);
+      ruleCosts.assign (aiRules.size (), AiRuleCost ());
+      pendingRules.clear ();
+      // a count, not a time, so the same rules run on the same frame on
+      // every machine and replays and autotests stay reproducible
+      maxRulesPerFrame =
+        Config::getInstance ().getInt ("AiMaxRulesPerFrame", "4");
     }
 
     Ai::~Ai ()
@@ -539,9 +548,9 @@ namespace
       if (SystemFlags::getSystemSettingType (SystemFlags::debugPerformance).
           enabled && chrono.getMillis () > 0)
         SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                  "In [%s::%s Line: %d] took msecs: %lld [START]\n",
+                                  "In [%s::%s Line: %d] took usecs: %lld [START]\n",
                                   __FILE__, __FUNCTION__, __LINE__,
-                                  chrono.getMillis ());
+                                  chrono.getMicros ());
 
       if (aiInterface->getMyFaction ()->getFirstSwitchTeamVote () != NULL)
         {
@@ -628,6 +637,68 @@ namespace
         }
 
       //process ai rules
+      queueDueRules ();
+
+      // the rules carried over from earlier frames go first
+      int
+        rulesRun = 0;
+      while (pendingRules.empty () == false)
+        {
+          if (maxRulesPerFrame > 0 && rulesRun >= maxRulesPerFrame)
+            {
+              break;
+            }
+          int
+            ruleIdx = pendingRules.front ();
+          pendingRules.pop_front ();
+          rulePending[ruleIdx] = false;
+
+          if (SystemFlags::
+              getSystemSettingType (SystemFlags::debugPerformance).enabled
+              && chrono.getMillis () > 0)
+            SystemFlags::OutputDebug (SystemFlags::debugPerformance,
+                                      "In [%s::%s Line: %d] took usecs: %lld [ruleIdx = %d]\n",
+                                      __FILE__, __FUNCTION__, __LINE__,
+                                      chrono.getMicros (), ruleIdx);
+
+          Chrono
+          ruleChrono (true);
+          processRule (ruleIdx);
+          int64
+            ruleMicros = ruleChrono.getMicros ();
+          ruleCosts[ruleIdx].add (ruleMicros);
+          rulesRun++;
+        }
+
+      if (SystemFlags::getSystemSettingType (SystemFlags::debugPerformance).
+          enabled && chrono.getMillis () > 0)
+        SystemFlags::OutputDebug (SystemFlags::debugPerformance,
+                                  "In [%s::%s Line: %d] took usecs: %lld [END]\n",
+                                  __FILE__, __FUNCTION__, __LINE__,
+                                  chrono.getMicros ());
+    }
+
+
+    // Spreads the frames a rule is tested on over its interval so the AI
+    // factions, and the rules of one faction, do not all come due together.
+    int
+    Ai::getRulePhase (int ruleIdx, int intervalFrames) const
+    {
+      int
+        factionIndex = aiInterface->getFactionIndex ();
+      return (factionIndex * 7 + ruleIdx * 3) % intervalFrames;
+    }
+
+    void
+    Ai::queueDueRules ()
+    {
+      if (rulePending.size () != aiRules.size ())
+        {
+          rulePending.assign (aiRules.size (), false);
+          ruleCosts.resize (aiRules.size ());
+          pendingRules.clear ();
+        }
+
       for (unsigned int ruleIdx = 0; ruleIdx < aiRules.size (); ++ruleIdx)
         {
           AiRule *
@@ -638,120 +709,123 @@ namespace
               megaglest_runtime_error ("rule == NULL");
             }
 
-          if (SystemFlags::
-              getSystemSettingType (SystemFlags::debugPerformance).enabled
-              && chrono.getMillis () > 0)
-            SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                      "In [%s::%s Line: %d] took msecs: %lld [ruleIdx = %d]\n",
-                                      __FILE__, __FUNCTION__, __LINE__,
-                                      chrono.getMillis (), ruleIdx);
           // Determines wether to process AI rules. Whether a particular rule is processed, is weighted by getTestInterval().
           // Values returned by getTestInterval() are defined in ai_rule.h.
-          if ((aiInterface->getTimer () %
-               (rule->getTestInterval () * GameConstants::updateFps /
-                1000)) == 0)
+          int
+            intervalFrames =
+            max (1, rule->getTestInterval () * GameConstants::updateFps / 1000);
+          if (rulePending[ruleIdx] == false
+              && (aiInterface->getTimer () +
+                  getRulePhase (ruleIdx, intervalFrames)) % intervalFrames == 0)
             {
+              pendingRules.push_back (ruleIdx);
+              rulePending[ruleIdx] = true;
+            }
+        }
+    }
 
-              if (SystemFlags::
-                  getSystemSettingType (SystemFlags::debugPerformance).enabled
-                  && chrono.getMillis () > 0)
-                SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                          "In [%s::%s Line: %d] took msecs: %lld [ruleIdx = %d, before rule->test()]\n",
-                                          __FILE__, __FUNCTION__, __LINE__,
-                                          chrono.getMillis (), ruleIdx);
+    void
+    Ai::processRule (int ruleIdx)
+    {
+      AiRule *
+        rule = aiRules[ruleIdx];
 
-              //printf("Testing AI Faction # %d RULE Name[%s]\n",aiInterface->getFactionIndex(),rule->getName().c_str());
+      //printf("Testing AI Faction # %d RULE Name[%s]\n",aiInterface->getFactionIndex(),rule->getName().c_str());
 
-              // Test to see if AI can execute rule e.g. is there a worker available to for harvesting wood?
-              if (rule->test ())
-                {
-                  if (outputAIBehaviourToConsole ())
-                    printf
-                      ("\n\nYYYYY Executing AI Faction # %d RULE Name[%s]\n\n",
-                       aiInterface->getFactionIndex (),
-                       rule->getName ().c_str ());
-
-                  aiInterface->printLog (3,
-                                         intToStr (1000 *
-                                                   aiInterface->getTimer () /
-                                                   GameConstants::updateFps) +
-                                         ": Executing rule: " +
-                                         rule->getName () + '\n');
+      // Test to see if AI can execute rule e.g. is there a worker available to for harvesting wood?
+      if (rule->test ())
+        {
+          if (outputAIBehaviourToConsole ())
+            printf ("\n\nYYYYY Executing AI Faction # %d RULE Name[%s]\n\n",
+                    aiInterface->getFactionIndex (),
+                    rule->getName ().c_str ());
 
-                  if (SystemFlags::
-                      getSystemSettingType (SystemFlags::debugPerformance).
-                      enabled && chrono.getMillis () > 0)
-                    SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                              "In [%s::%s Line: %d] took msecs: %lld [ruleIdx = %d, before rule->execute() [%s]]\n",
-                                              __FILE__, __FUNCTION__,
-                                              __LINE__, chrono.getMillis (),
-                                              ruleIdx,
-                                              rule->getName ().c_str ());
-                  // Execute the rule.
-                  rule->execute ();
+          aiInterface->printLog (3,
+                                 intToStr (1000 * aiInterface->getTimer () /
+                                           GameConstants::updateFps) +
+                                 ": Executing rule: " + rule->getName () +
+                                 '\n');
 
-                  if (SystemFlags::
-                      getSystemSettingType (SystemFlags::debugPerformance).
-                      enabled && chrono.getMillis () > 0)
-                    SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                              "In [%s::%s Line: %d] took msecs: %lld [ruleIdx = %d, after rule->execute() [%s]]\n",
-                                              __FILE__, __FUNCTION__,
-                                              __LINE__, chrono.getMillis (),
-                                              ruleIdx,
-                                              rule->getName ().c_str ());
-                }
-            }
+          // Execute the rule.
+          rule->execute ();
         }
+    }
 
-      if (SystemFlags::getSystemSettingType (SystemFlags::debugPerformance).
-          enabled && chrono.getMillis () > 0)
-        SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                  "In [%s::%s Line: %d] took msecs: %lld [END]\n",
-                                  __FILE__, __FUNCTION__, __LINE__,
-                                  chrono.getMillis ());
+    string
+    Ai::getRuleCostReport () const
+    {
+      string
+        result = "AI rule costs in microseconds:\n";
+      for (unsigned int ruleIdx = 0; ruleIdx < ruleCosts.size (); ++ruleIdx)
+        {
+          result +=
+            "  " + aiRules[ruleIdx]->getName () + " " +
+            ruleCosts[ruleIdx].toString () + "\n";
+        }
+      return result;
     }
 
+// ==================== AiRuleCost ====================
 
-// ==================== state requests ====================
+    AiRuleCost::AiRuleCost ()
+    {
+      runs = 0;
+      totalMicros = 0;
+      maxMicros = 0;
+      for (int i = 0; i < bucketCount; ++i)
+        {
+          buckets[i] = 0;
+        }
+    }
 
-    int
-    Ai::getCountOfType (const UnitType * ut)
+    void
+    AiRuleCost::add (int64 micros)
     {
+      runs++;
+      totalMicros += micros;
+      maxMicros = max (maxMicros, micros);
+
       int
-        count = 0;
-      for (int i = 0; i < aiInterface->getMyUnitCount (); ++i)
+        bucket = 0;
+      while (bucket < bucketCount - 1 && micros >= ((int64) 16 << bucket))
         {
-          if (ut == aiInterface->getMyUnit (i)->getType ())
-            {
-              count++;
-            }
+          bucket++;
         }
-      return count;
+      buckets[bucket]++;
+    }
+
+    string
+    AiRuleCost::toString () const
+    {
+      string
+        result =
+        "runs: " + intToStr (runs) + " total: " + intToStr (totalMicros) +
+        " max: " + intToStr (maxMicros);
+      for (int i = 0; i < bucketCount - 1; ++i)
+        {
+          result += " <" + intToStr (16 << i) + ": " + intToStr (buckets[i]);
+        }
+      result +=
+        " >=" + intToStr (16 << (bucketCount - 2)) + ": " +
+        intToStr (buckets[bucketCount - 1]);
+      return result;
+    }
+
+// ==================== state requests ====================
+
+    int
+    Ai::getCountOfType (const UnitType * ut)
+    {
+      return aiInterface->getMyFaction ()->getUnitCensus ().getTypeCount (ut);
     }
 
     int
     Ai::getCountOfClass (UnitClass uc,
                          UnitClass * additionalUnitClassToExcludeFromCount)
     {
-      int
-        count = 0;
-      for (int i = 0; i < aiInterface->getMyUnitCount (); ++i)
-        {
-          if (aiInterface->getMyUnit (i)->getType ()->isOfClass (uc))
-            {
-              // Skip unit if it ALSO contains the exclusion unit class type
-              if (additionalUnitClassToExcludeFromCount != NULL)
-                {
-                  if (aiInterface->getMyUnit (i)->getType ()->
-                      isOfClass (*additionalUnitClassToExcludeFromCount))
-                    {
-                      continue;
-                    }
-                }
-              ++count;
-            }
-        }
-      return count;
+      // Skip unit if it ALSO contains the exclusion unit class type
+      return aiInterface->getMyFaction ()->getUnitCensus ().
+        getClassCount (uc, additionalUnitClassToExcludeFromCount);
     }
 
     float
@@ -813,9 +887,7 @@ namespace
               const int
                 maxUnitsToHarvestResource = 5;
 
-              vector < int >
-                unitsGettingResource = findUnitsHarvestingResourceType (rt);
-              if ((int) unitsGettingResource.size () <=
+              if (getUnitCountHarvestingResourceType (rt) <=
                   maxUnitsToHarvestResource)
                 {
                   // Now MAKE SURE the unit has a harvest command for this resource
@@ -897,148 +969,62 @@ namespace
     bool
     Ai::findAbleUnit (int *unitIndex, CommandClass ability, bool idleOnly)
     {
-      vector < int >
-        units;
-
       *unitIndex = -1;
-      for (int i = 0; i < aiInterface->getMyUnitCount (); ++i)
+
+      // the census gives the number of candidates, so only the units up to
+      // the randomly chosen one are visited
+      const UnitCensus &
+        census = aiInterface->getMyFaction ()->getUnitCensus ();
+      int
+        ableCount = census.getIdleAbleCount (ability);
+      if (idleOnly == false)
         {
-          const Unit *
-            unit = aiInterface->getMyUnit (i);
-          if (unit->getType ()->isCommandable ()
-              && unit->getType ()->hasCommandClass (ability))
+          for (int cc = 0; cc < ccCount; ++cc)
             {
-              if (!idleOnly || !unit->anyCommand ()
-                  || unit->getCurrCommand ()->getCommandType ()->
-                  getClass () == ccStop)
+              if (cc != ccStop)
                 {
-                  units.push_back (i);
+                  ableCount +=
+                    census.getAbleCount (ability,
+                                         static_cast < CommandClass > (cc));
                 }
             }
         }
-
-      if (units.empty ())
+      if (ableCount <= 0)
         {
           return false;
         }
-      else
-        {
-          *unitIndex = units[random.randRange (0, (int) units.size () - 1)];
-          return true;
-        }
-    }
 
-    vector < int >
-    Ai::findUnitsHarvestingResourceType (const ResourceType * rt)
-    {
-      vector < int >
-        units;
-
-      Map *
-        map = aiInterface->getMap ();
+      int
+        chosen = random.randRange (0, ableCount - 1);
       for (int i = 0; i < aiInterface->getMyUnitCount (); ++i)
         {
           const Unit *
             unit = aiInterface->getMyUnit (i);
-          if (unit->getType ()->isCommandable ())
+          if (unit->getType ()->isCommandable ()
+              && unit->getType ()->hasCommandClass (ability))
             {
-              if (unit->getType ()->hasCommandClass (ccHarvest))
-                {
-                  if (unit->anyCommand ()
-                      && unit->getCurrCommand ()->getCommandType ()->
-                      getClass () == ccHarvest)
-                    {
-                      Command *
-                        command = unit->getCurrCommand ();
-                      const HarvestCommandType *
-                        hct = dynamic_cast < const
-                        HarvestCommandType * >(command->getCommandType ());
-                      if (hct != NULL)
-                        {
-                          const Vec2i
-                            unitTargetPos = unit->getTargetPos ();
-                          SurfaceCell *
-                            sc =
-                            map->
-                            getSurfaceCell (Map::
-                                            toSurfCoords (unitTargetPos));
-                          Resource *
-                            r = sc->getResource ();
-                          if (r != NULL && r->getType () == rt)
-                            {
-                              units.push_back (i);
-                            }
-                        }
-                    }
-                }
-              else if (unit->getType ()->hasCommandClass (ccProduce))
-                {
-                  if (unit->anyCommand ()
-                      && unit->getCurrCommand ()->getCommandType ()->
-                      getClass () == ccProduce)
-                    {
-                      Command *
-                        command = unit->getCurrCommand ();
-                      const ProduceCommandType *
-                        pct = dynamic_cast < const
-                        ProduceCommandType * >(command->getCommandType ());
-                      if (pct != NULL)
-                        {
-                          const UnitType *
-                            ut = pct->getProducedUnit ();
-                          if (ut != NULL)
-                            {
-                              const Resource *
-                                r = ut->getCost (rt);
-                              if (r != NULL)
-                                {
-                                  if (r != NULL && r->getAmount () < 0)
-                                    {
-                                      units.push_back (i);
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-              else if (unit->getType ()->hasCommandClass (ccBuild))
+              if (!idleOnly || !unit->anyCommand ()
+                  || unit->getCurrCommand ()->getCommandType ()->
+                  getClass () == ccStop)
                 {
-                  if (unit->anyCommand ()
-                      && unit->getCurrCommand ()->getCommandType ()->
-                      getClass () == ccBuild)
+                  if (chosen-- == 0)
                     {
-                      Command *
-                        command = unit->getCurrCommand ();
-                      const BuildCommandType *
-                        bct = dynamic_cast < const
-                        BuildCommandType * >(command->getCommandType ());
-                      if (bct != NULL)
-                        {
-                          for (int j = 0; j < bct->getBuildingCount (); ++j)
-                            {
-                              const UnitType *
-                                ut = bct->getBuilding (j);
-                              if (ut != NULL)
-                                {
-                                  const Resource *
-                                    r = ut->getCost (rt);
-                                  if (r != NULL)
-                                    {
-                                      if (r != NULL && r->getAmount () < 0)
-                                        {
-                                          units.push_back (i);
-                                          break;
-                                        }
-                                    }
-                                }
-                            }
-                        }
+                      *unitIndex = i;
+                      return true;
                     }
                 }
             }
         }
+      return false;
+    }
 
-      return units;
+    int
+    Ai::getUnitCountHarvestingResourceType (const ResourceType * rt)
+    {
+      // units harvesting rt, or producing or building units that yield it,
+      // counted by the census as their commands change
+      return aiInterface->getMyFaction ()->getUnitCensus ().
+        getHarvesterCount (rt);
     }
 
 //vector<int> Ai::findUnitsDoingCommand(CommandClass currentCommand) {
@@ -1060,10 +1046,19 @@ namespace
     Ai::findAbleUnit (int *unitIndex, CommandClass ability,
                       CommandClass currentCommand)
     {
-      vector < int >
-        units;
-
       *unitIndex = -1;
+
+      int
+        ableCount =
+        aiInterface->getMyFaction ()->getUnitCensus ().getAbleCount (ability,
+                                                                     currentCommand);
+      if (ableCount <= 0)
+        {
+          return false;
+        }
+
+      int
+        chosen = random.randRange (0, ableCount - 1);
       for (int i = 0; i < aiInterface->getMyUnitCount (); ++i)
         {
           const Unit *
@@ -1075,20 +1070,15 @@ namespace
                   && unit->getCurrCommand ()->getCommandType ()->
                   getClass () == currentCommand)
                 {
-                  units.push_back (i);
+                  if (chosen-- == 0)
+                    {
+                      *unitIndex = i;
+                      return true;
+                    }
                 }
             }
         }
-
-      if (units.empty ())
-        {
-          return false;
-        }
-      else
-        {
-          *unitIndex = units[random.randRange (0, (int) units.size () - 1)];
-          return true;
-        }
+      return false;
     }
 
     bool
@@ -1096,13 +1086,20 @@ namespace
                             const Vec2i & searchPos, Vec2i & outPos)
     {
 
+      // every radius only tests the ring it adds to the square of the
+      // previous one, the inner cells were already found not free
       for (int currRadius = 0; currRadius < maxBuildRadius; ++currRadius)
         {
           for (int i = searchPos.x - currRadius; i < searchPos.x + currRadius;
                ++i)
             {
+              bool
+                edgeColumn = (i == searchPos.x - currRadius
+                              || i == searchPos.x + currRadius - 1);
+              int
+                jStep = (edgeColumn ? 1 : 2 * currRadius - 1);
               for (int j = searchPos.y - currRadius;
-                   j < searchPos.y + currRadius; ++j)
+                   j < searchPos.y + currRadius; j += jStep)
                 {
                   outPos = Vec2i (i, j);
                   if (aiInterface->
@@ -1663,9 +1660,9 @@ namespace
       if (SystemFlags::getSystemSettingType (SystemFlags::debugPerformance).
           enabled && chrono.getMillis () > 0)
         SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                  "In [%s::%s Line: %d] took msecs: %lld [START]\n",
+                                  "In [%s::%s Line: %d] took usecs: %lld [START]\n",
                                   __FILE__, __FUNCTION__, __LINE__,
-                                  chrono.getMillis ());
+                                  chrono.getMicros ());
 
       int
         unitCount = aiInterface->getMyUnitCount ();
@@ -1728,9 +1725,9 @@ namespace
                       getSystemSettingType (SystemFlags::debugPerformance).
                       enabled && chrono.getMillis () > 0)
                     SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                              "In [%s::%s Line: %d] took msecs: %lld [START]\n",
+                                              "In [%s::%s Line: %d] took usecs: %lld [START]\n",
                                               __FILE__, __FUNCTION__,
-                                              __LINE__, chrono.getMillis ());
+                                              __LINE__, chrono.getMicros ());
                   return true;
                 }
             }
@@ -1739,9 +1736,9 @@ namespace
       if (SystemFlags::getSystemSettingType (SystemFlags::debugPerformance).
           enabled && chrono.getMillis () > 0)
         SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                  "In [%s::%s Line: %d] took msecs: %lld [START]\n",
+                                  "In [%s::%s Line: %d] took usecs: %lld [START]\n",
                                   __FILE__, __FUNCTION__, __LINE__,
-                                  chrono.getMillis ());
+                                  chrono.getMicros ());
       return false;
     }
 
@@ -1833,9 +1830,9 @@ namespace
       if (SystemFlags::getSystemSettingType (SystemFlags::debugPerformance).
           enabled && chrono.getMillis () > 0)
         SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                  "In [%s::%s Line: %d] took msecs: %lld [START]\n",
+                                  "In [%s::%s Line: %d] took usecs: %lld [START]\n",
                                   __FILE__, __FUNCTION__, __LINE__,
-                                  chrono.getMillis ());
+                                  chrono.getMicros ());
 
       int
         unitCount = aiInterface->getMyUnitCount ();
@@ -1897,9 +1894,9 @@ namespace
       if (SystemFlags::getSystemSettingType (SystemFlags::debugPerformance).
           enabled && chrono.getMillis () > 0)
         SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                  "In [%s::%s Line: %d] took msecs: %lld [START]\n",
+                                  "In [%s::%s Line: %d] took usecs: %lld [START]\n",
                                   __FILE__, __FUNCTION__, __LINE__,
-                                  chrono.getMillis ());
+                                  chrono.getMicros ());
 
       if (signalAdjacentUnits.empty () == false)
         {
@@ -1973,9 +1970,9 @@ namespace
       if (SystemFlags::getSystemSettingType (SystemFlags::debugPerformance).
           enabled && chrono.getMillis () > 0)
         SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                  "In [%s::%s Line: %d] took msecs: %lld [START]\n",
+                                  "In [%s::%s Line: %d] took usecs: %lld [START]\n",
                                   __FILE__, __FUNCTION__, __LINE__,
-                                  chrono.getMillis ());
+                                  chrono.getMicros ());
     }
 
     bool
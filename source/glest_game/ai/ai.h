@@ -221,6 +221,37 @@ namespace
       loadGame (const XmlNode * rootNode, Faction * faction);
     };
 
+// ===============================
+//      class AiRuleCost
+//
+///     Time spent testing and executing one AI rule
+// ===============================
+
+    class
+      AiRuleCost
+    {
+    public:
+      // bucket i holds the runs under 16 << i microseconds, the last one
+      // everything slower
+      static const int
+        bucketCount = 10;
+
+      int64
+        runs;
+      int64
+        totalMicros;
+      int64
+        maxMicros;
+      int64
+        buckets[bucketCount];
+
+      AiRuleCost ();
+      void
+      add (int64 micros);
+      string
+      toString () const;
+    };
+
 // ===============================
 //      class AI
 //
@@ -279,6 +310,10 @@ namespace
         deque <
         Vec2i >
         Positions;
+      typedef
+        deque <
+      int >
+        RuleQueue;
 
     private:
       AiInterface *
@@ -300,6 +335,24 @@ namespace
       int
         minWarriors;
 
+      // rules that came due but did not fit in their frame
+      RuleQueue
+        pendingRules;
+      vector < bool >
+        rulePending;
+      vector < AiRuleCost >
+        ruleCosts;
+      // rules run each frame, 0 for no limit
+      int
+        maxRulesPerFrame;
+
+      int
+      getRulePhase (int ruleIdx, int intervalFrames) const;
+      void
+      queueDueRules ();
+      void
+      processRule (int ruleIdx);
+
       bool
       getAdjacentUnits (std::map < float, std::map < int,
                         const Unit * > >&signalAdjacentUnits,
@@ -326,6 +379,7 @@ namespace
         startLoc = -1;
         randomMinWarriorsReached = false;
         minWarriors = 0;
+        maxRulesPerFrame = 0;
       }
       ~
       Ai ();
@@ -347,6 +401,9 @@ namespace
       int
       getCountOfType (const UnitType * ut);
 
+      string
+      getRuleCostReport () const;
+
       int
       getMinWarriors () const
       {
@@ -376,8 +433,8 @@ namespace
       findAbleUnit (int *unitIndex, CommandClass ability,
                     CommandClass currentCommand);
       //vector<int> findUnitsDoingCommand(CommandClass currentCommand);
-      vector < int >
-      findUnitsHarvestingResourceType (const ResourceType * rt);
+      int
+      getUnitCountHarvestingResourceType (const ResourceType * rt);
 
       bool
       beingAttacked (Vec2i & pos, Field & field, int radius);
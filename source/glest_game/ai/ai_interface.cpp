@@ -32,6 +32,7 @@
 #include "config.h"
 #include "network_manager.h"
 #include "platform_util.h"
+#include "profiler.h"
 #include "leak_dumper.h"
 
 using namespace
@@ -203,6 +204,15 @@ namespace
         Chrono
           chrono;
 
+        if (this->aiIntf != NULL)
+          {
+            FrameProfiler::getInstance ().setThreadName ("ai " +
+                                                         intToStr
+                                                         (this->aiIntf->
+                                                          getFactionIndex
+                                                          ()));
+          }
+
         //unsigned int idx = 0;
         for (; this->aiIntf != NULL;)
           {
@@ -448,6 +458,15 @@ namespace
           workerThread = NULL;
         }
 
+      if (SystemFlags::getSystemSettingType (SystemFlags::debugPerformance).
+          enabled)
+        SystemFlags::OutputDebug (SystemFlags::debugPerformance,
+                                  "In [%s::%s Line: %d] AI factionIndex = %d %s",
+                                  __FILE__, __FUNCTION__, __LINE__,
+                                  this->factionIndex,
+                                  ai.getRuleCostReport ().c_str ());
+      printLog (1, ai.getRuleCostReport ());
+
       if (fp)
         {
           fclose (fp);
@@ -487,6 +506,7 @@ namespace
     void
     AiInterface::update ()
     {
+      PROFILE_ZONE ("AiInterface::update");
       timer++;
       ai.update ();
     }
@@ -20,6 +20,7 @@
 #include "command.h"
 #include "faction.h"
 #include "randomgen.h"
+#include "profiler.h"
 #include "leak_dumper.h"
 
 using namespace std;
@@ -185,6 +186,7 @@ namespace
     PathFinder::findPath (Unit * unit, const Vec2i & finalPos,
                           bool * wasStuck, int frameIndex)
     {
+      PROFILE_ZONE ("PathFinder::findPath");
       TravelState
         ts = tsImpossible;
 
@@ -885,6 +887,7 @@ namespace
                        int frameIndex, int maxNodeCount,
                        uint32 * searched_node_count)
     {
+      PROFILE_ZONE ("PathFinder::aStar");
       TravelState
         ts = tsImpossible;
 
@@ -1128,10 +1131,10 @@ namespace
         if (SystemFlags::getSystemSettingType (SystemFlags::debugPerformance).
             enabled == true && chrono.getMillis () > 4)
           SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                    "In [%s::%s Line: %d] took msecs: %lld\n",
+                                    "In [%s::%s Line: %d] took usecs: %lld\n",
                                     extractFileFromDirectoryPath (__FILE__).
                                     c_str (), __FUNCTION__, __LINE__,
-                                    chrono.getMillis ());
+                                    chrono.getMicros ());
 
         //path find algorithm
 
@@ -1168,10 +1171,10 @@ namespace
         if (SystemFlags::getSystemSettingType (SystemFlags::debugPerformance).
             enabled == true && chrono.getMillis () > 4)
           SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                    "In [%s::%s Line: %d] took msecs: %lld\n",
+                                    "In [%s::%s Line: %d] took usecs: %lld\n",
                                     extractFileFromDirectoryPath (__FILE__).
                                     c_str (), __FUNCTION__, __LINE__,
-                                    chrono.getMillis ());
+                                    chrono.getMicros ());
 
         // First check if unit currently blocked all around them, if so don't try to pathfind
         if (inBailout == false && unitPos != finalPos)
@@ -1220,14 +1223,14 @@ namespace
                 getSystemSettingType (SystemFlags::debugPerformance).
                 enabled == true && chrono.getMillis () > 1)
               SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                        "In [%s::%s Line: %d] **Check if dest blocked, distance for unit [%d - %s] from [%s] to [%s] is %.2f took msecs: %lld nodeLimitReached = %d, failureCount = %d\n",
+                                        "In [%s::%s Line: %d] **Check if dest blocked, distance for unit [%d - %s] from [%s] to [%s] is %.2f took usecs: %lld nodeLimitReached = %d, failureCount = %d\n",
                                         extractFileFromDirectoryPath
                                         (__FILE__).c_str (), __FUNCTION__,
                                         __LINE__, unit->getId (),
                                         unit->getFullName (false).c_str (),
                                         unitPos.getString ().c_str (),
                                         finalPos.getString ().c_str (), dist,
-                                        (long long int) chrono.getMillis (),
+                                        (long long int) chrono.getMicros (),
                                         nodeLimitReached, failureCount);
 
             if (nodeLimitReached == false)
@@ -1276,7 +1279,7 @@ namespace
                     getSystemSettingType (SystemFlags::debugPerformance).
                     enabled == true && chrono.getMillis () > 1)
                   SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                            "In [%s::%s Line: %d] **Check if dest blocked, distance for unit [%d - %s] from [%s] to [%s] is %.2f took msecs: %lld nodeLimitReached = %d, failureCount = %d\n",
+                                            "In [%s::%s Line: %d] **Check if dest blocked, distance for unit [%d - %s] from [%s] to [%s] is %.2f took usecs: %lld nodeLimitReached = %d, failureCount = %d\n",
                                             extractFileFromDirectoryPath
                                             (__FILE__).c_str (), __FUNCTION__,
                                             __LINE__, unit->getId (),
@@ -1286,7 +1289,7 @@ namespace
                                             finalPos.getString ().c_str (),
                                             dist,
                                             (long long int) chrono.
-                                            getMillis (), nodeLimitReached,
+                                            getMicros (), nodeLimitReached,
                                             failureCount);
               }
           }
@@ -1440,10 +1443,10 @@ namespace
         if (SystemFlags::getSystemSettingType (SystemFlags::debugPerformance).
             enabled == true && chrono.getMillis () > 4)
           SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                    "In [%s::%s Line: %d] took msecs: %lld\n",
+                                    "In [%s::%s Line: %d] took usecs: %lld\n",
                                     extractFileFromDirectoryPath (__FILE__).
                                     c_str (), __FUNCTION__, __LINE__,
-                                    chrono.getMillis ());
+                                    chrono.getMicros ());
 
         //check results of path finding
         ts = tsImpossible;
@@ -1503,10 +1506,10 @@ namespace
                 getSystemSettingType (SystemFlags::debugPerformance).
                 enabled == true && chrono.getMillis () > 4)
               SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                        "In [%s::%s Line: %d] took msecs: %lld\n",
+                                        "In [%s::%s Line: %d] took usecs: %lld\n",
                                         extractFileFromDirectoryPath
                                         (__FILE__).c_str (), __FUNCTION__,
-                                        __LINE__, chrono.getMillis ());
+                                        __LINE__, chrono.getMicros ());
           }
         else
           {
@@ -1531,10 +1534,10 @@ namespace
                 getSystemSettingType (SystemFlags::debugPerformance).
                 enabled == true && chrono.getMillis () > 4)
               SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                        "In [%s::%s Line: %d] took msecs: %lld\n",
+                                        "In [%s::%s Line: %d] took usecs: %lld\n",
                                         extractFileFromDirectoryPath
                                         (__FILE__).c_str (), __FUNCTION__,
-                                        __LINE__, chrono.getMillis ());
+                                        __LINE__, chrono.getMicros ());
 
             if (frameIndex < 0)
               {
@@ -1595,10 +1598,10 @@ namespace
                 getSystemSettingType (SystemFlags::debugPerformance).
                 enabled == true && chrono.getMillis () > 4)
               SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                        "In [%s::%s Line: %d] took msecs: %lld\n",
+                                        "In [%s::%s Line: %d] took usecs: %lld\n",
                                         extractFileFromDirectoryPath
                                         (__FILE__).c_str (), __FUNCTION__,
-                                        __LINE__, chrono.getMillis ());
+                                        __LINE__, chrono.getMicros ());
 
             if (SystemFlags::
                 getSystemSettingType (SystemFlags::debugWorldSynch).enabled ==
@@ -1688,10 +1691,10 @@ namespace
                 getSystemSettingType (SystemFlags::debugPerformance).
                 enabled == true && chrono.getMillis () > 4)
               SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                        "In [%s::%s Line: %d] took msecs: %lld\n",
+                                        "In [%s::%s Line: %d] took usecs: %lld\n",
                                         extractFileFromDirectoryPath
                                         (__FILE__).c_str (), __FUNCTION__,
-                                        __LINE__, chrono.getMillis ());
+                                        __LINE__, chrono.getMicros ());
           }
 
 
@@ -1702,10 +1705,10 @@ namespace
         if (SystemFlags::getSystemSettingType (SystemFlags::debugPerformance).
             enabled == true && chrono.getMillis () > 4)
           SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                    "In [%s::%s] Line: %d took msecs: %lld --------------------------- [END OF METHOD] ---------------------------\n",
+                                    "In [%s::%s] Line: %d took usecs: %lld --------------------------- [END OF METHOD] ---------------------------\n",
                                     extractFileFromDirectoryPath (__FILE__).
                                     c_str (), __FUNCTION__, __LINE__,
-                                    chrono.getMillis ());
+                                    chrono.getMicros ());
 
         if (frameIndex >= 0)
           {
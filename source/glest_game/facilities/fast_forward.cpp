@@ -0,0 +1,178 @@
+// ==============================================================
+//	This file is part of Glest (www.glest.org)
+//
+//	Copyright (C) 2001-2009 Martio Figueroa
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include "fast_forward.h"
+
+#include "program.h"
+#include "game.h"
+#include "world.h"
+#include "faction.h"
+#include "core_data.h"
+#include "network_manager.h"
+#include "checksum.h"
+
+#include "leak_dumper.h"
+
+namespace Glest{ namespace Game{
+
+// =====================================================
+//	class FastForward
+// =====================================================
+
+const int FastForward::updatesPerLoop = GameConstants::updateFps;
+
+bool FastForward::enabled = false;
+int FastForward::maxFrames = 0;
+
+static const char *defaultGameSettingsFile = "lastCustomGameSettings.mgg";
+
+// ===================== PUBLIC ========================
+
+FastForward::FastForward() {
+	started = false;
+	startFrame = 0;
+}
+
+FastForward & FastForward::getInstance() {
+	static FastForward fastForward;
+	return fastForward;
+}
+
+void FastForward::startGame(Program *program, const string &file) {
+	if(file != "" && EndsWith(file, ".mgg") == false) {
+		// replay the whole command stream, a keyframe would skip the
+		// frames we want to measure
+		Game::loadReplay(file, program, true);
+		return;
+	}
+
+	string settingsFile = (file != "" ? file : defaultGameSettingsFile);
+	GameSettings gameSettings;
+	if(CoreData::getInstance().loadGameSettingsFromFile(settingsFile, &gameSettings) == false) {
+		throw megaglest_runtime_error("Specified game settings file [" + settingsFile + "] was NOT found!");
+	}
+
+	// every player slot is played by the AI
+	for(int i = 0; i < GameConstants::maxPlayers; ++i) {
+		switch(gameSettings.getFactionControl(i)) {
+			case ctHuman:
+			case ctNetwork:
+			case ctNetworkUnassigned:
+			case ctNetworkCpu:
+				gameSettings.setFactionControl(i, ctCpu);
+				break;
+			case ctNetworkCpuEasy:
+				gameSettings.setFactionControl(i, ctCpuEasy);
+				break;
+			case ctNetworkCpuUltra:
+				gameSettings.setFactionControl(i, ctCpuUltra);
+				break;
+			case ctNetworkCpuMega:
+				gameSettings.setFactionControl(i, ctCpuMega);
+				break;
+			default:
+				break;
+		}
+	}
+
+	NetworkManager &networkManager= NetworkManager::getInstance();
+	networkManager.end();
+	networkManager.init(nrServer, true);
+
+	program->setState(new Game(program, &gameSettings, true));
+}
+
+void FastForward::addPerformanceCount(const string &key, int64 value) {
+	if(started == true) {
+		performanceTotals[key] += value;
+	}
+}
+
+bool FastForward::updateGame(Game *game) {
+	const int frame= game->getWorld()->getFrameCount();
+	if(started == false) {
+		// loading is not part of the measurement
+		started = true;
+		startFrame = frame;
+		performanceTotals.clear();
+		chrono.start();
+		printf("Fast forward started at frame %d\n", startFrame);
+		return false;
+	}
+
+	string reason = "";
+	if(game->getGameOver() == true) {
+		reason = "game over";
+	}
+	else if(game->getLastWorldFrameCountForReplay() > 0 &&
+			frame >= game->getLastWorldFrameCountForReplay()) {
+		reason = "end of replay";
+	}
+	else if(maxFrames > 0 && frame - startFrame >= maxFrames) {
+		reason = "frame limit";
+	}
+	if(reason == "") {
+		return false;
+	}
+
+	printReport(game, reason);
+
+	Program *program = game->getProgram();
+	Stats endStats = game->quitGame();
+	Program::setWantShutdownApplicationAfterGame(true);
+	Game::exitGameState(program, endStats);
+	return true;
+}
+
+// ===================== PRIVATE ========================
+
+void FastForward::printReport(Game *game, const string &reason) {
+	const int64 elapsedMillis = chrono.getMillis();
+	World *world = game->getWorld();
+	const int frames = world->getFrameCount() - startFrame;
+	const double seconds = elapsedMillis / 1000.0;
+
+	printf("\nFast forward finished at frame %d (%s)\n", world->getFrameCount(), reason.c_str());
+	printf("-----------------------\n");
+	printf("Simulated %d frames in %.3f seconds", frames, seconds);
+	if(elapsedMillis > 0) {
+		printf(", %.1f frames/sec, %.1fx real time",
+				frames / seconds, frames / seconds / GameConstants::updateFps);
+	}
+	printf("\n");
+
+	int64 totalMicros = 0;
+	for(std::map<string, int64>::const_iterator iterMap = performanceTotals.begin();
+		iterMap != performanceTotals.end(); ++iterMap) {
+		totalMicros += iterMap->second;
+	}
+	printf("Subsystem times (total usecs, usecs per frame):\n");
+	for(std::map<string, int64>::const_iterator iterMap = performanceTotals.begin();
+		iterMap != performanceTotals.end(); ++iterMap) {
+		printf("  %-50s " MG_I64_SPECIFIER " %.2f\n", iterMap->first.c_str(),
+				iterMap->second, (frames > 0 ? (double)iterMap->second / frames : 0.0));
+	}
+	printf("  %-50s " MG_I64_SPECIFIER "\n", "(sum)", totalMicros);
+
+	Checksum worldCRC;
+	printf("Faction CRCs at frame %d:\n", world->getFrameCount());
+	for(int i = 0; i < world->getFactionCount(); ++i) {
+		Faction *faction = world->getFaction(i);
+		uint32 crc = faction->getCRC().getSum();
+		worldCRC.addUInt(crc);
+		printf("  #%d %-20s 0x%08X\n", i, faction->getType()->getName(false).c_str(), crc);
+	}
+	printf("World CRC: 0x%08X\n", worldCRC.getSum());
+	printf("-----------------------\n");
+	fflush(stdout);
+}
+
+}}//end namespace
@@ -0,0 +1,73 @@
+// ==============================================================
+//	This file is part of Glest (www.glest.org)
+//
+//	Copyright (C) 2001-2009 Martio Figueroa
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#ifndef _GLEST_GAME_FAST_FORWARD_H_
+#define _GLEST_GAME_FAST_FORWARD_H_
+
+#ifdef WIN32
+    #include <winsock2.h>
+    #include <winsock.h>
+#endif
+
+#include <map>
+#include <string>
+#include "platform_common.h"
+#include "leak_dumper.h"
+
+using namespace std;
+using Shared::PlatformCommon::Chrono;
+
+namespace Glest{ namespace Game{
+
+class Program;
+class Game;
+
+// =====================================================
+//	class FastForward
+//
+/// Runs a replay or an AI only game headless without
+/// frame pacing and reports the speed and the final CRCs
+// =====================================================
+
+class FastForward{
+public:
+	// world updates run for each pass of the main loop, so window events
+	// and quit requests are still handled
+	static const int updatesPerLoop;
+
+private:
+	static bool enabled;
+	static int maxFrames;
+
+	bool started;
+	int startFrame;
+	Chrono chrono;
+	std::map<string, int64> performanceTotals;
+
+	void printReport(Game *game, const string &reason);
+
+public:
+	static FastForward & getInstance();
+	FastForward();
+
+	static bool isEnabled() { return enabled; }
+	static void setEnabled(bool value) { enabled = value; }
+	static void setMaxFrames(int value) { maxFrames = value; }
+
+	static void startGame(Program *program, const string &file);
+
+	void addPerformanceCount(const string &key, int64 value);
+	bool updateGame(Game *game);
+};
+
+}}//end namespace
+
+#endif
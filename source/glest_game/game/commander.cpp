@@ -254,10 +254,10 @@ namespace
       if (SystemFlags::getSystemSettingType (SystemFlags::debugPerformance).
           enabled && chrono.getMillis () > 0)
         SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                  "In [%s::%s] Line: %d took msecs: %lld\n",
+                                  "In [%s::%s] Line: %d took usecs: %lld\n",
                                   extractFileFromDirectoryPath (__FILE__).
                                   c_str (), __FUNCTION__, __LINE__,
-                                  chrono.getMillis ());
+                                  chrono.getMicros ());
 
       std::pair < CommandResult, string > result (crFailUndefined, "");
       bool
@@ -274,10 +274,10 @@ namespace
               getSystemSettingType (SystemFlags::debugPerformance).enabled
               && chrono.getMillis () > 0)
             SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                      "In [%s::%s] Line: %d took msecs: %lld\n",
+                                      "In [%s::%s] Line: %d took usecs: %lld\n",
                                       extractFileFromDirectoryPath (__FILE__).
                                       c_str (), __FUNCTION__, __LINE__,
-                                      chrono.getMillis ());
+                                      chrono.getMicros ());
 
           result = pushNetworkCommand (&networkCommand);
         }
@@ -285,10 +285,10 @@ namespace
       if (SystemFlags::getSystemSettingType (SystemFlags::debugPerformance).
           enabled && chrono.getMillis () > 0)
         SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                  "In [%s::%s] Line: %d took msecs: %lld\n",
+                                  "In [%s::%s] Line: %d took usecs: %lld\n",
                                   extractFileFromDirectoryPath (__FILE__).
                                   c_str (), __FUNCTION__, __LINE__,
-                                  chrono.getMillis ());
+                                  chrono.getMicros ());
 
       return result;
     }
@@ -902,12 +902,12 @@ namespace
                       getSystemSettingType (SystemFlags::debugPerformance).
                       enabled && perfTimer.getMillis () > 0)
                     SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                              "In [%s::%s Line: %d] gameNetworkInterface->updateKeyframe for %d took %lld msecs\n",
+                                              "In [%s::%s Line: %d] gameNetworkInterface->updateKeyframe for %d took %lld usecs\n",
                                               extractFileFromDirectoryPath
                                               (__FILE__).c_str (),
                                               __FUNCTION__, __LINE__,
                                               world->getFrameCount (),
-                                              perfTimer.getMillis ());
+                                              perfTimer.getMicros ());
 
                   if (SystemFlags::
                       getSystemSettingType (SystemFlags::debugPerformance).
@@ -934,11 +934,11 @@ namespace
                       getSystemSettingType (SystemFlags::debugPerformance).
                       enabled && perfTimer.getMillis () > 0)
                     SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                              "In [%s::%s Line: %d] giveNetworkCommand took %lld msecs, PendingCommandCount = %d\n",
+                                              "In [%s::%s Line: %d] giveNetworkCommand took %lld usecs, PendingCommandCount = %d\n",
                                               extractFileFromDirectoryPath
                                               (__FILE__).c_str (),
                                               __FUNCTION__, __LINE__,
-                                              perfTimer.getMillis (),
+                                              perfTimer.getMicros (),
                                               gameNetworkInterface->
                                               getPendingCommandCount ());
                   gameNetworkInterface->clearPendingCommands ();
@@ -970,10 +970,10 @@ namespace
       if (SystemFlags::getSystemSettingType (SystemFlags::debugPerformance).
           enabled && chrono.getMillis () > 0)
         SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                  "In [%s::%s Line: %d] took msecs: %lld [START]\n",
+                                  "In [%s::%s Line: %d] took usecs: %lld [START]\n",
                                   extractFileFromDirectoryPath (__FILE__).
                                   c_str (), __FUNCTION__, __LINE__,
-                                  chrono.getMillis ());
+                                  chrono.getMicros ());
 
 
       world->
@@ -986,10 +986,10 @@ namespace
       if (SystemFlags::getSystemSettingType (SystemFlags::debugPerformance).
           enabled && chrono.getMillis () > 0)
         SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                  "In [%s::%s Line: %d] took msecs: %lld [after networkCommand->preprocessNetworkCommand]\n",
+                                  "In [%s::%s Line: %d] took usecs: %lld [after networkCommand->preprocessNetworkCommand]\n",
                                   extractFileFromDirectoryPath (__FILE__).
                                   c_str (), __FUNCTION__, __LINE__,
-                                  chrono.getMillis ());
+                                  chrono.getMicros ());
 
       bool
         commandWasHandled = false;
@@ -1116,10 +1116,10 @@ namespace
                 getSystemSettingType (SystemFlags::debugPerformance).enabled
                 && chrono.getMillis () > 0)
               SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                        "In [%s::%s Line: %d] took msecs: %lld [after unit->setMeetingPos]\n",
+                                        "In [%s::%s Line: %d] took usecs: %lld [after unit->setMeetingPos]\n",
                                         extractFileFromDirectoryPath
                                         (__FILE__).c_str (), __FUNCTION__,
-                                        __LINE__, chrono.getMillis ());
+                                        __LINE__, chrono.getMicros ());
 
             if (SystemFlags::getSystemSettingType (SystemFlags::debugSystem).
                 enabled)
@@ -1330,10 +1330,10 @@ namespace
                 getSystemSettingType (SystemFlags::debugPerformance).enabled
                 && chrono.getMillis () > 0)
               SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                        "In [%s::%s Line: %d] took msecs: %lld [after unit->setMeetingPos]\n",
+                                        "In [%s::%s Line: %d] took usecs: %lld [after unit->setMeetingPos]\n",
                                         extractFileFromDirectoryPath
                                         (__FILE__).c_str (), __FUNCTION__,
-                                        __LINE__, chrono.getMillis ());
+                                        __LINE__, chrono.getMicros ());
 
             if (SystemFlags::getSystemSettingType (SystemFlags::debugSystem).
                 enabled)
@@ -1544,10 +1544,10 @@ namespace
               getSystemSettingType (SystemFlags::debugPerformance).enabled
               && chrono.getMillis () > 0)
             SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                      "In [%s::%s Line: %d] took msecs: %lld [after world->findUnitById]\n",
+                                      "In [%s::%s Line: %d] took usecs: %lld [after world->findUnitById]\n",
                                       extractFileFromDirectoryPath (__FILE__).
                                       c_str (), __FUNCTION__, __LINE__,
-                                      chrono.getMillis ());
+                                      chrono.getMicros ());
 
           if (SystemFlags::VERBOSE_MODE_ENABLED)
             printf
@@ -1582,11 +1582,11 @@ namespace
                         getSystemSettingType (SystemFlags::debugPerformance).
                         enabled && chrono.getMillis () > 0)
                       SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                                "In [%s::%s Line: %d] took msecs: %lld [after buildCommand]\n",
+                                                "In [%s::%s Line: %d] took usecs: %lld [after buildCommand]\n",
                                                 extractFileFromDirectoryPath
                                                 (__FILE__).c_str (),
                                                 __FUNCTION__, __LINE__,
-                                                chrono.getMillis ());
+                                                chrono.getMicros ());
 
                     if (SystemFlags::
                         getSystemSettingType (SystemFlags::debugSystem).
@@ -1606,11 +1606,11 @@ namespace
                         getSystemSettingType (SystemFlags::debugPerformance).
                         enabled && chrono.getMillis () > 0)
                       SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                                "In [%s::%s Line: %d] took msecs: %lld [after unit->giveCommand]\n",
+                                                "In [%s::%s Line: %d] took usecs: %lld [after unit->giveCommand]\n",
                                                 extractFileFromDirectoryPath
                                                 (__FILE__).c_str (),
                                                 __FUNCTION__, __LINE__,
-                                                chrono.getMillis ());
+                                                chrono.getMicros ());
 
                     if (SystemFlags::
                         getSystemSettingType (SystemFlags::debugSystem).
@@ -1640,11 +1640,11 @@ namespace
                         getSystemSettingType (SystemFlags::debugPerformance).
                         enabled && chrono.getMillis () > 0)
                       SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                                "In [%s::%s Line: %d] took msecs: %lld [after unit->cancelCommand]\n",
+                                                "In [%s::%s Line: %d] took usecs: %lld [after unit->cancelCommand]\n",
                                                 extractFileFromDirectoryPath
                                                 (__FILE__).c_str (),
                                                 __FUNCTION__, __LINE__,
-                                                chrono.getMillis ());
+                                                chrono.getMicros ());
 
                     if (SystemFlags::
                         getSystemSettingType (SystemFlags::debugSystem).
@@ -1673,11 +1673,11 @@ namespace
                         getSystemSettingType (SystemFlags::debugPerformance).
                         enabled && chrono.getMillis () > 0)
                       SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                                "In [%s::%s Line: %d] took msecs: %lld [after unit->setMeetingPos]\n",
+                                                "In [%s::%s Line: %d] took usecs: %lld [after unit->setMeetingPos]\n",
                                                 extractFileFromDirectoryPath
                                                 (__FILE__).c_str (),
                                                 __FUNCTION__, __LINE__,
-                                                chrono.getMillis ());
+                                                chrono.getMicros ());
 
                     if (SystemFlags::
                         getSystemSettingType (SystemFlags::debugSystem).
@@ -1713,10 +1713,10 @@ namespace
       if (SystemFlags::getSystemSettingType (SystemFlags::debugPerformance).
           enabled && chrono.getMillis () > 0)
         SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                  "In [%s::%s Line: %d] took msecs: %lld [END]\n",
+                                  "In [%s::%s Line: %d] took usecs: %lld [END]\n",
                                   extractFileFromDirectoryPath (__FILE__).
                                   c_str (), __FUNCTION__, __LINE__,
-                                  chrono.getMillis ());
+                                  chrono.getMicros ());
     }
 
 // Reconstruct a network command received.
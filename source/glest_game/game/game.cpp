@@ -35,10 +35,12 @@
 #include "network_manager.h"
 #include "checksum.h"
 #include "auto_test.h"
+#include "fast_forward.h"
 #include "menu_state_keysetup.h"
 #include "video_player.h"
 #include "compression_utils.h"
 #include "cache_manager.h"
+#include "interpolation.h"
 #include "conversion.h"
 #include "steam.h"
 
@@ -71,6 +73,30 @@ namespace Glest
     const int CANCEL_DISCONNECT_PLAYER = -1;
 
     const float Game::highlightTime = 0.5f;
+    int Game::replayStartFrame = 0;
+
+    // settings read every frame
+    static ConfigValue < bool > configShowPerfStats ("ShowPerfStats", "false");
+    static ConfigValue < bool >
+      configEnableNewThreadManager ("EnableNewThreadManager", "false");
+    static ConfigValue < bool >
+      configPerformanceWarningEnabled ("PerformanceWarningEnabled", "false");
+    static ConfigValue < int >
+      configPerformanceWarningMillis ("PerformanceWarningMillis", "7");
+    static ConfigValue < int >
+      configPerformanceWarningRenderMillis ("PerformanceWarningRenderMillis",
+                                            "40");
+    static ConfigValue < bool >
+      configMouseMoveScrollsWorld ("MouseMoveScrollsWorld", "true");
+    static ConfigValue < bool >
+      configSaveCommandsForReplay ("SaveCommandsForReplay", "false");
+    static ConfigValue < int >
+      configReplayKeyframeSeconds ("ReplayKeyframeSeconds", "120");
+    static ConfigValue < bool >
+      configCompressSavedGames ("CompressSavedGames", "true");
+    static ConfigValue < int >
+      configAutoSaveSeconds ("AutoSaveSeconds", "0");
+    static ConfigValue < bool > configAutoTest ("AutoTest");
 
     int fadeMusicMilliseconds = 3500;
 
@@ -90,6 +116,9 @@ namespace Glest
       originalDisplayMsgCallback = NULL;
       aiInterfaces.clear ();
       videoPlayer = NULL;
+      autoSaveThread = NULL;
+      autoSaveMutex = new Mutex (CODE_AT_LINE);
+      pendingAutoSave = NULL;
       playingStaticVideo = false;
 
       mouse2d = 0;
@@ -363,6 +392,9 @@ namespace Glest
 
       this->masterserverMode = masterserverMode;
       videoPlayer = NULL;
+      autoSaveThread = NULL;
+      autoSaveMutex = new Mutex (CODE_AT_LINE);
+      pendingAutoSave = NULL;
       playingStaticVideo = false;
       highlightCellTexture = NULL;
       playerIndexDisconnect = 0;
@@ -550,6 +582,16 @@ namespace Glest
                                   (__FILE__).c_str (), __FUNCTION__,
                                   __LINE__);
 
+      // a game that ended early still writes the frames it got to
+      FrameProfiler::getInstance ().stopRecording ();
+
+      shutdownAutoSaveThread ();
+      writePendingAutoSave ();
+      delete autoSaveMutex;
+      autoSaveMutex = NULL;
+
+      replay.removeSpool ();
+
       quitGame ();
 
       Object::setStateCallback (NULL);
@@ -2495,6 +2537,29 @@ namespace Glest
       printf ("Game unique identifier is: %s\n",
               this->gameSettings.getGameUUID ().c_str ());
 
+      // ProfileFrames=start-end writes a trace of those world frames
+      int profileStartFrame = -1;
+      int profileEndFrame = -1;
+      string profileFrames =
+        Config::getInstance ().getString ("ProfileFrames", "");
+      if (sscanf (profileFrames.c_str (), "%d-%d", &profileStartFrame,
+                  &profileEndFrame) == 2
+          && profileStartFrame <= profileEndFrame)
+      {
+        FrameProfiler & frameProfiler = FrameProfiler::getInstance ();
+        frameProfiler.setEventsPerThread (Config::getInstance ().getInt
+                                          ("ProfileEventsPerThread",
+                                           "65536"));
+        frameProfiler.setFrameRange (profileStartFrame, profileEndFrame,
+                                     getSaveGameFilePath ("profile_" +
+                                                          intToStr
+                                                          (profileStartFrame)
+                                                          + "-" +
+                                                          intToStr
+                                                          (profileEndFrame),
+                                                          ""));
+      }
+
       gameStarted = true;
 
       if (this->masterserverMode == true)
@@ -2810,9 +2875,7 @@ namespace Glest
           currentUIState->update ();
         }
 
-        bool
-          showPerfStats =
-          Config::getInstance ().getBool ("ShowPerfStats", "false");
+        bool showPerfStats = configShowPerfStats.get ();
         Chrono chronoPerf;
         char perfBuf[8096] = "";
         std::vector < string > perfList;
@@ -3097,16 +3160,16 @@ namespace Glest
         }
 
         addPerformanceCount ("CalculateNetworkUpdateLoops",
-                             chronoGamePerformanceCounts.getMillis ());
+                             chronoGamePerformanceCounts.getMicros ());
 
         if (SystemFlags::
             getSystemSettingType (SystemFlags::debugPerformance).enabled
             && chrono.getMillis () > 0)
           SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                    "In [%s::%s] Line: %d took msecs: %lld\n",
+                                    "In [%s::%s] Line: %d took usecs: %lld\n",
                                     extractFileFromDirectoryPath
                                     (__FILE__).c_str (), __FUNCTION__,
-                                    __LINE__, chrono.getMillis ());
+                                    __LINE__, chrono.getMicros ());
         if (showPerfStats)
         {
           sprintf (perfBuf,
@@ -3120,10 +3183,10 @@ namespace Glest
             getSystemSettingType (SystemFlags::debugPerformance).enabled
             && chrono.getMillis () > 0)
           SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                    "In [%s::%s] Line: %d took msecs: %lld [before ReplaceDisconnectedNetworkPlayersWithAI]\n",
+                                    "In [%s::%s] Line: %d took usecs: %lld [before ReplaceDisconnectedNetworkPlayersWithAI]\n",
                                     extractFileFromDirectoryPath
                                     (__FILE__).c_str (), __FUNCTION__,
-                                    __LINE__, chrono.getMillis ());
+                                    __LINE__, chrono.getMicros ());
         if (showPerfStats)
         {
           sprintf (perfBuf,
@@ -3142,7 +3205,7 @@ namespace Glest
         ReplaceDisconnectedNetworkPlayersWithAI (isNetworkGame, role);
 
         addPerformanceCount ("ReplaceDisconnectedNetworkPlayersWithAI",
-                             chronoGamePerformanceCounts.getMillis ());
+                             chronoGamePerformanceCounts.getMicros ());
 
         setupPopupMenus (true);
 
@@ -3150,10 +3213,10 @@ namespace Glest
             getSystemSettingType (SystemFlags::debugPerformance).enabled
             && chrono.getMillis () > 0)
           SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                    "In [%s::%s] Line: %d took msecs: %lld [after ReplaceDisconnectedNetworkPlayersWithAI]\n",
+                                    "In [%s::%s] Line: %d took usecs: %lld [after ReplaceDisconnectedNetworkPlayersWithAI]\n",
                                     extractFileFromDirectoryPath
                                     (__FILE__).c_str (), __FUNCTION__,
-                                    __LINE__, chrono.getMillis ());
+                                    __LINE__, chrono.getMicros ());
         if (showPerfStats)
         {
           sprintf (perfBuf,
@@ -3207,13 +3270,11 @@ namespace Glest
                 processNetworkSynchChecksIfRequired ();
 
                 addPerformanceCount ("CalculateNetworkCRCSynchChecks",
-                                     chronoGamePerformanceCounts.getMillis
+                                     chronoGamePerformanceCounts.getMicros
                                      ());
 
-                const bool
-                  newThreadManager =
-                  Config::getInstance ().getBool ("EnableNewThreadManager",
-                                                  "false");
+                const bool newThreadManager =
+                  configEnableNewThreadManager.get ();
                 if (newThreadManager == true)
                 {
                   int currentFrameCount = world.getFrameCount ();
@@ -3245,12 +3306,12 @@ namespace Glest
                           && chrono.getMillis () > 0)
                         SystemFlags::
                           OutputDebug (SystemFlags::debugPerformance,
-                                       "In [%s::%s Line: %d] [i = %d] faction = %d, factionCount = %d, took msecs: %lld [before AI updates]\n",
+                                       "In [%s::%s Line: %d] [i = %d] faction = %d, factionCount = %d, took usecs: %lld [before AI updates]\n",
                                        extractFileFromDirectoryPath
                                        (__FILE__).c_str (), __FUNCTION__,
                                        __LINE__, i, j,
                                        world.getFactionCount (),
-                                       chrono.getMillis ());
+                                       chrono.getMicros ());
                       aiInterfaces[j]->signalWorkerThread (world.getFrameCount
                                                            ());
                       hasAIPlayer = true;
@@ -3315,7 +3376,7 @@ namespace Glest
                   }
 
                   addPerformanceCount ("ProcessAIWorkerThreads",
-                                       chronoGamePerformanceCounts.getMillis
+                                       chronoGamePerformanceCounts.getMicros
                                        ());
                 }
 
@@ -3397,10 +3458,10 @@ namespace Glest
                   (SystemFlags::debugPerformance).enabled
                   && chrono.getMillis () > 0)
                 SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                          "In [%s::%s] Line: %d took msecs: %lld [AI updates]\n",
+                                          "In [%s::%s] Line: %d took usecs: %lld [AI updates]\n",
                                           extractFileFromDirectoryPath
                                           (__FILE__).c_str (), __FUNCTION__,
-                                          __LINE__, chrono.getMillis ());
+                                          __LINE__, chrono.getMicros ());
               if (SystemFlags::getSystemSettingType
                   (SystemFlags::debugPerformance).enabled
                   && chrono.getMillis () > 0)
@@ -3413,16 +3474,16 @@ namespace Glest
                 world.update ();
 
               addPerformanceCount ("ProcessWorldUpdate",
-                                   chronoGamePerformanceCounts.getMillis ());
+                                   chronoGamePerformanceCounts.getMicros ());
 
               if (SystemFlags::getSystemSettingType
                   (SystemFlags::debugPerformance).enabled
                   && chrono.getMillis () > 0)
                 SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                          "In [%s::%s] Line: %d took msecs: %lld [world update i = %d]\n",
+                                          "In [%s::%s] Line: %d took usecs: %lld [world update i = %d]\n",
                                           extractFileFromDirectoryPath
                                           (__FILE__).c_str (), __FUNCTION__,
-                                          __LINE__, chrono.getMillis (), i);
+                                          __LINE__, chrono.getMicros (), i);
               if (SystemFlags::getSystemSettingType
                   (SystemFlags::debugPerformance).enabled
                   && chrono.getMillis () > 0)
@@ -3479,11 +3540,43 @@ namespace Glest
 
               if (pendingQuitError == false)
               {
+                PROFILE_ZONE ("Commander::signalNetworkUpdate");
                 commander.signalNetworkUpdate (this);
               }
 
               addPerformanceCount ("ProcessNetworkUpdate",
-                                   chronoGamePerformanceCounts.getMillis ());
+                                   chronoGamePerformanceCounts.getMicros ());
+
+              // Replay keyframes, the state after this frame's commands
+              const int keyframeSeconds = configReplayKeyframeSeconds.get ();
+              if (configSaveCommandsForReplay.get () == true
+                  && keyframeSeconds > 0
+                  && world.getFrameCount () %
+                  (keyframeSeconds * GameConstants::updateFps) == 0)
+              {
+                chronoGamePerformanceCounts.start ();
+
+                addReplayKeyframe ();
+
+                addPerformanceCount ("ProcessReplayKeyframe",
+                                     chronoGamePerformanceCounts.getMicros
+                                     ());
+              }
+
+              const int autoSaveSeconds = configAutoSaveSeconds.get ();
+              if (autoSaveSeconds > 0
+                  && world.getFrameCount () > 0
+                  && world.getFrameCount () %
+                  (autoSaveSeconds * GameConstants::updateFps) == 0)
+              {
+                chronoGamePerformanceCounts.start ();
+
+                autoSaveGame ();
+
+                addPerformanceCount ("ProcessAutoSave",
+                                     chronoGamePerformanceCounts.getMicros
+                                     ());
+              }
 
               if (showPerfStats)
               {
@@ -3499,10 +3592,10 @@ namespace Glest
                   (SystemFlags::debugPerformance).enabled
                   && chrono.getMillis () > 0)
                 SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                          "In [%s::%s] Line: %d took msecs: %lld [commander updateNetwork i = %d]\n",
+                                          "In [%s::%s] Line: %d took usecs: %lld [commander updateNetwork i = %d]\n",
                                           extractFileFromDirectoryPath
                                           (__FILE__).c_str (), __FUNCTION__,
-                                          __LINE__, chrono.getMillis (), i);
+                                          __LINE__, chrono.getMicros (), i);
               if (SystemFlags::getSystemSettingType
                   (SystemFlags::debugPerformance).enabled
                   && chrono.getMillis () > 0)
@@ -3514,16 +3607,16 @@ namespace Glest
               gui.update ();
 
               addPerformanceCount ("ProcessGUIUpdate",
-                                   chronoGamePerformanceCounts.getMillis ());
+                                   chronoGamePerformanceCounts.getMicros ());
 
               if (SystemFlags::getSystemSettingType
                   (SystemFlags::debugPerformance).enabled
                   && chrono.getMillis () > 0)
                 SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                          "In [%s::%s] Line: %d took msecs: %lld [gui updating i = %d]\n",
+                                          "In [%s::%s] Line: %d took usecs: %lld [gui updating i = %d]\n",
                                           extractFileFromDirectoryPath
                                           (__FILE__).c_str (), __FUNCTION__,
-                                          __LINE__, chrono.getMillis (), i);
+                                          __LINE__, chrono.getMicros (), i);
               if (SystemFlags::getSystemSettingType
                   (SystemFlags::debugPerformance).enabled
                   && chrono.getMillis () > 0)
@@ -3549,10 +3642,10 @@ namespace Glest
                   (SystemFlags::debugPerformance).enabled
                   && chrono.getMillis () > 0)
                 SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                          "In [%s::%s] Line: %d took msecs: %lld [weather particle updating i = %d]\n",
+                                          "In [%s::%s] Line: %d took usecs: %lld [weather particle updating i = %d]\n",
                                           extractFileFromDirectoryPath
                                           (__FILE__).c_str (), __FUNCTION__,
-                                          __LINE__, chrono.getMillis (), i);
+                                          __LINE__, chrono.getMicros (), i);
               if (SystemFlags::getSystemSettingType
                   (SystemFlags::debugPerformance).enabled
                   && chrono.getMillis () > 0)
@@ -3575,16 +3668,16 @@ namespace Glest
               renderer.updateParticleManager (rsGame, avgRenderFps);
 
               addPerformanceCount ("ProcessParticleManager",
-                                   chronoGamePerformanceCounts.getMillis ());
+                                   chronoGamePerformanceCounts.getMicros ());
 
               if (SystemFlags::getSystemSettingType
                   (SystemFlags::debugPerformance).enabled
                   && chrono.getMillis () > 0)
                 SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                          "In [%s::%s] Line: %d took msecs: %lld [particle manager updating i = %d]\n",
+                                          "In [%s::%s] Line: %d took usecs: %lld [particle manager updating i = %d]\n",
                                           extractFileFromDirectoryPath
                                           (__FILE__).c_str (), __FUNCTION__,
-                                          __LINE__, chrono.getMillis (), i);
+                                          __LINE__, chrono.getMicros (), i);
               if (SystemFlags::getSystemSettingType
                   (SystemFlags::debugPerformance).enabled
                   && chrono.getMillis () > 0)
@@ -3610,6 +3703,7 @@ namespace Glest
         {
           if (pendingQuitError == false)
           {
+            PROFILE_ZONE ("Commander::signalNetworkUpdate");
             commander.signalNetworkUpdate (this);
           }
 
@@ -3640,10 +3734,10 @@ namespace Glest
             getSystemSettingType (SystemFlags::debugPerformance).enabled
             && chrono.getMillis () > 0)
           SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                    "In [%s::%s] Line: %d took msecs: %lld [chatManager.updateNetwork]\n",
+                                    "In [%s::%s] Line: %d took usecs: %lld [chatManager.updateNetwork]\n",
                                     extractFileFromDirectoryPath
                                     (__FILE__).c_str (), __FUNCTION__,
-                                    __LINE__, chrono.getMillis ());
+                                    __LINE__, chrono.getMicros ());
         if (SystemFlags::
             getSystemSettingType (SystemFlags::debugPerformance).enabled
             && chrono.getMillis () > 0)
@@ -3698,7 +3792,7 @@ namespace Glest
         }
 
         addPerformanceCount ("ProcessMiscNetwork",
-                             chronoGamePerformanceCounts.getMillis ());
+                             chronoGamePerformanceCounts.getMicros ());
 
         // START - Handle joining in progress games
         if (role == nrServer)
@@ -4109,12 +4203,19 @@ namespace Glest
         // END - Handle joining in progress games
 
         //update auto test
-        if (Config::getInstance ().getBool ("AutoTest"))
+        if (configAutoTest.get ())
         {
           AutoTest::getInstance ().updateGame (this);
           return;
         }
 
+        //update fast forward
+        if (FastForward::isEnabled () == true
+            && FastForward::getInstance ().updateGame (this) == true)
+        {
+          return;
+        }
+
         if (showPerfStats)
         {
           sprintf (perfBuf,
@@ -4366,6 +4467,10 @@ namespace Glest
     void Game::addPerformanceCount (string key, int64 value)
     {
       gamePerformanceCounts[key] = value + gamePerformanceCounts[key] / 2;
+      if (FastForward::isEnabled () == true)
+      {
+        FastForward::getInstance ().addPerformanceCount (key, value);
+      }
     }
 
     string Game::getGamePerformanceCounts (bool displayWarnings) const
@@ -4376,16 +4481,12 @@ namespace Glest
       }
 
       bool displayWarningHeader = true;
-      bool
-        WARN_TO_CONSOLE =
-        Config::getInstance ().getBool ("PerformanceWarningEnabled", "false");
-      int
-        WARNING_MILLIS =
-        Config::getInstance ().getInt ("PerformanceWarningMillis", "7");
-      int
-        WARNING_RENDER_MILLIS =
-        Config::getInstance ().getInt ("PerformanceWarningRenderMillis",
-                                       "40");
+      bool WARN_TO_CONSOLE = configPerformanceWarningEnabled.get ();
+      // the counts are in microseconds, the warning settings in millis
+      int64 WARNING_MICROS =
+        (int64) configPerformanceWarningMillis.get () * 1000;
+      int64 WARNING_RENDER_MICROS =
+        (int64) configPerformanceWarningRenderMillis.get () * 1000;
 
       string result = "";
       for (std::map < string, int64 >::const_iterator iterMap =
@@ -4394,7 +4495,7 @@ namespace Glest
       {
         if (iterMap->first == ProgramState::MAIN_PROGRAM_RENDER_KEY)
         {
-          if (iterMap->second < WARNING_RENDER_MILLIS)
+          if (iterMap->second < WARNING_RENDER_MICROS)
           {
             continue;
           }
@@ -4402,7 +4503,7 @@ namespace Glest
           //      printf("iterMap->second: " MG_I64_SPECIFIER " WARNING_RENDER_MILLIS = %d\n",iterMap->second,WARNING_RENDER_MILLIS);
           //}
         }
-        else if (iterMap->second < WARNING_MILLIS)
+        else if (iterMap->second < WARNING_MICROS)
         {
           continue;
         }
@@ -4413,7 +4514,7 @@ namespace Glest
         }
         string
           perfStat =
-          iterMap->first + " = avg millis: " + intToStr (iterMap->second);
+          iterMap->first + " = avg micros: " + intToStr (iterMap->second);
 
         if (displayWarnings == true && WARN_TO_CONSOLE == true)
         {
@@ -4939,8 +5040,7 @@ namespace Glest
         }
 
         if (newAIPlayerCreated == true
-            && Config::getInstance ().getBool ("EnableNewThreadManager",
-                                               "false") == true)
+            && configEnableNewThreadManager.get () == true)
         {
           bool
             enableServerControlledAI =
@@ -5095,10 +5195,10 @@ namespace Glest
           getSystemSettingType (SystemFlags::debugPerformance).enabled
           && chrono.getMillis () > 0)
         SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                  "In [%s::%s Line: %d] renderFps = %d took msecs: %d [render3d]\n",
+                                  "In [%s::%s Line: %d] renderFps = %d took usecs: %d [render3d]\n",
                                   extractFileFromDirectoryPath
                                   (__FILE__).c_str (), __FUNCTION__, __LINE__,
-                                  renderFps, chrono.getMillis ());
+                                  renderFps, chrono.getMicros ());
       if (SystemFlags::
           getSystemSettingType (SystemFlags::debugPerformance).enabled
           && chrono.getMillis () > 0)
@@ -5110,10 +5210,10 @@ namespace Glest
           getSystemSettingType (SystemFlags::debugPerformance).enabled
           && chrono.getMillis () > 0)
         SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                  "In [%s::%s Line: %d] renderFps = %d took msecs: %d [render2d]\n",
+                                  "In [%s::%s Line: %d] renderFps = %d took usecs: %d [render2d]\n",
                                   extractFileFromDirectoryPath
                                   (__FILE__).c_str (), __FUNCTION__, __LINE__,
-                                  renderFps, chrono.getMillis ());
+                                  renderFps, chrono.getMicros ());
       if (SystemFlags::
           getSystemSettingType (SystemFlags::debugPerformance).enabled
           && chrono.getMillis () > 0)
@@ -5124,10 +5224,10 @@ namespace Glest
           getSystemSettingType (SystemFlags::debugPerformance).enabled
           && chrono.getMillis () > 0)
         SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                  "In [%s::%s Line: %d] renderFps = %d took msecs: %d [swap buffers]\n",
+                                  "In [%s::%s Line: %d] renderFps = %d took usecs: %d [swap buffers]\n",
                                   extractFileFromDirectoryPath
                                   (__FILE__).c_str (), __FUNCTION__, __LINE__,
-                                  renderFps, chrono.getMillis ());
+                                  renderFps, chrono.getMicros ());
     }
 
 // ==================== tick ====================
@@ -6691,10 +6791,7 @@ namespace Glest
             }
             else
             {
-              bool
-                mouseMoveScrollsWorld =
-                Config::getInstance ().getBool ("MouseMoveScrollsWorld",
-                                                "true");
+              bool mouseMoveScrollsWorld = configMouseMoveScrollsWorld.get ();
               if (mouseMoveScrollsWorld == true)
               {
                 if (y < 10)
@@ -7658,7 +7755,7 @@ namespace Glest
       }
       //printf("Check savegame\n");
       //printf("Saving...\n");
-      if (Config::getInstance ().getBool ("AutoTest"))
+      if (configAutoTest.get ())
       {
         this->saveGame (GameConstants::saveGameFileAutoTestDefault);
       }
@@ -7979,7 +8076,7 @@ namespace Glest
       }
 
       if ((game != NULL && game->isMasterserverMode () == true) ||
-          Config::getInstance ().getBool ("AutoTest") == true)
+          configAutoTest.get () == true)
       {
         printf ("Game ending with stats:\n");
         printf ("-----------------------\n");
@@ -8035,6 +8132,7 @@ namespace Glest
 
     void Game::render3d ()
     {
+      PROFILE_ZONE ("Game::render3d");
       Chrono chrono;
       if (SystemFlags::
           getSystemSettingType (SystemFlags::debugPerformance).enabled)
@@ -8048,17 +8146,17 @@ namespace Glest
           getSystemSettingType (SystemFlags::debugPerformance).enabled
           && chrono.getMillis () > 0)
         SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                  "In [%s::%s Line: %d] renderFps = %d took msecs: %lld [reset3d]\n",
+                                  "In [%s::%s Line: %d] renderFps = %d took usecs: %lld [reset3d]\n",
                                   extractFileFromDirectoryPath
                                   (__FILE__).c_str (), __FUNCTION__, __LINE__,
-                                  renderFps, chrono.getMillis ());
+                                  renderFps, chrono.getMicros ());
       if (SystemFlags::
           getSystemSettingType (SystemFlags::debugPerformance).enabled
           && chrono.getMillis () > 0)
         chrono.start ();
 
 //      renderer.computeVisibleQuad();
-//      if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] renderFps = %d took msecs: %lld [computeVisibleQuad]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,renderFps,chrono.getMillis());
+//      if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] renderFps = %d took usecs: %lld [computeVisibleQuad]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,renderFps,chrono.getMicros());
 //      if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) chrono.start();
 
       renderer.loadGameCameraMatrix ();
@@ -8066,10 +8164,10 @@ namespace Glest
           getSystemSettingType (SystemFlags::debugPerformance).enabled
           && chrono.getMillis () > 0)
         SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                  "In [%s::%s Line: %d] renderFps = %d took msecs: %lld [loadGameCameraMatrix]\n",
+                                  "In [%s::%s Line: %d] renderFps = %d took usecs: %lld [loadGameCameraMatrix]\n",
                                   extractFileFromDirectoryPath
                                   (__FILE__).c_str (), __FUNCTION__, __LINE__,
-                                  renderFps, chrono.getMillis ());
+                                  renderFps, chrono.getMicros ());
       if (SystemFlags::
           getSystemSettingType (SystemFlags::debugPerformance).enabled
           && chrono.getMillis () > 0)
@@ -8080,10 +8178,10 @@ namespace Glest
           getSystemSettingType (SystemFlags::debugPerformance).enabled
           && chrono.getMillis () > 0)
         SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                  "In [%s::%s Line: %d] renderFps = %d took msecs: %lld [computeVisibleQuad]\n",
+                                  "In [%s::%s Line: %d] renderFps = %d took usecs: %lld [computeVisibleQuad]\n",
                                   extractFileFromDirectoryPath
                                   (__FILE__).c_str (), __FUNCTION__, __LINE__,
-                                  renderFps, chrono.getMillis ());
+                                  renderFps, chrono.getMicros ());
       if (SystemFlags::
           getSystemSettingType (SystemFlags::debugPerformance).enabled
           && chrono.getMillis () > 0)
@@ -8094,10 +8192,10 @@ namespace Glest
           getSystemSettingType (SystemFlags::debugPerformance).enabled
           && chrono.getMillis () > 0)
         SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                  "In [%s::%s Line: %d] renderFps = %d took msecs: %lld [setupLighting]\n",
+                                  "In [%s::%s Line: %d] renderFps = %d took usecs: %lld [setupLighting]\n",
                                   extractFileFromDirectoryPath
                                   (__FILE__).c_str (), __FUNCTION__, __LINE__,
-                                  renderFps, chrono.getMillis ());
+                                  renderFps, chrono.getMicros ());
       if (SystemFlags::
           getSystemSettingType (SystemFlags::debugPerformance).enabled
           && chrono.getMillis () > 0)
@@ -8109,10 +8207,10 @@ namespace Glest
           getSystemSettingType (SystemFlags::debugPerformance).enabled
           && chrono.getMillis () > 0)
         SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                  "In [%s::%s Line: %d] renderFps = %d took msecs: %lld [renderShadowsToTexture]\n",
+                                  "In [%s::%s Line: %d] renderFps = %d took usecs: %lld [renderShadowsToTexture]\n",
                                   extractFileFromDirectoryPath
                                   (__FILE__).c_str (), __FUNCTION__, __LINE__,
-                                  renderFps, chrono.getMillis ());
+                                  renderFps, chrono.getMicros ());
       if (SystemFlags::
           getSystemSettingType (SystemFlags::debugPerformance).enabled
           && chrono.getMillis () > 0)
@@ -8124,10 +8222,10 @@ namespace Glest
           getSystemSettingType (SystemFlags::debugPerformance).enabled
           && chrono.getMillis () > 0)
         SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                  "In [%s::%s] Line: %d renderFps = %d took msecs: %lld\n",
+                                  "In [%s::%s] Line: %d renderFps = %d took usecs: %lld\n",
                                   extractFileFromDirectoryPath
                                   (__FILE__).c_str (), __FUNCTION__, __LINE__,
-                                  renderFps, chrono.getMillis ());
+                                  renderFps, chrono.getMicros ());
       if (SystemFlags::
           getSystemSettingType (SystemFlags::debugPerformance).enabled
           && chrono.getMillis () > 0)
@@ -8139,10 +8237,10 @@ namespace Glest
           getSystemSettingType (SystemFlags::debugPerformance).enabled
           && chrono.getMillis () > 0)
         SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                  "In [%s::%s Line: %d] renderFps = %d took msecs: %lld [renderSurface]\n",
+                                  "In [%s::%s Line: %d] renderFps = %d took usecs: %lld [renderSurface]\n",
                                   extractFileFromDirectoryPath
                                   (__FILE__).c_str (), __FUNCTION__, __LINE__,
-                                  renderFps, chrono.getMillis ());
+                                  renderFps, chrono.getMicros ());
       if (SystemFlags::
           getSystemSettingType (SystemFlags::debugPerformance).enabled
           && chrono.getMillis () > 0)
@@ -8154,10 +8252,10 @@ namespace Glest
           getSystemSettingType (SystemFlags::debugPerformance).enabled
           && chrono.getMillis () > 0)
         SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                  "In [%s::%s Line: %d] renderFps = %d took msecs: %lld [renderSelectionEffects]\n",
+                                  "In [%s::%s Line: %d] renderFps = %d took usecs: %lld [renderSelectionEffects]\n",
                                   extractFileFromDirectoryPath
                                   (__FILE__).c_str (), __FUNCTION__, __LINE__,
-                                  renderFps, chrono.getMillis ());
+                                  renderFps, chrono.getMicros ());
       if (SystemFlags::
           getSystemSettingType (SystemFlags::debugPerformance).enabled
           && chrono.getMillis () > 0)
@@ -8170,10 +8268,10 @@ namespace Glest
         if (SystemFlags::getSystemSettingType (SystemFlags::debugPerformance).
             enabled && chrono.getMillis () > 0)
           SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                    "In [%s::%s Line: %d] renderFps = %d took msecs: %lld [renderObjects]\n",
+                                    "In [%s::%s Line: %d] renderFps = %d took usecs: %lld [renderObjects]\n",
                                     extractFileFromDirectoryPath
                                     (__FILE__).c_str (), __FUNCTION__,
-                                    __LINE__, renderFps, chrono.getMillis ());
+                                    __LINE__, renderFps, chrono.getMicros ());
         if (SystemFlags::getSystemSettingType (SystemFlags::debugPerformance).
             enabled && chrono.getMillis () > 0)
           chrono.start ();
@@ -8187,10 +8285,10 @@ namespace Glest
           getSystemSettingType (SystemFlags::debugPerformance).enabled
           && chrono.getMillis () > 0)
         SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                  "In [%s::%s Line: %d] renderFps = %d took msecs: %lld [renderObjects]\n",
+                                  "In [%s::%s Line: %d] renderFps = %d took usecs: %lld [renderObjects]\n",
                                   extractFileFromDirectoryPath
                                   (__FILE__).c_str (), __FUNCTION__, __LINE__,
-                                  renderFps, chrono.getMillis ());
+                                  renderFps, chrono.getMicros ());
       if (SystemFlags::
           getSystemSettingType (SystemFlags::debugPerformance).enabled
           && chrono.getMillis () > 0)
@@ -8202,10 +8300,10 @@ namespace Glest
           getSystemSettingType (SystemFlags::debugPerformance).enabled
           && chrono.getMillis () > 0)
         SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                  "In [%s::%s Line: %d] renderFps = %d took msecs: %lld [renderObjects]\n",
+                                  "In [%s::%s Line: %d] renderFps = %d took usecs: %lld [renderObjects]\n",
                                   extractFileFromDirectoryPath
                                   (__FILE__).c_str (), __FUNCTION__, __LINE__,
-                                  renderFps, chrono.getMillis ());
+                                  renderFps, chrono.getMicros ());
       if (SystemFlags::
           getSystemSettingType (SystemFlags::debugPerformance).enabled
           && chrono.getMillis () > 0)
@@ -8217,10 +8315,10 @@ namespace Glest
           getSystemSettingType (SystemFlags::debugPerformance).enabled
           && chrono.getMillis () > 0)
         SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                  "In [%s::%s Line: %d] renderFps = %d took msecs: %lld [renderUnits]\n",
+                                  "In [%s::%s Line: %d] renderFps = %d took usecs: %lld [renderUnits]\n",
                                   extractFileFromDirectoryPath
                                   (__FILE__).c_str (), __FUNCTION__, __LINE__,
-                                  renderFps, chrono.getMillis ());
+                                  renderFps, chrono.getMicros ());
       if (SystemFlags::
           getSystemSettingType (SystemFlags::debugPerformance).enabled
           && chrono.getMillis () > 0)
@@ -8233,10 +8331,10 @@ namespace Glest
           getSystemSettingType (SystemFlags::debugPerformance).enabled
           && chrono.getMillis () > 0)
         SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                  "In [%s::%s Line: %d] renderFps = %d took msecs: %lld [renderWater]\n",
+                                  "In [%s::%s Line: %d] renderFps = %d took usecs: %lld [renderWater]\n",
                                   extractFileFromDirectoryPath
                                   (__FILE__).c_str (), __FUNCTION__, __LINE__,
-                                  renderFps, chrono.getMillis ());
+                                  renderFps, chrono.getMicros ());
       if (SystemFlags::
           getSystemSettingType (SystemFlags::debugPerformance).enabled
           && chrono.getMillis () > 0)
@@ -8248,10 +8346,10 @@ namespace Glest
           getSystemSettingType (SystemFlags::debugPerformance).enabled
           && chrono.getMillis () > 0)
         SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                  "In [%s::%s Line: %d] renderFps = %d took msecs: %lld [renderUnits]\n",
+                                  "In [%s::%s Line: %d] renderFps = %d took usecs: %lld [renderUnits]\n",
                                   extractFileFromDirectoryPath
                                   (__FILE__).c_str (), __FUNCTION__, __LINE__,
-                                  renderFps, chrono.getMillis ());
+                                  renderFps, chrono.getMicros ());
       if (SystemFlags::
           getSystemSettingType (SystemFlags::debugPerformance).enabled
           && chrono.getMillis () > 0)
@@ -8263,10 +8361,10 @@ namespace Glest
           getSystemSettingType (SystemFlags::debugPerformance).enabled
           && chrono.getMillis () > 0)
         SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                  "In [%s::%s Line: %d] renderFps = %d took msecs: %lld [renderParticleManager]\n",
+                                  "In [%s::%s Line: %d] renderFps = %d took usecs: %lld [renderParticleManager]\n",
                                   extractFileFromDirectoryPath
                                   (__FILE__).c_str (), __FUNCTION__, __LINE__,
-                                  renderFps, chrono.getMillis ());
+                                  renderFps, chrono.getMicros ());
       if (SystemFlags::
           getSystemSettingType (SystemFlags::debugPerformance).enabled
           && chrono.getMillis () > 0)
@@ -8285,10 +8383,10 @@ namespace Glest
         if (SystemFlags::getSystemSettingType (SystemFlags::debugPerformance).
             enabled && chrono.getMillis () > 0)
           SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                    "In [%s::%s Line: %d] renderFps = %d took msecs: %lld [renderObjects]\n",
+                                    "In [%s::%s Line: %d] renderFps = %d took usecs: %lld [renderObjects]\n",
                                     extractFileFromDirectoryPath
                                     (__FILE__).c_str (), __FUNCTION__,
-                                    __LINE__, renderFps, chrono.getMillis ());
+                                    __LINE__, renderFps, chrono.getMicros ());
         if (SystemFlags::getSystemSettingType (SystemFlags::debugPerformance).
             enabled && chrono.getMillis () > 0)
           chrono.start ();
@@ -8300,20 +8398,20 @@ namespace Glest
           getSystemSettingType (SystemFlags::debugPerformance).enabled
           && chrono.getMillis () > 0)
         SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                  "In [%s::%s Line: %d] renderFps = %d took msecs: %lld [renderMouse3d]\n",
+                                  "In [%s::%s Line: %d] renderFps = %d took usecs: %lld [renderMouse3d]\n",
                                   extractFileFromDirectoryPath
                                   (__FILE__).c_str (), __FUNCTION__, __LINE__,
-                                  renderFps, chrono.getMillis ());
+                                  renderFps, chrono.getMicros ());
 
       renderer.renderUnitsToBuild (avgRenderFps);
       if (SystemFlags::
           getSystemSettingType (SystemFlags::debugPerformance).enabled
           && chrono.getMillis () > 0)
         SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                  "In [%s::%s Line: %d] renderFps = %d took msecs: %lld [renderUnitsToBuild]\n",
+                                  "In [%s::%s Line: %d] renderFps = %d took usecs: %lld [renderUnitsToBuild]\n",
                                   extractFileFromDirectoryPath
                                   (__FILE__).c_str (), __FUNCTION__, __LINE__,
-                                  renderFps, chrono.getMillis ());
+                                  renderFps, chrono.getMicros ());
       if (SystemFlags::
           getSystemSettingType (SystemFlags::debugPerformance).enabled
           && chrono.getMillis () > 0)
@@ -8441,6 +8539,9 @@ namespace Glest
         str +=
           "Triangle count: " + intToStr (renderer.getTriangleCount ()) + "\n";
         str += "Vertex count: " + intToStr (renderer.getPointCount ()) + "\n";
+        str +=
+          "Interpolation cache: " +
+          InterpolationCache::getInstance ().getStatsString () + "\n";
       }
 
       str += "Frame count:" + intToStr (world.getFrameCount ()) + "\n";
@@ -8547,6 +8648,7 @@ namespace Glest
 
     void Game::render2d ()
     {
+      PROFILE_ZONE ("Game::render2d");
       Renderer & renderer = Renderer::getInstance ();
       //Config &config= Config::getInstance();
       CoreData & coreData = CoreData::getInstance ();
@@ -9679,11 +9781,181 @@ namespace Glest
       Game::addNetworkCommandToReplayList (NetworkCommand * networkCommand,
                                            int worldFrameCount)
     {
-      Config & config = Config::getInstance ();
-      if (config.getBool ("SaveCommandsForReplay", "false") == true)
+      if (configSaveCommandsForReplay.get () == true)
+      {
+        replay.addCommand (worldFrameCount, *networkCommand);
+      }
+    }
+
+    string Game::getSaveGameFilePath (const string & name,
+                                      const string & path) const
+    {
+      string saveGameFile = path + name;
+      if (getGameReadWritePath (GameConstants::path_logs_CacheLookupKey) !=
+          "")
+      {
+        saveGameFile =
+          getGameReadWritePath (GameConstants::path_logs_CacheLookupKey) +
+          saveGameFile;
+      }
+      else
+      {
+        string userData =
+          Config::getInstance ().getString ("UserData_Root", "");
+        if (userData != "")
+        {
+          endPathWithSlash (userData);
+        }
+        saveGameFile = userData + saveGameFile;
+      }
+      return saveGameFile;
+    }
+
+    void Game::autoSaveGame ()
+    {
+      // clients get the game state from the server, headless games have
+      // nobody to resume them
+      if (masterserverMode == true || FastForward::isEnabled () == true
+          || NetworkManager::getInstance ().getNetworkRole () == nrClient)
+      {
+        return;
+      }
+
+      // the tree is the snapshot of this frame, only writing it out is left
+      // to the thread
+      XmlTree *xmlTree = new XmlTree ();
+      buildSaveGameTree (*xmlTree);
+
+      MutexSafeWrapper safeMutex (autoSaveMutex, CODE_AT_LINE);
+      if (pendingAutoSave != NULL)
+      {
+        // the previous autosave was not written yet, this one replaces it
+        delete pendingAutoSave;
+      }
+      pendingAutoSave = xmlTree;
+      pendingAutoSaveFile =
+        getSaveGameFilePath (GameConstants::saveGameFileAutoSave, "saved/");
+      safeMutex.ReleaseLock ();
+
+      if (autoSaveThread == NULL)
+      {
+        static string mutexOwnerId =
+          string (extractFileFromDirectoryPath (__FILE__).c_str ()) +
+          string ("_") + intToStr (__LINE__);
+        autoSaveThread = new SimpleTaskThread (this, 0, 50, true);
+        autoSaveThread->setUniqueID (mutexOwnerId);
+        autoSaveThread->start ();
+      }
+      autoSaveThread->setTaskSignalled (true);
+    }
+
+    void Game::writePendingAutoSave ()
+    {
+      MutexSafeWrapper safeMutex (autoSaveMutex, CODE_AT_LINE);
+      XmlTree *xmlTree = pendingAutoSave;
+      string file = pendingAutoSaveFile;
+      pendingAutoSave = NULL;
+      safeMutex.ReleaseLock ();
+
+      if (xmlTree == NULL)
+      {
+        return;
+      }
+
+      // write next to the autosave and swap it in, a crash while writing
+      // keeps the previous autosave intact
+      string tempFile = file + ".tmp";
+      try
+      {
+        Chrono chrono (true);
+        xmlTree->save (tempFile, configCompressSavedGames.get ());
+#ifdef WIN32
+        // rename does not replace an existing file on windows
+        if (fileExists (file) == true)
+        {
+          removeFile (file);
+        }
+#endif
+        if (renameFile (tempFile, file) == false)
+        {
+          throw megaglest_runtime_error ("Could not rename [" + tempFile +
+                                         "] to [" + file + "]");
+        }
+        if (SystemFlags::VERBOSE_MODE_ENABLED)
+          printf ("Autosaved game to [%s] in " MG_I64_SPECIFIER
+                  " msecs\n", file.c_str (), chrono.getMillis ());
+      }
+      catch (const exception & ex)
+      {
+        SystemFlags::OutputDebug (SystemFlags::debugError,
+                                  "In [%s::%s Line: %d] Error [%s]\n",
+                                  extractFileFromDirectoryPath
+                                  (__FILE__).c_str (), __FUNCTION__,
+                                  __LINE__, ex.what ());
+        if (fileExists (tempFile) == true)
+        {
+          removeFile (tempFile);
+        }
+      }
+      delete xmlTree;
+    }
+
+    void Game::simpleTask (BaseThread * callingThread, void *userdata)
+    {
+      writePendingAutoSave ();
+    }
+
+    void Game::shutdownAutoSaveThread ()
+    {
+      if (autoSaveThread != NULL)
+      {
+        autoSaveThread->setSimpleTaskInterfaceValid (false);
+        autoSaveThread->signalQuit ();
+        autoSaveThread->setThreadOwnerValid (false);
+        if (autoSaveThread->canShutdown (true) == true &&
+            autoSaveThread->shutdownAndWait () == true)
+        {
+          delete autoSaveThread;
+        }
+        autoSaveThread = NULL;
+      }
+    }
+
+    void Game::addReplayKeyframe ()
+    {
+      int frame = world.getFrameCount ();
+      int keyframeCount = replay.getKeyframeCount ();
+      if (frame <= 0 || (keyframeCount > 0
+                         && replay.getKeyframe (keyframeCount - 1).frame >=
+                         frame))
+      {
+        return;
+      }
+
+      // the states are written out as they are taken, a game that is
+      // replaced by another one gets its own file
+      if (replay.getSpoolPath () == "")
+      {
+        static int spoolCount = 0;
+        char szBuf[8096] = "";
+        snprintf (szBuf, 8096, GameConstants::replayKeyframeFilePattern,
+                  spoolCount++);
+        replay.setSpoolPath (getSaveGameFilePath (szBuf, "saved/"));
+      }
+
+      XmlTree xmlTree;
+      buildSaveGameTree (xmlTree);
+      try
       {
-        replayCommandList.push_back (make_pair
-                                     (worldFrameCount, *networkCommand));
+        replay.addKeyframe (frame, xmlTree.getRootNode ());
+      }
+      catch (const exception & ex)
+      {
+        SystemFlags::OutputDebug (SystemFlags::debugError,
+                                  "In [%s::%s Line: %d] replay keyframe at frame %d was not written: %s\n",
+                                  extractFileFromDirectoryPath
+                                  (__FILE__).c_str (), __FUNCTION__,
+                                  __LINE__, frame, ex.what ());
       }
     }
 
@@ -9855,101 +10127,8 @@ namespace Glest
       config.save ();
     }
 
-    string Game::saveGame (string name, const string & path)
+    void Game::buildSaveGameTree (XmlTree & xmlTree)
     {
-      Config & config = Config::getInstance ();
-      // auto name file if using saved file pattern string
-      if (name == GameConstants::saveGameFilePattern)
-      {
-        //time_t curTime = time(NULL);
-        //struct tm *loctime = localtime (&curTime);
-        struct tm loctime = threadsafe_localtime (systemtime_now ());
-        char szBuf2[100] = "";
-        strftime (szBuf2, 100, "%Y%m%d_%H%M%S", &loctime);
-
-        char szBuf[8096] = "";
-        snprintf (szBuf, 8096, name.c_str (), szBuf2);
-        name = szBuf;
-      }
-      else if (name == GameConstants::saveGameFileAutoTestDefault)
-      {
-        //time_t curTime = time(NULL);
-        //struct tm *loctime = localtime (&curTime);
-        struct tm loctime = threadsafe_localtime (systemtime_now ());
-        char szBuf2[100] = "";
-        strftime (szBuf2, 100, "%Y%m%d_%H%M%S", &loctime);
-
-        char szBuf[8096] = "";
-        snprintf (szBuf, 8096, name.c_str (), szBuf2);
-        name = szBuf;
-      }
-
-      // Save the file now
-      string saveGameFile = path + name;
-      if (getGameReadWritePath (GameConstants::path_logs_CacheLookupKey) !=
-          "")
-      {
-        saveGameFile =
-          getGameReadWritePath (GameConstants::path_logs_CacheLookupKey) +
-          saveGameFile;
-      }
-      else
-      {
-        string userData = config.getString ("UserData_Root", "");
-        if (userData != "")
-        {
-          endPathWithSlash (userData);
-        }
-        saveGameFile = userData + saveGameFile;
-      }
-      if (SystemFlags::VERBOSE_MODE_ENABLED)
-        printf ("Saving game to [%s]\n", saveGameFile.c_str ());
-
-      // This condition will re-play all the commands from a replay file
-      // INSTEAD of saving from a saved game.
-      if (config.getBool ("SaveCommandsForReplay", "false") == true)
-      {
-        std::map < string, string > mapTagReplacements;
-        XmlTree xmlTreeSaveGame (XML_RAPIDXML_ENGINE);
-
-        xmlTreeSaveGame.init ("megaglest-saved-game");
-        XmlNode *rootNodeReplay = xmlTreeSaveGame.getRootNode ();
-
-        //std::map<string,string> mapTagReplacements;
-        //time_t now = time(NULL);
-        //struct tm *loctime = localtime (&now);
-        struct tm loctime = threadsafe_localtime (systemtime_now ());
-        char szBuf[4096] = "";
-        strftime (szBuf, 4095, "%Y-%m-%d %H:%M:%S", &loctime);
-
-        rootNodeReplay->addAttribute ("version", glestVersionString,
-                                      mapTagReplacements);
-        rootNodeReplay->addAttribute ("timestamp", szBuf, mapTagReplacements);
-
-        XmlNode *gameNodeReplay = rootNodeReplay->addChild ("Game");
-        gameSettings.saveGame (gameNodeReplay);
-
-        gameNodeReplay->addAttribute ("LastWorldFrameCount",
-                                      intToStr (world.getFrameCount ()),
-                                      mapTagReplacements);
-
-        for (unsigned int i = 0; i < replayCommandList.size (); ++i)
-        {
-          std::pair < int, NetworkCommand > & cmd = replayCommandList[i];
-          XmlNode *networkCommandNode = cmd.second.saveGame (gameNodeReplay);
-          networkCommandNode->addAttribute ("worldFrameCount",
-                                            intToStr (cmd.first),
-                                            mapTagReplacements);
-        }
-
-        string replayFile = saveGameFile + ".replay";
-        if (SystemFlags::VERBOSE_MODE_ENABLED)
-          printf ("Saving game replay commands to [%s]\n",
-                  replayFile.c_str ());
-        xmlTreeSaveGame.save (replayFile);
-      }
-
-      XmlTree xmlTree;
       xmlTree.init ("megaglest-saved-game");
       XmlNode *rootNode = xmlTree.getRootNode ();
 
@@ -10154,8 +10333,68 @@ namespace Glest
       gameNode->addAttribute ("disableSpeedChange",
                               intToStr (disableSpeedChange),
                               mapTagReplacements);
+    }
+
+    string Game::saveGame (string name, const string & path)
+    {
+      Config & config = Config::getInstance ();
+      // auto name file if using saved file pattern string
+      if (name == GameConstants::saveGameFilePattern)
+      {
+        //time_t curTime = time(NULL);
+        //struct tm *loctime = localtime (&curTime);
+        struct tm loctime = threadsafe_localtime (systemtime_now ());
+        char szBuf2[100] = "";
+        strftime (szBuf2, 100, "%Y%m%d_%H%M%S", &loctime);
+
+        char szBuf[8096] = "";
+        snprintf (szBuf, 8096, name.c_str (), szBuf2);
+        name = szBuf;
+      }
+      else if (name == GameConstants::saveGameFileAutoTestDefault)
+      {
+        //time_t curTime = time(NULL);
+        //struct tm *loctime = localtime (&curTime);
+        struct tm loctime = threadsafe_localtime (systemtime_now ());
+        char szBuf2[100] = "";
+        strftime (szBuf2, 100, "%Y%m%d_%H%M%S", &loctime);
+
+        char szBuf[8096] = "";
+        snprintf (szBuf, 8096, name.c_str (), szBuf2);
+        name = szBuf;
+      }
+
+      // Save the file now
+      string saveGameFile = getSaveGameFilePath (name, path);
+      if (SystemFlags::VERBOSE_MODE_ENABLED)
+        printf ("Saving game to [%s]\n", saveGameFile.c_str ());
+
+      // This condition will re-play all the commands from a replay file
+      // INSTEAD of saving from a saved game.
+      if (config.getBool ("SaveCommandsForReplay", "false") == true)
+      {
+        struct tm loctime = threadsafe_localtime (systemtime_now ());
+        char szBuf[4096] = "";
+        strftime (szBuf, 4095, "%Y-%m-%d %H:%M:%S", &loctime);
 
-      xmlTree.save (saveGameFile);
+        replay.setGameSettings (&gameSettings, glestVersionString, szBuf);
+        replay.setLastWorldFrameCount (world.getFrameCount ());
+
+        string replayFile = saveGameFile + ".replay";
+        if (SystemFlags::VERBOSE_MODE_ENABLED)
+          printf ("Saving game replay commands to [%s]\n",
+                  replayFile.c_str ());
+        replay.save (replayFile);
+      }
+
+      // the network save is zipped on its own and must stay readable by
+      // clients of older versions
+      bool compressed = configCompressSavedGames.get () == true
+        && name != GameConstants::saveNetworkGameFileServer;
+
+      XmlTree xmlTree;
+      buildSaveGameTree (xmlTree);
+      xmlTree.save (saveGameFile, compressed);
 
       if (masterserverMode == false)
       {
@@ -10187,105 +10426,228 @@ namespace Glest
       if (joinGameSettings == NULL
           && config.getBool ("SaveCommandsForReplay", "false") == true)
       {
-        XmlTree xmlTreeReplay (XML_RAPIDXML_ENGINE);
-        std::map < string, string > mapExtraTagReplacementValues;
-        xmlTreeReplay.load (name + ".replay",
-                            Properties::getTagReplacementValues
-                            (&mapExtraTagReplacementValues), true);
+        loadReplay (name + ".replay", programPtr, isMasterserverMode,
+                    replayStartFrame);
+        return;
+      }
 
-        const XmlNode *rootNode = xmlTreeReplay.getRootNode ();
+      XmlTree xmlTree (XML_RAPIDXML_ENGINE);
+
+      if (SystemFlags::VERBOSE_MODE_ENABLED)
+        printf ("Before load of XML\n");
+      std::map < string, string > mapExtraTagReplacementValues;
+      xmlTree.load (name,
+                    Properties::getTagReplacementValues
+                    (&mapExtraTagReplacementValues), true);
+      if (SystemFlags::VERBOSE_MODE_ENABLED)
+        printf ("After load of XML\n");
+
+      Game *newGame =
+        loadGameFromNode (xmlTree.getRootNode (), programPtr,
+                          isMasterserverMode, joinGameSettings);
+      programPtr->setState (newGame);
+    }
 
-        if (rootNode->hasChild ("megaglest-saved-game") == true)
+    // a replay only plays back the same game with the data it was recorded
+    // with, compare its CRCs to the local techtree, tileset and map
+    static void
+    validateReplayData (const Replay & replay,
+                        const GameSettings & gameSettings)
+    {
+      Config & config = Config::getInstance ();
+      string scenarioDir = "";
+      if (gameSettings.getScenarioDir () != "")
+      {
+        scenarioDir = gameSettings.getScenarioDir ();
+        if (EndsWith (scenarioDir, ".xml") == true)
         {
-          rootNode = rootNode->getChild ("megaglest-saved-game");
+          scenarioDir = scenarioDir.erase (scenarioDir.size () - 4, 4);
+          scenarioDir =
+            scenarioDir.erase (scenarioDir.size () -
+                               gameSettings.getScenario ().size (),
+                               gameSettings.getScenario ().size () + 1);
         }
+      }
 
-        //const XmlNode *versionNode= rootNode->getChild("megaglest-saved-game");
-        const XmlNode *versionNode = rootNode;
-
-        Lang & lang = Lang::getInstance ();
-        string gameVer = versionNode->getAttribute ("version")->getValue ();
-        if (gameVer != glestVersionString
-            && checkVersionComptability (gameVer,
-                                         glestVersionString) == false)
+      string mismatch = "";
+      if (replay.getTechCRC () != 0)
+      {
+        uint32 techCRC =
+          getFolderTreeContentsCheckSumRecursively (config.getPathListForType
+                                                    (ptTechs, scenarioDir),
+                                                    string ("/") +
+                                                    gameSettings.getTech () +
+                                                    string ("/*"), ".xml",
+                                                    NULL);
+        if (techCRC != replay.getTechCRC ())
         {
-          char szBuf[8096] = "";
-          snprintf (szBuf, 8096,
-                    lang.getString ("SavedGameBadVersion").c_str (),
-                    gameVer.c_str (), glestVersionString.c_str ());
-          throw megaglest_runtime_error (szBuf, true);
+          mismatch += " techtree [" + gameSettings.getTech () + "]";
+        }
+      }
+      if (replay.getTilesetCRC () != 0)
+      {
+        uint32 tilesetCRC =
+          getFolderTreeContentsCheckSumRecursively (config.getPathListForType
+                                                    (ptTilesets, scenarioDir),
+                                                    string ("/") +
+                                                    gameSettings.getTileset () +
+                                                    string ("/*"), ".xml",
+                                                    NULL);
+        if (tilesetCRC != replay.getTilesetCRC ())
+        {
+          mismatch += " tileset [" + gameSettings.getTileset () + "]";
+        }
+      }
+      if (replay.getMapCRC () != 0)
+      {
+        uint32 mapCRC = 0;
+        string file =
+          Config::getMapPath (gameSettings.getMap (), scenarioDir, false);
+        if (file != "")
+        {
+          Checksum checksum;
+          checksum.addFile (file);
+          mapCRC = checksum.getSum ();
+        }
+        if (mapCRC != replay.getMapCRC ())
+        {
+          mismatch += " map [" + gameSettings.getMap () + "]";
         }
+      }
 
-        if (SystemFlags::VERBOSE_MODE_ENABLED)
-          printf
-            ("Found saved game version that matches your application version: [%s] --> [%s]\n",
-             gameVer.c_str (), glestVersionString.c_str ());
+      if (mismatch != "")
+      {
+        throw megaglest_runtime_error ("The replay was recorded with different"
+                                       " data than installed:" + mismatch,
+                                       true);
+      }
+    }
 
-        XmlNode *gameNode = rootNode->getChild ("Game");
+    void
+      Game::loadReplay (const string & replayFile, Program * programPtr,
+                        bool isMasterserverMode, int startFrame)
+    {
+      Replay replay;
+      if (Replay::isBinaryReplay (replayFile) == true)
+      {
+        replay.load (replayFile);
+      }
+      else
+      {
+        replay.loadXml (replayFile);
+      }
 
-        GameSettings newGameSettingsReplay;
-        newGameSettingsReplay.loadGame (gameNode);
-        //printf("Loading scenario [%s]\n",newGameSettingsReplay.getScenarioDir().c_str());
-        if (newGameSettingsReplay.getScenarioDir () != ""
-            && fileExists (newGameSettingsReplay.getScenarioDir ()) == false)
-        {
-          newGameSettingsReplay.setScenarioDir (Scenario::getScenarioPath
-                                                (Config::
-                                                 getInstance
-                                                 ().getPathListForType
-                                                 (ptScenarios),
-                                                 newGameSettingsReplay.getScenario
-                                                 ()));
+      Lang & lang = Lang::getInstance ();
+      string gameVer = replay.getVersion ();
+      if (gameVer != glestVersionString
+          && checkVersionComptability (gameVer,
+                                       glestVersionString) == false)
+      {
+        char szBuf[8096] = "";
+        snprintf (szBuf, 8096,
+                  lang.getString ("SavedGameBadVersion").c_str (),
+                  gameVer.c_str (), glestVersionString.c_str ());
+        throw megaglest_runtime_error (szBuf, true);
+      }
 
-          //printf("Loading scenario #2 [%s]\n",newGameSettingsReplay.getScenarioDir().c_str());
-        }
+      if (SystemFlags::VERBOSE_MODE_ENABLED)
+        printf
+          ("Found saved game version that matches your application version: [%s] --> [%s]\n",
+           gameVer.c_str (), glestVersionString.c_str ());
 
-        //GameSettings newGameSettings;
-        //newGameSettings.loadGame(gameNode);
-        //if(SystemFlags::VERBOSE_MODE_ENABLED) printf("Game settings loaded\n");
+      GameSettings newGameSettingsReplay;
+      replay.loadGameSettings (&newGameSettingsReplay);
+      //printf("Loading scenario [%s]\n",newGameSettingsReplay.getScenarioDir().c_str());
+      if (newGameSettingsReplay.getScenarioDir () != ""
+          && fileExists (newGameSettingsReplay.getScenarioDir ()) == false)
+      {
+        newGameSettingsReplay.setScenarioDir (Scenario::getScenarioPath
+                                              (Config::
+                                               getInstance
+                                               ().getPathListForType
+                                               (ptScenarios),
+                                               newGameSettingsReplay.getScenario
+                                               ()));
 
-        NetworkManager & networkManager = NetworkManager::getInstance ();
-        networkManager.end ();
-        networkManager.init (nrServer, true);
+        //printf("Loading scenario #2 [%s]\n",newGameSettingsReplay.getScenarioDir().c_str());
+      }
+      validateReplayData (replay, newGameSettingsReplay);
+
+      // seek to the last saved state before the requested frame and only
+      // replay the commands given after it
+      int keyframeIndex = -1;
+      if (startFrame > 0)
+      {
+        keyframeIndex = replay.findKeyframe (startFrame);
+        if (keyframeIndex < 0)
+        {
+          SystemFlags::OutputDebug (SystemFlags::debugError,
+                                    "In [%s::%s Line: %d] replay [%s] has no keyframe before frame %d, playing from the start\n",
+                                    extractFileFromDirectoryPath
+                                    (__FILE__).c_str (), __FUNCTION__,
+                                    __LINE__, replayFile.c_str (),
+                                    startFrame);
+        }
+      }
+      if (keyframeIndex >= 0)
+      {
+        XmlTree xmlTreeKeyframe;
+        replay.loadKeyframe (keyframeIndex, xmlTreeKeyframe);
 
         Game *newGame =
-          new Game (programPtr, &newGameSettingsReplay, isMasterserverMode);
+          loadGameFromNode (xmlTreeKeyframe.getRootNode (), programPtr,
+                            isMasterserverMode, NULL);
         newGame->lastworldFrameCountForReplay =
-          gameNode->getAttribute ("LastWorldFrameCount")->getIntValue ();
+          replay.getLastWorldFrameCount ();
+        newGame->replay = replay;
+        newGame->replay.truncate (keyframeIndex);
 
-        vector < XmlNode * >networkCommandNodeList =
-          gameNode->getChildList ("NetworkCommand");
         if (SystemFlags::VERBOSE_MODE_ENABLED)
-          printf ("networkCommandNodeList.size() = " MG_SIZE_T_SPECIFIER
-                  "\n", networkCommandNodeList.size ());
-        for (unsigned int i = 0; i < networkCommandNodeList.size (); ++i)
-        {
-          XmlNode *node = networkCommandNodeList[i];
-          int
-            worldFrameCount =
-            node->getAttribute ("worldFrameCount")->getIntValue ();
-          NetworkCommand command;
-          command.loadGame (node);
+          printf ("Replay keyframe %d at frame %d, commands %d\n",
+                  keyframeIndex, replay.getKeyframe (keyframeIndex).frame,
+                  replay.getCommandCount () -
+                  replay.getKeyframe (keyframeIndex).commandIndex);
+        for (int i = replay.getKeyframe (keyframeIndex).commandIndex;
+             i < replay.getCommandCount (); ++i)
+        {
+          NetworkCommand command = replay.getCommand (i).second;
           newGame->commander.addToReplayCommandList (command,
-                                                     worldFrameCount);
+                                                     replay.getCommand
+                                                     (i).first);
         }
 
         programPtr->setState (newGame);
         return;
       }
 
-      XmlTree xmlTree (XML_RAPIDXML_ENGINE);
+      NetworkManager & networkManager = NetworkManager::getInstance ();
+      networkManager.end ();
+      networkManager.init (nrServer, true);
+
+      Game *newGame =
+        new Game (programPtr, &newGameSettingsReplay, isMasterserverMode);
+      newGame->lastworldFrameCountForReplay =
+        replay.getLastWorldFrameCount ();
 
       if (SystemFlags::VERBOSE_MODE_ENABLED)
-        printf ("Before load of XML\n");
-      std::map < string, string > mapExtraTagReplacementValues;
-      xmlTree.load (name,
-                    Properties::getTagReplacementValues
-                    (&mapExtraTagReplacementValues), true);
-      if (SystemFlags::VERBOSE_MODE_ENABLED)
-        printf ("After load of XML\n");
+        printf ("replay.getCommandCount() = %d\n",
+                replay.getCommandCount ());
+      for (int i = 0; i < replay.getCommandCount (); ++i)
+      {
+        NetworkCommand command = replay.getCommand (i).second;
+        newGame->commander.addToReplayCommandList (command,
+                                                   replay.getCommand
+                                                   (i).first);
+      }
 
-      const XmlNode *rootNode = xmlTree.getRootNode ();
+      programPtr->setState (newGame);
+    }
+
+    Game *Game::loadGameFromNode (const XmlNode * rootNode,
+                                  Program * programPtr,
+                                  bool isMasterserverMode,
+                                  const GameSettings * joinGameSettings)
+    {
       if (rootNode->hasChild ("megaglest-saved-game") == true)
       {
         rootNode = rootNode->getChild ("megaglest-saved-game");
@@ -10589,7 +10951,7 @@ namespace Glest
       newGame->world.loadGame (worldNode);
       if (SystemFlags::VERBOSE_MODE_ENABLED)
         printf ("Starting Game ...\n");
-      programPtr->setState (newGame);
+      return newGame;
     }
 
   }
@@ -44,6 +44,7 @@
 #   include "network_interface.h"
 #   include "data_types.h"
 #   include "selection.h"
+#   include "replay.h"
 #   include "leak_dumper.h"
 
 using std::vector;
@@ -89,7 +90,8 @@ namespace Glest
       ProgramState,
       public
       FileCRCPreCacheThreadCallbackInterface,
-      public CustomInputCallbackInterface, public ClientLagCallbackInterface
+      public CustomInputCallbackInterface, public ClientLagCallbackInterface,
+      public SimpleTaskCallbackInterface
     {
     public:
       static const float highlightTime;
@@ -229,7 +231,15 @@ namespace Glest
 
       XmlNode *loadGameNode;
       int lastworldFrameCountForReplay;
-      std::vector < std::pair < int, NetworkCommand > > replayCommandList;
+      // frame a loaded replay seeks to, 0 plays it from the start
+      static int replayStartFrame;
+      Replay replay;
+
+      // the autosave tree is built here and written by the thread
+      SimpleTaskThread *autoSaveThread;
+      Mutex *autoSaveMutex;
+      XmlTree *pendingAutoSave;
+      string pendingAutoSaveFile;
 
       std::vector < string > streamingVideos;
       ::Shared::Graphics::VideoPlayer * videoPlayer;
@@ -464,12 +474,17 @@ namespace Glest
       {
         return gameOver;
       }
+      int getLastWorldFrameCountForReplay () const
+      {
+        return lastworldFrameCountForReplay;
+      }
       bool hasGameStarted ()
       {
         return gameStarted;
       }
       virtual vector < Texture2D * >processTech (string techName);
       virtual void consoleAddLine (string line);
+      virtual void simpleTask (BaseThread * callingThread, void *userdata);
 
       void endGame ();
 
@@ -482,6 +497,14 @@ namespace Glest
       static void
         loadGame (string name, Program * programPtr, bool isMasterserverMode,
                   const GameSettings * joinGameSettings = NULL);
+      static void setReplayStartFrame (int value)
+      {
+        replayStartFrame = value;
+      }
+      // startFrame > 0 starts at the last keyframe at or before that frame
+      static void
+        loadReplay (const string & replayFile, Program * programPtr,
+                    bool isMasterserverMode, int startFrame = 0);
 
       void
         addNetworkCommandToReplayList (NetworkCommand * networkCommand,
@@ -562,6 +585,18 @@ namespace Glest
 
       void renderVideoPlayer ();
 
+      void buildSaveGameTree (XmlTree & xmlTree);
+      static Game *loadGameFromNode (const XmlNode * rootNode,
+                                     Program * programPtr,
+                                     bool isMasterserverMode,
+                                     const GameSettings * joinGameSettings);
+      void addReplayKeyframe ();
+      string getSaveGameFilePath (const string & name,
+                                  const string & path) const;
+      void autoSaveGame ();
+      void writePendingAutoSave ();
+      void shutdownAutoSaveThread ();
+
       void updateNetworkMarkedCells ();
       void updateNetworkUnMarkedCells ();
       void updateNetworkHighligtedCells ();
@@ -274,6 +274,10 @@ namespace
         saveGameFileAutoTestDefault;
       static const char *
         saveGameFilePattern;
+      static const char *
+        saveGameFileAutoSave;
+      static const char *
+        replayKeyframeFilePattern;
 
       // VC++ Chokes on init of non integral static types
       static const float
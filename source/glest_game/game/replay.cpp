@@ -0,0 +1,974 @@
+// ==============================================================
+//      This file is part of Glest (www.glest.org)
+//
+//      Copyright (C) 2001-2008 Martiño Figueroa
+//
+//      You can redistribute this code and/or modify it under
+//      the terms of the GNU General Public License as published
+//      by the Free Software Foundation; either version 2 of the
+//      License, or (at your option) any later version
+// ==============================================================
+
+#include "replay.h"
+
+#include <map>
+#include <cstdio>
+#include <cstring>
+#include "game_settings.h"
+#include "properties.h"
+#include "conversion.h"
+#include "platform_util.h"
+#include "leak_dumper.h"
+
+using namespace
+  Shared::Util;
+using namespace
+  Shared::Platform;
+using namespace
+  Shared::Xml;
+
+namespace
+  Glest
+{
+  namespace
+    Game
+  {
+
+// =====================================================
+//      binary encoding
+// =====================================================
+
+    static void
+    writeVarint (vector < unsigned char >&out, uint64 value)
+    {
+      while (value >= 0x80)
+        {
+          out.push_back ((unsigned char) (value | 0x80));
+          value >>= 7;
+        }
+      out.push_back ((unsigned char) value);
+    }
+
+    // zigzag, so small negative values stay short
+    static void
+    writeSigned (vector < unsigned char >&out, int64 value)
+    {
+      writeVarint (out, ((uint64) value << 1) ^ (uint64) (value >> 63));
+    }
+
+    static void
+    writeString (vector < unsigned char >&out, const string & value)
+    {
+      writeVarint (out, value.size ());
+      out.insert (out.end (), value.begin (), value.end ());
+    }
+
+    static void
+    writeBytes (vector < unsigned char >&out,
+                const vector < unsigned char >&value)
+    {
+      writeVarint (out, value.size ());
+      out.insert (out.end (), value.begin (), value.end ());
+    }
+
+    class
+      ReplayReader
+    {
+    private:
+      const unsigned char *
+        data;
+      size_t
+        size;
+      size_t
+        pos;
+
+    public:
+      ReplayReader (const vector < unsigned char >&buffer)
+      {
+        data = (buffer.empty () == false ? &buffer[0] : NULL);
+        size = buffer.size ();
+        pos = 0;
+      }
+
+      size_t
+      getRemaining () const
+      {
+        return size - pos;
+      }
+
+      uint64
+      readVarint ()
+      {
+        uint64
+          value = 0;
+        for (int shift = 0; shift < 64; shift += 7)
+          {
+            if (pos >= size)
+              {
+                throw megaglest_runtime_error ("Replay data is truncated");
+              }
+            unsigned char
+              byte = data[pos++];
+            value |= (uint64) (byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0)
+              {
+                return value;
+              }
+          }
+        throw megaglest_runtime_error ("Replay data has a bad number");
+      }
+
+      int64
+      readSigned ()
+      {
+        uint64
+          value = readVarint ();
+        return (int64) (value >> 1) ^ -(int64) (value & 1);
+      }
+
+      string
+      readString ()
+      {
+        uint64
+          length = readVarint ();
+        if (length > size - pos)
+          {
+            throw megaglest_runtime_error ("Replay data is truncated");
+          }
+        string
+        value ((const char *) data + pos, (size_t) length);
+        pos += (size_t) length;
+        return value;
+      }
+
+      void
+      readBytes (vector < unsigned char >&value)
+      {
+        uint64
+          length = readVarint ();
+        if (length > size - pos)
+          {
+            throw megaglest_runtime_error ("Replay data is truncated");
+          }
+        value.assign (data + pos, data + pos + (size_t) length);
+        pos += (size_t) length;
+      }
+    };
+
+    // node and attribute names repeat through a saved game, each one is
+    // written once and then referred to by its index
+    static void
+    writeName (vector < unsigned char >&out, const string & name,
+               std::map < string, int >&names)
+    {
+      std::map < string, int >::iterator iterFind = names.find (name);
+      if (iterFind != names.end ())
+        {
+          writeVarint (out, iterFind->second + 1);
+        }
+      else
+        {
+          writeVarint (out, 0);
+          writeString (out, name);
+          int
+            index = (int) names.size ();
+          names[name] = index;
+        }
+    }
+
+    static string
+    readName (ReplayReader & reader, vector < string > &names)
+    {
+      uint64
+        index = reader.readVarint ();
+      if (index == 0)
+        {
+          names.push_back (reader.readString ());
+          return names.back ();
+        }
+      if (index > names.size ())
+        {
+          throw megaglest_runtime_error ("Replay data has a bad name index");
+        }
+      return names[(size_t) index - 1];
+    }
+
+    // a node is its name and text, then its attributes and children
+    static void
+    writeNode (vector < unsigned char >&out, const XmlNode * node,
+               std::map < string, int >&names)
+    {
+      writeName (out, node->getName (), names);
+      writeString (out, node->getText ());
+      writeVarint (out, node->getAttributeCount ());
+      for (unsigned int i = 0; i < node->getAttributeCount (); ++i)
+        {
+          const XmlAttribute *
+            attribute = node->getAttribute (i);
+          writeName (out, attribute->getName (), names);
+          writeString (out, attribute->getValue ());
+        }
+      writeVarint (out, node->getChildCount ());
+      for (unsigned int i = 0; i < node->getChildCount (); ++i)
+        {
+          writeNode (out, node->getChild (i), names);
+        }
+    }
+
+    static void
+    readNodeContent (ReplayReader & reader, XmlNode * node,
+                     vector < string > &names,
+                     const std::map < string, string > &mapTagReplacements)
+    {
+      uint64
+        attributeCount = reader.readVarint ();
+      for (uint64 i = 0; i < attributeCount; ++i)
+        {
+          string
+            name = readName (reader, names);
+          node->addAttribute (name, reader.readString (), mapTagReplacements);
+        }
+      uint64
+        childCount = reader.readVarint ();
+      for (uint64 i = 0; i < childCount; ++i)
+        {
+          string
+            name = readName (reader, names);
+          string
+            text = reader.readString ();
+          XmlNode *
+            child = node->addChild (name, text);
+          readNodeContent (reader, child, names, mapTagReplacements);
+        }
+    }
+
+    static void
+    encodeTree (vector < unsigned char >&out, const XmlNode * rootNode)
+    {
+      std::map < string, int >names;
+      out.clear ();
+      writeNode (out, rootNode, names);
+    }
+
+    static void
+    decodeTree (const vector < unsigned char >&data, XmlTree & xmlTree)
+    {
+      std::map < string, string > mapExtraTagReplacementValues;
+      std::map < string, string > mapTagReplacements =
+        Properties::getTagReplacementValues (&mapExtraTagReplacementValues);
+
+      ReplayReader
+      reader (data);
+      vector < string > names;
+      xmlTree.init (readName (reader, names));
+      // the root node never has text
+      reader.readString ();
+      readNodeContent (reader, xmlTree.getRootNode (), names,
+                       mapTagReplacements);
+    }
+
+    static void
+    writeCommand (vector < unsigned char >&out,
+                  const NetworkCommand & command)
+    {
+      writeSigned (out, command.networkCommandType);
+      writeSigned (out, command.unitId);
+      writeSigned (out, command.unitTypeId);
+      writeSigned (out, command.commandTypeId);
+      writeSigned (out, command.positionX);
+      writeSigned (out, command.positionY);
+      writeSigned (out, command.targetId);
+      writeSigned (out, command.wantQueue);
+      writeSigned (out, command.fromFactionIndex);
+      writeSigned (out, command.unitFactionUnitCount);
+      writeSigned (out, command.unitFactionIndex);
+      writeSigned (out, command.commandStateType);
+      writeSigned (out, command.commandStateValue);
+      writeSigned (out, command.unitCommandGroupId);
+    }
+
+    static void
+    readCommand (ReplayReader & reader, NetworkCommand & command)
+    {
+      command.networkCommandType = (int16) reader.readSigned ();
+      command.unitId = (int32) reader.readSigned ();
+      command.unitTypeId = (int16) reader.readSigned ();
+      command.commandTypeId = (int16) reader.readSigned ();
+      command.positionX = (int16) reader.readSigned ();
+      command.positionY = (int16) reader.readSigned ();
+      command.targetId = (int32) reader.readSigned ();
+      command.wantQueue = (int8) reader.readSigned ();
+      command.fromFactionIndex = (int8) reader.readSigned ();
+      command.unitFactionUnitCount = (uint16) reader.readSigned ();
+      command.unitFactionIndex = (int8) reader.readSigned ();
+      command.commandStateType = (int8) reader.readSigned ();
+      command.commandStateValue = (int32) reader.readSigned ();
+      command.unitCommandGroupId = (int32) reader.readSigned ();
+    }
+
+    static FILE *
+    openReplayFile (const string & path, const char *mode)
+    {
+#ifdef WIN32
+      return _wfopen (utf8_decode (path).c_str (), utf8_decode (mode).c_str ());
+#else
+      return fopen (path.c_str (), mode);
+#endif
+    }
+
+    static int
+    seekReplayFile (FILE * fp, int64 offset, int whence)
+    {
+#ifdef WIN32
+      return _fseeki64 (fp, offset, whence);
+#else
+      return fseeko (fp, (off_t) offset, whence);
+#endif
+    }
+
+    static int64
+    tellReplayFile (FILE * fp)
+    {
+#ifdef WIN32
+      return _ftelli64 (fp);
+#else
+      return (int64) ftello (fp);
+#endif
+    }
+
+    static uint64
+    readFileVarint (FILE * fp)
+    {
+      uint64
+        value = 0;
+      for (int shift = 0; shift < 64; shift += 7)
+        {
+          int
+            byte = fgetc (fp);
+          if (byte == EOF)
+            {
+              throw megaglest_runtime_error ("Replay file is truncated");
+            }
+          value |= (uint64) (byte & 0x7f) << shift;
+          if ((byte & 0x80) == 0)
+            {
+              return value;
+            }
+        }
+      throw megaglest_runtime_error ("Replay file has a bad number");
+    }
+
+    static void
+    readFileBytes (FILE * fp, vector < unsigned char >&value, uint64 size)
+    {
+      value.resize ((size_t) size);
+      if (size > 0 && fread (&value[0], 1, (size_t) size, fp) != size)
+        {
+          throw megaglest_runtime_error ("Replay file is truncated");
+        }
+    }
+
+    // a size read from the file is checked against what is left of it
+    // before anything is allocated for it
+    static uint64
+    readFileSize (FILE * fp, int64 fileSize)
+    {
+      uint64
+        size = readFileVarint (fp);
+      int64
+        pos = tellReplayFile (fp);
+      if (pos < 0 || size > (uint64) (fileSize - pos))
+        {
+          throw megaglest_runtime_error ("Replay file is truncated");
+        }
+      return size;
+    }
+
+    static void
+    writeFileBytes (FILE * fp, const void *data, size_t size,
+                    const string & path)
+    {
+      if (size > 0 && fwrite (data, 1, size, fp) != size)
+        {
+          throw megaglest_runtime_error ("Can't write replay file: [" + path +
+                                         "]");
+        }
+    }
+
+    static void
+    copyFileBytes (FILE * from, int64 offset, uint64 size, FILE * to,
+                   const string & path)
+    {
+      if (seekReplayFile (from, offset, SEEK_SET) != 0)
+        {
+          throw megaglest_runtime_error ("Replay file is truncated");
+        }
+      vector < unsigned char >buffer (64 * 1024);
+      while (size > 0)
+        {
+          size_t
+            count = (size_t) min ((uint64) buffer.size (), size);
+          if (fread (&buffer[0], 1, count, from) != count)
+            {
+              throw megaglest_runtime_error ("Replay file is truncated");
+            }
+          writeFileBytes (to, &buffer[0], count, path);
+          size -= count;
+        }
+    }
+
+// =====================================================
+//      class ReplayKeyframe
+// =====================================================
+
+    ReplayKeyframe::ReplayKeyframe ()
+    {
+      frame = 0;
+      commandIndex = 0;
+      fileOffset = -1;
+      snapshotSize = 0;
+      spooled = false;
+    }
+
+// =====================================================
+//      class Replay
+// =====================================================
+
+    const char
+      Replay::fileMagic[4] = { 'M', 'G', 'R', 'P' };
+    const int
+      Replay::fileFormatVersion = 1;
+
+    Replay::Replay ()
+    {
+      clear ();
+      spoolPath = "";
+    }
+
+    void
+    Replay::clear ()
+    {
+      version = "";
+      timestamp = "";
+      techCRC = 0;
+      mapCRC = 0;
+      tilesetCRC = 0;
+      lastWorldFrameCount = 0;
+      settings.clear ();
+      commands.clear ();
+      keyframes.clear ();
+      loadPath = "";
+    }
+
+    bool
+    Replay::isBinaryReplay (const string & path)
+    {
+      FILE *
+        fp = openReplayFile (path, "rb");
+      if (fp == NULL)
+        {
+          return false;
+        }
+      char
+        magic[4] = "";
+      bool
+        result = (fread (magic, 1, 4, fp) == 4
+                  && memcmp (magic, fileMagic, 4) == 0);
+      fclose (fp);
+      return result;
+    }
+
+    void
+    Replay::setGameSettings (const GameSettings * gameSettings,
+                             const string & version,
+                             const string & timestamp)
+    {
+      this->version = version;
+      this->timestamp = timestamp;
+      techCRC = gameSettings->getTechCRC ();
+      mapCRC = gameSettings->getMapCRC ();
+      tilesetCRC = gameSettings->getTilesetCRC ();
+
+      XmlTree
+        xmlTree;
+      xmlTree.init ("Game");
+      gameSettings->saveGame (xmlTree.getRootNode ());
+      encodeTree (settings, xmlTree.getRootNode ());
+    }
+
+    void
+    Replay::loadGameSettings (GameSettings * gameSettings) const
+    {
+      if (settings.empty () == true)
+        {
+          throw megaglest_runtime_error ("Replay has no game settings");
+        }
+      XmlTree
+        xmlTree;
+      decodeTree (settings, xmlTree);
+      gameSettings->loadGame (xmlTree.getRootNode ());
+    }
+
+    void
+    Replay::addCommand (int worldFrameCount, const NetworkCommand & command)
+    {
+      commands.push_back (std::make_pair (worldFrameCount, command));
+    }
+
+    void
+    Replay::setSpoolPath (const string & path)
+    {
+      removeSpool ();
+      spoolPath = path;
+    }
+
+    void
+    Replay::removeSpool ()
+    {
+      if (spoolPath != "" && fileExists (spoolPath) == true)
+        {
+          removeFile (spoolPath);
+        }
+    }
+
+    void
+    Replay::addKeyframe (int worldFrameCount, const XmlNode * saveGameRoot)
+    {
+      if (spoolPath == "")
+        {
+          throw megaglest_runtime_error ("Replay has no keyframe file");
+        }
+      vector < unsigned char >snapshot;
+      encodeTree (snapshot, saveGameRoot);
+
+      FILE *
+        fp = openReplayFile (spoolPath, "ab");
+      if (fp == NULL)
+        {
+          throw megaglest_runtime_error ("Can't open replay file: [" +
+                                         spoolPath + "]");
+        }
+      ReplayKeyframe
+        keyframe;
+      keyframe.frame = worldFrameCount;
+      keyframe.commandIndex = (int) commands.size ();
+      keyframe.snapshotSize = snapshot.size ();
+      keyframe.spooled = true;
+      try
+      {
+        if (seekReplayFile (fp, 0, SEEK_END) != 0)
+          {
+            throw megaglest_runtime_error ("Can't write replay file: [" +
+                                           spoolPath + "]");
+          }
+        keyframe.fileOffset = tellReplayFile (fp);
+        writeFileBytes (fp, &snapshot[0], snapshot.size (), spoolPath);
+      }
+      catch ( ...)
+      {
+        fclose (fp);
+        throw;
+      }
+      if (fclose (fp) != 0)
+        {
+          throw megaglest_runtime_error ("Can't write replay file: [" +
+                                         spoolPath + "]");
+        }
+      keyframes.push_back (keyframe);
+    }
+
+    int
+    Replay::findKeyframe (int worldFrameCount) const
+    {
+      int
+        result = -1;
+      for (int i = 0; i < (int) keyframes.size (); ++i)
+        {
+          if (keyframes[i].frame <= worldFrameCount)
+            {
+              result = i;
+            }
+        }
+      return result;
+    }
+
+    void
+    Replay::readSnapshot (const ReplayKeyframe & keyframe,
+                          vector < unsigned char >&snapshot) const
+    {
+      const string & path = (keyframe.spooled == true ? spoolPath : loadPath);
+      FILE *
+        fp = openReplayFile (path, "rb");
+      if (fp == NULL)
+        {
+          throw megaglest_runtime_error ("Can't open replay file: [" + path +
+                                         "]");
+        }
+      try
+      {
+        if (seekReplayFile (fp, keyframe.fileOffset, SEEK_SET) != 0)
+          {
+            throw megaglest_runtime_error ("Replay file is truncated");
+          }
+        readFileBytes (fp, snapshot, keyframe.snapshotSize);
+      }
+      catch ( ...)
+      {
+        fclose (fp);
+        throw;
+      }
+      fclose (fp);
+    }
+
+    void
+    Replay::loadKeyframe (int index, XmlTree & xmlTree) const
+    {
+      vector < unsigned char >snapshot;
+      readSnapshot (keyframes[index], snapshot);
+      decodeTree (snapshot, xmlTree);
+    }
+
+    void
+    Replay::truncate (int keyframeIndex)
+    {
+      if (keyframeIndex < 0)
+        {
+          commands.clear ();
+          keyframes.clear ();
+          return;
+        }
+      commands.resize (keyframes[keyframeIndex].commandIndex);
+      keyframes.resize (keyframeIndex + 1);
+    }
+
+    void
+    Replay::save (const string & path)
+    {
+      vector < unsigned char >header;
+      writeString (header, version);
+      writeString (header, timestamp);
+      writeVarint (header, techCRC);
+      writeVarint (header, mapCRC);
+      writeVarint (header, tilesetCRC);
+      writeSigned (header, lastWorldFrameCount);
+      writeBytes (header, settings);
+
+      // the commands are grouped by frame, a group also ends where a
+      // keyframe starts
+      vector < unsigned char >commandStream;
+      writeVarint (commandStream, commands.size ());
+      unsigned int
+        keyframeIndex = 0;
+      int
+        lastFrame = 0;
+      for (unsigned int i = 0; i < commands.size ();)
+        {
+          while (keyframeIndex < keyframes.size () &&
+                 keyframes[keyframeIndex].commandIndex <= (int) i)
+            {
+              keyframeIndex++;
+            }
+          unsigned int
+            groupEnd = i + 1;
+          while (groupEnd < commands.size () &&
+                 commands[groupEnd].first == commands[i].first &&
+                 (keyframeIndex >= keyframes.size () ||
+                  keyframes[keyframeIndex].commandIndex > (int) groupEnd))
+            {
+              groupEnd++;
+            }
+          writeSigned (commandStream, commands[i].first - lastFrame);
+          writeVarint (commandStream, groupEnd - i);
+          for (; i < groupEnd; ++i)
+            {
+              writeCommand (commandStream, commands[i].second);
+            }
+          lastFrame = commands[groupEnd - 1].first;
+        }
+
+      // the keyframes are copied from the file they were loaded from,
+      // which may be this one, so the replay is written next to it
+      const string tempPath = path + ".tmp";
+      FILE *
+        fp = openReplayFile (tempPath, "wb");
+      if (fp == NULL)
+        {
+          throw megaglest_runtime_error ("Can't open replay file: [" +
+                                         tempPath + "]");
+        }
+      vector < int64 > offsets (keyframes.size (), -1);
+      try
+      {
+        vector < unsigned char >buffer;
+        buffer.insert (buffer.end (), fileMagic, fileMagic + 4);
+        writeVarint (buffer, fileFormatVersion);
+        writeBytes (buffer, header);
+        writeBytes (buffer, commandStream);
+        writeVarint (buffer, keyframes.size ());
+        writeFileBytes (fp, &buffer[0], buffer.size (), tempPath);
+
+        FILE *
+          spoolFile = NULL;
+        FILE *
+          loadFile = NULL;
+        try
+        {
+          for (unsigned int i = 0; i < keyframes.size (); ++i)
+            {
+              const ReplayKeyframe & keyframe = keyframes[i];
+              FILE *&from = (keyframe.spooled == true ? spoolFile : loadFile);
+              const string & fromPath =
+                (keyframe.spooled == true ? spoolPath : loadPath);
+              if (from == NULL)
+                {
+                  from = openReplayFile (fromPath, "rb");
+                  if (from == NULL)
+                    {
+                      throw megaglest_runtime_error
+                        ("Can't open replay file: [" + fromPath + "]");
+                    }
+                }
+
+              buffer.clear ();
+              writeSigned (buffer, keyframe.frame);
+              writeVarint (buffer, keyframe.commandIndex);
+              writeVarint (buffer, keyframe.snapshotSize);
+              writeFileBytes (fp, &buffer[0], buffer.size (), tempPath);
+              offsets[i] = tellReplayFile (fp);
+              copyFileBytes (from, keyframe.fileOffset, keyframe.snapshotSize,
+                             fp, tempPath);
+            }
+        }
+        catch ( ...)
+        {
+          if (spoolFile != NULL)
+            {
+              fclose (spoolFile);
+            }
+          if (loadFile != NULL)
+            {
+              fclose (loadFile);
+            }
+          throw;
+        }
+        if (spoolFile != NULL)
+          {
+            fclose (spoolFile);
+          }
+        if (loadFile != NULL)
+          {
+            fclose (loadFile);
+          }
+      }
+      catch ( ...)
+      {
+        fclose (fp);
+        removeFile (tempPath);
+        throw;
+      }
+      if (fclose (fp) != 0)
+        {
+          removeFile (tempPath);
+          throw megaglest_runtime_error ("Can't write replay file: [" +
+                                         tempPath + "]");
+        }
+
+#ifdef WIN32
+      // rename does not replace an existing file on windows
+      if (fileExists (path) == true)
+        {
+          removeFile (path);
+        }
+#endif
+      if (renameFile (tempPath, path) == false)
+        {
+          throw megaglest_runtime_error ("Can't write replay file: [" + path +
+                                         "]");
+        }
+
+      // the saved file holds every keyframe now
+      for (unsigned int i = 0; i < keyframes.size (); ++i)
+        {
+          keyframes[i].fileOffset = offsets[i];
+          keyframes[i].spooled = false;
+        }
+      loadPath = path;
+    }
+
+    void
+    Replay::load (const string & path)
+    {
+      clear ();
+
+      FILE *
+        fp = openReplayFile (path, "rb");
+      if (fp == NULL)
+        {
+          throw megaglest_runtime_error ("Can't open replay file: [" + path +
+                                         "]");
+        }
+      try
+      {
+        int64
+          fileSize = -1;
+        if (seekReplayFile (fp, 0, SEEK_END) == 0)
+          {
+            fileSize = tellReplayFile (fp);
+          }
+        if (fileSize < 0 || seekReplayFile (fp, 0, SEEK_SET) != 0)
+          {
+            throw megaglest_runtime_error ("Can't read replay file: [" + path +
+                                           "]");
+          }
+
+        char
+          magic[4] = "";
+        if (fread (magic, 1, 4, fp) != 4 || memcmp (magic, fileMagic, 4) != 0)
+          {
+            throw megaglest_runtime_error ("Not a binary replay file: [" +
+                                           path + "]");
+          }
+        int
+          formatVersion = (int) readFileVarint (fp);
+        if (formatVersion > fileFormatVersion)
+          {
+            throw megaglest_runtime_error ("Replay file [" + path +
+                                           "] has unknown format version " +
+                                           intToStr (formatVersion));
+          }
+
+        vector < unsigned char >buffer;
+        readFileBytes (fp, buffer, readFileSize (fp, fileSize));
+        ReplayReader
+        header (buffer);
+        version = header.readString ();
+        timestamp = header.readString ();
+        techCRC = (uint32) header.readVarint ();
+        mapCRC = (uint32) header.readVarint ();
+        tilesetCRC = (uint32) header.readVarint ();
+        lastWorldFrameCount = (int) header.readSigned ();
+        header.readBytes (settings);
+
+        readFileBytes (fp, buffer, readFileSize (fp, fileSize));
+        ReplayReader
+        commandStream (buffer);
+        // every field of a command takes at least one byte
+        const size_t minCommandSize = 14;
+        uint64
+          commandCount = commandStream.readVarint ();
+        if (commandCount > commandStream.getRemaining () / minCommandSize)
+          {
+            throw megaglest_runtime_error ("Replay data is truncated");
+          }
+        commands.reserve ((size_t) commandCount);
+        int
+          frame = 0;
+        while (commands.size () < commandCount)
+          {
+            frame += (int) commandStream.readSigned ();
+            uint64
+              groupCount = commandStream.readVarint ();
+            for (uint64 i = 0; i < groupCount; ++i)
+              {
+                NetworkCommand
+                  command;
+                readCommand (commandStream, command);
+                commands.push_back (std::make_pair (frame, command));
+              }
+          }
+
+        // only the position of each saved state is read, the state
+        // itself is read when the keyframe is used
+        uint64
+          keyframeCount = readFileVarint (fp);
+        for (uint64 i = 0; i < keyframeCount; ++i)
+          {
+            ReplayKeyframe
+              keyframe;
+            uint64
+              value = readFileVarint (fp);
+            keyframe.frame = (int) ((int64) (value >> 1) ^ -(int64) (value & 1));
+            keyframe.commandIndex = (int) readFileVarint (fp);
+            keyframe.snapshotSize = readFileSize (fp, fileSize);
+            keyframe.fileOffset = tellReplayFile (fp);
+            if (seekReplayFile (fp, keyframe.snapshotSize, SEEK_CUR) != 0)
+              {
+                throw megaglest_runtime_error ("Replay file is truncated");
+              }
+            keyframes.push_back (keyframe);
+          }
+      }
+      catch ( ...)
+      {
+        fclose (fp);
+        throw;
+      }
+      fclose (fp);
+      loadPath = path;
+    }
+
+    void
+    Replay::loadXml (const string & path)
+    {
+      clear ();
+
+      XmlTree
+      xmlTree (XML_RAPIDXML_ENGINE);
+      std::map < string, string > mapExtraTagReplacementValues;
+      xmlTree.load (path,
+                    Properties::getTagReplacementValues
+                    (&mapExtraTagReplacementValues), true);
+
+      const XmlNode *
+        rootNode = xmlTree.getRootNode ();
+      if (rootNode->hasChild ("megaglest-saved-game") == true)
+        {
+          rootNode = rootNode->getChild ("megaglest-saved-game");
+        }
+      version = rootNode->getAttribute ("version")->getValue ();
+      if (rootNode->hasAttribute ("timestamp") == true)
+        {
+          timestamp = rootNode->getAttribute ("timestamp")->getValue ();
+        }
+
+      const XmlNode *
+        gameNode = rootNode->getChild ("Game");
+      lastWorldFrameCount =
+        gameNode->getAttribute ("LastWorldFrameCount")->getIntValue ();
+
+      // keep only the settings, the commands are stored in the stream
+      const XmlNode *
+        gameSettingsNode = gameNode->getChild ("GameSettings");
+      if (gameSettingsNode->hasAttribute ("techCRC") == true)
+        {
+          techCRC =
+            gameSettingsNode->getAttribute ("techCRC")->getUIntValue ();
+          mapCRC = gameSettingsNode->getAttribute ("mapCRC")->getUIntValue ();
+          tilesetCRC =
+            gameSettingsNode->getAttribute ("tilesetCRC")->getUIntValue ();
+        }
+      std::map < string, int >names;
+      settings.clear ();
+      writeName (settings, "Game", names);
+      writeString (settings, "");
+      writeVarint (settings, 0);
+      writeVarint (settings, 1);
+      writeNode (settings, gameSettingsNode, names);
+
+      vector < XmlNode * >networkCommandNodeList =
+        gameNode->getChildList ("NetworkCommand");
+      commands.reserve (networkCommandNodeList.size ());
+      for (unsigned int i = 0; i < networkCommandNodeList.size (); ++i)
+        {
+          XmlNode *
+            node = networkCommandNodeList[i];
+          NetworkCommand
+            command;
+          command.loadGame (node);
+          addCommand (node->getAttribute ("worldFrameCount")->getIntValue (),
+                      command);
+        }
+    }
+
+  }
+}                               //end namespace
@@ -0,0 +1,232 @@
+// ==============================================================
+//      This file is part of Glest (www.glest.org)
+//
+//      Copyright (C) 2001-2008 Martiño Figueroa
+//
+//      You can redistribute this code and/or modify it under
+//      the terms of the GNU General Public License as published
+//      by the Free Software Foundation; either version 2 of the
+//      License, or (at your option) any later version
+// ==============================================================
+
+#ifndef _GLEST_GAME_REPLAY_H_
+#   define _GLEST_GAME_REPLAY_H_
+
+#   ifdef WIN32
+#      include <winsock2.h>
+#      include <winsock.h>
+#   endif
+
+#   include <string>
+#   include <vector>
+#   include "network_types.h"
+#   include "xml_parser.h"
+#   include "data_types.h"
+#   include "leak_dumper.h"
+
+using
+  std::string;
+using
+  std::vector;
+using
+  Shared::Xml::XmlNode;
+using
+  Shared::Xml::XmlTree;
+using
+  Shared::Platform::uint32;
+using
+  Shared::Platform::int64;
+
+namespace
+  Glest
+{
+  namespace
+    Game
+  {
+
+    class
+      GameSettings;
+
+// =====================================================
+//      class ReplayKeyframe
+//
+///     The saved game state at one frame of a replay
+// =====================================================
+    class
+      ReplayKeyframe
+    {
+    public:
+      ReplayKeyframe ();
+
+      int
+        frame;
+      // number of commands given before the state was saved
+      int
+        commandIndex;
+      // where the encoded saved game is, only the position is kept in
+      // memory
+      int64
+        fileOffset;
+      int64
+        snapshotSize;
+      // in the spool file of the running game, else in the loaded replay
+      bool
+        spooled;
+    };
+
+// =====================================================
+//      class Replay
+//
+///     The commands of a game and periodic saved states,
+///     kept in a compact binary file
+// =====================================================
+    class
+      Replay
+    {
+    private:
+      static const char
+        fileMagic[4];
+      static const int
+        fileFormatVersion;
+
+      string
+        version;
+      string
+        timestamp;
+      uint32
+        techCRC;
+      uint32
+        mapCRC;
+      uint32
+        tilesetCRC;
+      int
+        lastWorldFrameCount;
+      // the encoded Game node holding the game settings
+      vector < unsigned char >
+        settings;
+      vector < std::pair < int, NetworkCommand > >
+        commands;
+      vector < ReplayKeyframe >
+        keyframes;
+      string
+        loadPath;
+      // the keyframes taken during the game are written here as they are
+      // taken
+      string
+        spoolPath;
+
+      void
+      readSnapshot (const ReplayKeyframe & keyframe,
+                    vector < unsigned char >&snapshot) const;
+
+    public:
+      Replay ();
+
+      void
+      clear ();
+
+      static bool
+      isBinaryReplay (const string & path);
+
+      void
+      setGameSettings (const GameSettings * gameSettings,
+                       const string & version, const string & timestamp);
+      void
+      loadGameSettings (GameSettings * gameSettings) const;
+
+      void
+      addCommand (int worldFrameCount, const NetworkCommand & command);
+      void
+      setSpoolPath (const string & path);
+      const string &
+      getSpoolPath () const
+      {
+        return spoolPath;
+      }
+      void
+      removeSpool ();
+      void
+      addKeyframe (int worldFrameCount, const XmlNode * saveGameRoot);
+
+      // the last keyframe at or before the frame, -1 if there is none
+      int
+      findKeyframe (int worldFrameCount) const;
+      void
+      loadKeyframe (int index, XmlTree & xmlTree) const;
+      // drops the keyframes after the index and the commands given after
+      // its state was saved, everything with an index of -1
+      void
+      truncate (int keyframeIndex);
+
+      void
+      save (const string & path);
+      void
+      load (const string & path);
+      // reads a replay saved as xml by older versions
+      void
+      loadXml (const string & path);
+
+      const string &
+      getVersion () const
+      {
+        return version;
+      }
+      const string &
+      getTimestamp () const
+      {
+        return timestamp;
+      }
+      uint32
+      getTechCRC () const
+      {
+        return techCRC;
+      }
+      uint32
+      getMapCRC () const
+      {
+        return mapCRC;
+      }
+      uint32
+      getTilesetCRC () const
+      {
+        return tilesetCRC;
+      }
+      int
+      getLastWorldFrameCount () const
+      {
+        return lastWorldFrameCount;
+      }
+      void
+      setLastWorldFrameCount (int value)
+      {
+        lastWorldFrameCount = value;
+      }
+      int
+      getCommandCount () const
+      {
+        return (int) commands.size ();
+      }
+      const
+        std::pair <
+        int,
+        NetworkCommand > &
+      getCommand (int index) const
+      {
+        return commands[index];
+      }
+      int
+      getKeyframeCount () const
+      {
+        return (int) keyframes.size ();
+      }
+      const ReplayKeyframe &
+      getKeyframe (int index) const
+      {
+        return keyframes[index];
+      }
+    };
+
+  }
+}                               //end namespace
+
+#endif
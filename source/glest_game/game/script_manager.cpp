@@ -277,6 +277,20 @@ namespace
         }
     }
 
+// =====================================================
+//      class ScriptEvent
+// =====================================================
+
+    ScriptEvent::ScriptEvent ()
+    {
+      eventFunction = sefUnitCreated;
+      unitId = -1;
+      hasAttacker = false;
+      killerId = -1;
+      causeOfDeath = ucodNone;
+      unitTriggerEventType = utet_None;
+    }
+
 // =====================================================
 //      class ScriptManager
 // =====================================================
@@ -304,12 +318,21 @@ namespace
       currentCellTriggeredEventUnitId = 0;
       currentEventId = 0;
       inCellTriggerEvent = false;
+      cellTriggerIndexDirty = true;
+      cellTriggerGridW = 0;
+      cellTriggerGridH = 0;
       rootNode = NULL;
       currentCellTriggeredEventAreaEntryUnitId = 0;
       currentCellTriggeredEventAreaExitUnitId = 0;
       lastDayNightTriggerStatus = 0;
       registeredDayNightEvent = false;
       errorCount = 0;
+      for (int i = 0; i < sefCount; ++i)
+        {
+          eventFunctionIds[i] = -1;
+        }
+      batchEvents = false;
+      luaCallMicros = 0;
 
       lastUnitTriggerEventUnitId = -1;
       lastUnitTriggerEventType = utet_None;
@@ -344,6 +367,7 @@ namespace
       //printf("In [%s::%s Line: %d]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
       currentEventId = 1;
       CellTriggerEventList.clear ();
+      cellTriggerIndexDirty = true;
       TimerTriggerEventList.clear ();
 
       //printf("In [%s::%s Line: %d]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
@@ -544,6 +568,8 @@ namespace
       luaScript.registerFunction (getTimeOfDay, "getTimeOfDay");
       luaScript.registerFunction (registerDayNightEvent,
                                   "registerDayNightEvent");
+      luaScript.registerFunction (setBatchScriptEvents,
+                                  "setBatchScriptEvents");
       luaScript.registerFunction (unregisterDayNightEvent,
                                   "unregisterDayNightEvent");
 
@@ -596,6 +622,28 @@ namespace
 //      luaScript.beginCall("megaglest_lua_sandbox");
 //      luaScript.endCall();
 
+      const char *
+        eventFunctionNames[sefCount] = {
+        "resourceHarvested",
+        "unitCreated",
+        "unitDied",
+        "unitAttacked",
+        "unitAttacking",
+        "timerTriggerEvent",
+        "cellTriggerEvent",
+        "unitTriggerEvent",
+        "dayNightTriggerEvent",
+        "gameOver"
+      };
+      for (int i = 0; i < sefCount; ++i)
+        {
+          eventFunctionIds[i] =
+            luaScript.getFunctionId (eventFunctionNames[i]);
+        }
+      batchEvents = false;
+      queuedEvents.clear ();
+      luaCallMicros = 0;
+
       //setup message box
       messageBox.init (Lang::getInstance ().getString ("Ok"));
       messageBox.setEnabled (false);
@@ -751,8 +799,10 @@ namespace
 
       if (this->rootNode == NULL)
         {
-          luaScript.beginCall ("resourceHarvested");
-          luaScript.endCall ();
+          ScriptEvent
+            event;
+          event.eventFunction = sefResourceHarvested;
+          dispatchEvent (event);
         }
     }
 
@@ -767,13 +817,13 @@ namespace
 
       if (this->rootNode == NULL)
         {
-          lastCreatedUnitName = unit->getType ()->getName (false);
-          lastCreatedUnitId = unit->getId ();
-          luaScript.beginCall ("unitCreated");
-          luaScript.endCall ();
-          luaScript.beginCall ("unitCreatedOfType_" +
-                               unit->getType ()->getName ());
-          luaScript.endCall ();
+          ScriptEvent
+            event;
+          event.eventFunction = sefUnitCreated;
+          event.unitId = unit->getId ();
+          event.unitName = unit->getType ()->getName (false);
+          event.unitTypeName = unit->getType ()->getName ();
+          dispatchEvent (event);
         }
     }
 
@@ -788,36 +838,24 @@ namespace
 
       if (this->rootNode == NULL)
         {
+          ScriptEvent
+            event;
+          event.eventFunction = sefUnitDied;
+          event.unitId = unit->getId ();
+          event.unitName = unit->getType ()->getName (false);
+          event.causeOfDeath = unit->getCauseOfDeath ();
           if (unit->getLastAttackerUnitId () >= 0)
             {
+              event.hasAttacker = true;
               Unit *
                 killer = world->findUnitById (unit->getLastAttackerUnitId ());
-
               if (killer != NULL)
                 {
-                  lastAttackingUnitName = killer->getType ()->getName (false);
-                  lastAttackingUnitId = killer->getId ();
-
-                  lastDeadUnitKillerName =
-                    killer->getType ()->getName (false);
-                  lastDeadUnitKillerId = killer->getId ();
-                }
-              else
-                {
-                  lastDeadUnitKillerName = "";
-                  lastDeadUnitKillerId = -1;
+                  event.killerId = killer->getId ();
+                  event.killerName = killer->getType ()->getName (false);
                 }
             }
-
-          lastAttackedUnitName = unit->getType ()->getName (false);
-          lastAttackedUnitId = unit->getId ();
-
-          lastDeadUnitName = unit->getType ()->getName (false);
-          lastDeadUnitId = unit->getId ();
-          lastDeadUnitCauseOfDeath = unit->getCauseOfDeath ();
-
-          luaScript.beginCall ("unitDied");
-          luaScript.endCall ();
+          dispatchEvent (event);
         }
     }
 
@@ -832,10 +870,12 @@ namespace
 
       if (this->rootNode == NULL)
         {
-          lastAttackedUnitName = unit->getType ()->getName (false);
-          lastAttackedUnitId = unit->getId ();
-          luaScript.beginCall ("unitAttacked");
-          luaScript.endCall ();
+          ScriptEvent
+            event;
+          event.eventFunction = sefUnitAttacked;
+          event.unitId = unit->getId ();
+          event.unitName = unit->getType ()->getName (false);
+          dispatchEvent (event);
         }
     }
 
@@ -850,10 +890,12 @@ namespace
 
       if (this->rootNode == NULL)
         {
-          lastAttackingUnitName = unit->getType ()->getName (false);
-          lastAttackingUnitId = unit->getId ();
-          luaScript.beginCall ("unitAttacking");
-          luaScript.endCall ();
+          ScriptEvent
+            event;
+          event.eventFunction = sefUnitAttacking;
+          event.unitId = unit->getId ();
+          event.unitName = unit->getType ()->getName (false);
+          dispatchEvent (event);
         }
     }
 
@@ -867,8 +909,7 @@ namespace
                                   c_str (), __FUNCTION__, __LINE__);
 
       gameWon = won;
-      luaScript.beginCall ("gameOver");
-      luaScript.endCall ();
+      callEventFunction (eventFunctionIds[sefGameOver]);
     }
 
     void
@@ -930,8 +971,7 @@ namespace
                     }
                 }
               currentTimerTriggeredEventId = iterMap->first;
-              luaScript.beginCall ("timerTriggerEvent");
-              luaScript.endCall ();
+              callEventFunction (eventFunctionIds[sefTimerTriggerEvent]);
 
               if (event.triggerSecondsElapsed > 0)
                 {
@@ -970,10 +1010,34 @@ namespace
         {
           //ScenarioInfo scenarioInfoStart = world->getScenario()->getInfo();
 
-          for (std::map < int, CellTriggerEvent >::iterator iterMap =
-               CellTriggerEventList.begin ();
-               iterMap != CellTriggerEventList.end (); ++iterMap)
+          findCellTriggerCandidates (movingUnit, cellTriggerCandidates);
+
+          // triggers registered by the lua handlers below are tested after
+          // the others, in the same order as a walk over the whole list
+          int
+            nextNewEventId = currentEventId;
+          for (unsigned int candidateIdx = 0;; ++candidateIdx)
             {
+              std::map < int, CellTriggerEvent >::iterator iterMap;
+              if (candidateIdx < cellTriggerCandidates.size ())
+                {
+                  iterMap =
+                    CellTriggerEventList.find (cellTriggerCandidates
+                                               [candidateIdx]);
+                  if (iterMap == CellTriggerEventList.end ())
+                    {
+                      continue;
+                    }
+                }
+              else
+                {
+                  iterMap = CellTriggerEventList.lower_bound (nextNewEventId);
+                  if (iterMap == CellTriggerEventList.end ())
+                    {
+                      break;
+                    }
+                  nextNewEventId = iterMap->first + 1;
+                }
               CellTriggerEvent & event = iterMap->second;
 
               if (SystemFlags::getSystemSettingType (SystemFlags::debugLUA).
@@ -1487,6 +1551,9 @@ namespace
                                     event.eventStateInfo[movingUnit->
                                                          getId ()] =
                                       Vec2i (x, y).getString ();
+                                    cellTriggerAreaUnits[movingUnit->
+                                                         getId ()].
+                                      insert (iterMap->first);
                                   }
                               }
                           }
@@ -1548,6 +1615,8 @@ namespace
                               movingUnit->getId ();
 
                             event.eventStateInfo.erase (movingUnit->getId ());
+                            cellTriggerAreaUnits[movingUnit->getId ()].
+                              erase (iterMap->first);
                           }
                       }
                   }
@@ -1568,8 +1637,8 @@ namespace
                   currentCellTriggeredEventId = iterMap->first;
                   event.triggerCount++;
 
-                  luaScript.beginCall ("cellTriggerEvent");
-                  luaScript.endCall ();
+                  callEventFunction (eventFunctionIds
+                                     [sefCellTriggerEvent]);
                 }
 
 //                      ScenarioInfo scenarioInfoEnd = world->getScenario()->getInfo();
@@ -1582,6 +1651,163 @@ namespace
       inCellTriggerEvent = false;
     }
 
+    void
+    ScriptManager::rebuildCellTriggerIndex ()
+    {
+      cellTriggerUnitIndex.clear ();
+      cellTriggerFactionIndex.clear ();
+      cellTriggerAreaUnits.clear ();
+
+      const Map *
+        map = world->getMap ();
+      cellTriggerGridW = (map->getW () + cellTriggerBucketSize - 1) /
+        cellTriggerBucketSize;
+      cellTriggerGridH = (map->getH () + cellTriggerBucketSize - 1) /
+        cellTriggerBucketSize;
+      cellTriggerGrid.assign (cellTriggerGridW * cellTriggerGridH,
+                              std::vector < int >());
+
+      for (std::map < int, CellTriggerEvent >::iterator iterMap =
+           CellTriggerEventList.begin ();
+           iterMap != CellTriggerEventList.end (); ++iterMap)
+        {
+          const int
+            eventId = iterMap->first;
+          const CellTriggerEvent & event = iterMap->second;
+          switch (event.type)
+            {
+            case ctet_Unit:
+            case ctet_UnitPos:
+            case ctet_UnitAreaPos:
+              cellTriggerUnitIndex[event.sourceId].push_back (eventId);
+              break;
+
+            case ctet_Faction:
+              // the unit reached moves too, so these stay per faction
+              cellTriggerFactionIndex[event.sourceId].push_back (eventId);
+              break;
+
+            case ctet_FactionPos:
+            case ctet_FactionAreaPos:
+            case ctet_AreaPos:
+              {
+                Vec2i
+                  areaEnd =
+                  (event.type == ctet_FactionPos ? event.destPos : event.
+                   destPosEnd);
+                if (areaEnd.x < event.destPos.x
+                    || areaEnd.y < event.destPos.y)
+                  {
+                    break;
+                  }
+                // clamping both corners keeps every overlap with a unit
+                // inside the map
+                int
+                  startX =
+                  clamp (event.destPos.x, 0,
+                         map->getW () - 1) / cellTriggerBucketSize;
+                int
+                  startY =
+                  clamp (event.destPos.y, 0,
+                         map->getH () - 1) / cellTriggerBucketSize;
+                int
+                  endX =
+                  clamp (areaEnd.x, 0,
+                         map->getW () - 1) / cellTriggerBucketSize;
+                int
+                  endY =
+                  clamp (areaEnd.y, 0,
+                         map->getH () - 1) / cellTriggerBucketSize;
+                for (int y = startY; y <= endY; ++y)
+                  {
+                    for (int x = startX; x <= endX; ++x)
+                      {
+                        cellTriggerGrid[y * cellTriggerGridW +
+                                        x].push_back (eventId);
+                      }
+                  }
+
+                if (event.type == ctet_AreaPos)
+                  {
+                    for (std::map < int, string >::const_iterator iterUnit =
+                         event.eventStateInfo.begin ();
+                         iterUnit != event.eventStateInfo.end (); ++iterUnit)
+                      {
+                        cellTriggerAreaUnits[iterUnit->first].
+                          insert (eventId);
+                      }
+                  }
+              }
+              break;
+            }
+        }
+      cellTriggerIndexDirty = false;
+    }
+
+    void
+    ScriptManager::findCellTriggerCandidates (Unit * movingUnit,
+                                              std::vector < int >&result)
+    {
+      if (cellTriggerIndexDirty == true)
+        {
+          rebuildCellTriggerIndex ();
+        }
+      result.clear ();
+
+      std::map < int, std::vector < int > >::const_iterator iterFind =
+        cellTriggerUnitIndex.find (movingUnit->getId ());
+      if (iterFind != cellTriggerUnitIndex.end ())
+        {
+          result.insert (result.end (), iterFind->second.begin (),
+                         iterFind->second.end ());
+        }
+      iterFind = cellTriggerFactionIndex.find (movingUnit->getFactionIndex ());
+      if (iterFind != cellTriggerFactionIndex.end ())
+        {
+          result.insert (result.end (), iterFind->second.begin (),
+                         iterFind->second.end ());
+        }
+      std::map < int, std::set < int > >::const_iterator iterArea =
+        cellTriggerAreaUnits.find (movingUnit->getId ());
+      if (iterArea != cellTriggerAreaUnits.end ())
+        {
+          result.insert (result.end (), iterArea->second.begin (),
+                         iterArea->second.end ());
+        }
+
+      // a unit covers its position and size - 1 cells past it, so the
+      // triggers it can be in start between these corners
+      const Map *
+        map = world->getMap ();
+      const Vec2i
+        pos = movingUnit->getPos ();
+      const int
+        size = movingUnit->getType ()->getSize ();
+      int
+        startX =
+        clamp (pos.x - size + 1, 0, map->getW () - 1) / cellTriggerBucketSize;
+      int
+        startY =
+        clamp (pos.y - size + 1, 0, map->getH () - 1) / cellTriggerBucketSize;
+      int
+        endX = clamp (pos.x, 0, map->getW () - 1) / cellTriggerBucketSize;
+      int
+        endY = clamp (pos.y, 0, map->getH () - 1) / cellTriggerBucketSize;
+      for (int y = startY; y <= endY; ++y)
+        {
+          for (int x = startX; x <= endX; ++x)
+            {
+              const std::vector < int >&bucket =
+                cellTriggerGrid[y * cellTriggerGridW + x];
+              result.insert (result.end (), bucket.begin (), bucket.end ());
+            }
+        }
+
+      std::sort (result.begin (), result.end ());
+      result.erase (std::unique (result.begin (), result.end ()),
+                    result.end ());
+    }
+
 // ========================== lua wrappers ===============================================
 
     string
@@ -2203,6 +2429,7 @@ namespace
       int
         eventId = currentEventId++;
       CellTriggerEventList[eventId] = trigger;
+      cellTriggerIndexDirty = true;
 
       if (SystemFlags::getSystemSettingType (SystemFlags::debugLUA).enabled)
         SystemFlags::OutputDebug (SystemFlags::debugLUA,
@@ -2228,6 +2455,7 @@ namespace
       int
         eventId = currentEventId++;
       CellTriggerEventList[eventId] = trigger;
+      cellTriggerIndexDirty = true;
 
       if (SystemFlags::getSystemSettingType (SystemFlags::debugLUA).enabled)
         SystemFlags::OutputDebug (SystemFlags::debugLUA,
@@ -2257,6 +2485,7 @@ namespace
       int
         eventId = currentEventId++;
       CellTriggerEventList[eventId] = trigger;
+      cellTriggerIndexDirty = true;
 
       if (SystemFlags::getSystemSettingType (SystemFlags::debugLUA).enabled)
         SystemFlags::OutputDebug (SystemFlags::debugLUA,
@@ -2283,6 +2512,7 @@ namespace
       int
         eventId = currentEventId++;
       CellTriggerEventList[eventId] = trigger;
+      cellTriggerIndexDirty = true;
 
       if (SystemFlags::getSystemSettingType (SystemFlags::debugLUA).enabled)
         SystemFlags::OutputDebug (SystemFlags::debugLUA,
@@ -2308,6 +2538,7 @@ namespace
       int
         eventId = currentEventId++;
       CellTriggerEventList[eventId] = trigger;
+      cellTriggerIndexDirty = true;
 
       if (SystemFlags::getSystemSettingType (SystemFlags::debugLUA).enabled)
         SystemFlags::OutputDebug (SystemFlags::debugLUA,
@@ -2337,6 +2568,7 @@ namespace
       int
         eventId = currentEventId++;
       CellTriggerEventList[eventId] = trigger;
+      cellTriggerIndexDirty = true;
 
       if (SystemFlags::getSystemSettingType (SystemFlags::debugLUA).enabled)
         SystemFlags::OutputDebug (SystemFlags::debugLUA,
@@ -2364,6 +2596,7 @@ namespace
       int
         eventId = currentEventId++;
       CellTriggerEventList[eventId] = trigger;
+      cellTriggerIndexDirty = true;
 
       if (SystemFlags::getSystemSettingType (SystemFlags::debugLUA).enabled)
         SystemFlags::OutputDebug (SystemFlags::debugLUA,
@@ -2396,6 +2629,7 @@ namespace
           if (inCellTriggerEvent == false)
             {
               CellTriggerEventList.erase (eventId);
+              cellTriggerIndexDirty = true;
             }
           else
             {
@@ -2415,6 +2649,7 @@ namespace
                   CellTriggerEventList.erase (delayedEventId);
                 }
               unRegisterCellTriggerEventList.clear ();
+              cellTriggerIndexDirty = true;
             }
         }
     }
@@ -3411,13 +3646,12 @@ namespace
             {
               //printf("File: %s line: %d\n",extractFileFromDirectoryPath(__FILE__).c_str(),__LINE__);
 
-              lastUnitTriggerEventUnitId = unit->getId ();
-              lastUnitTriggerEventType = event;
-
-              //printf("File: %s line: %d\n",extractFileFromDirectoryPath(__FILE__).c_str(),__LINE__);
-
-              luaScript.beginCall ("unitTriggerEvent");
-              luaScript.endCall ();
+              ScriptEvent
+                triggerEvent;
+              triggerEvent.eventFunction = sefUnitTriggerEvent;
+              triggerEvent.unitId = unit->getId ();
+              triggerEvent.unitTriggerEventType = event;
+              dispatchEvent (triggerEvent);
 
               //printf("File: %s line: %d\n",extractFileFromDirectoryPath(__FILE__).c_str(),__LINE__);
             }
@@ -3438,6 +3672,116 @@ namespace
       registeredDayNightEvent = false;
     }
 
+    void
+    ScriptManager::setBatchScriptEvents (bool value)
+    {
+      if (value == false)
+        {
+          deliverQueuedEvents ();
+        }
+      batchEvents = value;
+    }
+
+    void
+    ScriptManager::callEventFunction (int functionId)
+    {
+      Chrono
+        chrono;
+      chrono.start ();
+      luaScript.beginCall (functionId);
+      luaScript.endCall ();
+      luaCallMicros += chrono.getMicros ();
+    }
+
+    void
+    ScriptManager::dispatchEvent (const ScriptEvent & event)
+    {
+      if (batchEvents == true)
+        {
+          queuedEvents.push_back (event);
+        }
+      else
+        {
+          deliverEvent (event);
+        }
+    }
+
+    void
+    ScriptManager::deliverEvent (const ScriptEvent & event)
+    {
+      switch (event.eventFunction)
+        {
+        case sefUnitCreated:
+          lastCreatedUnitName = event.unitName;
+          lastCreatedUnitId = event.unitId;
+          callEventFunction (eventFunctionIds[sefUnitCreated]);
+          callEventFunction (luaScript.getFunctionId
+                             ("unitCreatedOfType_" + event.unitTypeName));
+          break;
+        case sefUnitDied:
+          if (event.hasAttacker == true)
+            {
+              if (event.killerId >= 0)
+                {
+                  lastAttackingUnitName = event.killerName;
+                  lastAttackingUnitId = event.killerId;
+                }
+              lastDeadUnitKillerName = event.killerName;
+              lastDeadUnitKillerId = event.killerId;
+            }
+
+          lastAttackedUnitName = event.unitName;
+          lastAttackedUnitId = event.unitId;
+
+          lastDeadUnitName = event.unitName;
+          lastDeadUnitId = event.unitId;
+          lastDeadUnitCauseOfDeath = event.causeOfDeath;
+          callEventFunction (eventFunctionIds[sefUnitDied]);
+          break;
+        case sefUnitAttacked:
+          lastAttackedUnitName = event.unitName;
+          lastAttackedUnitId = event.unitId;
+          callEventFunction (eventFunctionIds[sefUnitAttacked]);
+          break;
+        case sefUnitAttacking:
+          lastAttackingUnitName = event.unitName;
+          lastAttackingUnitId = event.unitId;
+          callEventFunction (eventFunctionIds[sefUnitAttacking]);
+          break;
+        case sefUnitTriggerEvent:
+          lastUnitTriggerEventUnitId = event.unitId;
+          lastUnitTriggerEventType = event.unitTriggerEventType;
+          callEventFunction (eventFunctionIds[sefUnitTriggerEvent]);
+          break;
+        default:
+          callEventFunction (eventFunctionIds[event.eventFunction]);
+          break;
+        }
+    }
+
+    void
+    ScriptManager::deliverQueuedEvents ()
+    {
+      // the lua functions may raise more events, they are delivered in
+      // the same pass
+      for (unsigned int i = 0; i < queuedEvents.size (); ++i)
+        {
+          ScriptEvent
+            event = queuedEvents[i];
+          deliverEvent (event);
+        }
+      queuedEvents.clear ();
+    }
+
+    int64
+    ScriptManager::takeLuaCallMicros ()
+    {
+      int64
+        result = luaCallMicros;
+      luaCallMicros = 0;
+      return result;
+    }
+
     void
     ScriptManager::onDayNightTriggerEvent ()
     {
@@ -3460,8 +3804,7 @@ namespace
               printf ("Triggering daynight event isDay: %d [%f]\n", isDay,
                       getTimeOfDay ());
 
-              luaScript.beginCall ("dayNightTriggerEvent");
-              luaScript.endCall ();
+              callEventFunction (eventFunctionIds[sefDayNightTriggerEvent]);
             }
         }
     }
@@ -6563,6 +6906,24 @@ namespace
       return luaArguments.getReturnCount ();
     }
 
+    int
+    ScriptManager::setBatchScriptEvents (LuaHandle * luaHandle)
+    {
+      LuaArguments
+      luaArguments (luaHandle);
+      try
+      {
+        thisScriptManager->setBatchScriptEvents (luaArguments.getInt (-1) !=
+                                                 0);
+      }
+      catch (const megaglest_runtime_error & ex)
+      {
+        error (luaHandle, &ex, __FILE__, __FUNCTION__, __LINE__);
+      }
+
+      return luaArguments.getReturnCount ();
+    }
+
     int
     ScriptManager::registerUnitTriggerEvent (LuaHandle * luaHandle)
     {
@@ -6787,6 +7148,9 @@ namespace
     void
     ScriptManager::saveGame (XmlNode * rootNode)
     {
+      // batched events are not saved, the script sees them before onSave
+      deliverQueuedEvents ();
+
       std::map < string, string > mapTagReplacements;
       XmlNode *
         scriptManagerNode = rootNode->addChild ("ScriptManager");
@@ -6979,6 +7343,9 @@ namespace
       scriptManagerNode->addAttribute ("lastDayNightTriggerStatus",
                                        intToStr (lastDayNightTriggerStatus),
                                        mapTagReplacements);
+      scriptManagerNode->addAttribute ("batchEvents",
+                                       intToStr (batchEvents),
+                                       mapTagReplacements);
 
       for (std::map < int, UnitTriggerEventType >::iterator iterMap =
            UnitTriggerEventList.begin ();
@@ -7155,6 +7522,7 @@ namespace
           CellTriggerEventList[node->getAttribute ("key")->getIntValue ()] =
             event;
         }
+      cellTriggerIndexDirty = true;
 
 //      std::map<int,TimerTriggerEvent> TimerTriggerEventList;
       vector < XmlNode * >timerTriggerEventListNodeList =
@@ -7201,6 +7569,12 @@ namespace
             scriptManagerNode->getAttribute ("lastDayNightTriggerStatus")->
             getIntValue ();
         }
+      if (scriptManagerNode->hasAttribute ("batchEvents") == true)
+        {
+          batchEvents =
+            scriptManagerNode->getAttribute ("batchEvents")->getIntValue () !=
+            0;
+        }
 
       vector < XmlNode * >unitTriggerEventListNodeList =
         scriptManagerNode->getChildList ("UnitTriggerEventList");
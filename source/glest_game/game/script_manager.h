@@ -23,6 +23,7 @@
 #   include "components.h"
 #   include "game_constants.h"
 #   include <map>
+#   include <set>
 #   include "xml_parser.h"
 #   include "randomgen.h"
 #   include "leak_dumper.h"
@@ -249,6 +250,49 @@ namespace
       loadGame (const XmlNode * rootNode);
     };
 
+    enum ScriptEventFunction
+    {
+      sefResourceHarvested,
+      sefUnitCreated,
+      sefUnitDied,
+      sefUnitAttacked,
+      sefUnitAttacking,
+      sefTimerTriggerEvent,
+      sefCellTriggerEvent,
+      sefUnitTriggerEvent,
+      sefDayNightTriggerEvent,
+      sefGameOver,
+
+      sefCount
+    };
+
+    // the state a unit event hands to its lua function, kept so the
+    // event can be delivered later in the frame
+    class
+      ScriptEvent
+    {
+    public:
+      ScriptEvent ();
+      ScriptEventFunction
+        eventFunction;
+      int
+        unitId;
+      string
+        unitName;
+      string
+        unitTypeName;
+      bool
+        hasAttacker;
+      int
+        killerId;
+      string
+        killerName;
+      int
+        causeOfDeath;
+      UnitTriggerEventType
+        unitTriggerEventType;
+    };
+
     class
       TimerTriggerEvent
     {
@@ -370,11 +414,47 @@ namespace
       std::vector < int >
         unRegisterCellTriggerEventList;
 
+      // lets onCellTriggerEvent only test the triggers a moving unit can
+      // set off, rebuilt when triggers are registered or removed
+      static const int
+        cellTriggerBucketSize = 8;
+      bool
+        cellTriggerIndexDirty;
+      std::map < int,
+        std::vector < int > >
+        cellTriggerUnitIndex;
+      std::map < int,
+        std::vector < int > >
+        cellTriggerFactionIndex;
+      std::vector < std::vector < int > >
+        cellTriggerGrid;
+      int
+        cellTriggerGridW;
+      int
+        cellTriggerGridH;
+      // area triggers each unit is inside of, to see it leave
+      std::map < int,
+        std::set < int > >
+        cellTriggerAreaUnits;
+      std::vector < int >
+        cellTriggerCandidates;
+
       bool
         registeredDayNightEvent;
       int
         lastDayNightTriggerStatus;
 
+      int
+        eventFunctionIds[sefCount];
+      // when set by the script, unit events are queued and delivered in
+      // one pass at the end of the world update
+      bool
+        batchEvents;
+      std::vector < ScriptEvent >
+        queuedEvents;
+      int64
+        luaCallMicros;
+
       std::map < int,
         UnitTriggerEventType >
         UnitTriggerEventList;
@@ -458,6 +538,15 @@ namespace
       void
       onCellTriggerEvent (Unit * movingUnit);
       void
+      deliverQueuedEvents ();
+      int64
+      takeLuaCallMicros ();
+      void
+      rebuildCellTriggerIndex ();
+      void
+      findCellTriggerCandidates (Unit * movingUnit,
+                                 std::vector < int >&result);
+      void
       onTimerTriggerEvent ();
       void
       onDayNightTriggerEvent ();
@@ -765,6 +854,15 @@ namespace
       registerDayNightEvent ();
       void
       unregisterDayNightEvent ();
+      void
+      setBatchScriptEvents (bool value);
+
+      void
+      callEventFunction (int functionId);
+      void
+      dispatchEvent (const ScriptEvent & event);
+      void
+      deliverEvent (const ScriptEvent & event);
 
       void
       registerUnitTriggerEvent (int unitId);
@@ -1074,6 +1172,8 @@ namespace
       registerDayNightEvent (LuaHandle * luaHandle);
       static int
       unregisterDayNightEvent (LuaHandle * luaHandle);
+      static int
+      setBatchScriptEvents (LuaHandle * luaHandle);
 
       static int
       registerUnitTriggerEvent (LuaHandle * luaHandle);
@@ -106,6 +106,10 @@ namespace Glest
     const char *GameConstants::saveGameFileAutoTestDefault =
       "zetaglest-auto-saved_%s.xml";
     const char *GameConstants::saveGameFilePattern = "zetaglest-saved_%s.xml";
+    const char *GameConstants::saveGameFileAutoSave =
+      "zetaglest-autosave.xml";
+    const char *GameConstants::replayKeyframeFilePattern =
+      "zetaglest-replay-keyframes_%d.tmp";
 
     const char *Config::glest_ini_filename = "glest.ini";
     const char *Config::glestuser_ini_filename = "glestuser.ini";
@@ -120,6 +124,7 @@ namespace Glest
     const char *Config::frustumPicking = "frustum";
 
     map < string, string > Config::customRuntimeProperties;
+    std::atomic < int > Config::generation (0);
 
 // =====================================================
 //      class Config
@@ -499,6 +504,7 @@ namespace Glest
 
       Config & oldconfig = configList.find (type.first)->second;
       CopyAll (&newconfig, &oldconfig);
+      generation++;
 
       if (SystemFlags::VERBOSE_MODE_ENABLED)
         if (SystemFlags::getSystemSettingType (SystemFlags::debugSystem).
@@ -689,6 +695,27 @@ namespace Glest
       return properties.first.getString (key, defaultValueIfNotFound);
     }
 
+    void Config::getValue (const char *key,
+                           const char *defaultValueIfNotFound,
+                           int &value) const
+    {
+      value = getInt (key, defaultValueIfNotFound);
+    }
+
+    void Config::getValue (const char *key,
+                           const char *defaultValueIfNotFound,
+                           bool & value) const
+    {
+      value = getBool (key, defaultValueIfNotFound);
+    }
+
+    void Config::getValue (const char *key,
+                           const char *defaultValueIfNotFound,
+                           float &value) const
+    {
+      value = getFloat (key, defaultValueIfNotFound);
+    }
+
     SDL_Keycode Config::translateStringToSDLKey (const string & value) const
     {
       SDL_Keycode result = SDLK_UNKNOWN;
@@ -856,14 +883,16 @@ namespace Glest
       if (tempBuffer == true)
       {
         tempProperties.setInt (key, value);
-        return;
       }
-      if (fileLoaded.second == true)
+      else if (fileLoaded.second == true)
       {
         properties.second.setInt (key, value);
-        return;
       }
-      properties.first.setInt (key, value);
+      else
+      {
+        properties.first.setInt (key, value);
+      }
+      generation++;
     }
 
     void Config::setBool (const string & key, bool value, bool tempBuffer)
@@ -871,16 +900,16 @@ namespace Glest
       if (tempBuffer == true)
       {
         tempProperties.setBool (key, value);
-        return;
       }
-
-      if (fileLoaded.second == true)
+      else if (fileLoaded.second == true)
       {
         properties.second.setBool (key, value);
-        return;
       }
-
-      properties.first.setBool (key, value);
+      else
+      {
+        properties.first.setBool (key, value);
+      }
+      generation++;
     }
 
     void Config::setFloat (const string & key, float value, bool tempBuffer)
@@ -888,16 +917,16 @@ namespace Glest
       if (tempBuffer == true)
       {
         tempProperties.setFloat (key, value);
-        return;
       }
-
-      if (fileLoaded.second == true)
+      else if (fileLoaded.second == true)
       {
         properties.second.setFloat (key, value);
-        return;
       }
-
-      properties.first.setFloat (key, value);
+      else
+      {
+        properties.first.setFloat (key, value);
+      }
+      generation++;
     }
 
     void Config::setString (const string & key, const string & value,
@@ -906,16 +935,16 @@ namespace Glest
       if (tempBuffer == true)
       {
         tempProperties.setString (key, value);
-        return;
       }
-
-      if (fileLoaded.second == true)
+      else if (fileLoaded.second == true)
       {
         properties.second.setString (key, value);
-        return;
       }
-
-      properties.first.setString (key, value);
+      else
+      {
+        properties.first.setString (key, value);
+      }
+      generation++;
     }
 
     vector < pair < string,
@@ -985,6 +1014,7 @@ namespace Glest
         const pair < string, string > &nameValuePair = valueList[idx];
         propertiesObj.setString (nameValuePair.first, nameValuePair.second);
       }
+      generation++;
     }
 
     string Config::getFileName (bool userFilename) const
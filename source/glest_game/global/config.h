@@ -30,6 +30,7 @@
 
 #   include "properties.h"
 #   include <vector>
+#   include <atomic>
 #   include "game_constants.h"
 #   include <SDL.h>
 #   include "leak_dumper.h"
@@ -76,6 +77,10 @@ namespace Glest
 
       static map < string, string > customRuntimeProperties;
 
+      // bumped after a value changed, never before, so a ConfigValue
+      // can not cache the old value under the new generation
+      static std::atomic < int > generation;
+
     public:
 
       static const char *glestkeys_ini_filename;
@@ -172,10 +177,70 @@ namespace Glest
 
       static string findValidLocalFileFromPath (string fileName);
 
+      // read from the faction worker threads too, see ConfigValue
+      static int getGeneration ()
+      {
+        return generation.load ();
+      }
+
+      void getValue (const char *key, const char *defaultValueIfNotFound,
+                     int &value) const;
+      void getValue (const char *key, const char *defaultValueIfNotFound,
+                     bool &value) const;
+      void getValue (const char *key, const char *defaultValueIfNotFound,
+                     float &value) const;
+
       static string getMapPath (const string & mapName, string scenarioDir =
                                 "", bool errorOnNotFound = true);
     };
 
+// =====================================================
+//      class ConfigValue
+//
+//      Typed handle to an int, bool or float game setting
+//      read in hot code, the value is looked up and converted
+//      once and again only after the configuration changed.
+//      Handles may be read from several threads.
+// =====================================================
+
+    template < typename T > class ConfigValue
+    {
+    private:
+      const char *key;
+      const char *defaultValueIfNotFound;
+      mutable std::atomic < T > value;
+      mutable std::atomic < int > generation;
+
+    public:
+      ConfigValue (const char *key, const char *defaultValueIfNotFound =
+                   NULL):key (key),
+        defaultValueIfNotFound (defaultValueIfNotFound), value (T ()),
+        generation (-1)
+      {
+      }
+
+      T get () const
+      {
+        int currentGeneration = Config::getGeneration ();
+        if (generation.load () != currentGeneration)
+        {
+          // threads refreshing at once store the same value
+          T newValue = T ();
+          Config::getInstance ().getValue (key, defaultValueIfNotFound,
+                                           newValue);
+          value.store (newValue);
+          generation.store (currentGeneration);
+          return newValue;
+        }
+        return value.load ();
+      }
+
+      operator         T () const
+      {
+        return get ();
+      }
+    };
+
 }}                              //end namespace
 
 #endif
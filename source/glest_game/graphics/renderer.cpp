@@ -27,6 +27,7 @@
 #include <cstdlib>
 #include "cache_manager.h"
 #include "network_manager.h"
+#include "interpolation.h"
 #include <algorithm>
 #include <iterator>
 #include "leak_dumper.h"
@@ -44,11 +45,119 @@ bool Renderer::renderText3DEnabled = true;
 //const float SKIP_INTERPOLATION_DISTANCE = 20.0f;
 const string DEFAULT_CHAR_FOR_WIDTH_CALC = "V";
 
+// settings read every frame
+static ConfigValue<bool> configInGameClock("InGameClock","true");
+static ConfigValue<bool> configInGameLocalClock("InGameLocalClock","true");
+static ConfigValue<bool> configInGameFrameCounter("InGameFrameCounter","false");
+static ConfigValue<bool> configTwoLineTeamResourceRendering("TwoLineTeamResourceRendering","false");
+static ConfigValue<bool> configRecordMode("RecordMode","false");
+static ConfigValue<bool> configPhotoMode("PhotoMode");
+static ConfigValue<int> configAnimatedTilesetObjects("AnimatedTilesetObjects","-1");
+static ConfigValue<bool> configDebugGameSynchUI("DebugGameSynchUI","false");
+static ConfigValue<bool> configEnableFrustrumCache("EnableFrustrumCache","false");
+static ConfigValue<bool> configBatchedUnitRendering("BatchedUnitRendering","true");
+static ConfigValue<bool> configTerrainChunks("TerrainChunks","true");
+
 enum PROJECTION_TO_INFINITY {
 	pti_D_IS_ZERO,
 	pti_N_OVER_D_IS_OUTSIDE
 };
 
+// the interpolated frame of every mesh when other units showing the model
+// at the same time see the same one
+static bool getSharedModelFrame(const Model *model, std::vector<const Vec3f *> &frame) {
+	frame.clear();
+	for(uint32 i = 0; i < model->getMeshCount(); ++i) {
+		const InterpolationData *interpolationData= model->getMesh(i)->getInterpolationData();
+		const Vec3f *vertices= interpolationData->getSharedVertices();
+		const Vec3f *normals= interpolationData->getSharedNormals();
+		if(vertices == NULL || normals == NULL) {
+			return false;
+		}
+		frame.push_back(vertices);
+		frame.push_back(normals);
+	}
+	return true;
+}
+
+// =====================================================
+// 	class UnitRenderQueueSource
+// =====================================================
+
+class UnitRenderQueueSource : public RenderQueueSource {
+private:
+	const std::vector<Unit *> &units;
+	const std::vector<Model *> &models;
+
+public:
+	UnitRenderQueueSource(const std::vector<Unit *> &units, const std::vector<Model *> &models) :
+		units(units), models(models) {
+	}
+
+	virtual int getRenderItemCount() const {
+		return (int)units.size();
+	}
+
+	virtual bool fillRenderItem(int index, RenderQueueItem &item) const {
+		// units of the other pass have no model
+		if(models[index] == NULL) {
+			return false;
+		}
+		const Unit *unit= units[index];
+		item.model= models[index];
+		item.teamTexture= unit->getFaction()->getTexture();
+		item.position= unit->getCurrVectorFlat();
+		item.rotation= Vec3f(unit->getRotationX(), unit->getRotation(), unit->getRotationZ());
+		item.animProgress= unit->getAnimProgressAsFloat();
+		item.cycleAnimation= (unit->isAlive() && !unit->isAnimProgressBound());
+		item.frameStep= InterpolationCache::getInstance().getFrameStep(item.model,
+				item.animProgress, item.cycleAnimation);
+
+		//dead alpha
+		const SkillType *st= unit->getCurrSkill();
+		if(st->getClass() == scDie && static_cast<const DieSkillType*>(st)->getFade()) {
+			item.faded= true;
+			item.color= Vec4f(1.0f, 1.0f, 1.0f, 1.0f - item.animProgress);
+		}
+		return true;
+	}
+};
+
+// =====================================================
+// 	class ObjectRenderQueueSource
+// =====================================================
+
+class ObjectRenderQueueSource : public RenderQueueSource {
+private:
+	const std::vector<Object *> &objects;
+	const std::vector<float> &animProgress;
+	const Pixmap2D *fowTexPixmap;
+
+public:
+	ObjectRenderQueueSource(const std::vector<Object *> &objects, const std::vector<float> &animProgress,
+			const Pixmap2D *fowTexPixmap) :
+		objects(objects), animProgress(animProgress), fowTexPixmap(fowTexPixmap) {
+	}
+
+	virtual int getRenderItemCount() const {
+		return (int)objects.size();
+	}
+
+	virtual bool fillRenderItem(int index, RenderQueueItem &item) const {
+		const Object *o= objects[index];
+		item.model= o->getModelPtr();
+		item.position= o->getConstPos();
+		item.rotation= Vec3f(0.f, o->getRotation(), 0.f);
+		item.animProgress= animProgress[index];
+		item.cycleAnimation= true;
+
+		//ambient and diffuse color is taken from cell color
+		float fowFactor= fowTexPixmap->getPixelf(o->getMapPos().x / Map::cellScale, o->getMapPos().y / Map::cellScale);
+		item.color= Vec4f(Vec3f(fowFactor), 1.f);
+		return true;
+	}
+};
+
 // =====================================================
 // 	class MeshCallbackTeamColor
 // =====================================================
@@ -168,6 +277,9 @@ Renderer::Renderer() : BaseRenderer(), saveScreenShotThreadAccessor(new Mutex(CO
 	//assert(0==1);
 
 	Renderer::rendererEnded = false;
+	cullTreeMap = NULL;
+	objectCullSurfaceChange = 0;
+	unitCullStamp = 0;
 	shadowIntensity = 0;
 	shadowFrameSkip = 0;
 	triangleCount = 0;
@@ -257,6 +369,9 @@ Renderer::Renderer() : BaseRenderer(), saveScreenShotThreadAccessor(new Mutex(CO
 	}
 
 	if(GlobalStaticFlags::getIsNonGraphicalModeEnabled() == false) {
+		// game textures decode in the background while the techtree and tileset load
+		textureManager[rsGame]->setDecodeThreadCount(config.getInt("TextureDecodeThreads","3"));
+
 		static string mutexOwnerId = string(extractFileFromDirectoryPath(__FILE__).c_str()) + string("_") + intToStr(__LINE__);
 		saveScreenShotThread = new SimpleTaskThread(this,0,25);
 		saveScreenShotThread->setUniqueID(mutexOwnerId);
@@ -563,6 +678,9 @@ void Renderer::initGame(const Game *game, GameCamera *gameCamera) {
 	textureManager[rsGame]->init();
 	fontManager[rsGame]->init();
 
+	//textures loaded while the game runs are uploaded right away again
+	textureManager[rsGame]->setDecodeThreadCount(0);
+
 	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
 
 	init3dList();
@@ -755,6 +873,9 @@ void Renderer::endScenario() {
 
 	worldToScreenPosCache.clear();
 	ReleaseSurfaceVBOs();
+	mapRenderer.destroy();
+	cullTreeMap = NULL;
+	unitCullItems.clear();
 	mapSurfaceData.clear();
 }
 
@@ -776,6 +897,8 @@ void Renderer::endGame(bool isFinalEnd) {
 		abort();
 	}
 
+	InterpolationCache::getInstance().clear();
+
 	if(isFinalEnd) {
 		//delete resources
 		if(modelManager[rsGame] != NULL) {
@@ -810,7 +933,12 @@ void Renderer::endGame(bool isFinalEnd) {
 
 	worldToScreenPosCache.clear();
 	ReleaseSurfaceVBOs();
+	mapRenderer.destroy();
+	cullTreeMap = NULL;
+	unitCullItems.clear();
 	mapSurfaceData.clear();
+
+	textureManager[rsGame]->setDecodeThreadCount(config.getInt("TextureDecodeThreads","3"));
 }
 
 void Renderer::endMenu() {
@@ -1227,7 +1355,7 @@ bool Renderer::ExtractFrustum(VisibleQuadContainerCache &quadCacheItem) {
 //   }
 
    // Check the frustum cache
-   const bool useFrustumCache = Config::getInstance().getBool("EnableFrustrumCache","false");
+   const bool useFrustumCache = configEnableFrustrumCache.get();
    pair<vector<float>,vector<float> > lookupKey;
    if(useFrustumCache == true) {
 	   lookupKey = make_pair(proj,modl);
@@ -1743,8 +1871,7 @@ void Renderer::renderMouse3d() {
 		return;
 	}
 
-	Config &config= Config::getInstance();
-	if(config.getBool("RecordMode","false") == true) {
+	if(configRecordMode.get() == true) {
 		return;
 	}
 
@@ -2326,10 +2453,9 @@ void Renderer::renderClock() {
 		return;
 	}
 
-	Config &config= Config::getInstance();
-	if(config.getBool("InGameClock","true") == false &&
-		config.getBool("InGameLocalClock","true") == false &&
-		config.getBool("InGameFrameCounter","false") == false) {
+	if(configInGameClock.get() == false &&
+		configInGameLocalClock.get() == false &&
+		configInGameFrameCounter.get() == false) {
 		return;
 	}
 
@@ -2338,7 +2464,7 @@ void Renderer::renderClock() {
 	const World *world = game->getWorld();
 	const Vec4f fontColor = game->getGui()->getDisplay()->getColor();
 
-	if(config.getBool("InGameClock","true") == true) {
+	if(configInGameClock.get() == true) {
 		Lang &lang= Lang::getInstance();
 		char szBuf[501]="";
 
@@ -2353,7 +2479,7 @@ void Renderer::renderClock() {
 		str += szBuf;
 	}
 
-	if(config.getBool("InGameLocalClock","true") == true) {
+	if(configInGameLocalClock.get() == true) {
 		//time_t nowTime = time(NULL);
 		//struct tm *loctime = localtime(&nowTime);
 		struct tm loctime = threadsafe_localtime(systemtime_now());
@@ -2369,7 +2495,7 @@ void Renderer::renderClock() {
 		str += szBuf;
 	}
 
-	if(config.getBool("InGameFrameCounter","false") == true) {
+	if(configInGameFrameCounter.get() == true) {
 		char szBuf[200]="";
 		snprintf(szBuf,200,"Frame: %d",game->getWorld()->getFrameCount() / 20);
 		if(str != "") {
@@ -2400,7 +2526,6 @@ void Renderer::renderResourceStatus() {
 	}
 
 	const World *world		= game->getWorld();
-	Config &config= Config::getInstance();
 
 	if(world->getThisFactionIndex() < 0 ||
 		world->getThisFactionIndex() >= world->getFactionCount()) {
@@ -2427,7 +2552,7 @@ void Renderer::renderResourceStatus() {
 	bool renderSharedTeamUnits=false;
 	bool renderLocalFactionResources=false;
 
-	if(config.getBool("TwoLineTeamResourceRendering","false") == true) {
+	if(configTwoLineTeamResourceRendering.get() == true) {
 		if( sharedTeamResources == true || sharedTeamUnits == true){
 			twoRessourceLines=true;
 		}
@@ -2664,8 +2789,7 @@ void Renderer::renderSelectionQuad() {
 		return;
 	}
 
-	Config &config= Config::getInstance();
-	if(config.getBool("RecordMode","false") == true) {
+	if(configRecordMode.get() == true) {
 		return;
 	}
 
@@ -4379,6 +4503,210 @@ void Renderer::MapRenderer::Layer::render(VisibleQuadContainerCache &qCache) {
 //	}
 }
 
+void Renderer::MapRenderer::Layer::renderAll() {
+	glVertexPointer(3,GL_FLOAT,0,_bindVBO(vbo_vertices,vertices));
+	glNormalPointer(GL_FLOAT,0,_bindVBO(vbo_normals,normals));
+
+	glClientActiveTexture(Renderer::fowTexUnit);
+	glTexCoordPointer(2,GL_FLOAT,0,_bindVBO(vbo_fowTexCoords,fowTexCoords));
+
+	glClientActiveTexture(Renderer::baseTexUnit);
+	glBindTexture(GL_TEXTURE_2D,textureHandle);
+	glTexCoordPointer(2,GL_FLOAT,0,_bindVBO(vbo_surfTexCoords,surfTexCoords));
+
+	glDrawElements(GL_TRIANGLES,indexCount,GL_UNSIGNED_INT,_bindVBO(vbo_indices,indices,GL_ELEMENT_ARRAY_BUFFER_ARB));
+}
+
+const int Renderer::MapRenderer::chunkCells= 16;
+
+Renderer::MapRenderer::Chunk::~Chunk() {
+	while(layers.empty() == false) {
+		delete layers.back();
+		layers.pop_back();
+	}
+}
+
+void Renderer::MapRenderer::loadChunks(float coordStep) {
+	if(GlobalStaticFlags::getIsNonGraphicalModeEnabled() == true) {
+		return;
+	}
+
+	const int cellsW= map->getSurfaceW()-1;
+	const int cellsH= map->getSurfaceH()-1;
+	for(int y = 0; y < cellsH; y += chunkCells) {
+		for(int x = 0; x < cellsW; x += chunkCells) {
+			Chunk *chunk= new Chunk();
+			chunk->cells= Rect2i(x, y, min(x + chunkCells, cellsW), min(y + chunkCells, cellsH));
+			chunks.push_back(chunk);
+
+			loadChunk(chunk,coordStep);
+		}
+	}
+	surfaceChangeCount= map->getSurfaceChangeCount();
+
+	//printf("Terrain split into %d chunks\n",(int)chunks.size());
+}
+
+void Renderer::MapRenderer::loadChunk(Chunk *chunk,float coordStep) {
+	while(chunk->layers.empty() == false) {
+		delete chunk->layers.back();
+		chunk->layers.pop_back();
+	}
+	chunk->dirty= false;
+
+	const Vec3f &firstVertex= map->getSurfaceCell(chunk->cells.p[0])->getVertex();
+	chunk->boundsMin= firstVertex;
+	chunk->boundsMax= firstVertex;
+
+	for(int y = chunk->cells.p[0].y; y < chunk->cells.p[1].y; ++y) {
+		for(int x = chunk->cells.p[0].x; x < chunk->cells.p[1].x; ++x) {
+			SurfaceCell *tc[4] = {
+				map->getSurfaceCell(x,y),
+				map->getSurfaceCell(x+1,y),
+				map->getSurfaceCell(x,y+1),
+				map->getSurfaceCell(x+1,y+1)
+			};
+			int textureHandle = static_cast<const Texture2DGl*>(tc[0]->getSurfaceTexture())->getHandle();
+			Layer* layer = NULL;
+			for(Layers::iterator it= chunk->layers.begin(); it!= chunk->layers.end(); ++it) {
+				if((*it)->textureHandle == textureHandle) {
+					layer = *it;
+					break;
+				}
+			}
+			if(!layer) {
+				layer = new Layer(textureHandle);
+				layer->texturePath = static_cast<const Texture2DGl*>(tc[0]->getSurfaceTexture())->getPath();
+				chunk->layers.push_back(layer);
+			}
+
+			int index[4];
+			int loopIndexes[4] = { 2,0,3,1 };
+			for(int i=0; i < 4; i++) {
+				index[i] = (int)layer->vertices.size();
+				SurfaceCell *corner = tc[loopIndexes[i]];
+				const Vec3f &vertex= corner->getVertex();
+				layer->vertices.push_back(vertex);
+				layer->normals.push_back(corner->getNormal());
+				layer->fowTexCoords.push_back(corner->getFowTexCoord());
+
+				chunk->boundsMin.x= min(chunk->boundsMin.x, vertex.x);
+				chunk->boundsMin.y= min(chunk->boundsMin.y, vertex.y);
+				chunk->boundsMin.z= min(chunk->boundsMin.z, vertex.z);
+				chunk->boundsMax.x= max(chunk->boundsMax.x, vertex.x);
+				chunk->boundsMax.y= max(chunk->boundsMax.y, vertex.y);
+				chunk->boundsMax.z= max(chunk->boundsMax.z, vertex.z);
+			}
+
+			const Vec2f &surfCoord= tc[0]->getSurfTexCoord();
+			layer->surfTexCoords.push_back(Vec2f(surfCoord.x, surfCoord.y + coordStep));
+			layer->surfTexCoords.push_back(Vec2f(surfCoord.x, surfCoord.y));
+			layer->surfTexCoords.push_back(Vec2f(surfCoord.x+coordStep, surfCoord.y+coordStep));
+			layer->surfTexCoords.push_back(Vec2f(surfCoord.x+coordStep, surfCoord.y));
+
+			layer->indices.push_back(index[0]);
+			layer->indices.push_back(index[1]);
+			layer->indices.push_back(index[2]);
+			layer->indices.push_back(index[1]);
+			layer->indices.push_back(index[3]);
+			layer->indices.push_back(index[2]);
+		}
+	}
+
+	for(Layers::iterator it= chunk->layers.begin(); it!= chunk->layers.end(); ++it) {
+		Layer *layer= *it;
+		layer->load_vbos(true);
+
+		// the buffers hold the data now
+		std::vector<Vec3f>().swap(layer->vertices);
+		std::vector<Vec3f>().swap(layer->normals);
+		std::vector<Vec2f>().swap(layer->fowTexCoords);
+		std::vector<Vec2f>().swap(layer->surfTexCoords);
+		std::vector<GLuint>().swap(layer->indices);
+	}
+}
+
+void Renderer::MapRenderer::updateChangedChunks(float coordStep) {
+	if(map->getSurfaceChangesSince(surfaceChangeCount,surfaceChanges) == false) {
+		// more changes than the map remembers, rebuild everything
+		for(Chunks::iterator it= chunks.begin(); it!= chunks.end(); ++it) {
+			(*it)->dirty= true;
+		}
+	}
+	for(unsigned int i = 0; i < surfaceChanges.size(); ++i) {
+		// the changed vertices are corners of the cells left of and above them too
+		const Rect2i &area= surfaceChanges[i];
+		for(Chunks::iterator it= chunks.begin(); it!= chunks.end(); ++it) {
+			Chunk *chunk= *it;
+			if(	chunk->cells.p[0].x <= area.p[1].x && chunk->cells.p[1].x >= area.p[0].x &&
+				chunk->cells.p[0].y <= area.p[1].y && chunk->cells.p[1].y >= area.p[0].y) {
+				chunk->dirty= true;
+			}
+		}
+	}
+
+	for(Chunks::iterator it= chunks.begin(); it!= chunks.end(); ++it) {
+		if((*it)->dirty == true) {
+			loadChunk(*it,coordStep);
+		}
+	}
+	surfaceChangeCount= map->getSurfaceChangeCount();
+}
+
+void Renderer::MapRenderer::renderChunks(const Map* map,float coordStep,VisibleQuadContainerCache &qCache,
+		int &triangleCount,int &pointCount) {
+	if(GlobalStaticFlags::getIsNonGraphicalModeEnabled() == true) {
+		return;
+	}
+
+	if(map != this->map) {
+		destroy(); // clear any previous map data
+		this->map = map;
+		loadChunks(coordStep);
+	}
+	else if(map->getSurfaceChangeCount() != surfaceChangeCount) {
+		updateChangedChunks(coordStep);
+	}
+
+	Quad2i scaledQuad= qCache.lastVisibleQuad / Map::cellScale;
+	const Rect2i visibleCells= scaledQuad.computeBoundingRect();
+
+	glClientActiveTexture(fowTexUnit);
+	glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+	glClientActiveTexture(baseTexUnit);
+	glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+	glEnableClientState(GL_VERTEX_ARRAY);
+	glEnableClientState(GL_NORMAL_ARRAY);
+	for(Chunks::iterator it= chunks.begin(); it!= chunks.end(); ++it) {
+		Chunk *chunk= *it;
+		if(	chunk->cells.p[1].x <= visibleCells.p[0].x || chunk->cells.p[0].x > visibleCells.p[1].x ||
+			chunk->cells.p[1].y <= visibleCells.p[0].y || chunk->cells.p[0].y > visibleCells.p[1].y) {
+			continue;
+		}
+		if(VisibleQuadContainerCache::enableFrustumCalcs == true &&
+			LooseQuadTree::boxInFrustum(qCache.frustumData, chunk->boundsMin, chunk->boundsMax) == false) {
+			continue;
+		}
+
+		for(Layers::iterator layer= chunk->layers.begin(); layer!= chunk->layers.end(); ++layer) {
+			(*layer)->renderAll();
+			triangleCount+= (*layer)->indexCount / 3;
+			pointCount+= (*layer)->indexCount * 2 / 3;
+		}
+	}
+	glDisableClientState(GL_VERTEX_ARRAY);
+	glBindBuffer(GL_ARRAY_BUFFER_ARB,0);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER_ARB,0);
+	glDisableClientState(GL_NORMAL_ARRAY);
+	glClientActiveTexture(fowTexUnit);
+	glBindTexture(GL_TEXTURE_2D,0);
+	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+	glClientActiveTexture(baseTexUnit);
+	glBindTexture(GL_TEXTURE_2D,0);
+	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+	assertGl();
+}
+
 void Renderer::MapRenderer::renderVisibleLayers(const Map* map,float coordStep,VisibleQuadContainerCache &qCache) {
 	if(GlobalStaticFlags::getIsNonGraphicalModeEnabled() == true) {
 		return;
@@ -4460,6 +4788,11 @@ void Renderer::MapRenderer::destroy() {
 		delete layers.back();
 		layers.pop_back();
 	}
+	while(chunks.empty() == false) {
+		delete chunks.back();
+		chunks.pop_back();
+	}
+	surfaceChangeCount = 0;
 	map = NULL;
 }
 
@@ -4524,7 +4857,12 @@ void Renderer::renderSurface(const int renderFps) {
 	if(useVBORendering == true) {
 		VisibleQuadContainerCache &qCache = getQuadCache();
 		//mapRenderer.render(map,coordStep,qCache);
-		mapRenderer.renderVisibleLayers(map,coordStep,qCache);
+		if(configTerrainChunks.get() == true) {
+			mapRenderer.renderChunks(map,coordStep,qCache,triangleCount,pointCount);
+		}
+		else {
+			mapRenderer.renderVisibleLayers(map,coordStep,qCache);
+		}
 	}
 	else if(qCache.visibleScaledCellList.empty() == false) {
 
@@ -4895,8 +5233,7 @@ void Renderer::renderObjects(const int renderFps) {
 	const World *world= game->getWorld();
 	//const Map *map= world->getMap();
 
-	Config &config= Config::getInstance();
-	int tilesetObjectsToAnimate=config.getInt("AnimatedTilesetObjects","-1");
+	int tilesetObjectsToAnimate=configAnimatedTilesetObjects.get();
 
     assertGl();
 
@@ -4908,17 +5245,30 @@ void Renderer::renderObjects(const int renderFps) {
 
 	VisibleQuadContainerCache &qCache = getQuadCache();
 
-	//	for(int visibleIndex = 0;
-	//			visibleIndex < qCache.visibleObjectList.size(); ++visibleIndex) {
-	// render from last to first object so animated objects which are on bottom of screen are
-	// rendered first which looks better for limited number of animated tileset objects
+	// walk from last to first object so animated objects which are on bottom of screen
+	// get the limited number of animated tileset objects
+	renderQueueAnimProgress.resize(qCache.visibleObjectList.size());
 	for(int visibleIndex = (int)qCache.visibleObjectList.size()-1;
 			visibleIndex >= 0 ; --visibleIndex) {
 		Object *o = qCache.visibleObjectList[visibleIndex];
 
-		Model *objModel= o->getModelPtr();
-		//objModel->updateInterpolationData(o->getAnimProgress(), true);
-		const Vec3f v= o->getConstPos();
+		float animProgress = 0.f;
+		if (tilesetObjectsToAnimate == -1) {
+			animProgress = o->getAnimProgress();
+		} else if (tilesetObjectsToAnimate > 0 && o->isAnimated()) {
+			tilesetObjectsToAnimate--;
+			animProgress = o->getAnimProgress();
+		}
+		renderQueueAnimProgress[visibleIndex] = animProgress;
+	}
+
+	// draw the objects sorted by model
+	renderQueue.build(ObjectRenderQueueSource(qCache.visibleObjectList, renderQueueAnimProgress, fowTexPixmap));
+	renderQueue.sort();
+
+	for(int itemIndex = 0; itemIndex < renderQueue.getItemCount(); ++itemIndex) {
+		const RenderQueueItem &item = renderQueue.getItem(itemIndex);
+		Model *objModel= item.model;
 
 		if(modelRenderStarted == false) {
 			modelRenderStarted = true;
@@ -4943,38 +5293,21 @@ void Renderer::renderObjects(const int renderFps) {
 			modelRenderer->begin(true, true, false, false);
 		}
 		//ambient and diffuse color is taken from cell color
-
-		float fowFactor= fowTexPixmap->getPixelf(o->getMapPos().x / Map::cellScale, o->getMapPos().y / Map::cellScale);
-		Vec4f color= Vec4f(Vec3f(fowFactor), 1.f);
-		glColor4fv(color.ptr());
-		glMaterialfv(GL_FRONT_AND_BACK, GL_AMBIENT, (color * ambFactor).ptr());
-		glFogfv(GL_FOG_COLOR, (baseFogColor * fowFactor).ptr());
+		glColor4fv(item.color.ptr());
+		glMaterialfv(GL_FRONT_AND_BACK, GL_AMBIENT, (item.color * ambFactor).ptr());
+		glFogfv(GL_FOG_COLOR, (baseFogColor * item.color.x).ptr());
 
 		glMatrixMode(GL_MODELVIEW);
 		glPushMatrix();
-		glTranslatef(v.x, v.y, v.z);
-		glRotatef(o->getRotation(), 0.f, 1.f, 0.f);
+		glTranslatef(item.position.x, item.position.y, item.position.z);
+		glRotatef(item.rotation.y, 0.f, 1.f, 0.f);
 
 		//We use OpenGL Lights so no manual action is needed here. In fact this call did bad things on lighting big rocks for example
 		//		if(o->getRotation() != 0.0) {
 		//			setupLightingForRotatedModel();
 		//		}
 
-		//objModel->updateInterpolationData(0.f, true);
-		//if(this->gameCamera->getPos().dist(o->getPos()) <= SKIP_INTERPOLATION_DISTANCE) {
-
-
-		if (tilesetObjectsToAnimate == -1) {
-			objModel->updateInterpolationData(o->getAnimProgress(), true);
-		} else if (tilesetObjectsToAnimate > 0 && o->isAnimated()) {
-			tilesetObjectsToAnimate--;
-			objModel->updateInterpolationData(o->getAnimProgress(), true);
-		} else {
-			objModel->updateInterpolationData(0, true);
-		}
-
-//		objModel->updateInterpolationData(o->getAnimProgress(), true);
-		//}
+		objModel->updateInterpolationData(item.animProgress, true);
 		modelRenderer->render(objModel);
 
 		triangleCount+= objModel->getTriangleCount();
@@ -5326,16 +5659,47 @@ void Renderer::renderUnits(bool airUnits, const int renderFps) {
 	}
 
 	VisibleQuadContainerCache &qCache = getQuadCache();
+
+	// ground units render first, interpolate the frames of all visible
+	// units (ground and air) in parallel before drawing any of them
+	InterpolationCache &interpolationCache= InterpolationCache::getInstance();
+	if(airUnits == false && interpolationCache.isEnabled() == true) {
+		interpolationCache.nextFrame();
+		for(int visibleUnitIndex = 0;
+				visibleUnitIndex < (int)qCache.visibleQuadUnitList.size(); ++visibleUnitIndex) {
+			Unit *unit = qCache.visibleQuadUnitList[visibleUnitIndex];
+			interpolationCache.queue(unit->getCurrentModelPtr(), unit->getAnimProgressAsFloat(),
+					unit->isAlive() && !unit->isAnimProgressBound());
+		}
+		interpolationCache.fillQueued();
+	}
+
 	if(qCache.visibleQuadUnitList.empty() == false) {
-		bool modelRenderStarted = false;
+		// pick the models of this pass in visible order, the build threads only read them
+		renderQueueModels.resize(qCache.visibleQuadUnitList.size());
 		for(int visibleUnitIndex = 0;
 				visibleUnitIndex < (int)qCache.visibleQuadUnitList.size(); ++visibleUnitIndex) {
 			Unit *unit = qCache.visibleQuadUnitList[visibleUnitIndex];
 
 			if(( airUnits==false && unit->getType()->getField()==fAir) || ( airUnits==true && unit->getType()->getField()!=fAir)){
-				continue;
+				renderQueueModels[visibleUnitIndex] = NULL;
+			}
+			else {
+				renderQueueModels[visibleUnitIndex] = unit->getCurrentModelPtr();
 			}
-			meshCallbackTeamColor.setTeamTexture(unit->getFaction()->getTexture());
+		}
+
+		// draw the units sorted by team texture and model
+		renderQueue.build(UnitRenderQueueSource(qCache.visibleQuadUnitList, renderQueueModels));
+		renderQueue.sort();
+
+		const bool batching = configBatchedUnitRendering.get();
+
+		bool modelRenderStarted = false;
+		for(int itemIndex = 0; itemIndex < renderQueue.getItemCount(); ) {
+			const RenderQueueItem &item = renderQueue.getItem(itemIndex);
+
+			meshCallbackTeamColor.setTeamTexture(item.teamTexture);
 
 			if(modelRenderStarted == false) {
 				modelRenderStarted = true;
@@ -5359,30 +5723,38 @@ void Renderer::renderUnits(bool airUnits, const int renderFps) {
 				modelRenderer->begin(true, true, true, false, &meshCallbackTeamColor);
 			}
 
-			glMatrixMode(GL_MODELVIEW);
-			glPushMatrix();
-
-			//translate
-			Vec3f currVec= unit->getCurrVectorFlat();
-			glTranslatef(currVec.x, currVec.y, currVec.z);
-
-			//rotate
-			float zrot=unit->getRotationZ();
-			float xrot=unit->getRotationX();
-			if(zrot!=.0f){
-				glRotatef(zrot, 0.f, 0.f, 1.f);
-			}
-			if(xrot!=.0f){
-				glRotatef(xrot, 1.f, 0.f, 0.f);
+			//render
+			Model *model= item.model;
+			model->updateInterpolationData(item.animProgress, item.cycleAnimation);
+
+			// the following items with the same model, team texture and
+			// interpolated frame are drawn in one batch with this one, the
+			// state key sorts them next to each other by frame step
+			int batchCount = 1;
+			if(batching == true && item.faded == false &&
+				getSharedModelFrame(model, renderQueueFrame) == true) {
+				for(; itemIndex + batchCount < renderQueue.getItemCount(); ++batchCount) {
+					const RenderQueueItem &nextItem = renderQueue.getItem(itemIndex + batchCount);
+					if(nextItem.stateKey != item.stateKey) {
+						break;
+					}
+					model->updateInterpolationData(nextItem.animProgress, nextItem.cycleAnimation);
+					if(getSharedModelFrame(model, renderQueueNextFrame) == false ||
+						renderQueueNextFrame != renderQueueFrame) {
+						break;
+					}
+				}
+				if(itemIndex + batchCount < renderQueue.getItemCount() &&
+					renderQueue.getItem(itemIndex + batchCount).stateKey == item.stateKey) {
+					// the item that ended the batch changed the frame
+					model->updateInterpolationData(item.animProgress, item.cycleAnimation);
+				}
 			}
-			glRotatef(unit->getRotation(), 0.f, 1.f, 0.f);
 
 			//dead alpha
-			const SkillType *st= unit->getCurrSkill();
-			if(st->getClass() == scDie && static_cast<const DieSkillType*>(st)->getFade()) {
-				float alpha= 1.0f - unit->getAnimProgressAsFloat();
+			if(item.faded == true) {
 				glDisable(GL_COLOR_MATERIAL);
-				glMaterialfv(GL_FRONT_AND_BACK, GL_AMBIENT_AND_DIFFUSE, Vec4f(1.0f, 1.0f, 1.0f, alpha).ptr());
+				glMaterialfv(GL_FRONT_AND_BACK, GL_AMBIENT_AND_DIFFUSE, item.color.ptr());
 			}
 			else {
 				glEnable(GL_COLOR_MATERIAL);
@@ -5390,28 +5762,53 @@ void Renderer::renderUnits(bool airUnits, const int renderFps) {
 				glAlphaFunc(GL_GREATER, 0.02f);
 			}
 
-			//render
-			Model *model= unit->getCurrentModelPtr();
-			//printf("Rendering model [%d - %s]\n[%s]\nCamera [%s]\nDistance: %f\n",unit->getId(),unit->getType()->getName().c_str(),unit->getCurrVector().getString().c_str(),this->gameCamera->getPos().getString().c_str(),this->gameCamera->getPos().dist(unit->getCurrVector()));
+			glMatrixMode(GL_MODELVIEW);
+			if(batchCount > 1) {
+				renderQueuePlacements.resize(batchCount);
+				for(int batchIndex = 0; batchIndex < batchCount; ++batchIndex) {
+					const RenderQueueItem &batchItem = renderQueue.getItem(itemIndex + batchIndex);
+					renderQueuePlacements[batchIndex] = ModelPlacement(batchItem.position, batchItem.rotation);
+				}
+				static_cast<ModelRendererGl*>(modelRenderer)->renderBatch(model, &renderQueuePlacements[0], batchCount);
+			}
+			else {
+				glPushMatrix();
 
-			//if(this->gameCamera->getPos().dist(unit->getCurrVector()) <= SKIP_INTERPOLATION_DISTANCE) {
-				model->updateInterpolationData(unit->getAnimProgressAsFloat(), unit->isAlive() && !unit->isAnimProgressBound());
-			//}
+				//translate
+				const Vec3f &currVec= item.position;
+				glTranslatef(currVec.x, currVec.y, currVec.z);
 
-			modelRenderer->render(model);
-			triangleCount+= model->getTriangleCount();
-			pointCount+= model->getVertexCount();
+				//rotate
+				if(item.rotation.z != .0f){
+					glRotatef(item.rotation.z, 0.f, 0.f, 1.f);
+				}
+				if(item.rotation.x != .0f){
+					glRotatef(item.rotation.x, 1.f, 0.f, 0.f);
+				}
+				glRotatef(item.rotation.y, 0.f, 1.f, 0.f);
 
-			glPopMatrix();
-			unit->setVisible(true);
+				modelRenderer->render(model);
 
-			if(	showDebugUI == true &&
-				(showDebugUILevel & debugui_unit_titles) == debugui_unit_titles) {
+				glPopMatrix();
+			}
+
+			for(int batchIndex = 0; batchIndex < batchCount; ++batchIndex) {
+				const RenderQueueItem &batchItem = renderQueue.getItem(itemIndex + batchIndex);
+				Unit *unit = qCache.visibleQuadUnitList[batchItem.sourceIndex];
+
+				triangleCount+= model->getTriangleCount();
+				pointCount+= model->getVertexCount();
+				unit->setVisible(true);
+
+				if(	showDebugUI == true &&
+					(showDebugUILevel & debugui_unit_titles) == debugui_unit_titles) {
 
-				unit->setScreenPos(computeScreenPosition(currVec));
-				visibleFrameUnitList.push_back(unit);
-				visibleFrameUnitListCameraKey = game->getGameCamera()->getCameraMovementKey();
+					unit->setScreenPos(computeScreenPosition(batchItem.position));
+					visibleFrameUnitList.push_back(unit);
+					visibleFrameUnitListCameraKey = game->getGameCamera()->getCameraMovementKey();
+				}
 			}
+			itemIndex += batchCount;
 		}
 
 		if(modelRenderStarted == true) {
@@ -5564,8 +5961,7 @@ void Renderer::renderSelectionEffects(int healthbarMode) {
 		return;
 	}
 
-	Config &config= Config::getInstance();
-	if(config.getBool("RecordMode","false") == true) {
+	if(configRecordMode.get() == true) {
 		return;
 	}
 
@@ -5798,12 +6194,11 @@ void Renderer::renderHealthBars(int healthbarMode){
 		return;
 	}
 
-	Config &config= Config::getInstance();
-	if(config.getBool("RecordMode","false") == true) {
+	if(configRecordMode.get() == true) {
 		return;
 	}
 
-	if(config.getBool("PhotoMode")) {
+	if(configPhotoMode.get()) {
 		return;
 	}
 
@@ -6245,7 +6640,7 @@ void Renderer::renderMinimap(){
 	VisibleQuadContainerCache &qCache = getQuadCache();
 	std::vector<Unit *> visibleUnitList = qCache.visibleUnitList;
 
-	const bool showAllUnitsInMinimap = Config::getInstance().getBool("DebugGameSynchUI","false");
+	const bool showAllUnitsInMinimap = configDebugGameSynchUI.get();
 	if(showAllUnitsInMinimap == true) {
 		visibleUnitList.clear();
 
@@ -7682,6 +8077,18 @@ void Renderer::loadConfig() {
 			textureManager[i]->setFilter(textureFilter);
 			textureManager[i]->setMaxAnisotropy(maxAnisotropy);
 		}
+
+		//shared unit animation frames
+		InterpolationCache &interpolationCache= InterpolationCache::getInstance();
+		interpolationCache.setTimeSteps(config.getInt("InterpolationCacheSteps","8"));
+		interpolationCache.setThreadCount(config.getInt("InterpolationCacheThreads","2"));
+
+		renderQueue.setBuildThreadCount(config.getInt("RenderQueueThreads","2"));
+	}
+
+	//particle updates of the game, observers still run on this thread
+	if(particleManager[rsGame] != NULL) {
+		particleManager[rsGame]->setUpdateThreadCount(config.getInt("ParticleUpdateThreads","2"));
 	}
 }
 
@@ -8716,8 +9123,7 @@ void Renderer::renderArrow(const Vec3f &pos1, const Vec3f &pos2,
 		return;
 	}
 
-	Config &config= Config::getInstance();
-	if(config.getBool("RecordMode","false") == true) {
+	if(configRecordMode.get() == true) {
 		return;
 	}
 
@@ -9162,16 +9568,21 @@ VisibleQuadContainerCache & Renderer::getQuadCache(	bool updateOnDirtyFrame,
 			worldToScreenPosCache.clear();
 			//}
 
+			if(VisibleQuadContainerCache::enableFrustumCalcs == true) {
+				updateCullTrees(world);
+			}
+
 			// Unit calculations
+			int unitCullIndex = 0;
 			for(int i = 0; i < world->getFactionCount(); ++i) {
 				const Faction *faction = world->getFaction(i);
-				for(int j = 0; j < faction->getUnitCount(); ++j) {
+				for(int j = 0; j < faction->getUnitCount(); ++j, ++unitCullIndex) {
 					Unit *unit= faction->getUnit(j);
 
 					bool unitCheckedForRender = false;
 					if(VisibleQuadContainerCache::enableFrustumCalcs == true) {
 						//bool insideQuad 	= PointInFrustum(quadCache.frustumData, unit->getCurrVector().x, unit->getCurrVector().y, unit->getCurrVector().z );
-						bool insideQuad 	= CubeInFrustum(quadCache.frustumData, unit->getCurrMidHeightVector().x, unit->getCurrMidHeightVector().y, unit->getCurrMidHeightVector().z, unit->getType()->getRenderSize());
+						bool insideQuad 	= (unitInFrustum[unitCullOrder[unitCullIndex]] != 0);
 						bool renderInMap 	= world->toRenderUnit(unit);
 						if(insideQuad == false || renderInMap == false) {
 							unit->setVisible(false);
@@ -9257,43 +9668,63 @@ VisibleQuadContainerCache & Renderer::getQuadCache(	bool updateOnDirtyFrame,
 				}
 				quadCache.clearNonVolatileCacheData();
 
-				//int loops1=0;
-				PosQuadIterator pqi(map,visibleQuad, Map::cellScale);
-				while(pqi.next()) {
-					const Vec2i &pos= pqi.getPos();
-					if(map->isInside(pos)) {
-						//loops1++;
-						const Vec2i &mapPos = Map::toSurfCoords(pos);
-
-						//quadCache.visibleCellList.push_back(mapPos);
-
-						SurfaceCell *sc = map->getSurfaceCell(mapPos);
+				if(VisibleQuadContainerCache::enableFrustumCalcs == true) {
+					const bool showWorld = world->showWorldForPlayer(world->getThisFactionIndex());
+					objectCullTree.cull(quadCache.frustumData, cullResult);
+					for(int cullIndex = 0; cullIndex < (int)cullResult.size(); ++cullIndex) {
+						// objects are looked up in their cell, harvested ones are gone
+						SurfaceCell *sc = static_cast<SurfaceCell *>(objectCullTree.getUserData(cullResult[cullIndex]));
 						Object *o = sc->getObject();
-
-						if(VisibleQuadContainerCache::enableFrustumCalcs == true) {
-							if(o != NULL) {
-								//bool insideQuad 	= PointInFrustum(quadCache.frustumData, o->getPos().x, o->getPos().y, o->getPos().z );
-								bool insideQuad 	= CubeInFrustum(quadCache.frustumData, o->getPos().x, o->getPos().y, o->getPos().z, 1);
-								if(insideQuad == false) {
-									o->setVisible(false);
-									continue;
-								}
-							}
+						if(o == NULL) {
+							continue;
+						}
+						const Vec3f &objectPos = objectCullTree.getCenter(cullResult[cullIndex]);
+						if(visibleQuad.isInside(Vec2i((int)objectPos.x, (int)objectPos.z)) == false) {
+							o->setVisible(false);
+							continue;
 						}
 
-                        bool cellExplored = world->showWorldForPlayer(world->getThisFactionIndex());
-                        if(cellExplored == false) {
-                            cellExplored = sc->isExplored(world->getThisTeamIndex());
-                        }
-
-						bool isExplored = (cellExplored == true && o != NULL);
-						//bool isVisible = (sc->isVisible(world->getThisTeamIndex()) && o != NULL);
-						bool isVisible = true;
-
-						if(isExplored == true && isVisible == true) {
+						bool cellExplored = showWorld;
+						if(cellExplored == false) {
+							cellExplored = sc->isExplored(world->getThisTeamIndex());
+						}
+						if(cellExplored == true) {
 							quadCache.visibleObjectList.push_back(o);
 							o->setVisible(true);
 						}
+						else {
+							o->setVisible(false);
+						}
+					}
+				}
+				else {
+					//int loops1=0;
+					PosQuadIterator pqi(map,visibleQuad, Map::cellScale);
+					while(pqi.next()) {
+						const Vec2i &pos= pqi.getPos();
+						if(map->isInside(pos)) {
+							//loops1++;
+							const Vec2i &mapPos = Map::toSurfCoords(pos);
+
+							//quadCache.visibleCellList.push_back(mapPos);
+
+							SurfaceCell *sc = map->getSurfaceCell(mapPos);
+							Object *o = sc->getObject();
+
+	                        bool cellExplored = world->showWorldForPlayer(world->getThisFactionIndex());
+	                        if(cellExplored == false) {
+	                            cellExplored = sc->isExplored(world->getThisTeamIndex());
+	                        }
+
+							bool isExplored = (cellExplored == true && o != NULL);
+							//bool isVisible = (sc->isVisible(world->getThisTeamIndex()) && o != NULL);
+							bool isVisible = true;
+
+							if(isExplored == true && isVisible == true) {
+								quadCache.visibleObjectList.push_back(o);
+								o->setVisible(true);
+							}
+						}
 					}
 				}
 
@@ -9374,6 +9805,116 @@ VisibleQuadContainerCache & Renderer::getQuadCache(	bool updateOnDirtyFrame,
 	return quadCache;
 }
 
+void Renderer::updateCullTrees(const World *world) {
+	const Map *map= world->getMap();
+	if(map != cullTreeMap) {
+		// only the cells of the tileset objects are kept so harvested
+		// objects are never referenced after being deleted
+		const float treeSize= (float)max(map->getW(), map->getH());
+		objectCullTree.init(Vec2f(0.f), treeSize, 7);
+		objectCullItems.assign(map->getSurfaceW() * map->getSurfaceH(), -1);
+		for(int y = 0; y < map->getSurfaceH(); ++y) {
+			for(int x = 0; x < map->getSurfaceW(); ++x) {
+				SurfaceCell *sc= map->getSurfaceCell(x, y);
+				Object *o= sc->getObject();
+				if(o != NULL) {
+					objectCullItems[y * map->getSurfaceW() + x]=
+						objectCullTree.addItem(sc, o->getPos(), 1.f);
+					// only objects in the visible object list are shown, the
+					// ones left visible by a saved game would keep their
+					// particles running off screen
+					if(o->isVisible() == true) {
+						o->setVisible(false);
+					}
+				}
+			}
+		}
+		objectCullSurfaceChange= map->getSurfaceChangeCount();
+
+		unitCullTree.init(Vec2f(0.f), treeSize, 7);
+		unitCullItems.clear();
+		unitCullItemStamps.clear();
+		cullTreeMap= map;
+	}
+	else if(map->getSurfaceChangeCount() != objectCullSurfaceChange) {
+		// the terrain under some objects changed height
+		if(map->getSurfaceChangesSince(objectCullSurfaceChange, objectCullSurfaceChanges) == false) {
+			objectCullSurfaceChanges.assign(1, Rect2i(0, 0, map->getSurfaceW() - 1, map->getSurfaceH() - 1));
+		}
+		for(unsigned int i = 0; i < objectCullSurfaceChanges.size(); ++i) {
+			updateObjectCullItems(map, objectCullSurfaceChanges[i]);
+		}
+		objectCullSurfaceChange= map->getSurfaceChangeCount();
+	}
+
+	// units only change node when they walk out of their current one
+	unitCullStamp++;
+	unitCullOrder.clear();
+	for(int i = 0; i < world->getFactionCount(); ++i) {
+		const Faction *faction = world->getFaction(i);
+		for(int j = 0; j < faction->getUnitCount(); ++j) {
+			Unit *unit= faction->getUnit(j);
+			const Vec3f center= unit->getCurrMidHeightVector();
+			const float radius= unit->getType()->getRenderSize();
+
+			// the item of a unit is stale when the tree was rebuilt
+			int item= unit->getCullTreeItem();
+			if(item < 0 || item >= (int)unitCullItemStamps.size() ||
+				unitCullTree.getUserData(item) != unit) {
+				item= unitCullTree.addItem(unit, center, radius);
+				unit->setCullTreeItem(item);
+				unitCullItems.push_back(item);
+			}
+			else {
+				unitCullTree.moveItem(item, center, radius);
+			}
+			if(item >= (int)unitCullItemStamps.size()) {
+				unitCullItemStamps.resize(item + 1, 0);
+			}
+			unitCullItemStamps[item]= unitCullStamp;
+			unitCullOrder.push_back(item);
+		}
+	}
+	// items of deleted units, their unit is never dereferenced
+	for(unsigned int i = 0; i < unitCullItems.size();) {
+		const int item= unitCullItems[i];
+		if(unitCullItemStamps[item] != unitCullStamp) {
+			unitCullTree.removeItem(item);
+			unitCullItems[i]= unitCullItems.back();
+			unitCullItems.pop_back();
+		}
+		else {
+			++i;
+		}
+	}
+
+	unitCullTree.cull(quadCache.frustumData, cullResult);
+	unitInFrustum.assign(unitCullItemStamps.size(), 0);
+	for(int i = 0; i < (int)cullResult.size(); ++i) {
+		unitInFrustum[cullResult[i]]= 1;
+	}
+}
+
+void Renderer::updateObjectCullItems(const Map *map, const Rect2i &area) {
+	const int x0= max(area.p[0].x, 0);
+	const int y0= max(area.p[0].y, 0);
+	const int x1= min(area.p[1].x, map->getSurfaceW() - 1);
+	const int y1= min(area.p[1].y, map->getSurfaceH() - 1);
+	for(int y = y0; y <= y1; ++y) {
+		for(int x = x0; x <= x1; ++x) {
+			const int item= objectCullItems[y * map->getSurfaceW() + x];
+			const SurfaceCell *sc= map->getSurfaceCell(x, y);
+			const Object *o= sc->getObject();
+			if(item >= 0 && o != NULL) {
+				// objects are drawn where they were placed, grow the bounds
+				// to the new terrain height so the cell stays covered too
+				const float heightChange= std::fabs(sc->getHeight() - o->getPos().y);
+				objectCullTree.moveItem(item, o->getPos(), 1.f + heightChange);
+			}
+		}
+	}
+}
+
 void Renderer::updateMarkedCellScreenPosQuadCache(Vec2i pos) {
 	const World *world= game->getWorld();
 	const Map *map= world->getMap();
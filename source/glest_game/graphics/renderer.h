@@ -37,6 +37,8 @@
 #include "graphics_interface.h"
 #include "base_renderer.h"
 #include "simple_threads.h"
+#include "render_queue.h"
+#include "loose_quadtree.h"
 #include "video_player.h"
 
 #ifdef DEBUG_RENDERING_ENABLED
@@ -316,6 +318,30 @@ private:
 	std::vector<Unit *> visibleFrameUnitList;
 	string visibleFrameUnitListCameraKey;
 
+	//state sorted units and objects of the frame
+	RenderQueue renderQueue;
+	std::vector<Model *> renderQueueModels;
+	std::vector<float> renderQueueAnimProgress;
+	std::vector<const Vec3f *> renderQueueFrame;
+	std::vector<const Vec3f *> renderQueueNextFrame;
+	std::vector< ::Shared::Graphics::Gl::ModelPlacement> renderQueuePlacements;
+
+	//frustum culling of the tileset objects and units
+	const Map *cullTreeMap;
+	LooseQuadTree objectCullTree;
+	// the item of the object on each surface cell, -1 for none
+	std::vector<int> objectCullItems;
+	uint32 objectCullSurfaceChange;
+	std::vector<Rect2i> objectCullSurfaceChanges;
+	LooseQuadTree unitCullTree;
+	// the items of unitCullTree, each unit keeps its own item index
+	std::vector<int> unitCullItems;
+	std::vector<int> unitCullItemStamps;
+	int unitCullStamp;
+	std::vector<int> unitCullOrder;
+	std::vector<char> unitInFrustum;
+	std::vector<int> cullResult;
+
 	bool no2DMouseRendering;
 	bool showDebugUI;
 	int showDebugUILevel;
@@ -360,14 +386,21 @@ private:
 	
 	class MapRenderer {
 	public:
-		inline MapRenderer(): map(NULL) {}
+		inline MapRenderer(): map(NULL), surfaceChangeCount(0) {}
 		inline ~MapRenderer() { destroy(); }
 		void render(const Map* map,float coordStep,VisibleQuadContainerCache &qCache);
 		void renderVisibleLayers(const Map* map,float coordStep,VisibleQuadContainerCache &qCache);
+		void renderChunks(const Map* map,float coordStep,VisibleQuadContainerCache &qCache,
+				int &triangleCount,int &pointCount);
 		void destroy();
 	private:
+		struct Chunk;
+
 		void load(float coordStep);
 		void loadVisibleLayers(float coordStep,VisibleQuadContainerCache &qCache);
+		void loadChunks(float coordStep);
+		void loadChunk(Chunk *chunk,float coordStep);
+		void updateChangedChunks(float coordStep);
 
 		const Map* map;
 		struct Layer {
@@ -406,6 +439,7 @@ private:
 			void load_vbos(bool vboEnabled);
 			void render(VisibleQuadContainerCache &qCache);
 			void renderVisibleLayer();
+			void renderAll();
 
 			std::vector<Vec3f> vertices, normals;
 			std::vector<Vec2f> fowTexCoords, surfTexCoords;
@@ -424,6 +458,24 @@ private:
 		typedef std::vector<Layer*> Layers;
 		Layers layers;
 		Quad2i lastVisibleQuad;
+
+		// a square of surface cells with one layer per texture,
+		// built once and culled as a whole
+		struct Chunk {
+			inline Chunk(): dirty(false) {}
+			~Chunk();
+
+			// surface cells from p[0] up to, but not including, p[1]
+			Rect2i cells;
+			Vec3f boundsMin, boundsMax;
+			Layers layers;
+			bool dirty;
+		};
+		typedef std::vector<Chunk*> Chunks;
+		static const int chunkCells;
+		Chunks chunks;
+		uint32 surfaceChangeCount;
+		std::vector<Rect2i> surfaceChanges;
 	} mapRenderer;
 
 	bool ExtractFrustum(VisibleQuadContainerCache &quadCacheItem);
@@ -632,6 +684,8 @@ public:
 	std::pair<bool,Vec3f> posInCellQuadCache(Vec2i pos);
 	//Vec3f getMarkedCellScreenPosQuadCache(Vec2i pos);
 	void updateMarkedCellScreenPosQuadCache(Vec2i pos);
+	void updateCullTrees(const World *world);
+	void updateObjectCullItems(const Map *map, const Rect2i &area);
 	void forceQuadCacheUpdate();
 	void renderVisibleMarkedCells(bool renderTextHint=false,int x=-1, int y=-1);
 	void renderMarkedCellsOnMinimap();
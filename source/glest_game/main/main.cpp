@@ -56,6 +56,7 @@
 #include <locale.h>
 #include "string_utils.h"
 #include "auto_test.h"
+#include "fast_forward.h"
 #include "lua_script.h"
 #include "interpolation.h"
 #include "common_scoped_ptr.h"
@@ -6024,6 +6025,62 @@ namespace
       return return_value;
     }
 
+    int
+    handleConvertReplayCommand (int argc, char **argv)
+    {
+      int
+        foundParamIndIndex = -1;
+      hasCommandArgument (argc, argv,
+                          string (GAME_ARGS[GAME_ARG_CONVERT_REPLAY]) +
+                          string ("="), &foundParamIndIndex);
+      if (foundParamIndIndex < 0)
+      {
+        hasCommandArgument (argc, argv,
+                            string (GAME_ARGS[GAME_ARG_CONVERT_REPLAY]),
+                            &foundParamIndIndex);
+      }
+      string
+        paramValue = argv[foundParamIndIndex];
+      vector < string > paramPartTokens;
+      Tokenize (paramValue, paramPartTokens, "=");
+      if (paramPartTokens.size () < 2 || paramPartTokens[1].length () == 0)
+      {
+        printf
+          ("\nInvalid missing replay file specified on commandline [%s]\n\n",
+           argv[foundParamIndIndex]);
+        return 1;
+      }
+
+      string
+        replayFile = paramPartTokens[1];
+      string
+        outputFile = replayFile;
+      if (paramPartTokens.size () >= 3 && paramPartTokens[2].length () > 0)
+      {
+        outputFile = paramPartTokens[2];
+      }
+      if (fileExists (replayFile) == false)
+      {
+        printf ("Replay file [%s] was NOT FOUND\n", replayFile.c_str ());
+        return 1;
+      }
+      if (Replay::isBinaryReplay (replayFile) == true)
+      {
+        printf ("Replay file [%s] is already in the binary format\n",
+                replayFile.c_str ());
+        return 0;
+      }
+
+      Replay
+        replay;
+      replay.loadXml (replayFile);
+      replay.save (outputFile);
+      printf ("Converted replay [%s] with %d commands to [%s]\n",
+              replayFile.c_str (), replay.getCommandCount (),
+              outputFile.c_str ());
+      return 0;
+    }
+
     int
     handleListDataCommand (int argc, char **argv)
     {
@@ -6611,6 +6668,14 @@ namespace
         }
       }
 
+      if (hasCommandArgument
+          (argc, argv, string (GAME_ARGS[GAME_ARG_FAST_FORWARD])) == true)
+      {
+        GlobalStaticFlags::setIsNonGraphicalModeEnabled (true);
+        disableheadless_console = true;
+        FastForward::setEnabled (true);
+      }
+
       if (hasCommandArgument (argc, argv, GAME_ARGS[GAME_ARG_SERVER_TITLE]) ==
           true)
       {
@@ -7353,7 +7418,10 @@ namespace
             || hasCommandArgument (argc, argv,
                                    string (GAME_ARGS
                                            [GAME_ARG_MASTERSERVER_MODE])) ==
-            true)
+            true
+            || hasCommandArgument (argc, argv,
+                                   string (GAME_ARGS
+                                           [GAME_ARG_FAST_FORWARD])) == true)
         {
           config.setString ("FactorySound", "None", true);
           if (hasCommandArgument
@@ -7804,6 +7872,32 @@ namespace
             printf ("**INFO** Disabling Interpolation\n");
         }
 
+        if (hasCommandArgument
+            (argc, argv,
+             string (GAME_ARGS[GAME_ARG_REPLAY_START_FRAME])) == true)
+        {
+          int
+            foundParamIndIndex = -1;
+          hasCommandArgument (argc, argv,
+                              string (GAME_ARGS[GAME_ARG_REPLAY_START_FRAME])
+                              + string ("="), &foundParamIndIndex);
+          if (foundParamIndIndex >= 0)
+          {
+            string
+              paramValue = argv[foundParamIndIndex];
+            vector < string > paramPartTokens;
+            Tokenize (paramValue, paramPartTokens, "=");
+            if (paramPartTokens.size () >= 2
+                && paramPartTokens[1].length () > 0)
+            {
+              int
+                startFrame = strToInt (paramPartTokens[1]);
+              printf ("Starting replays at frame [%d]\n", startFrame);
+              Game::setReplayStartFrame (startFrame);
+            }
+          }
+        }
+
 
         if (config.getBool ("EnableVSynch", "false") == true)
         {
@@ -8112,6 +8206,12 @@ namespace
           return handleShowCRCValuesCommand (argc, argv);
         }
 
+        if (hasCommandArgument
+            (argc, argv, GAME_ARGS[GAME_ARG_CONVERT_REPLAY]) == true)
+        {
+          return handleConvertReplayCommand (argc, argv);
+        }
+
         if (hasCommandArgument (argc, argv, GAME_ARGS[GAME_ARG_LIST_MAPS]) ==
             true
             || hasCommandArgument (argc, argv,
@@ -8208,6 +8308,47 @@ namespace
           program->initServer (mainWindow, false, true);
           gameInitialized = true;
         }
+        else
+          if (hasCommandArgument
+              (argc, argv,
+               string (GAME_ARGS[GAME_ARG_FAST_FORWARD])) == true)
+        {
+          string
+            fileName = "";
+          int
+            foundParamIndIndex = -1;
+          hasCommandArgument (argc, argv,
+                              string (GAME_ARGS[GAME_ARG_FAST_FORWARD]) +
+                              string ("="), &foundParamIndIndex);
+          if (foundParamIndIndex >= 0)
+          {
+            string
+              paramValue = argv[foundParamIndIndex];
+            vector < string > paramPartTokens;
+            Tokenize (paramValue, paramPartTokens, "=");
+            if (paramPartTokens.size () >= 2
+                && paramPartTokens[1].length () > 0)
+            {
+              vector < string > paramPartTokens2;
+              Tokenize (paramPartTokens[1], paramPartTokens2, ",");
+              if (paramPartTokens2.empty () == false)
+              {
+                fileName = paramPartTokens2[0];
+              }
+              if (paramPartTokens2.size () >= 2
+                  && paramPartTokens2[1].length () > 0)
+              {
+                int
+                  maxFrames = strToInt (paramPartTokens2[1]);
+                printf ("Forcing maximum frames to [%d]\n", maxFrames);
+                FastForward::setMaxFrames (maxFrames);
+              }
+            }
+          }
+          Program::setWantShutdownApplicationAfterGame (true);
+          program->initFastForward (mainWindow, fileName);
+          gameInitialized = true;
+        }
         else
           if (hasCommandArgument
               (argc, argv,
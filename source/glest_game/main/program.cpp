@@ -39,6 +39,7 @@
 #include "menu_state_custom_game.h"
 #include "menu_state_join_game.h"
 #include "menu_state_scenario.h"
+#include "fast_forward.h"
 #include "leak_dumper.h"
 
 using namespace
@@ -70,6 +71,9 @@ namespace Glest
     const char *
       ProgramState::MAIN_PROGRAM_RENDER_KEY = "MEGAGLEST.RENDER";
 
+    // read on every loop
+    static ConfigValue < bool > configShowPerfStats ("ShowPerfStats", "false");
+
 // =====================================================
 //      class Program::CrashProgramState
 // =====================================================
@@ -355,6 +359,19 @@ namespace Glest
       Game::loadGame (saveGameFile, this, masterserverMode);
     }
 
+    void
+    Program::initFastForward (WindowGl * window, string file)
+    {
+      init (window);
+      MainMenu *
+        mainMenu = new MainMenu (this);
+      setState (mainMenu);
+
+      printf ("Fast forwarding [%s]\n", file.c_str ());
+
+      FastForward::startGame (this, file);
+    }
+
     void
     Program::initServer (WindowGl * window, bool autostart,
                          bool openNetworkSlots, bool masterserverMode)
@@ -621,9 +638,7 @@ namespace Glest
 
       Chrono chronoPerformanceCounts;
 
-      bool
-        showPerfStats =
-        Config::getInstance ().getBool ("ShowPerfStats", "false");
+      bool showPerfStats = configShowPerfStats.get ();
       Chrono chronoPerf;
       char
         perfBuf[8096] = "";
@@ -708,7 +723,7 @@ namespace Glest
       programState->addPerformanceCount (ProgramState::
                                          MAIN_PROGRAM_RENDER_KEY,
                                          chronoPerformanceCounts.
-                                         getMillis ());
+                                         getMicros ());
 
       if (showPerfStats)
       {
@@ -723,10 +738,10 @@ namespace Glest
           getSystemSettingType (SystemFlags::debugPerformance).enabled
           && chrono.getMillis () > 0)
         SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                  "In [%s::%s] Line: %d programState->render took msecs: %lld ==============> MAIN LOOP RENDERING\n",
+                                  "In [%s::%s] Line: %d programState->render took usecs: %lld ==============> MAIN LOOP RENDERING\n",
                                   extractFileFromDirectoryPath
                                   (__FILE__).c_str (), __FUNCTION__, __LINE__,
-                                  chrono.getMillis ());
+                                  chrono.getMicros ());
       if (SystemFlags::
           getSystemSettingType (SystemFlags::debugPerformance).enabled
           && chrono.getMillis () > 0)
@@ -746,7 +761,7 @@ namespace Glest
       }
 
       programState->addPerformanceCount ("programState->updateCamera()",
-                                         chronoPerformanceCounts.getMillis
+                                         chronoPerformanceCounts.getMicros
                                          ());
 
       if (showPerfStats)
@@ -763,10 +778,10 @@ namespace Glest
           getSystemSettingType (SystemFlags::debugPerformance).enabled
           && chrono.getMillis () > 0)
         SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                  "In [%s::%s] Line: %d programState->render took msecs: %lld ==============> MAIN LOOP CAMERA UPDATING\n",
+                                  "In [%s::%s] Line: %d programState->render took usecs: %lld ==============> MAIN LOOP CAMERA UPDATING\n",
                                   extractFileFromDirectoryPath
                                   (__FILE__).c_str (), __FUNCTION__, __LINE__,
-                                  chrono.getMillis ());
+                                  chrono.getMicros ());
       if (SystemFlags::
           getSystemSettingType (SystemFlags::debugPerformance).enabled
           && chrono.getMillis () > 0)
@@ -780,7 +795,11 @@ namespace Glest
 #endif
       int
         updateCount = 0;
-      while (prevState == this->programState && updateTimer.isTime ())
+      // fast forward runs the updates without waiting for the update timer
+      const bool fastForward = FastForward::isEnabled ();
+      while (prevState == this->programState &&
+             (fastForward == true ? updateCount < FastForward::updatesPerLoop :
+              updateTimer.isTime ()))
       {
         Chrono chronoUpdateLoop;
 
@@ -808,10 +827,10 @@ namespace Glest
             getSystemSettingType (SystemFlags::debugPerformance).enabled
             && chronoUpdateLoop.getMillis () > 0)
           SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                    "In [%s::%s Line: %d] programState->update took msecs: %lld, updateCount = %d\n",
+                                    "In [%s::%s Line: %d] programState->update took usecs: %lld, updateCount = %d\n",
                                     extractFileFromDirectoryPath
                                     (__FILE__).c_str (), __FUNCTION__,
-                                    __LINE__, chronoUpdateLoop.getMillis (),
+                                    __LINE__, chronoUpdateLoop.getMicros (),
                                     updateCount);
         if (SystemFlags::
             getSystemSettingType (SystemFlags::debugPerformance).enabled
@@ -860,11 +879,11 @@ namespace Glest
                 (SystemFlags::debugPerformance).enabled
                 && chronoUpdateLoop.getMillis () > 0)
               SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                        "In [%s::%s Line: %d] SoundRenderer::getInstance().update() took msecs: %lld, updateCount = %d\n",
+                                        "In [%s::%s Line: %d] SoundRenderer::getInstance().update() took usecs: %lld, updateCount = %d\n",
                                         extractFileFromDirectoryPath
                                         (__FILE__).c_str (), __FUNCTION__,
                                         __LINE__,
-                                        chronoUpdateLoop.getMillis (),
+                                        chronoUpdateLoop.getMicros (),
                                         updateCount);
             if (SystemFlags::getSystemSettingType
                 (SystemFlags::debugPerformance).enabled
@@ -876,7 +895,7 @@ namespace Glest
 
           programState->addPerformanceCount
             ("SoundRenderer::getInstance().update()",
-             chronoPerformanceCounts.getMillis ());
+             chronoPerformanceCounts.getMicros ());
 
           if (showPerfStats)
           {
@@ -895,16 +914,16 @@ namespace Glest
 
           programState->addPerformanceCount
             ("NetworkManager::getInstance().update()",
-             chronoPerformanceCounts.getMillis ());
+             chronoPerformanceCounts.getMicros ());
 #ifdef DEBUG
           if (SystemFlags::getSystemSettingType
               (SystemFlags::debugPerformance).enabled
               && chronoUpdateLoop.getMillis () > 0)
             SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                      "In [%s::%s Line: %d] NetworkManager::getInstance().update() took msecs: %lld, updateCount = %d\n",
+                                      "In [%s::%s Line: %d] NetworkManager::getInstance().update() took usecs: %lld, updateCount = %d\n",
                                       extractFileFromDirectoryPath
                                       (__FILE__).c_str (), __FUNCTION__,
-                                      __LINE__, chronoUpdateLoop.getMillis (),
+                                      __LINE__, chronoUpdateLoop.getMicros (),
                                       updateCount);
           if (SystemFlags::getSystemSettingType
               (SystemFlags::debugPerformance).enabled
@@ -932,10 +951,10 @@ namespace Glest
           getSystemSettingType (SystemFlags::debugPerformance).enabled
           && chrono.getMillis () > 0)
         SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                  "In [%s::%s] Line: %d AFTER programState->update took msecs: %lld ==============> MAIN LOOP BODY LOGIC, updateCount = %d\n",
+                                  "In [%s::%s] Line: %d AFTER programState->update took usecs: %lld ==============> MAIN LOOP BODY LOGIC, updateCount = %d\n",
                                   extractFileFromDirectoryPath
                                   (__FILE__).c_str (), __FUNCTION__, __LINE__,
-                                  chrono.getMillis (), updateCount);
+                                  chrono.getMicros (), updateCount);
       if (SystemFlags::
           getSystemSettingType (SystemFlags::debugPerformance).enabled
           && chrono.getMillis () > 0)
@@ -968,7 +987,7 @@ namespace Glest
         }
 
         programState->addPerformanceCount ("programState->tick()",
-                                           chronoPerformanceCounts.getMillis
+                                           chronoPerformanceCounts.getMicros
                                            ());
 
         if (showPerfStats)
@@ -984,10 +1003,10 @@ namespace Glest
             getSystemSettingType (SystemFlags::debugPerformance).enabled
             && chrono.getMillis () > 0)
           SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                    "In [%s::%s] Line: %d programState->render took msecs: %lld ==============> MAIN LOOP TICKING\n",
+                                    "In [%s::%s] Line: %d programState->render took usecs: %lld ==============> MAIN LOOP TICKING\n",
                                     extractFileFromDirectoryPath
                                     (__FILE__).c_str (), __FUNCTION__,
-                                    __LINE__, chrono.getMillis ());
+                                    __LINE__, chrono.getMicros ());
         if (SystemFlags::
             getSystemSettingType (SystemFlags::debugPerformance).enabled
             && chrono.getMillis () > 0)
@@ -1013,10 +1032,10 @@ namespace Glest
       if (SystemFlags::
           getSystemSettingType (SystemFlags::debugPerformance).enabled)
         SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                  "In [%s::%s Line: %d] ------------------------------- MAIN LOOP END, stats: loop took msecs: %lld -------------------------------\n",
+                                  "In [%s::%s Line: %d] ------------------------------- MAIN LOOP END, stats: loop took usecs: %lld -------------------------------\n",
                                   extractFileFromDirectoryPath
                                   (__FILE__).c_str (), __FUNCTION__, __LINE__,
-                                  chronoLoop.getMillis ());
+                                  chronoLoop.getMicros ());
 #endif
     }
 
@@ -411,6 +411,8 @@ namespace Glest
       initSavedGame (WindowGl * window, bool masterserverMode =
                      false, string saveGameFile = "");
       void
+      initFastForward (WindowGl * window, string file);
+      void
       initClient (WindowGl * window, const Ip & serverIp, int portNumber =
                   -1);
       void
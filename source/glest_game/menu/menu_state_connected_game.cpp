@@ -39,6 +39,7 @@
 #include "cache_manager.h"
 #include "string_utils.h"
 #include "map_preview.h"
+#include "map_index.h"
 #include <iterator>
 #include "compression_utils.h"
 
@@ -184,6 +185,10 @@ namespace Glest
         config.getString ("NetPlayerName", Socket::getHostName ().c_str ());
       enableFactionTexturePreview = config.getBool ("FactionPreview", "true");
       enableMapPreview = config.getBool ("MapPreview", "true");
+      // list and preview maps from the map index, refreshing changed maps
+      // in the background
+      MapIndex::getInstance ().startRefresh (config.getPathListForType (ptMaps,
+                                                                         ""));
 
       enableScenarioTexturePreview =
         Config::getInstance ().getBool ("EnableScenarioTexturePreview",
@@ -1109,6 +1114,8 @@ namespace Glest
 
     MenuStateConnectedGame::~MenuStateConnectedGame ()
     {
+      MapIndex::getInstance ().stopRefresh ();
+
       if (launchingNewGame == false)
       {
         disconnectFromServer ();
@@ -1311,37 +1318,27 @@ namespace Glest
       Config & config = Config::getInstance ();
       vector < string > mappaths = config.getPathListForType (ptMaps, "");
       string result = "";
-      if (mappaths.empty () == false)
+      // the user data folder comes first
+      for (int idx = (int) mappaths.size () - 1; idx >= 0; --idx)
       {
-        Checksum checksum;
-        string itemPath = mappaths[1] + "/" + mapName;
+        string itemPath = mappaths[idx];
+        endPathWithSlash (itemPath);
+        itemPath += mapName;
         if (fileExists (itemPath))
         {
-          checksum.addFile (itemPath);
-          uint32 crc = checksum.getSum ();
-          result = uIntToStr (crc);
-//printf("itemPath='%s' modinfo.name='%s' remote crc:'%s'  local crc:'%s'   crc='%d' \n",itemPath.c_str(),modinfo.name.c_str(),modinfo.crc.c_str(),modinfo.localCRC.c_str(),crc);
-        }
-        else
-        {
-          itemPath = mappaths[0] + "/" + mapName;
-          if (fileExists (itemPath))
+          // the map index has the checksum unless the file changed since
+          // it was refreshed
+          uint32 crc = 0;
+          if (MapIndex::getInstance ().getMapCRC (itemPath, crc) == false)
           {
+            Checksum checksum;
             checksum.addFile (itemPath);
-            uint32 crc = checksum.getSum ();
-            result = uIntToStr (crc);
-//printf("itemPath='%s' modinfo.name='%s' remote crc:'%s'  local crc:'%s'   crc='%d' \n",itemPath.c_str(),modinfo.name.c_str(),modinfo.crc.c_str(),modinfo.localCRC.c_str(),crc);
-          }
-          else
-          {
-            result = "";
+            crc = checksum.getSum ();
           }
+          result = uIntToStr (crc);
+          break;
         }
       }
-      else
-      {
-        result = "";
-      }
       return result;
     }
 
@@ -4478,10 +4475,10 @@ namespace Glest
             getSystemSettingType (SystemFlags::debugPerformance).enabled
             && chrono.getMillis () > 0)
           SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                    "In [%s::%s Line: %d] took msecs: %lld\n",
+                                    "In [%s::%s Line: %d] took usecs: %lld\n",
                                     extractFileFromDirectoryPath
                                     (__FILE__).c_str (), __FUNCTION__,
-                                    __LINE__, chrono.getMillis ());
+                                    __LINE__, chrono.getMicros ());
         if (SystemFlags::
             getSystemSettingType (SystemFlags::debugPerformance).enabled
             && chrono.getMillis () > 0)
@@ -4615,10 +4612,10 @@ namespace Glest
             getSystemSettingType (SystemFlags::debugPerformance).enabled
             && chrono.getMillis () > 0)
           SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                    "In [%s::%s Line: %d] took msecs: %lld\n",
+                                    "In [%s::%s Line: %d] took usecs: %lld\n",
                                     extractFileFromDirectoryPath
                                     (__FILE__).c_str (), __FUNCTION__,
-                                    __LINE__, chrono.getMillis ());
+                                    __LINE__, chrono.getMicros ());
         if (SystemFlags::
             getSystemSettingType (SystemFlags::debugPerformance).enabled
             && chrono.getMillis () > 0)
@@ -4668,10 +4665,10 @@ namespace Glest
                 (SystemFlags::debugPerformance).enabled
                 && chrono.getMillis () > 0)
               SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                        "In [%s::%s Line: %d] took msecs: %lld\n",
+                                        "In [%s::%s Line: %d] took usecs: %lld\n",
                                         extractFileFromDirectoryPath
                                         (__FILE__).c_str (), __FUNCTION__,
-                                        __LINE__, chrono.getMillis ());
+                                        __LINE__, chrono.getMicros ());
             if (SystemFlags::getSystemSettingType
                 (SystemFlags::debugPerformance).enabled
                 && chrono.getMillis () > 0)
@@ -4683,10 +4680,10 @@ namespace Glest
                 (SystemFlags::debugPerformance).enabled
                 && chrono.getMillis () > 0)
               SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                        "In [%s::%s Line: %d] took msecs: %lld\n",
+                                        "In [%s::%s Line: %d] took usecs: %lld\n",
                                         extractFileFromDirectoryPath
                                         (__FILE__).c_str (), __FUNCTION__,
-                                        __LINE__, chrono.getMillis ());
+                                        __LINE__, chrono.getMicros ());
             if (SystemFlags::getSystemSettingType
                 (SystemFlags::debugPerformance).enabled
                 && chrono.getMillis () > 0)
@@ -4744,10 +4741,10 @@ namespace Glest
             getSystemSettingType (SystemFlags::debugPerformance).enabled
             && chrono.getMillis () > 0)
           SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                    "In [%s::%s Line: %d] took msecs: %lld\n",
+                                    "In [%s::%s Line: %d] took usecs: %lld\n",
                                     extractFileFromDirectoryPath
                                     (__FILE__).c_str (), __FUNCTION__,
-                                    __LINE__, chrono.getMillis ());
+                                    __LINE__, chrono.getMicros ());
         if (SystemFlags::
             getSystemSettingType (SystemFlags::debugPerformance).enabled
             && chrono.getMillis () > 0)
@@ -4770,10 +4767,10 @@ namespace Glest
               (SystemFlags::debugPerformance).enabled
               && chrono.getMillis () > 0)
             SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                      "In [%s::%s Line: %d] took msecs: %lld\n",
+                                      "In [%s::%s Line: %d] took usecs: %lld\n",
                                       extractFileFromDirectoryPath
                                       (__FILE__).c_str (), __FUNCTION__,
-                                      __LINE__, chrono.getMillis ());
+                                      __LINE__, chrono.getMicros ());
           if (SystemFlags::getSystemSettingType
               (SystemFlags::debugPerformance).enabled
               && chrono.getMillis () > 0)
@@ -4825,10 +4822,10 @@ namespace Glest
                 (SystemFlags::debugPerformance).enabled
                 && chrono.getMillis () > 0)
               SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                        "In [%s::%s Line: %d] took msecs: %lld\n",
+                                        "In [%s::%s Line: %d] took usecs: %lld\n",
                                         extractFileFromDirectoryPath
                                         (__FILE__).c_str (), __FUNCTION__,
-                                        __LINE__, chrono.getMillis ());
+                                        __LINE__, chrono.getMicros ());
             if (SystemFlags::getSystemSettingType
                 (SystemFlags::debugPerformance).enabled
                 && chrono.getMillis () > 0)
@@ -4893,10 +4890,10 @@ namespace Glest
                   (SystemFlags::debugPerformance).enabled
                   && chrono.getMillis () > 0)
                 SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                          "In [%s::%s Line: %d] took msecs: %lld\n",
+                                          "In [%s::%s Line: %d] took usecs: %lld\n",
                                           extractFileFromDirectoryPath
                                           (__FILE__).c_str (), __FUNCTION__,
-                                          __LINE__, chrono.getMillis ());
+                                          __LINE__, chrono.getMicros ());
               if (SystemFlags::getSystemSettingType
                   (SystemFlags::debugPerformance).enabled
                   && chrono.getMillis () > 0)
@@ -4913,10 +4910,10 @@ namespace Glest
                   (SystemFlags::debugPerformance).enabled
                   && chrono.getMillis () > 0)
                 SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                          "In [%s::%s Line: %d] took msecs: %lld\n",
+                                          "In [%s::%s Line: %d] took usecs: %lld\n",
                                           extractFileFromDirectoryPath
                                           (__FILE__).c_str (), __FUNCTION__,
-                                          __LINE__, chrono.getMillis ());
+                                          __LINE__, chrono.getMicros ());
               if (SystemFlags::getSystemSettingType
                   (SystemFlags::debugPerformance).enabled
                   && chrono.getMillis () > 0)
@@ -5008,10 +5005,10 @@ namespace Glest
                   (SystemFlags::debugPerformance).enabled
                   && chrono.getMillis () > 0)
                 SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                          "In [%s::%s Line: %d] took msecs: %lld\n",
+                                          "In [%s::%s Line: %d] took usecs: %lld\n",
                                           extractFileFromDirectoryPath
                                           (__FILE__).c_str (), __FUNCTION__,
-                                          __LINE__, chrono.getMillis ());
+                                          __LINE__, chrono.getMicros ());
               if (SystemFlags::getSystemSettingType
                   (SystemFlags::debugPerformance).enabled
                   && chrono.getMillis () > 0)
@@ -5023,10 +5020,10 @@ namespace Glest
                 (SystemFlags::debugPerformance).enabled
                 && chrono.getMillis () > 0)
               SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                        "In [%s::%s Line: %d] took msecs: %lld\n",
+                                        "In [%s::%s Line: %d] took usecs: %lld\n",
                                         extractFileFromDirectoryPath
                                         (__FILE__).c_str (), __FUNCTION__,
-                                        __LINE__, chrono.getMillis ());
+                                        __LINE__, chrono.getMicros ());
             if (SystemFlags::getSystemSettingType
                 (SystemFlags::debugPerformance).enabled
                 && chrono.getMillis () > 0)
@@ -5056,10 +5053,10 @@ namespace Glest
                 (SystemFlags::debugPerformance).enabled
                 && chrono.getMillis () > 0)
               SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                        "In [%s::%s Line: %d] took msecs: %lld\n",
+                                        "In [%s::%s Line: %d] took usecs: %lld\n",
                                         extractFileFromDirectoryPath
                                         (__FILE__).c_str (), __FUNCTION__,
-                                        __LINE__, chrono.getMillis ());
+                                        __LINE__, chrono.getMicros ());
             if (SystemFlags::getSystemSettingType
                 (SystemFlags::debugPerformance).enabled
                 && chrono.getMillis () > 0)
@@ -5198,11 +5195,11 @@ namespace Glest
                       (SystemFlags::debugPerformance).enabled
                       && chrono.getMillis () > 0)
                     SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                              "In [%s::%s Line: %d] took msecs: %lld\n",
+                                              "In [%s::%s Line: %d] took usecs: %lld\n",
                                               extractFileFromDirectoryPath
                                               (__FILE__).c_str (),
                                               __FUNCTION__, __LINE__,
-                                              chrono.getMillis ());
+                                              chrono.getMicros ());
                   if (SystemFlags::getSystemSettingType
                       (SystemFlags::debugPerformance).enabled
                       && chrono.getMillis () > 0)
@@ -5423,11 +5420,11 @@ namespace Glest
                       (SystemFlags::debugPerformance).enabled
                       && chrono.getMillis () > 0)
                     SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                              "In [%s::%s Line: %d] took msecs: %lld\n",
+                                              "In [%s::%s Line: %d] took usecs: %lld\n",
                                               extractFileFromDirectoryPath
                                               (__FILE__).c_str (),
                                               __FUNCTION__, __LINE__,
-                                              chrono.getMillis ());
+                                              chrono.getMicros ());
                   if (SystemFlags::getSystemSettingType
                       (SystemFlags::debugPerformance).enabled
                       && chrono.getMillis () > 0)
@@ -5448,10 +5445,10 @@ namespace Glest
               (SystemFlags::debugPerformance).enabled
               && chrono.getMillis () > 0)
             SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                      "In [%s::%s Line: %d] took msecs: %lld\n",
+                                      "In [%s::%s Line: %d] took usecs: %lld\n",
                                       extractFileFromDirectoryPath
                                       (__FILE__).c_str (), __FUNCTION__,
-                                      __LINE__, chrono.getMillis ());
+                                      __LINE__, chrono.getMicros ());
           if (SystemFlags::getSystemSettingType
               (SystemFlags::debugPerformance).enabled
               && chrono.getMillis () > 0)
@@ -5483,10 +5480,10 @@ namespace Glest
                 (SystemFlags::debugPerformance).enabled
                 && chrono.getMillis () > 0)
               SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                        "In [%s::%s Line: %d] took msecs: %lld\n",
+                                        "In [%s::%s Line: %d] took usecs: %lld\n",
                                         extractFileFromDirectoryPath
                                         (__FILE__).c_str (), __FUNCTION__,
-                                        __LINE__, chrono.getMillis ());
+                                        __LINE__, chrono.getMicros ());
             if (SystemFlags::getSystemSettingType
                 (SystemFlags::debugPerformance).enabled
                 && chrono.getMillis () > 0)
@@ -5512,10 +5509,10 @@ namespace Glest
                 (SystemFlags::debugPerformance).enabled
                 && chrono.getMillis () > 0)
               SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                        "In [%s::%s Line: %d] took msecs: %lld\n",
+                                        "In [%s::%s Line: %d] took usecs: %lld\n",
                                         extractFileFromDirectoryPath
                                         (__FILE__).c_str (), __FUNCTION__,
-                                        __LINE__, chrono.getMillis ());
+                                        __LINE__, chrono.getMicros ());
             if (SystemFlags::getSystemSettingType
                 (SystemFlags::debugPerformance).enabled
                 && chrono.getMillis () > 0)
@@ -5569,10 +5566,10 @@ namespace Glest
                 (SystemFlags::debugPerformance).enabled
                 && chrono.getMillis () > 0)
               SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                        "In [%s::%s Line: %d] took msecs: %lld\n",
+                                        "In [%s::%s Line: %d] took usecs: %lld\n",
                                         extractFileFromDirectoryPath
                                         (__FILE__).c_str (), __FUNCTION__,
-                                        __LINE__, chrono.getMillis ());
+                                        __LINE__, chrono.getMicros ());
             if (SystemFlags::getSystemSettingType
                 (SystemFlags::debugPerformance).enabled
                 && chrono.getMillis () > 0)
@@ -5594,10 +5591,10 @@ namespace Glest
               (SystemFlags::debugPerformance).enabled
               && chrono.getMillis () > 0)
             SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                      "In [%s::%s Line: %d] took msecs: %lld\n",
+                                      "In [%s::%s Line: %d] took usecs: %lld\n",
                                       extractFileFromDirectoryPath
                                       (__FILE__).c_str (), __FUNCTION__,
-                                      __LINE__, chrono.getMillis ());
+                                      __LINE__, chrono.getMicros ());
           if (SystemFlags::getSystemSettingType
               (SystemFlags::debugPerformance).enabled
               && chrono.getMillis () > 0)
@@ -5617,10 +5614,10 @@ namespace Glest
               (SystemFlags::debugPerformance).enabled
               && chrono.getMillis () > 0)
             SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                      "In [%s::%s Line: %d] took msecs: %lld\n",
+                                      "In [%s::%s Line: %d] took usecs: %lld\n",
                                       extractFileFromDirectoryPath
                                       (__FILE__).c_str (), __FUNCTION__,
-                                      __LINE__, chrono.getMillis ());
+                                      __LINE__, chrono.getMicros ());
           if (SystemFlags::getSystemSettingType
               (SystemFlags::debugPerformance).enabled
               && chrono.getMillis () > 0)
@@ -5658,10 +5655,10 @@ namespace Glest
             getSystemSettingType (SystemFlags::debugPerformance).enabled
             && chrono.getMillis () > 0)
           SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                    "In [%s::%s Line: %d] took msecs: %lld\n",
+                                    "In [%s::%s Line: %d] took usecs: %lld\n",
                                     extractFileFromDirectoryPath
                                     (__FILE__).c_str (), __FUNCTION__,
-                                    __LINE__, chrono.getMillis ());
+                                    __LINE__, chrono.getMicros ());
         if (SystemFlags::
             getSystemSettingType (SystemFlags::debugPerformance).enabled
             && chrono.getMillis () > 0)
@@ -5694,10 +5691,10 @@ namespace Glest
             getSystemSettingType (SystemFlags::debugPerformance).enabled
             && chrono.getMillis () > 0)
           SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                    "In [%s::%s Line: %d] took msecs: %lld\n",
+                                    "In [%s::%s Line: %d] took usecs: %lld\n",
                                     extractFileFromDirectoryPath
                                     (__FILE__).c_str (), __FUNCTION__,
-                                    __LINE__, chrono.getMillis ());
+                                    __LINE__, chrono.getMicros ());
         if (SystemFlags::
             getSystemSettingType (SystemFlags::debugPerformance).enabled
             && chrono.getMillis () > 0)
@@ -5718,10 +5715,10 @@ namespace Glest
           getSystemSettingType (SystemFlags::debugPerformance).enabled
           && chrono.getMillis () > 0)
         SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                  "In [%s::%s Line: %d] took msecs: %lld\n",
+                                  "In [%s::%s Line: %d] took usecs: %lld\n",
                                   extractFileFromDirectoryPath
                                   (__FILE__).c_str (), __FUNCTION__, __LINE__,
-                                  chrono.getMillis ());
+                                  chrono.getMicros ());
       if (SystemFlags::
           getSystemSettingType (SystemFlags::debugPerformance).enabled
           && chrono.getMillis () > 0)
@@ -5734,10 +5731,10 @@ namespace Glest
             getSystemSettingType (SystemFlags::debugPerformance).enabled
             && chrono.getMillis () > 0)
           SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                    "In [%s::%s Line: %d] took msecs: %lld\n",
+                                    "In [%s::%s Line: %d] took usecs: %lld\n",
                                     extractFileFromDirectoryPath
                                     (__FILE__).c_str (), __FUNCTION__,
-                                    __LINE__, chrono.getMillis ());
+                                    __LINE__, chrono.getMicros ());
         if (SystemFlags::
             getSystemSettingType (SystemFlags::debugPerformance).enabled
             && chrono.getMillis () > 0)
@@ -5763,10 +5760,10 @@ namespace Glest
                 (SystemFlags::debugPerformance).enabled
                 && chrono.getMillis () > 0)
               SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                        "In [%s::%s Line: %d] took msecs: %lld\n",
+                                        "In [%s::%s Line: %d] took usecs: %lld\n",
                                         extractFileFromDirectoryPath
                                         (__FILE__).c_str (), __FUNCTION__,
-                                        __LINE__, chrono.getMillis ());
+                                        __LINE__, chrono.getMicros ());
             if (SystemFlags::getSystemSettingType
                 (SystemFlags::debugPerformance).enabled
                 && chrono.getMillis () > 0)
@@ -5785,10 +5782,10 @@ namespace Glest
                   (SystemFlags::debugPerformance).enabled
                   && chrono.getMillis () > 0)
                 SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                          "In [%s::%s Line: %d] took msecs: %lld\n",
+                                          "In [%s::%s Line: %d] took usecs: %lld\n",
                                           extractFileFromDirectoryPath
                                           (__FILE__).c_str (), __FUNCTION__,
-                                          __LINE__, chrono.getMillis ());
+                                          __LINE__, chrono.getMicros ());
               if (SystemFlags::getSystemSettingType
                   (SystemFlags::debugPerformance).enabled
                   && chrono.getMillis () > 0)
@@ -5876,10 +5873,10 @@ namespace Glest
                   (SystemFlags::debugPerformance).enabled
                   && chrono.getMillis () > 0)
                 SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                          "In [%s::%s Line: %d] took msecs: %lld\n",
+                                          "In [%s::%s Line: %d] took usecs: %lld\n",
                                           extractFileFromDirectoryPath
                                           (__FILE__).c_str (), __FUNCTION__,
-                                          __LINE__, chrono.getMillis ());
+                                          __LINE__, chrono.getMicros ());
               if (SystemFlags::getSystemSettingType
                   (SystemFlags::debugPerformance).enabled
                   && chrono.getMillis () > 0)
@@ -5895,10 +5892,10 @@ namespace Glest
                   (SystemFlags::debugPerformance).enabled
                   && chrono.getMillis () > 0)
                 SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                          "In [%s::%s Line: %d] took msecs: %lld\n",
+                                          "In [%s::%s Line: %d] took usecs: %lld\n",
                                           extractFileFromDirectoryPath
                                           (__FILE__).c_str (), __FUNCTION__,
-                                          __LINE__, chrono.getMillis ());
+                                          __LINE__, chrono.getMicros ());
               if (SystemFlags::getSystemSettingType
                   (SystemFlags::debugPerformance).enabled
                   && chrono.getMillis () > 0)
@@ -5912,10 +5909,10 @@ namespace Glest
                 (SystemFlags::debugPerformance).enabled
                 && chrono.getMillis () > 0)
               SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                        "In [%s::%s Line: %d] took msecs: %lld\n",
+                                        "In [%s::%s Line: %d] took usecs: %lld\n",
                                         extractFileFromDirectoryPath
                                         (__FILE__).c_str (), __FUNCTION__,
-                                        __LINE__, chrono.getMillis ());
+                                        __LINE__, chrono.getMicros ());
             if (SystemFlags::getSystemSettingType
                 (SystemFlags::debugPerformance).enabled
                 && chrono.getMillis () > 0)
@@ -5929,10 +5926,10 @@ namespace Glest
               (SystemFlags::debugPerformance).enabled
               && chrono.getMillis () > 0)
             SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                      "In [%s::%s Line: %d] took msecs: %lld\n",
+                                      "In [%s::%s Line: %d] took usecs: %lld\n",
                                       extractFileFromDirectoryPath
                                       (__FILE__).c_str (), __FUNCTION__,
-                                      __LINE__, chrono.getMillis ());
+                                      __LINE__, chrono.getMicros ());
           if (SystemFlags::getSystemSettingType
               (SystemFlags::debugPerformance).enabled
               && chrono.getMillis () > 0)
@@ -5949,10 +5946,10 @@ namespace Glest
                 (SystemFlags::debugPerformance).enabled
                 && chrono.getMillis () > 0)
               SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                        "In [%s::%s Line: %d] took msecs: %lld\n",
+                                        "In [%s::%s Line: %d] took usecs: %lld\n",
                                         extractFileFromDirectoryPath
                                         (__FILE__).c_str (), __FUNCTION__,
-                                        __LINE__, chrono.getMillis ());
+                                        __LINE__, chrono.getMicros ());
             if (SystemFlags::getSystemSettingType
                 (SystemFlags::debugPerformance).enabled
                 && chrono.getMillis () > 0)
@@ -6019,10 +6016,10 @@ namespace Glest
                   (SystemFlags::debugPerformance).enabled
                   && chrono.getMillis () > 0)
                 SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                          "In [%s::%s Line: %d] took msecs: %lld\n",
+                                          "In [%s::%s Line: %d] took usecs: %lld\n",
                                           extractFileFromDirectoryPath
                                           (__FILE__).c_str (), __FUNCTION__,
-                                          __LINE__, chrono.getMillis ());
+                                          __LINE__, chrono.getMicros ());
               if (SystemFlags::getSystemSettingType
                   (SystemFlags::debugPerformance).enabled
                   && chrono.getMillis () > 0)
@@ -6037,10 +6034,10 @@ namespace Glest
               (SystemFlags::debugPerformance).enabled
               && chrono.getMillis () > 0)
             SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                      "In [%s::%s Line: %d] took msecs: %lld\n",
+                                      "In [%s::%s Line: %d] took usecs: %lld\n",
                                       extractFileFromDirectoryPath
                                       (__FILE__).c_str (), __FUNCTION__,
-                                      __LINE__, chrono.getMillis ());
+                                      __LINE__, chrono.getMicros ());
           if (SystemFlags::getSystemSettingType
               (SystemFlags::debugPerformance).enabled
               && chrono.getMillis () > 0)
@@ -6055,10 +6052,10 @@ namespace Glest
                 (SystemFlags::debugPerformance).enabled
                 && chrono.getMillis () > 0)
               SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                        "In [%s::%s Line: %d] took msecs: %lld\n",
+                                        "In [%s::%s Line: %d] took usecs: %lld\n",
                                         extractFileFromDirectoryPath
                                         (__FILE__).c_str (), __FUNCTION__,
-                                        __LINE__, chrono.getMillis ());
+                                        __LINE__, chrono.getMicros ());
             if (SystemFlags::getSystemSettingType
                 (SystemFlags::debugPerformance).enabled
                 && chrono.getMillis () > 0)
@@ -6070,10 +6067,10 @@ namespace Glest
                 (SystemFlags::debugPerformance).enabled
                 && chrono.getMillis () > 0)
               SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                        "In [%s::%s Line: %d] took msecs: %lld\n",
+                                        "In [%s::%s Line: %d] took usecs: %lld\n",
                                         extractFileFromDirectoryPath
                                         (__FILE__).c_str (), __FUNCTION__,
-                                        __LINE__, chrono.getMillis ());
+                                        __LINE__, chrono.getMicros ());
             if (SystemFlags::getSystemSettingType
                 (SystemFlags::debugPerformance).enabled
                 && chrono.getMillis () > 0)
@@ -6084,10 +6081,10 @@ namespace Glest
               (SystemFlags::debugPerformance).enabled
               && chrono.getMillis () > 0)
             SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                      "In [%s::%s Line: %d] took msecs: %lld\n",
+                                      "In [%s::%s Line: %d] took usecs: %lld\n",
                                       extractFileFromDirectoryPath
                                       (__FILE__).c_str (), __FUNCTION__,
-                                      __LINE__, chrono.getMillis ());
+                                      __LINE__, chrono.getMicros ());
           if (SystemFlags::getSystemSettingType
               (SystemFlags::debugPerformance).enabled
               && chrono.getMillis () > 0)
@@ -6128,10 +6125,10 @@ namespace Glest
                 (SystemFlags::debugPerformance).enabled
                 && chrono.getMillis () > 0)
               SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                        "In [%s::%s Line: %d] took msecs: %lld\n",
+                                        "In [%s::%s Line: %d] took usecs: %lld\n",
                                         extractFileFromDirectoryPath
                                         (__FILE__).c_str (), __FUNCTION__,
-                                        __LINE__, chrono.getMillis ());
+                                        __LINE__, chrono.getMicros ());
             if (SystemFlags::getSystemSettingType
                 (SystemFlags::debugPerformance).enabled
                 && chrono.getMillis () > 0)
@@ -6206,10 +6203,10 @@ namespace Glest
                   (SystemFlags::debugPerformance).enabled
                   && chrono.getMillis () > 0)
                 SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                          "In [%s::%s Line: %d] took msecs: %lld\n",
+                                          "In [%s::%s Line: %d] took usecs: %lld\n",
                                           extractFileFromDirectoryPath
                                           (__FILE__).c_str (), __FUNCTION__,
-                                          __LINE__, chrono.getMillis ());
+                                          __LINE__, chrono.getMicros ());
               if (SystemFlags::getSystemSettingType
                   (SystemFlags::debugPerformance).enabled
                   && chrono.getMillis () > 0)
@@ -6255,10 +6252,10 @@ namespace Glest
                   (SystemFlags::debugPerformance).enabled
                   && chrono.getMillis () > 0)
                 SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                          "In [%s::%s Line: %d] took msecs: %lld\n",
+                                          "In [%s::%s Line: %d] took usecs: %lld\n",
                                           extractFileFromDirectoryPath
                                           (__FILE__).c_str (), __FUNCTION__,
-                                          __LINE__, chrono.getMillis ());
+                                          __LINE__, chrono.getMicros ());
               if (SystemFlags::getSystemSettingType
                   (SystemFlags::debugPerformance).enabled
                   && chrono.getMillis () > 0)
@@ -6292,10 +6289,10 @@ namespace Glest
                   (SystemFlags::debugPerformance).enabled
                   && chrono.getMillis () > 0)
                 SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                          "In [%s::%s Line: %d] took msecs: %lld\n",
+                                          "In [%s::%s Line: %d] took usecs: %lld\n",
                                           extractFileFromDirectoryPath
                                           (__FILE__).c_str (), __FUNCTION__,
-                                          __LINE__, chrono.getMillis ());
+                                          __LINE__, chrono.getMicros ());
               if (SystemFlags::getSystemSettingType
                   (SystemFlags::debugPerformance).enabled
                   && chrono.getMillis () > 0)
@@ -6313,10 +6310,10 @@ namespace Glest
               (SystemFlags::debugPerformance).enabled
               && chrono.getMillis () > 0)
             SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                      "In [%s::%s Line: %d] took msecs: %lld\n",
+                                      "In [%s::%s Line: %d] took usecs: %lld\n",
                                       extractFileFromDirectoryPath
                                       (__FILE__).c_str (), __FUNCTION__,
-                                      __LINE__, chrono.getMillis ());
+                                      __LINE__, chrono.getMicros ());
           if (SystemFlags::getSystemSettingType
               (SystemFlags::debugPerformance).enabled
               && chrono.getMillis () > 0)
@@ -6359,10 +6356,10 @@ namespace Glest
               (SystemFlags::debugPerformance).enabled
               && chrono.getMillis () > 0)
             SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                      "In [%s::%s Line: %d] took msecs: %lld\n",
+                                      "In [%s::%s Line: %d] took usecs: %lld\n",
                                       extractFileFromDirectoryPath
                                       (__FILE__).c_str (), __FUNCTION__,
-                                      __LINE__, chrono.getMillis ());
+                                      __LINE__, chrono.getMicros ());
           if (SystemFlags::getSystemSettingType
               (SystemFlags::debugPerformance).enabled
               && chrono.getMillis () > 0)
@@ -6394,10 +6391,10 @@ namespace Glest
             getSystemSettingType (SystemFlags::debugPerformance).enabled
             && chrono.getMillis () > 0)
           SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                    "In [%s::%s Line: %d] took msecs: %lld\n",
+                                    "In [%s::%s Line: %d] took usecs: %lld\n",
                                     extractFileFromDirectoryPath
                                     (__FILE__).c_str (), __FUNCTION__,
-                                    __LINE__, chrono.getMillis ());
+                                    __LINE__, chrono.getMicros ());
         if (SystemFlags::
             getSystemSettingType (SystemFlags::debugPerformance).enabled
             && chrono.getMillis () > 0)
@@ -6963,7 +6960,11 @@ namespace Glest
                                           __LINE__);
               if (mapPreview.getMapFileLoaded () != file)
               {
-                mapPreview.loadFromFile (file.c_str ());
+                if (MapIndex::getInstance ().loadPreview (file, &mapPreview)
+                    == false)
+                {
+                  mapPreview.loadFromFile (file.c_str ());
+                }
                 cleanupMapPreviewTexture ();
               }
             }
@@ -7543,9 +7544,8 @@ namespace Glest
 // START
 // Clear the CRC Cache if it is populated
 //
-// Clear the CRC file Cache
+// (the per file CRC cache was refreshed by the FTP thread)
           safeMutexFTPProgress.Lock ();
-          Checksum::clearFileCache ();
 
           vector < string > paths =
             Config::getInstance ().getPathListForType (ptTilesets);
@@ -7713,9 +7713,8 @@ namespace Glest
 // START
 // Clear the CRC Cache if it is populated
 //
-// Clear the CRC file Cache
+// (the per file CRC cache was refreshed by the FTP thread)
           safeMutexFTPProgress.Lock ();
-          Checksum::clearFileCache ();
 
           vector < string > paths =
             Config::getInstance ().getPathListForType (ptTechs);
@@ -43,6 +43,7 @@
 #include "cache_manager.h"
 #include <iterator>
 #include "map_preview.h"
+#include "map_index.h"
 #include "gen_uuid.h"
 #include "leak_dumper.h"
 
@@ -170,6 +171,10 @@ namespace Glest
         enableFactionTexturePreview =
           config.getBool ("FactionPreview", "true");
         enableMapPreview = config.getBool ("MapPreview", "true");
+        // list and preview maps from the map index, refreshing changed maps
+        // in the background
+        MapIndex::getInstance ().startRefresh (config.getPathListForType (ptMaps,
+                                                                           ""));
 
         showFullConsole = false;
 
@@ -1437,6 +1442,7 @@ namespace Glest
                 __FUNCTION__, __LINE__);
 
       cleanup ();
+      MapIndex::getInstance ().stopRefresh ();
 
       if (SystemFlags::
           getSystemSettingType (SystemFlags::debugSystem).enabled)
@@ -3933,10 +3939,10 @@ namespace Glest
             getSystemSettingType (SystemFlags::debugPerformance).enabled
             && chrono.getMillis () > 0)
           SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                    "In [%s::%s Line: %d] took msecs: %lld\n",
+                                    "In [%s::%s Line: %d] took usecs: %lld\n",
                                     extractFileFromDirectoryPath
                                     (__FILE__).c_str (), __FUNCTION__,
-                                    __LINE__, chrono.getMillis ());
+                                    __LINE__, chrono.getMicros ());
         if (SystemFlags::
             getSystemSettingType (SystemFlags::debugPerformance).enabled
             && chrono.getMillis () > 0)
@@ -3998,10 +4004,10 @@ namespace Glest
             getSystemSettingType (SystemFlags::debugPerformance).enabled
             && chrono.getMillis () > 0)
           SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                    "In [%s::%s Line: %d] took msecs: %lld\n",
+                                    "In [%s::%s Line: %d] took usecs: %lld\n",
                                     extractFileFromDirectoryPath
                                     (__FILE__).c_str (), __FUNCTION__,
-                                    __LINE__, chrono.getMillis ());
+                                    __LINE__, chrono.getMicros ());
         if (SystemFlags::
             getSystemSettingType (SystemFlags::debugPerformance).enabled
             && chrono.getMillis () > 0)
@@ -4058,10 +4064,10 @@ namespace Glest
             getSystemSettingType (SystemFlags::debugPerformance).enabled
             && chrono.getMillis () > 0)
           SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                    "In [%s::%s Line: %d] took msecs: %lld\n",
+                                    "In [%s::%s Line: %d] took usecs: %lld\n",
                                     extractFileFromDirectoryPath
                                     (__FILE__).c_str (), __FUNCTION__,
-                                    __LINE__, chrono.getMillis ());
+                                    __LINE__, chrono.getMicros ());
         if (SystemFlags::
             getSystemSettingType (SystemFlags::debugPerformance).enabled
             && chrono.getMillis () > 0)
@@ -4348,10 +4354,10 @@ namespace Glest
             getSystemSettingType (SystemFlags::debugPerformance).enabled
             && chrono.getMillis () > 0)
           SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                    "In [%s::%s Line: %d] took msecs: %lld\n",
+                                    "In [%s::%s Line: %d] took usecs: %lld\n",
                                     extractFileFromDirectoryPath
                                     (__FILE__).c_str (), __FUNCTION__,
-                                    __LINE__, chrono.getMillis ());
+                                    __LINE__, chrono.getMicros ());
         if (SystemFlags::
             getSystemSettingType (SystemFlags::debugPerformance).enabled
             && chrono.getMillis () > 0)
@@ -4454,10 +4460,10 @@ namespace Glest
             getSystemSettingType (SystemFlags::debugPerformance).enabled
             && chrono.getMillis () > 0)
           SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                    "In [%s::%s Line: %d] took msecs: %lld\n",
+                                    "In [%s::%s Line: %d] took usecs: %lld\n",
                                     extractFileFromDirectoryPath
                                     (__FILE__).c_str (), __FUNCTION__,
-                                    __LINE__, chrono.getMillis ());
+                                    __LINE__, chrono.getMicros ());
         if (SystemFlags::
             getSystemSettingType (SystemFlags::debugPerformance).enabled
             && chrono.getMillis () > 0)
@@ -4474,10 +4480,10 @@ namespace Glest
             getSystemSettingType (SystemFlags::debugPerformance).enabled
             && chrono.getMillis () > 0)
           SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                    "In [%s::%s Line: %d] took msecs: %lld\n",
+                                    "In [%s::%s Line: %d] took usecs: %lld\n",
                                     extractFileFromDirectoryPath
                                     (__FILE__).c_str (), __FUNCTION__,
-                                    __LINE__, chrono.getMillis ());
+                                    __LINE__, chrono.getMicros ());
         if (SystemFlags::
             getSystemSettingType (SystemFlags::debugPerformance).enabled
             && chrono.getMillis () > 0)
@@ -4564,10 +4570,10 @@ namespace Glest
             getSystemSettingType (SystemFlags::debugPerformance).enabled
             && chrono.getMillis () > 0)
           SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                    "In [%s::%s Line: %d] took msecs: %lld\n",
+                                    "In [%s::%s Line: %d] took usecs: %lld\n",
                                     extractFileFromDirectoryPath
                                     (__FILE__).c_str (), __FUNCTION__,
-                                    __LINE__, chrono.getMillis ());
+                                    __LINE__, chrono.getMicros ());
         if (SystemFlags::
             getSystemSettingType (SystemFlags::debugPerformance).enabled
             && chrono.getMillis () > 0)
@@ -4623,10 +4629,10 @@ namespace Glest
               (SystemFlags::debugPerformance).enabled
               && chrono.getMillis () > 0)
             SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                      "In [%s::%s Line: %d] took msecs: %lld\n",
+                                      "In [%s::%s Line: %d] took usecs: %lld\n",
                                       extractFileFromDirectoryPath
                                       (__FILE__).c_str (), __FUNCTION__,
-                                      __LINE__, chrono.getMillis ());
+                                      __LINE__, chrono.getMicros ());
           if (SystemFlags::getSystemSettingType
               (SystemFlags::debugPerformance).enabled
               && chrono.getMillis () > 0)
@@ -4661,10 +4667,10 @@ namespace Glest
             getSystemSettingType (SystemFlags::debugPerformance).enabled
             && chrono.getMillis () > 0)
           SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                    "In [%s::%s Line: %d] took msecs: %lld\n",
+                                    "In [%s::%s Line: %d] took usecs: %lld\n",
                                     extractFileFromDirectoryPath
                                     (__FILE__).c_str (), __FUNCTION__,
-                                    __LINE__, chrono.getMillis ());
+                                    __LINE__, chrono.getMicros ());
         if (SystemFlags::
             getSystemSettingType (SystemFlags::debugPerformance).enabled
             && chrono.getMillis () > 0)
@@ -4686,10 +4692,10 @@ namespace Glest
             getSystemSettingType (SystemFlags::debugPerformance).enabled
             && chrono.getMillis () > 0)
           SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                    "In [%s::%s Line: %d] took msecs: %lld\n",
+                                    "In [%s::%s Line: %d] took usecs: %lld\n",
                                     extractFileFromDirectoryPath
                                     (__FILE__).c_str (), __FUNCTION__,
-                                    __LINE__, chrono.getMillis ());
+                                    __LINE__, chrono.getMicros ());
         if (SystemFlags::
             getSystemSettingType (SystemFlags::debugPerformance).enabled
             && chrono.getMillis () > 0)
@@ -4716,10 +4722,10 @@ namespace Glest
             getSystemSettingType (SystemFlags::debugPerformance).enabled
             && chrono.getMillis () > 0)
           SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                    "In [%s::%s Line: %d] took msecs: %lld\n",
+                                    "In [%s::%s Line: %d] took usecs: %lld\n",
                                     extractFileFromDirectoryPath
                                     (__FILE__).c_str (), __FUNCTION__,
-                                    __LINE__, chrono.getMillis ());
+                                    __LINE__, chrono.getMicros ());
         if (SystemFlags::
             getSystemSettingType (SystemFlags::debugPerformance).enabled
             && chrono.getMillis () > 0)
@@ -6921,7 +6927,11 @@ namespace Glest
                                         (__FILE__).c_str (), __FUNCTION__,
                                         __LINE__);
 
-            mapPreview.loadFromFile (file.c_str ());
+            if (MapIndex::getInstance ().loadPreview (file, &mapPreview) ==
+                false)
+            {
+              mapPreview.loadFromFile (file.c_str ());
+            }
 
 //printf("Loading map preview MAP\n");
             cleanupMapPreviewTexture ();
@@ -21,6 +21,7 @@
 #include <algorithm>
 #include <curl/curl.h>
 #include "cache_manager.h"
+#include "map_index.h"
 // Need the include below for vc++ 2010 because Microsoft messed up their STL!
 #include <iterator>
 #include "leak_dumper.h"
@@ -1420,37 +1421,29 @@ namespace Glest
       Config & config = Config::getInstance ();
       vector < string > mappaths = config.getPathListForType (ptMaps, "");
       string result = "";
-      if (mappaths.empty () == false)
+      // the user data folder comes first
+      for (int idx = (int) mappaths.size () - 1; idx >= 0; --idx)
       {
-        Checksum checksum;
-        string itemPath = mappaths[1] + "/" + mapName;
+        string itemPath = mappaths[idx];
+        endPathWithSlash (itemPath);
+        itemPath += mapName;
         if (fileExists (itemPath))
         {
-          checksum.addFile (itemPath);
-          uint32 crc = checksum.getSum ();
-          result = uIntToStr (crc);
-          //printf("itemPath='%s' modinfo.name='%s' remote crc:'%s'  local crc:'%s'   crc='%d' \n",itemPath.c_str(),modinfo.name.c_str(),modinfo.crc.c_str(),modinfo.localCRC.c_str(),crc);
-        }
-        else
-        {
-          itemPath = mappaths[0] + "/" + mapName;
-          if (fileExists (itemPath))
+          // the map index has the checksum unless the file changed since
+          // it was refreshed
+          uint32 crc = 0;
+          if (::Shared::Map::MapIndex::getInstance ().getMapCRC (itemPath,
+                                                                 crc) ==
+              false)
           {
+            Checksum checksum;
             checksum.addFile (itemPath);
-            uint32 crc = checksum.getSum ();
-            result = uIntToStr (crc);
-            //printf("itemPath='%s' modinfo.name='%s' remote crc:'%s'  local crc:'%s'   crc='%d' \n",itemPath.c_str(),modinfo.name.c_str(),modinfo.crc.c_str(),modinfo.localCRC.c_str(),crc);
-          }
-          else
-          {
-            result = "";
+            crc = checksum.getSum ();
           }
+          result = uIntToStr (crc);
+          break;
         }
       }
-      else
-      {
-        result = "";
-      }
       return result;
     }
 
@@ -3924,8 +3917,8 @@ namespace Glest
 
           // START
           // Clear the CRC Cache if it is populated
+          // (the per file CRC cache was refreshed by the FTP thread)
           safeMutexFTPProgress.Lock ();
-          Checksum::clearFileCache ();
 
           vector < string > paths =
             Config::getInstance ().getPathListForType (ptTechs);
@@ -3994,9 +3987,8 @@ namespace Glest
           // START
           // Clear the CRC Cache if it is populated
           //
-          // Clear the CRC file Cache
+          // (the per file CRC cache was refreshed by the FTP thread)
           safeMutexFTPProgress.Lock ();
-          Checksum::clearFileCache ();
 
           vector < string > paths =
             Config::getInstance ().getPathListForType (ptScenarios);
@@ -26,6 +26,9 @@ using namespace Shared::Util;
 
 namespace Glest{ namespace Game{
 
+// settings read every network frame
+static ConfigValue<bool> configAutoClientLagCorrection("AutoClientLagCorrection","true");
+
 // =====================================================
 //	class ConnectionSlotThread
 // =====================================================
@@ -1376,7 +1379,7 @@ void ConnectionSlot::update(bool checkForNewClients,int lockedSlotIndex) {
 
 					// This may end up continuously lagging and not disconnecting players who have
 					// just the 'wrong' amount of lag (but not enough to be horrible for a disconnect)
-					if(Config::getInstance().getBool("AutoClientLagCorrection","true") == true) {
+					if(configAutoClientLagCorrection.get() == true) {
 						double LAG_CHECK_GRACE_PERIOD 		= 15;
 
 						//printf("#4 Server slot got currentFrameCount = %d\n",currentFrameCount);
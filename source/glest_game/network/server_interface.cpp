@@ -66,6 +66,10 @@ const int MASTERSERVER_HEARTBEAT_GAME_STATUS_SECONDS 		= 30;
 
 const int MAX_EMPTY_NETWORK_COMMAND_LIST_BROADCAST_INTERVAL_MILLISECONDS = 4000;
 
+// settings read every network update
+static ConfigValue<bool> configEnableNewThreadManager("EnableNewThreadManager","false");
+static ConfigValue<bool> configEnableInGameBlockingSockets("EnableInGameBlockingSockets","true");
+
 ServerInterface::ServerInterface(bool publishEnabled, ClientLagCallbackInterface *clientLagCallbackInterface) : GameNetworkInterface() {
 	if(SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork,"In [%s::%s Line: %d]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
 
@@ -915,7 +919,7 @@ void ServerInterface::signalClientsToRecieveData(std::map<PLATFORM_SOCKET,bool>
 	//printf("====================================In [%s::%s Line: %d]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
 
 	//printf("Signal clients get new data\n");
-	const bool newThreadManager = Config::getInstance().getBool("EnableNewThreadManager","false");
+	const bool newThreadManager = configEnableNewThreadManager.get();
 	if(newThreadManager == true) {
 		masterController.clearSlaves(true);
 		std::vector<SlaveThreadControllerInterface *> slaveThreadList;
@@ -1091,7 +1095,7 @@ void ServerInterface::checkForCompletedClients(std::map<int,bool> & mapSlotSigna
 
 	if(SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
-	const bool newThreadManager = Config::getInstance().getBool("EnableNewThreadManager","false");
+	const bool newThreadManager = configEnableNewThreadManager.get();
 	if(newThreadManager == true) {
 		checkForCompletedClientsUsingThreadManager(mapSlotSignalledList, errorMsgList);
 	}
@@ -2466,7 +2470,7 @@ void ServerInterface::checkListenerSlots() {
 		if(difftime((long int)time(NULL),lastListenerSlotCheckTime) >= 7) {
 
 			lastListenerSlotCheckTime 			= time(NULL);
-			bool useInGameBlockingClientSockets = Config::getInstance().getBool("EnableInGameBlockingSockets","true");
+			bool useInGameBlockingClientSockets = configEnableInGameBlockingSockets.get();
 
 			if(SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork,"In [%s::%s Line: %d]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
 			for(int startIndex = 0; startIndex < GameConstants::maxPlayers; ++startIndex) {
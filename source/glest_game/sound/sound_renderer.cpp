@@ -275,6 +275,10 @@ void SoundRenderer::loadConfig() {
 	fxVolume= config.getInt("SoundVolumeFx")/100.f;
 	musicVolume= config.getInt("SoundVolumeMusic")/100.f;
 	ambientVolume= config.getInt("SoundVolumeAmbient")/100.f;
+
+	StaticSound::setLazyLoading(config.getBool("SoundLazyLoading","true"));
+	StaticSoundCache::getInstance().setMemoryBudget(
+			(uint64)config.getInt("SoundCacheMaxMegabytes","64") * 1024 * 1024);
 }
 
 }}//end namespace
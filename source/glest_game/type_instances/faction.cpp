@@ -23,6 +23,7 @@
 #include "game.h"
 #include "config.h"
 #include "randomgen.h"
+#include "profiler.h"
 #include "leak_dumper.h"
 
 using namespace Shared::Util;
@@ -383,6 +384,13 @@ namespace Glest
         Chrono chrono;
 
         codeLocation = "2";
+        if (this->faction != NULL)
+        {
+          FrameProfiler::getInstance ().setThreadName ("faction " +
+                                                       intToStr
+                                                       (this->faction->
+                                                        getIndex ()));
+        }
         //unsigned int idx = 0;
         for (; this->faction != NULL;)
         {
@@ -434,6 +442,7 @@ namespace Glest
           {
             codeLocation = "6";
             ExecutingTaskSafeWrapper safeExecutingTaskMutex (this);
+            PROFILE_ZONE ("FactionThread::execute");
 
             if (this->faction == NULL)
             {
@@ -649,6 +658,121 @@ namespace Glest
     }
 
 
+// =====================================================
+//      class UnitCensus
+// =====================================================
+
+    UnitCensus::UnitCensus ()
+    {
+      clear ();
+    }
+
+    void UnitCensus::clear ()
+    {
+      typeCounts.clear ();
+      for (int i = 0; i < unitClassCount; ++i)
+      {
+        for (int j = 0; j < unitClassCount; ++j)
+        {
+          classCounts[i][j] = 0;
+        }
+      }
+      for (int i = 0; i < ccCount; ++i)
+      {
+        idleAbleCounts[i] = 0;
+        commandCounts[i] = 0;
+        for (int j = 0; j < ccCount; ++j)
+        {
+          busyAbleCounts[i][j] = 0;
+        }
+      }
+      harvesterCounts.clear ();
+    }
+
+    void UnitCensus::add (const UnitType * type, CommandClass currentCommand,
+                          int delta)
+    {
+      if (type == NULL)
+      {
+        return;
+      }
+      typeCounts[type] += delta;
+
+      for (int i = 0; i < unitClassCount; ++i)
+      {
+        if (type->isOfClass (static_cast < UnitClass > (i)))
+        {
+          for (int j = 0; j < unitClassCount; ++j)
+          {
+            if (type->isOfClass (static_cast < UnitClass > (j)))
+            {
+              classCounts[i][j] += delta;
+            }
+          }
+        }
+      }
+
+      const bool hasCommand = (currentCommand >= 0
+                               && currentCommand < ccCount);
+      if (hasCommand == true)
+      {
+        commandCounts[currentCommand] += delta;
+      }
+      if (type->isCommandable () == true)
+      {
+        const bool idle = (hasCommand == false || currentCommand == ccStop);
+        for (int ability = 0; ability < ccCount; ++ability)
+        {
+          if (type->hasCommandClass (static_cast < CommandClass > (ability)))
+          {
+            if (idle == true)
+            {
+              idleAbleCounts[ability] += delta;
+            }
+            if (hasCommand == true)
+            {
+              busyAbleCounts[ability][currentCommand] += delta;
+            }
+          }
+        }
+      }
+    }
+
+    void UnitCensus::addHarvesters (const std::vector <
+                                    const ResourceType * >&resources,
+                                    int delta)
+    {
+      for (unsigned int i = 0; i < resources.size (); ++i)
+      {
+        harvesterCounts[resources[i]] += delta;
+      }
+    }
+
+    int UnitCensus::getHarvesterCount (const ResourceType * rt) const
+    {
+      std::map < const ResourceType *, int >::const_iterator iterFind =
+        harvesterCounts.find (rt);
+      return (iterFind != harvesterCounts.end ()? iterFind->second : 0);
+    }
+
+    int UnitCensus::getTypeCount (const UnitType * type) const
+    {
+      std::map < const UnitType *, int >::const_iterator iterFind =
+        typeCounts.find (type);
+      return (iterFind != typeCounts.end () ? iterFind->second : 0);
+    }
+
+    int UnitCensus::getClassCount (UnitClass uc,
+                                   const UnitClass * excludeClass) const
+    {
+      int result = classCounts[uc][uc];
+      if (excludeClass != NULL)
+      {
+        result -= classCounts[uc][*excludeClass];
+      }
+      return result;
+    }
+
 // =====================================================
 //      class Faction
 // =====================================================
@@ -726,6 +850,7 @@ namespace Glest
                                   intToStr (__LINE__));
       deleteValues (units.begin (), units.end ());
       units.clear ();
+      unitCensus.clear ();
 
       safeMutex.ReleaseLock ();
 
@@ -770,6 +895,7 @@ namespace Glest
                                   intToStr (__LINE__));
       deleteValues (units.begin (), units.end ());
       units.clear ();
+      unitCensus.clear ();
 
       safeMutex.ReleaseLock ();
 
@@ -1857,6 +1983,131 @@ namespace Glest
                                   intToStr (__LINE__));
       units.push_back (unit);
       unitMap[unit->getId ()] = unit;
+
+      std::vector < const ResourceType * >resources;
+      getCensusResources (unit, resources);
+      unit->setCensusState (unit->getType (), unit->getCurrCommandClass (),
+                            resources);
+      unitCensus.add (unit->getCensusType (), unit->getCensusCommandClass (),
+                      1);
+      unitCensus.addHarvesters (unit->getCensusResources (), 1);
+    }
+
+    void Faction::getCensusResources (const Unit * unit,
+                                      std::vector <
+                                      const ResourceType * >&resources) const
+    {
+      resources.clear ();
+      if (unit->getType ()->isCommandable () == false
+          || unit->anyCommand () == false)
+      {
+        return;
+      }
+
+      const Command *command = unit->getCurrCommand ();
+      const CommandType *ct = command->getCommandType ();
+      if (unit->getType ()->hasCommandClass (ccHarvest))
+      {
+        const HarvestCommandType *hct =
+          dynamic_cast < const HarvestCommandType * >(ct);
+        if (hct == NULL || world == NULL)
+        {
+          return;
+        }
+        // the resource on the cell the unit is working on, the census is
+        // updated when the unit moves on to another cell or the resource
+        // runs out
+        const Map *map = world->getMap ();
+        const Vec2i surfPos = Map::toSurfCoords (unit->getTargetPos ());
+        const Resource *r = NULL;
+        if (map->isInsideSurface (surfPos))
+        {
+          r = map->getSurfaceCell (surfPos)->getResource ();
+        }
+        if (r != NULL)
+        {
+          resources.push_back (r->getType ());
+        }
+        return;
+      }
+
+      // units producing or building something with a negative cost
+      std::vector < const UnitType * >producedTypes;
+      if (unit->getType ()->hasCommandClass (ccProduce))
+      {
+        const ProduceCommandType *pct =
+          dynamic_cast < const ProduceCommandType * >(ct);
+        if (pct != NULL && pct->getProducedUnit () != NULL)
+        {
+          producedTypes.push_back (pct->getProducedUnit ());
+        }
+      }
+      else if (unit->getType ()->hasCommandClass (ccBuild))
+      {
+        const BuildCommandType *bct =
+          dynamic_cast < const BuildCommandType * >(ct);
+        if (bct != NULL)
+        {
+          for (int i = 0; i < bct->getBuildingCount (); ++i)
+          {
+            producedTypes.push_back (bct->getBuilding (i));
+          }
+        }
+      }
+      for (unsigned int i = 0; i < producedTypes.size (); ++i)
+      {
+        const UnitType *ut = producedTypes[i];
+        if (ut == NULL)
+        {
+          continue;
+        }
+        for (int j = 0; j < ut->getCostCount (); ++j)
+        {
+          const Resource *r = ut->getCost (j);
+          if (r->getAmount () < 0
+              && std::find (resources.begin (), resources.end (),
+                            r->getType ()) == resources.end ())
+          {
+            resources.push_back (r->getType ());
+          }
+        }
+      }
+    }
+
+    void Faction::updateUnitCensus (Unit * unit)
+    {
+      // only the units added to the faction are counted
+      if (unit->getCensusType () == NULL)
+      {
+        return;
+      }
+      CommandClass currentCommand = unit->getCurrCommandClass ();
+      std::vector < const ResourceType * >resources;
+      getCensusResources (unit, resources);
+      if (unit->getCensusType () != unit->getType () ||
+          unit->getCensusCommandClass () != currentCommand ||
+          unit->getCensusResources () != resources)
+      {
+        unitCensus.add (unit->getCensusType (),
+                        unit->getCensusCommandClass (), -1);
+        unitCensus.addHarvesters (unit->getCensusResources (), -1);
+        unit->setCensusState (unit->getType (), currentCommand, resources);
+        unitCensus.add (unit->getCensusType (),
+                        unit->getCensusCommandClass (), 1);
+        unitCensus.addHarvesters (unit->getCensusResources (), 1);
+      }
+    }
+
+    void Faction::updateHarvesterCensus ()
+    {
+      for (unsigned int i = 0; i < units.size (); ++i)
+      {
+        Unit *unit = units[i];
+        if (unit->getType ()->hasCommandClass (ccHarvest))
+        {
+          updateUnitCensus (unit);
+        }
+      }
     }
 
     void Faction::removeUnit (Unit * unit)
@@ -1874,6 +2125,11 @@ namespace Glest
         {
           units.erase (units.begin () + i);
           unitMap.erase (unitId);
+          unitCensus.add (unit->getCensusType (),
+                          unit->getCensusCommandClass (), -1);
+          unitCensus.addHarvesters (unit->getCensusResources (), -1);
+          unit->setCensusState (NULL, ccNull,
+                                std::vector < const ResourceType * >());
           assert (units.size () == unitMap.size ());
           return;
         }
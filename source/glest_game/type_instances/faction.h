@@ -77,6 +77,60 @@ namespace Glest
       static time_t lastDebug;
     };
 
+// =====================================================
+//      class UnitCensus
+//
+///     Counts of the units of a faction by type, class and current
+///     command, kept up to date as units come and go so the AI does
+///     not have to walk every unit to answer them
+// =====================================================
+
+    class UnitCensus
+    {
+    public:
+      static const int unitClassCount = ucBuilding + 1;
+
+    private:
+      std::map < const UnitType *, int >typeCounts;
+      // units of both classes, the diagonal holds the count of each class
+      int classCounts[unitClassCount][unitClassCount];
+      // commandable units able to do a command class that are idle, or
+      // whose current command is of a class
+      int idleAbleCounts[ccCount];
+      int busyAbleCounts[ccCount][ccCount];
+      int commandCounts[ccCount];
+      // units harvesting a resource type, or producing or building units
+      // that yield it
+      std::map < const ResourceType *, int >harvesterCounts;
+
+    public:
+      UnitCensus ();
+      void clear ();
+
+      // currentCommand is ccNull for a unit without commands
+      void add (const UnitType * type, CommandClass currentCommand,
+                int delta);
+      void addHarvesters (const std::vector < const ResourceType * >&resources,
+                          int delta);
+
+      int getTypeCount (const UnitType * type) const;
+      int getClassCount (UnitClass uc, const UnitClass * excludeClass) const;
+      int getIdleAbleCount (CommandClass ability) const
+      {
+        return idleAbleCounts[ability];
+      }
+      int getAbleCount (CommandClass ability,
+                        CommandClass currentCommand) const
+      {
+        return busyAbleCounts[ability][currentCommand];
+      }
+      int getCommandCount (CommandClass currentCommand) const
+      {
+        return commandCounts[currentCommand];
+      }
+      int getHarvesterCount (const ResourceType * rt) const;
+    };
+
 // =====================================================
 //      class Faction
 //
@@ -207,6 +261,11 @@ namespace Glest
 
       std::map < std::string, bool > resourceTypeCostCache;
 
+      UnitCensus unitCensus;
+
+      void getCensusResources (const Unit * unit,
+                               std::vector < const ResourceType * >&resources) const;
+
     public:
       Faction ();
       ~Faction ();
@@ -227,6 +286,12 @@ namespace Glest
       void notifyUnitTypeChange (const Unit * unit, const UnitType * newType);
       void notifyUnitSkillTypeChange (const Unit * unit,
                                       const SkillType * newType);
+      void updateUnitCensus (Unit * unit);
+      void updateHarvesterCensus ();
+      const UnitCensus & getUnitCensus () const
+      {
+        return unitCensus;
+      }
       bool hasAliveUnits (bool filterMobileUnits,
                           bool filterBuiltUnits) const;
 
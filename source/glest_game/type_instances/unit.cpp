@@ -786,6 +786,8 @@ namespace Glest
       this->faction = faction;
       this->preMorph_type = NULL;
       this->type = type;
+      this->censusType = NULL;
+      this->censusCommandClass = ccNull;
       setType (this->type);
 
       this->map = map;
@@ -795,6 +797,7 @@ namespace Glest
       this->targetPos = Vec2i (0);
       this->lastRenderFrame = 0;
       this->visible = true;
+      this->cullTreeItem = -1;
       this->retryCurrCommandCount = 0;
       this->screenPos = Vec3f (0.0);
       this->ignoreCheckCommand = false;
@@ -994,6 +997,7 @@ namespace Glest
     {
       this->faction->notifyUnitTypeChange (this, newType);
       this->type = newType;
+      this->faction->updateUnitCensus (this);
     }
 
     void Unit::setAlive (bool value)
@@ -2380,6 +2384,19 @@ namespace Glest
       assert (commands.empty () == false);
       commands.front () = cmd;
       this->setCurrentUnitTitle ("");
+
+      safeMutex.ReleaseLock ();
+      this->faction->updateUnitCensus (this);
+    }
+
+    CommandClass Unit::getCurrCommandClass () const
+    {
+      if (commands.empty () == false &&
+          commands.front ()->getCommandType () != NULL)
+      {
+        return commands.front ()->getCommandType ()->getClass ();
+      }
+      return ccNull;
     }
 
 //returns the size of the commands
@@ -2451,10 +2468,10 @@ namespace Glest
           getSystemSettingType (SystemFlags::debugPerformance).enabled
           && chrono.getMillis () > 0)
         SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                  "In [%s::%s] Line: %d took msecs: %lld\n",
+                                  "In [%s::%s] Line: %d took usecs: %lld\n",
                                   extractFileFromDirectoryPath
                                   (__FILE__).c_str (), __FUNCTION__, __LINE__,
-                                  chrono.getMillis ());
+                                  chrono.getMicros ());
 
       //printf("In [%s::%s] Line: %d unit [%d - %s] command [%s] tryQueue = %d command->getCommandType()->isQueuable(tryQueue) = %d\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,this->getId(),this->getType()->getName().c_str(), command->getCommandType()->getName().c_str(), tryQueue,command->getCommandType()->isQueuable(tryQueue));
 
@@ -2465,10 +2482,10 @@ namespace Glest
             getSystemSettingType (SystemFlags::debugPerformance).enabled
             && chrono.getMillis () > 0)
           SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                    "In [%s::%s] Line: %d took msecs: %lld\n",
+                                    "In [%s::%s] Line: %d took usecs: %lld\n",
                                     extractFileFromDirectoryPath
                                     (__FILE__).c_str (), __FUNCTION__,
-                                    __LINE__, chrono.getMillis ());
+                                    __LINE__, chrono.getMicros ());
         if (SystemFlags::getSystemSettingType
             (SystemFlags::debugUnitCommands).enabled)
           SystemFlags::OutputDebug (SystemFlags::debugUnitCommands,
@@ -2520,10 +2537,10 @@ namespace Glest
             getSystemSettingType (SystemFlags::debugPerformance).enabled
             && chrono.getMillis () > 0)
           SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                    "In [%s::%s] Line: %d took msecs: %lld\n",
+                                    "In [%s::%s] Line: %d took usecs: %lld\n",
                                     extractFileFromDirectoryPath
                                     (__FILE__).c_str (), __FUNCTION__,
-                                    __LINE__, chrono.getMillis ());
+                                    __LINE__, chrono.getMicros ());
 
         //cancel current command if it is not queuable
         if (commands.empty () == false &&
@@ -2547,10 +2564,10 @@ namespace Glest
             getSystemSettingType (SystemFlags::debugPerformance).enabled
             && chrono.getMillis () > 0)
           SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                    "In [%s::%s] Line: %d took msecs: %lld\n",
+                                    "In [%s::%s] Line: %d took usecs: %lld\n",
                                     extractFileFromDirectoryPath
                                     (__FILE__).c_str (), __FUNCTION__,
-                                    __LINE__, chrono.getMillis ());
+                                    __LINE__, chrono.getMicros ());
       }
       else
       {
@@ -2607,20 +2624,20 @@ namespace Glest
             getSystemSettingType (SystemFlags::debugPerformance).enabled
             && chrono.getMillis () > 0)
           SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                    "In [%s::%s] Line: %d took msecs: %lld\n",
+                                    "In [%s::%s] Line: %d took usecs: %lld\n",
                                     extractFileFromDirectoryPath
                                     (__FILE__).c_str (), __FUNCTION__,
-                                    __LINE__, chrono.getMillis ());
+                                    __LINE__, chrono.getMicros ());
       }
 
       if (SystemFlags::
           getSystemSettingType (SystemFlags::debugPerformance).enabled
           && chrono.getMillis () > 0)
         SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                  "In [%s::%s] Line: %d took msecs: %lld\n",
+                                  "In [%s::%s] Line: %d took usecs: %lld\n",
                                   extractFileFromDirectoryPath
                                   (__FILE__).c_str (), __FUNCTION__, __LINE__,
-                                  chrono.getMillis ());
+                                  chrono.getMicros ());
 
       //check command
       result = checkCommand (command);
@@ -2638,10 +2655,10 @@ namespace Glest
           getSystemSettingType (SystemFlags::debugPerformance).enabled
           && chrono.getMillis () > 0)
         SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                  "In [%s::%s] Line: %d took msecs: %lld\n",
+                                  "In [%s::%s] Line: %d took usecs: %lld\n",
                                   extractFileFromDirectoryPath
                                   (__FILE__).c_str (), __FUNCTION__, __LINE__,
-                                  chrono.getMillis ());
+                                  chrono.getMicros ());
 
       if (result.first == crSuccess)
       {
@@ -2652,10 +2669,10 @@ namespace Glest
           getSystemSettingType (SystemFlags::debugPerformance).enabled
           && chrono.getMillis () > 0)
         SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                  "In [%s::%s] Line: %d took msecs: %lld\n",
+                                  "In [%s::%s] Line: %d took usecs: %lld\n",
                                   extractFileFromDirectoryPath
                                   (__FILE__).c_str (), __FUNCTION__, __LINE__,
-                                  chrono.getMillis ());
+                                  chrono.getMicros ());
 
       //push back command
       if (result.first == crSuccess)
@@ -2678,10 +2695,12 @@ namespace Glest
           getSystemSettingType (SystemFlags::debugPerformance).enabled
           && chrono.getMillis () > 0)
         SystemFlags::OutputDebug (SystemFlags::debugPerformance,
-                                  "In [%s::%s] Line: %d took msecs: %lld\n",
+                                  "In [%s::%s] Line: %d took usecs: %lld\n",
                                   extractFileFromDirectoryPath
                                   (__FILE__).c_str (), __FUNCTION__, __LINE__,
-                                  chrono.getMillis ());
+                                  chrono.getMicros ());
+
+      this->faction->updateUnitCensus (this);
 
       return result;
     }
@@ -2735,6 +2754,7 @@ namespace Glest
           break;
         }
       }
+      this->faction->updateUnitCensus (this);
 
       return crSuccess;
     }
@@ -2778,7 +2798,7 @@ namespace Glest
       //clear routes
       this->unitPath->clear ();
 
-
+      this->faction->updateUnitCensus (this);
 
       return crSuccess;
     }
@@ -5353,6 +5373,7 @@ namespace Glest
         safeMutex.ReleaseLock ();
       }
       changedActiveCommand = false;
+      this->faction->updateUnitCensus (this);
     }
 
     void Unit::deleteQueuedCommand (Command * command)
@@ -547,6 +547,11 @@ namespace Glest
 
       Commands commands;
       Observers observers;
+
+      // what the faction unit census counted this unit as
+      const UnitType *censusType;
+      CommandClass censusCommandClass;
+      std::vector < const ResourceType * >censusResources;
         vector < UnitParticleSystem * >unitParticleSystems;
         vector < UnitParticleSystemType * >queuedUnitParticleSystemTypes;
 
@@ -565,6 +570,8 @@ namespace Glest
         std::string lastSource;
       int32 lastRenderFrame;
       bool visible;
+      // item of the renderer's unit cull tree, -1 until it is added
+      int cullTreeItem;
 
       int retryCurrCommandCount;
 
@@ -973,6 +980,27 @@ namespace Glest
         return NULL;
       }
       void replaceCurrCommand (Command * cmd);
+      CommandClass getCurrCommandClass () const;
+      const UnitType *getCensusType () const
+      {
+        return censusType;
+      }
+      CommandClass getCensusCommandClass () const
+      {
+        return censusCommandClass;
+      }
+      const std::vector < const ResourceType * >&getCensusResources () const
+      {
+        return censusResources;
+      }
+      void setCensusState (const UnitType * type,
+                           CommandClass currentCommand,
+                           const std::vector < const ResourceType * >&resources)
+      {
+        censusType = type;
+        censusCommandClass = currentCommand;
+        censusResources = resources;
+      }
       int getCountOfProducedUnits (const UnitType * ut) const;
       unsigned int getCommandSize () const;
       std::pair < CommandResult, string > giveCommand (Command * command, bool tryQueue = false);       //give a command
@@ -1053,6 +1081,15 @@ namespace Glest
         screenPos = value;
       }
 
+      inline int getCullTreeItem () const
+      {
+        return cullTreeItem;
+      }
+      inline void setCullTreeItem (int value)
+      {
+        cullTreeItem = value;
+      }
+
       inline string getCurrentUnitTitle () const
       {
         return currentUnitTitle;
@@ -718,7 +718,7 @@ namespace Glest
              ++i)
         {
           StaticSound *sound = unitType.getSelectionSounds ().getSounds ()[i];
-          if (sound != NULL
+          if (sound != NULL && sound->ensureLoaded () == true
               && sound->getInfo ()->getBitRate () > MAX_BITRATE_WARNING)
           {
             char szBuf[8096] = "";
@@ -734,7 +734,7 @@ namespace Glest
              i < (int) unitType.getCommandSounds ().getSounds ().size (); ++i)
         {
           StaticSound *sound = unitType.getCommandSounds ().getSounds ()[i];
-          if (sound != NULL
+          if (sound != NULL && sound->ensureLoaded () == true
               && sound->getInfo ()->getBitRate () > MAX_BITRATE_WARNING)
           {
             char szBuf[8096] = "";
@@ -347,6 +347,7 @@ void SurfaceCell::loadGame(const XmlNode *rootNode, int index, World *world) {
 
 const int Map::cellScale= 2;
 const int Map::mapScale= 2;
+const int Map::maxSurfaceChanges= 64;
 
 Map::Map() {
 	cells= NULL;
@@ -365,6 +366,7 @@ Map::Map() {
 	surfaceSize=(surfaceW * surfaceH);
 	maxPlayers=0;
 	maxMapHeight=0;
+	surfaceChangeCount=0;
 }
 
 Map::~Map() {
@@ -498,6 +500,10 @@ Checksum Map::load(const string &path, TechTree *techTree, Tileset *tileset) {
 			//cells
 			cells= new Cell[getCellArraySize()];
 			surfaceCells= new SurfaceCell[getSurfaceCellArraySize()];
+			for(int field = 0; field < fieldCount; ++field) {
+				terrainBlockedSums[field].clear();
+				unitCellCounts[field].assign((w + 1) * (h + 1), 0);
+			}
 
 			//read heightmap
 			for(int j = 0; j < surfaceH; ++j) {
@@ -860,6 +866,14 @@ bool Map::isAproxFreeCell(const Vec2i &pos, Field field, int teamIndex) const {
 }
 
 bool Map::isFreeCells(const Vec2i & pos, int size, Field field) const  {
+	// nothing in the area that could block it, the cells need no look
+	if(size > 0 && isInside(pos) && isInside(pos.x + size - 1, pos.y + size - 1) &&
+		terrainBlockedSums[field].empty() == false &&
+		getTerrainBlockedCount(field, pos, size) == 0 &&
+		getUnitCellCount(field, pos, size) == 0) {
+		return true;
+	}
+
 	for(int i=pos.x; i<pos.x+size; ++i) {
 		for(int j=pos.y; j<pos.y+size; ++j) {
 			Vec2i testPos(i,j);
@@ -1438,11 +1452,11 @@ void Map::putUnitCellsPrivate(Unit *unit, const Vec2i &pos, const UnitType *ut,
 								   getCell(currPos)->getUnit(field) == unit) {
 					if(isMorph) {
 						// unit is beeing morphed to another unit with maybe other field.
-						getCell(currPos)->setUnit(field, unit);
+						setCellUnit(currPos, field, unit);
 						canPutInCell = false;
 					}
 					if(canPutInCell == true) {
-						getCell(currPos)->setUnit(unit->getCurrField(), unit);
+						setCellUnit(currPos, unit->getCurrField(), unit);
 					}
 				}
 				else if(canPutInCell == true) {
@@ -1516,7 +1530,7 @@ void Map::clearUnitCells(Unit *unit, const Vec2i &pos, bool ignoreSkill) {
 
                 // Only clear the cell if its the unit we expect to clear out of it
                 if(getCell(currPos)->getUnit(currentField) == unit) {
-                    getCell(currPos)->setUnit(currentField, NULL);
+                    setCellUnit(currPos, currentField, NULL);
                 }
 			}
 			else if(ut->hasCellMap() == true &&
@@ -1610,15 +1624,15 @@ void Map::prepareTerrain(const Unit *unit) {
 
 	flatternTerrain(unit);
 
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
+	if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took usecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMicros());
 
     computeNormals();
 
-    if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
+    if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took usecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMicros());
 
 	computeInterpolatedHeights();
 
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
+	if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took usecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMicros());
 }
 
 // ==================== PRIVATE ====================
@@ -1627,6 +1641,11 @@ void Map::prepareTerrain(const Unit *unit) {
 
 void Map::flatternTerrain(const Unit *unit){
 	float refHeight= getSurfaceCell(toSurfCoords(unit->getCenteredPos()))->getHeight();
+	Vec2i firstPos= toSurfCoords(unit->getPosNotThreadSafe() - Vec2i(1));
+	Vec2i lastPos= toSurfCoords(unit->getPosNotThreadSafe() + Vec2i(unit->getType()->getSize()));
+	// the normals of the neighbour vertices change too
+	addSurfaceChange(Rect2i(firstPos - Vec2i(1), lastPos + Vec2i(1)));
+
 	for(int i=-1; i<=unit->getType()->getSize(); ++i){
         for(int j=-1; j<=unit->getType()->getSize(); ++j){
             Vec2i pos= unit->getPosNotThreadSafe()+Vec2i(i, j);
@@ -1642,6 +1661,31 @@ void Map::flatternTerrain(const Unit *unit){
     }
 }
 
+void Map::addSurfaceChange(const Rect2i &surfaceArea) {
+	surfaceChangeCount++;
+	surfaceChanges.push_back(make_pair(surfaceChangeCount, surfaceArea));
+	if((int)surfaceChanges.size() > maxSurfaceChanges) {
+		surfaceChanges.erase(surfaceChanges.begin());
+	}
+}
+
+bool Map::getSurfaceChangesSince(uint32 changeCount, std::vector<Rect2i> &surfaceAreas) const {
+	surfaceAreas.clear();
+	if(changeCount == surfaceChangeCount) {
+		return true;
+	}
+	// the oldest changes were dropped, the caller must assume everything changed
+	if(surfaceChanges.empty() == true || surfaceChanges.front().first > changeCount + 1) {
+		return false;
+	}
+	for(unsigned int i = 0; i < surfaceChanges.size(); ++i) {
+		if(surfaceChanges[i].first > changeCount) {
+			surfaceAreas.push_back(surfaceChanges[i].second);
+		}
+	}
+	return true;
+}
+
 //compute normals
 void Map::computeNormals(){
     //compute center normals
@@ -1692,6 +1736,78 @@ void Map::computeInterpolatedHeights(){
 			}
 		}
 	}
+
+	// the deep submerged cells depend on these heights
+	computeTerrainBlockedSums();
+}
+
+void Map::computeTerrainBlockedSums() {
+	for(int field = 0; field < fieldCount; ++field) {
+		vector<int> &sums= terrainBlockedSums[field];
+		sums.assign((w + 1) * (h + 1), 0);
+		for(int j = 0; j < h; ++j) {
+			int rowSum= 0;
+			for(int i = 0; i < w; ++i) {
+				// the same checks as isFreeCell without the units
+				Vec2i pos(i, j);
+				bool blocked= (isInsideSurface(toSurfCoords(pos)) == false);
+				if(blocked == false && field != fAir) {
+					blocked= (getSurfaceCell(toSurfCoords(pos))->isFree() == false);
+				}
+				if(blocked == false && field == fLand) {
+					blocked= getDeepSubmerged(getCell(pos));
+				}
+				rowSum+= (blocked ? 1 : 0);
+				sums[(j + 1) * (w + 1) + i + 1]= sums[j * (w + 1) + i + 1] + rowSum;
+			}
+		}
+	}
+}
+
+int Map::getTerrainBlockedCount(int field, const Vec2i &pos, int size) const {
+	const vector<int> &sums= terrainBlockedSums[field];
+	const int x0= pos.x;
+	const int y0= pos.y;
+	const int x1= pos.x + size;
+	const int y1= pos.y + size;
+	return	sums[y1 * (w + 1) + x1] - sums[y0 * (w + 1) + x1] -
+			sums[y1 * (w + 1) + x0] + sums[y0 * (w + 1) + x0];
+}
+
+void Map::setCellUnit(const Vec2i &pos, int field, Unit *unit) {
+	Cell *cell= getCell(pos);
+	const bool wasOccupied= (cell->getUnit(field) != NULL);
+	cell->setUnit(field, unit);
+
+	const bool occupied= (unit != NULL);
+	if(occupied != wasOccupied && unitCellCounts[field].empty() == false) {
+		const int delta= (occupied ? 1 : -1);
+		vector<int> &counts= unitCellCounts[field];
+		for(int i = pos.x + 1; i <= w; i += (i & -i)) {
+			for(int j = pos.y + 1; j <= h; j += (j & -j)) {
+				counts[j * (w + 1) + i]+= delta;
+			}
+		}
+	}
+}
+
+// cells holding a unit left of x and above y
+int Map::getUnitCellCount(int field, int x, int y) const {
+	const vector<int> &counts= unitCellCounts[field];
+	int result= 0;
+	for(int i = x; i > 0; i -= (i & -i)) {
+		for(int j = y; j > 0; j -= (j & -j)) {
+			result+= counts[j * (w + 1) + i];
+		}
+	}
+	return result;
+}
+
+int Map::getUnitCellCount(int field, const Vec2i &pos, int size) const {
+	const int x1= pos.x + size;
+	const int y1= pos.y + size;
+	return	getUnitCellCount(field, x1, y1) - getUnitCellCount(field, pos.x, y1) -
+			getUnitCellCount(field, x1, pos.y) + getUnitCellCount(field, pos.x, pos.y);
 }
 
 void Map::smoothSurface(Tileset *tileset) {
@@ -245,10 +245,31 @@ private:
 	float maxMapHeight;
 	string mapFile;
 
+	// surface areas whose vertices or normals changed since loading,
+	// the renderer rebuilds only the terrain chunks covering them
+	static const int maxSurfaceChanges;
+	uint32 surfaceChangeCount;
+	std::vector<std::pair<uint32,Rect2i> > surfaceChanges;
+
+	// lets isFreeCells accept a free area without visiting its cells: a
+	// summed area table of the cells the terrain blocks in each field and
+	// a binary indexed one, updated as units are put and cleared, of the
+	// cells holding a unit
+	std::vector<int> terrainBlockedSums[fieldCount];
+	std::vector<int> unitCellCounts[fieldCount];
+
 private:
 	Map(Map&);
 	void operator=(Map&);
 
+	void addSurfaceChange(const Rect2i &surfaceArea);
+
+	void computeTerrainBlockedSums();
+	void setCellUnit(const Vec2i &pos, int field, Unit *unit);
+	int getTerrainBlockedCount(int field, const Vec2i &pos, int size) const;
+	int getUnitCellCount(int field, int x, int y) const;
+	int getUnitCellCount(int field, const Vec2i &pos, int size) const;
+
 public:
 	Map();
 	~Map();
@@ -373,6 +394,9 @@ public:
 	void computeNormals();
 	void computeInterpolatedHeights();
 
+	inline uint32 getSurfaceChangeCount() const						{return surfaceChangeCount;}
+	bool getSurfaceChangesSince(uint32 changeCount, std::vector<Rect2i> &surfaceAreas) const;
+
 	//static
 	inline static Vec2i toSurfCoords(const Vec2i &unitPos)		{return unitPos / cellScale;}
 	inline static Vec2i toUnitCoords(const Vec2i &surfPos)		{return surfPos * cellScale;}
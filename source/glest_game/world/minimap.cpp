@@ -19,6 +19,7 @@
 #include "config.h"
 #include "object.h"
 #include "game_settings.h"
+#include "math_util.h"
 #include "leak_dumper.h"
 
 using namespace Shared::Graphics;
@@ -139,18 +140,46 @@ void Minimap::incFowTextureAlphaSurface(const Vec2i sPos, float alpha,
 	if(fowPixmap1) {
 		assert(sPos.x < fowPixmap1->getW() && sPos.y < fowPixmap1->getH());
 
-		if(fowPixmap1->getPixelf(sPos.x, sPos.y) < alpha){
-			fowPixmap1->setPixel(sPos.x, sPos.y, alpha);
+		const uint8 alphaByte= static_cast<uint8>(alpha * 255.f);
+		const int index= sPos.y * fowPixmap1->getW() + sPos.x;
+
+		uint8 *pixels= fowPixmap1->getPixels();
+		if(pixels[index] < alphaByte) {
+			pixels[index]= alphaByte;
 		}
 
 		if(fowPixmap1Copy != NULL && isIncrementalUpdate == true) {
-			if(fowPixmap1Copy->getPixelf(sPos.x, sPos.y) < alpha){
-				fowPixmap1Copy->setPixel(sPos.x, sPos.y, alpha);
+			uint8 *copyPixels= fowPixmap1Copy->getPixels();
+			if(copyPixels[index] < alphaByte) {
+				copyPixels[index]= alphaByte;
 			}
 		}
 	}
 }
 
+void Minimap::incFowTextureAlphaMap(int surfaceW, int surfaceH) {
+	if(fowPixmap1 && surfaceW > 0) {
+		assert(surfaceW <= fowPixmap1->getW() && surfaceH <= fowPixmap1->getH());
+
+		// the outer ring stays hidden and the next one is dimmed,
+		// the same alpha incFowTextureAlphaSurface gets for them
+		const uint8 borderAlpha= static_cast<uint8>(0.3f * 255.f);
+		std::vector<uint8> borderRow(surfaceW, 0);
+		std::vector<uint8> innerRow(surfaceW, 0);
+		for(int x = 1; x < surfaceW - 1; ++x) {
+			borderRow[x]= borderAlpha;
+			innerRow[x]= (x > 1 && x < surfaceW - 2 ? 255 : borderAlpha);
+		}
+
+		const int pitch= fowPixmap1->getW();
+		uint8 *pixels= fowPixmap1->getPixels();
+		for(int y = 1; y < surfaceH - 1; ++y) {
+			const bool inner= (y > 1 && y < surfaceH - 2);
+			maxUint8Array(inner ? &innerRow[0] : &borderRow[0], pixels + y * pitch, surfaceW);
+		}
+	}
+}
+
 void Minimap::copyFowTexAlphaSurface() {
 	if(fowPixmap1_default != NULL && fowPixmap1 != NULL) {
 		fowPixmap1_default->copy(fowPixmap1);
@@ -196,67 +225,24 @@ void Minimap::resetFowTex() {
 		fowPixmap0= fowPixmap1;
 		fowPixmap1= tmpPixmap;
 
-		// Could turn off ONLY fog of war by setting below to false
-		bool overridefogOfWarValue = fogOfWar;
-
-		for(int indexPixelWidth = 0;
-				indexPixelWidth < fowTex->getPixmap()->getW();
-				++indexPixelWidth){
-			for(int indexPixelHeight = 0;
-					indexPixelHeight < fowTex->getPixmap()->getH();
-					++indexPixelHeight){
-				if ((fogOfWar == false && overridefogOfWarValue == false)) {
-					//(gameSettings->getFlagTypes1() & ft1_show_map_resources) != ft1_show_map_resources) {
-					//printf("Line: %d\n",__LINE__);
-
-					float p0 = fowPixmap0->getPixelf(indexPixelWidth, indexPixelHeight);
-					float p1 = fowPixmap1->getPixelf(indexPixelWidth, indexPixelHeight);
-					if (p0 > p1) {
-						fowPixmap1->setPixel(indexPixelWidth, indexPixelHeight, p0);
-					}
-					else {
-						fowPixmap1->setPixel(indexPixelWidth, indexPixelHeight, p1);
-					}
-				}
-				else if((fogOfWar && overridefogOfWarValue) ||
-					(gameSettings->getFlagTypes1() & ft1_show_map_resources) == ft1_show_map_resources) {
-					//printf("Line: %d\n",__LINE__);
-
-					float p0= fowPixmap0->getPixelf(indexPixelWidth, indexPixelHeight);
-					float p1= fowPixmap1->getPixelf(indexPixelWidth, indexPixelHeight);
-
-					if(p1 > exploredAlpha) {
-						fowPixmap1->setPixel(indexPixelWidth, indexPixelHeight, exploredAlpha);
-					}
-					if(p0 > p1) {
-						fowPixmap1->setPixel(indexPixelWidth, indexPixelHeight, p0);
-					}
-				}
-				else {
-					//printf("Line: %d\n",__LINE__);
-					fowPixmap1->setPixel(indexPixelWidth, indexPixelHeight, 1.f);
-				}
-			}
+		const uint32 pixelCount= fowPixmap1->getW() * fowPixmap1->getH();
+		if(fogOfWar == false) {
+			maxUint8Array(fowPixmap0->getPixels(), fowPixmap1->getPixels(), pixelCount);
+		}
+		else {
+			// visible cells fade back to explored unless seen again
+			const uint8 exploredAlphaByte= static_cast<uint8>(exploredAlpha * 255.f);
+			maxOrLimitUint8Array(fowPixmap0->getPixels(), fowPixmap1->getPixels(),
+					exploredAlphaByte, pixelCount);
 		}
 	}
 }
 
 void Minimap::updateFowTex(float t) {
 	if(fowTex && fowPixmap0 && fowPixmap1) {
-		for(int indexPixelWidth = 0;
-				indexPixelWidth < fowPixmap0->getW();
-				++indexPixelWidth){
-			for(int indexPixelHeight = 0;
-					indexPixelHeight < fowPixmap0->getH();
-					++indexPixelHeight){
-				float p1 = fowPixmap1->getPixelf(indexPixelWidth, indexPixelHeight);
-				float p2 = fowTex->getPixmap()->getPixelf(indexPixelWidth, indexPixelHeight);
-				if(p1 != p2) {
-					float p0 = fowPixmap0->getPixelf(indexPixelWidth, indexPixelHeight);
-					fowTex->getPixmap()->setPixel(indexPixelWidth, indexPixelHeight, p0+(t*(p1-p0)));
-				}
-			}
-		}
+		const uint32 pixelCount= fowPixmap0->getW() * fowPixmap0->getH();
+		lerpChangedUint8Array(fowPixmap0->getPixels(), fowPixmap1->getPixels(),
+				fowTex->getPixmap()->getPixels(), t, pixelCount);
 	}
 }
 
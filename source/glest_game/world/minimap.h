@@ -72,6 +72,7 @@ public:
 	const Texture2D *getTexture() const		{return tex;}
 
 	void incFowTextureAlphaSurface(const Vec2i sPos, float alpha, bool isIncrementalUpdate=false);
+	void incFowTextureAlphaMap(int surfaceW, int surfaceH);
 	void resetFowTex();
 	void updateFowTex(float t);
 	void setFogOfWar(bool value);
@@ -13,18 +13,244 @@
 
 #include <stdexcept>
 #include <algorithm>
+#include <set>
 
 #include "renderer.h"
 #include "util.h"
 #include "math_util.h"
+#include "checksum.h"
+#include "simple_threads.h"
+#include "platform_util.h"
 #include "leak_dumper.h"
 
 using namespace std;
 using namespace Shared::Util;
 using namespace Shared::Graphics;
+using namespace Shared::PlatformCommon;
 
 namespace Glest{ namespace Game{
 
+static const char *SPLAT_CACHE_FILE_FORMAT	= "surface_splats_%08x.bin";
+static const int32 SPLAT_CACHE_MAGIC		= 0x4d475353;
+static const int32 SPLAT_CACHE_VERSION		= 1;
+
+// =====================================================
+//	class SurfaceSplatTask
+// =====================================================
+
+class SurfaceSplatTask : public WorkerThreadTask {
+public:
+	const Pixmap2D *leftUp;
+	const Pixmap2D *rightUp;
+	const Pixmap2D *leftDown;
+	const Pixmap2D *rightDown;
+	Pixmap2D *pixmap;
+
+	// the splat only depends on the source pixels, its random
+	// generator always starts from the same seed
+	uint32 key[4];
+	bool cached;
+
+	SurfaceSplatTask() {
+		leftUp= NULL;
+		rightUp= NULL;
+		leftDown= NULL;
+		rightDown= NULL;
+		pixmap= NULL;
+		for(int i = 0; i < 4; ++i) {
+			key[i]= 0;
+		}
+		cached= false;
+	}
+
+	virtual void executeTask(BaseThread *callingThread) {
+		pixmap->splat(leftUp, rightUp, leftDown, rightDown);
+	}
+};
+
+struct SplatCacheKey {
+	uint32 key[4];
+	int32 w;
+	int32 h;
+	int32 components;
+
+	bool operator<(const SplatCacheKey &other) const {
+		for(int i = 0; i < 4; ++i) {
+			if(key[i] != other.key[i]) {
+				return key[i] < other.key[i];
+			}
+		}
+		if(w != other.w) {
+			return w < other.w;
+		}
+		if(h != other.h) {
+			return h < other.h;
+		}
+		return components < other.components;
+	}
+};
+
+static SplatCacheKey getSplatCacheKey(const SurfaceSplatTask &task) {
+	SplatCacheKey cacheKey;
+	for(int i = 0; i < 4; ++i) {
+		cacheKey.key[i]= task.key[i];
+	}
+	cacheKey.w= task.pixmap->getW();
+	cacheKey.h= task.pixmap->getH();
+	cacheKey.components= task.pixmap->getComponents();
+	return cacheKey;
+}
+
+static FILE *openSplatCache(const string &path, const char *mode) {
+#ifdef WIN32
+	return _wfopen(utf8_decode(path).c_str(), utf8_decode(mode).c_str());
+#else
+	return fopen(path.c_str(), mode);
+#endif
+}
+
+static uint32 getPixmapCRC(const Pixmap2D *pixmap, std::map<const Pixmap2D *, uint32> &pixmapCRCs) {
+	std::map<const Pixmap2D *, uint32>::iterator iterFind= pixmapCRCs.find(pixmap);
+	if(iterFind != pixmapCRCs.end()) {
+		return iterFind->second;
+	}
+	Checksum checksum;
+	checksum.addBytes(pixmap->getPixels(), pixmap->getPixelByteCount());
+	uint32 crc= checksum.getSum();
+	pixmapCRCs[pixmap]= crc;
+	return crc;
+}
+
+// finds the offset of the pixels of every complete entry in the cache
+// file, a truncated entry at the end and anything after it is dropped
+static void indexSplatCache(FILE *f, std::map<SplatCacheKey, long> &offsets) {
+	offsets.clear();
+	if(fseek(f, 0, SEEK_END) != 0) {
+		return;
+	}
+	const long fileSize= ftell(f);
+	if(fileSize < 0 || fseek(f, 0, SEEK_SET) != 0) {
+		return;
+	}
+
+	int32 header[2]= { 0, 0 };
+	if(fread(header, sizeof(header), 1, f) != 1 ||
+		header[0] != SPLAT_CACHE_MAGIC || header[1] != SPLAT_CACHE_VERSION) {
+		return;
+	}
+	for(;;) {
+		SplatCacheKey cacheKey;
+		if(fread(&cacheKey.key[0], sizeof(uint32), 4, f) != 4 ||
+			fread(&cacheKey.w, sizeof(int32), 1, f) != 1 ||
+			fread(&cacheKey.h, sizeof(int32), 1, f) != 1 ||
+			fread(&cacheKey.components, sizeof(int32), 1, f) != 1 ||
+			cacheKey.w <= 0 || cacheKey.h <= 0 || cacheKey.components <= 0) {
+			break;
+		}
+		const long offset= ftell(f);
+		const int64 byteCount= (int64)cacheKey.w * cacheKey.h * cacheKey.components;
+		// fseek succeeds past the end of the file
+		if(offset < 0 || byteCount > (int64)(fileSize - offset) ||
+			fseek(f, (long)byteCount, SEEK_CUR) != 0) {
+			break;
+		}
+		offsets[cacheKey]= offset;
+	}
+}
+
+// fills every task found in the cache file, returns how many were found
+static int readSplatCache(const string &path, vector<SurfaceSplatTask> &tasks) {
+	FILE *f= openSplatCache(path, "rb");
+	if(f == NULL) {
+		return 0;
+	}
+
+	std::map<SplatCacheKey, long> offsets;
+	indexSplatCache(f, offsets);
+
+	int foundCount= 0;
+	for(unsigned int i = 0; i < tasks.size(); ++i) {
+		SurfaceSplatTask &task= tasks[i];
+		std::map<SplatCacheKey, long>::const_iterator iterFind= offsets.find(getSplatCacheKey(task));
+		if(iterFind != offsets.end() && fseek(f, iterFind->second, SEEK_SET) == 0 &&
+			fread(task.pixmap->getPixels(), task.pixmap->getPixelByteCount(), 1, f) == 1) {
+			task.cached= true;
+			foundCount++;
+		}
+	}
+	fclose(f);
+	return foundCount;
+}
+
+static bool writeSplatCacheEntry(FILE *f, const SplatCacheKey &cacheKey, const void *pixels, size_t byteCount) {
+	return	fwrite(&cacheKey.key[0], sizeof(uint32), 4, f) == 4 &&
+			fwrite(&cacheKey.w, sizeof(int32), 1, f) == 1 &&
+			fwrite(&cacheKey.h, sizeof(int32), 1, f) == 1 &&
+			fwrite(&cacheKey.components, sizeof(int32), 1, f) == 1 &&
+			fwrite(pixels, byteCount, 1, f) == 1;
+}
+
+// writes the splats of this map and the valid entries of the old cache
+// file, other maps of the tileset use those, to a temp file and swaps it in
+static void writeSplatCache(const string &path, const vector<SurfaceSplatTask> &tasks) {
+	const string tempPath= path + ".tmp";
+	FILE *f= openSplatCache(tempPath, "wb");
+	if(f == NULL) {
+		SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] cannot write splat cache [%s]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,tempPath.c_str());
+		return;
+	}
+
+	int32 header[2]= { SPLAT_CACHE_MAGIC, SPLAT_CACHE_VERSION };
+	bool ok= (fwrite(header, sizeof(header), 1, f) == 1);
+
+	std::set<SplatCacheKey> written;
+	for(unsigned int i = 0; ok == true && i < tasks.size(); ++i) {
+		const SurfaceSplatTask &task= tasks[i];
+		SplatCacheKey cacheKey= getSplatCacheKey(task);
+		if(written.insert(cacheKey).second == true) {
+			ok= writeSplatCacheEntry(f, cacheKey, task.pixmap->getPixels(), task.pixmap->getPixelByteCount());
+		}
+	}
+
+	FILE *oldFile= (ok == true ? openSplatCache(path, "rb") : NULL);
+	if(oldFile != NULL) {
+		std::map<SplatCacheKey, long> offsets;
+		indexSplatCache(oldFile, offsets);
+		vector<char> pixels;
+		for(std::map<SplatCacheKey, long>::const_iterator iterMap = offsets.begin();
+			ok == true && iterMap != offsets.end(); ++iterMap) {
+			const SplatCacheKey &cacheKey= iterMap->first;
+			if(written.find(cacheKey) != written.end()) {
+				continue;
+			}
+			pixels.resize((size_t)cacheKey.w * cacheKey.h * cacheKey.components);
+			if(fseek(oldFile, iterMap->second, SEEK_SET) != 0 ||
+				fread(&pixels[0], pixels.size(), 1, oldFile) != 1) {
+				continue;
+			}
+			ok= writeSplatCacheEntry(f, cacheKey, &pixels[0], pixels.size());
+		}
+		fclose(oldFile);
+	}
+
+	if(fclose(f) != 0) {
+		ok= false;
+	}
+	if(ok == true) {
+#ifdef WIN32
+		// rename does not replace an existing file on windows
+		if(fileExists(path) == true) {
+			removeFile(path);
+		}
+#endif
+		ok= renameFile(tempPath, path);
+	}
+	if(ok == false) {
+		SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] cannot write splat cache [%s]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,path.c_str());
+		removeFile(tempPath);
+	}
+}
+
 // =====================================================
 //	class PixmapInfo
 // =====================================================
@@ -58,6 +284,22 @@ bool SurfaceInfo::operator==(const SurfaceInfo &si) const {
 		this->rightUp == si.getRightUp();
 }
 
+bool SurfaceInfo::operator<(const SurfaceInfo &si) const {
+	if(this->center != si.getCenter()) {
+		return this->center < si.getCenter();
+	}
+	if(this->leftDown != si.getLeftDown()) {
+		return this->leftDown < si.getLeftDown();
+	}
+	if(this->leftUp != si.getLeftUp()) {
+		return this->leftUp < si.getLeftUp();
+	}
+	if(this->rightDown != si.getRightDown()) {
+		return this->rightDown < si.getRightDown();
+	}
+	return this->rightUp < si.getRightUp();
+}
+
 // ===============================
 // 	class SurfaceAtlas
 // ===============================
@@ -83,8 +325,8 @@ void SurfaceAtlas::addSurface(SurfaceInfo *si) {
 	}
 
 	//add info
-	SurfaceInfos::iterator it = find(surfaceInfos.begin(), surfaceInfos.end(), *si);
-	if(it == surfaceInfos.end()) {
+	SurfaceIndex::const_iterator it = surfaceIndex.find(*si);
+	if(it == surfaceIndex.end()) {
 		//add new texture
 		Texture2D *t= Renderer::getInstance().newTexture2D(rsGame);
 		if(t) {
@@ -97,6 +339,7 @@ void SurfaceAtlas::addSurface(SurfaceInfo *si) {
 		
 		si->setCoord(Vec2f(0.f, 0.f));
 		si->setTexture(t);
+		surfaceIndex[*si]= (int)surfaceInfos.size();
 		surfaceInfos.push_back(*si);
 		
 		//copy texture to pixmap
@@ -106,15 +349,83 @@ void SurfaceAtlas::addSurface(SurfaceInfo *si) {
 			}
 		}
 		else {
+			// splats are generated together, see generatePendingSplats
 			if(t) {
-				t->getPixmap()->splat(si->getLeftUp(), si->getRightUp(), si->getLeftDown(), si->getRightDown());
+				PendingSplat splat;
+				splat.leftUp= si->getLeftUp();
+				splat.rightUp= si->getRightUp();
+				splat.leftDown= si->getLeftDown();
+				splat.rightDown= si->getRightDown();
+				splat.pixmap= t->getPixmap();
+				pendingSplats.push_back(splat);
 			}
 		}
 	}
 	else{
-		si->setCoord(it->getCoord());
-		si->setTexture(it->getTexture());
+		const SurfaceInfo &found= surfaceInfos[it->second];
+		si->setCoord(found.getCoord());
+		si->setTexture(found.getTexture());
+	}
+}
+
+void SurfaceAtlas::generatePendingSplats(uint32 tilesetCRC, int threadCount) {
+	if(pendingSplats.empty() == true) {
+		return;
 	}
+
+	Chrono chrono;
+	chrono.start();
+
+	std::map<const Pixmap2D *, uint32> pixmapCRCs;
+	vector<SurfaceSplatTask> tasks(pendingSplats.size());
+	for(unsigned int i = 0; i < pendingSplats.size(); ++i) {
+		const PendingSplat &splat= pendingSplats[i];
+		SurfaceSplatTask &task= tasks[i];
+		task.leftUp= splat.leftUp;
+		task.rightUp= splat.rightUp;
+		task.leftDown= splat.leftDown;
+		task.rightDown= splat.rightDown;
+		task.pixmap= splat.pixmap;
+		task.key[0]= getPixmapCRC(splat.leftUp, pixmapCRCs);
+		task.key[1]= getPixmapCRC(splat.rightUp, pixmapCRCs);
+		task.key[2]= getPixmapCRC(splat.leftDown, pixmapCRCs);
+		task.key[3]= getPixmapCRC(splat.rightDown, pixmapCRCs);
+	}
+	pendingSplats.clear();
+
+	string cacheFile= "";
+	if(getCRCCacheFilePath() != "") {
+		char szBuf[1024]="";
+		snprintf(szBuf,1024,SPLAT_CACHE_FILE_FORMAT,tilesetCRC);
+		cacheFile= getCRCCacheFilePath() + szBuf;
+	}
+
+	int cachedCount= 0;
+	if(cacheFile != "") {
+		cachedCount= readSplatCache(cacheFile, tasks);
+	}
+
+	if(cachedCount < (int)tasks.size()) {
+		WorkerThreadPool pool("SurfaceSplat",threadCount);
+		for(unsigned int i = 0; i < tasks.size(); ++i) {
+			if(tasks[i].cached == false) {
+				pool.queueTask(&tasks[i]);
+			}
+		}
+		pool.waitForAllTasks();
+
+		for(unsigned int i = 0; i < tasks.size(); ++i) {
+			if(tasks[i].hasError() == true) {
+				throw megaglest_runtime_error("Error generating surface splat: " + tasks[i].getErrorMessage());
+			}
+		}
+
+		if(cacheFile != "") {
+			writeSplatCache(cacheFile, tasks);
+		}
+	}
+
+	if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] %d surface splats, %d from cache, took %lld usecs\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,(int)tasks.size(),cachedCount,(long long int)chrono.getMicros());
 }
 
 float SurfaceAtlas::getCoordStep() const {
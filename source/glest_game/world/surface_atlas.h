@@ -19,6 +19,7 @@
 
 #include <vector>
 #include <set>
+#include <map>
 #include "texture.h"
 #include "vec.h"
 #include "leak_dumper.h"
@@ -29,6 +30,7 @@ using Shared::Graphics::Pixmap2D;
 using Shared::Graphics::Texture2D;
 using Shared::Graphics::Vec2i;
 using Shared::Graphics::Vec2f;
+using Shared::Platform::uint32;
 
 namespace Glest{ namespace Game{
 
@@ -50,6 +52,7 @@ public:
 	explicit SurfaceInfo(const Pixmap2D *center);
 	SurfaceInfo(const Pixmap2D *lu, const Pixmap2D *ru, const Pixmap2D *ld, const Pixmap2D *rd);
 	bool operator==(const SurfaceInfo &si) const;
+	bool operator<(const SurfaceInfo &si) const;
 
 	inline const Pixmap2D *getCenter() const		{return center;}
 	inline const Pixmap2D *getLeftUp() const		{return leftUp;}
@@ -72,15 +75,29 @@ public:
 class SurfaceAtlas{
 private:
 	typedef vector<SurfaceInfo> SurfaceInfos;
+	typedef std::map<SurfaceInfo, int> SurfaceIndex;
+
+	// a splatted texture waiting for generatePendingSplats
+	struct PendingSplat {
+		const Pixmap2D *leftUp;
+		const Pixmap2D *rightUp;
+		const Pixmap2D *leftDown;
+		const Pixmap2D *rightDown;
+		Pixmap2D *pixmap;
+	};
+	typedef vector<PendingSplat> PendingSplats;
 
 private:
 	SurfaceInfos surfaceInfos;
+	SurfaceIndex surfaceIndex;
+	PendingSplats pendingSplats;
 	int surfaceSize;
 
 public:
 	SurfaceAtlas();
 
 	void addSurface(SurfaceInfo *si);
+	void generatePendingSplats(uint32 tilesetCRC, int threadCount);
 	float getCoordStep() const;
 
 private:
@@ -22,6 +22,7 @@
 #include "properties.h"
 #include "lang.h"
 #include "platform_util.h"
+#include "config.h"
 
 using namespace Shared::Util;
 using namespace Shared::Xml;
@@ -566,4 +567,9 @@ void Tileset::addSurfTex(int leftUp, int rightUp, int leftDown, int rightDown, V
 	}
 }
 
+void Tileset::generateSurfTex() {
+	int threadCount= Config::getInstance().getInt("SurfaceSplatThreads","3");
+	surfaceAtlas.generatePendingSplats(checksumValue.getSum(), threadCount);
+}
+
 }}// end namespace
@@ -32,6 +32,7 @@
 #include "logger.h"
 #include "sound_renderer.h"
 #include "game_settings.h"
+#include "profiler.h"
 #include "cache_manager.h"
 #include <iostream>
 #include "sound.h"
@@ -53,6 +54,10 @@ int MaxExploredCellsLookupItemCache = 9500;
 //int MaxExploredCellsLookupItemCache = 0;
 time_t ExploredCellsLookupItem::lastDebug = 0;
 
+// settings read every frame
+static ConfigValue<bool> configShowPerfStats("ShowPerfStats","false");
+static ConfigValue<bool> configEnableNewThreadManager("EnableNewThreadManager","false");
+
 // ===================== PUBLIC ========================
 
 World::World() : mutexFactionNextUnitId(new Mutex(CODE_AT_LINE)) {
@@ -584,7 +589,8 @@ void World::updateAllTilesetObjects() {
 }
 
 void World::updateAllFactionUnits() {
-	bool showPerfStats = Config::getInstance().getBool("ShowPerfStats","false");
+	PROFILE_ZONE("World::updateAllFactionUnits");
+	bool showPerfStats = configShowPerfStats.get();
 	Chrono chronoPerf;
 	if(showPerfStats) chronoPerf.start();
 	char perfBuf[8096]="";
@@ -627,7 +633,7 @@ void World::updateAllFactionUnits() {
 	Chrono chrono;
 	chrono.start();
 
-	const bool newThreadManager = Config::getInstance().getBool("EnableNewThreadManager","false");
+	const bool newThreadManager = configEnableNewThreadManager.get();
 	if(newThreadManager == true) {
 		masterController.signalSlaves(&frameCount);
 		bool slavesCompleted = masterController.waitTillSlavesTrigger(20000);
@@ -837,7 +843,7 @@ void World::update() {
 
 	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
 
-	bool showPerfStats = Config::getInstance().getBool("ShowPerfStats","false");
+	bool showPerfStats = configShowPerfStats.get();
 	Chrono chronoPerf;
 	char perfBuf[8096]="";
 	std::vector<string> perfList;
@@ -847,6 +853,9 @@ void World::update() {
 
 	++frameCount;
 
+	FrameProfiler::getInstance().beginFrame(frameCount);
+	PROFILE_ZONE("World::update");
+
 	//time
 	timeFlow.update();
 	if(scriptManager) scriptManager->onDayNightTriggerEvent();
@@ -872,7 +881,7 @@ void World::update() {
 
 	updateAllTilesetObjects();
 
-	if(this->game) this->game->addPerformanceCount("updateAllTilesetObjects",chronoGamePerformanceCounts.getMillis());
+	if(this->game) this->game->addPerformanceCount("updateAllTilesetObjects",chronoGamePerformanceCounts.getMicros());
 
 	if(showPerfStats) {
 		sprintf(perfBuf,"In [%s::%s] Line: %d took msecs: " MG_I64_SPECIFIER "\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,chronoPerf.getMillis());
@@ -885,7 +894,7 @@ void World::update() {
 
 		updateAllFactionUnits();
 
-		if(this->game) this->game->addPerformanceCount("updateAllFactionUnits",chronoGamePerformanceCounts.getMillis());
+		if(this->game) this->game->addPerformanceCount("updateAllFactionUnits",chronoGamePerformanceCounts.getMicros());
 
 		if(showPerfStats) {
 			sprintf(perfBuf,"In [%s::%s] Line: %d took msecs: " MG_I64_SPECIFIER "\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,chronoPerf.getMillis());
@@ -897,7 +906,7 @@ void World::update() {
 
 		underTakeDeadFactionUnits();
 
-		if(this->game) this->game->addPerformanceCount("underTakeDeadFactionUnits",chronoGamePerformanceCounts.getMillis());
+		if(this->game) this->game->addPerformanceCount("underTakeDeadFactionUnits",chronoGamePerformanceCounts.getMicros());
 
 		if(showPerfStats) {
 			sprintf(perfBuf,"In [%s::%s] Line: %d took msecs: " MG_I64_SPECIFIER "\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,chronoPerf.getMillis());
@@ -911,7 +920,7 @@ void World::update() {
 
 		updateAllFactionConsumableCosts();
 
-		if(this->game) this->game->addPerformanceCount("updateAllFactionConsumableCosts",chronoGamePerformanceCounts.getMillis());
+		if(this->game) this->game->addPerformanceCount("updateAllFactionConsumableCosts",chronoGamePerformanceCounts.getMicros());
 
 		if(showPerfStats) {
 			sprintf(perfBuf,"In [%s::%s] Line: %d took msecs: " MG_I64_SPECIFIER "\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,chronoPerf.getMillis());
@@ -926,7 +935,7 @@ void World::update() {
 			float fogFactor= static_cast<float>(frameCount % GameConstants::updateFps) / GameConstants::updateFps;
 			minimap.updateFowTex(clamp(fogFactor, 0.f, 1.f));
 
-			if(this->game) this->game->addPerformanceCount("minimap.updateFowTex",chronoGamePerformanceCounts.getMillis());
+			if(this->game) this->game->addPerformanceCount("minimap.updateFowTex",chronoGamePerformanceCounts.getMicros());
 		}
 
 		if(showPerfStats) {
@@ -951,7 +960,7 @@ void World::update() {
 
 			tick();
 
-			if(this->game) this->game->addPerformanceCount("world->tick",chronoGamePerformanceCounts.getMillis());
+			if(this->game) this->game->addPerformanceCount("world->tick",chronoGamePerformanceCounts.getMicros());
 		}
 
 		if(showPerfStats) {
@@ -960,6 +969,17 @@ void World::update() {
 		}
 	}
 
+	if(scriptManager != NULL) {
+		if(this->game) chronoGamePerformanceCounts.start();
+
+		// unit events the script asked to have batched, once per frame
+		// after everything that can raise them
+		scriptManager->deliverQueuedEvents();
+
+		if(this->game) this->game->addPerformanceCount("world scriptManager->deliverQueuedEvents()",chronoGamePerformanceCounts.getMicros());
+		if(this->game) this->game->addPerformanceCount("world lua script calls",scriptManager->takeLuaCallMicros());
+	}
+
 	if(showPerfStats && chronoPerf.getMillis() >= 50) {
 		for(unsigned int x = 0; x < perfList.size(); ++x) {
 			printf("%s",perfList[x].c_str());
@@ -975,7 +995,8 @@ bool World::canTickWorld() const {
 }
 
 void World::tick() {
-	bool showPerfStats = Config::getInstance().getBool("ShowPerfStats","false");
+	PROFILE_ZONE("World::tick");
+	bool showPerfStats = configShowPerfStats.get();
 	Chrono chronoPerf;
 	char perfBuf[8096]="";
 	std::vector<string> perfList;
@@ -991,7 +1012,7 @@ void World::tick() {
 
 	computeFow();
 
-	if(this->game) this->game->addPerformanceCount("world->computeFow",chronoGamePerformanceCounts.getMillis());
+	if(this->game) this->game->addPerformanceCount("world->computeFow",chronoGamePerformanceCounts.getMicros());
 
 	if(showPerfStats) {
 		sprintf(perfBuf,"In [%s::%s] Line: %d took msecs: " MG_I64_SPECIFIER " fogOfWar: %d\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,chronoPerf.getMillis(),fogOfWar);
@@ -1003,7 +1024,7 @@ void World::tick() {
 
 		minimap.updateFowTex(1.f);
 
-		if(this->game) this->game->addPerformanceCount("minimap.updateFowTex",chronoGamePerformanceCounts.getMillis());
+		if(this->game) this->game->addPerformanceCount("minimap.updateFowTex",chronoGamePerformanceCounts.getMicros());
 	}
 
 	if(showPerfStats) {
@@ -1028,7 +1049,7 @@ void World::tick() {
 			unit->tick();
 		}
 	}
-	if(this->game) this->game->addPerformanceCount("world unit->tick()",chronoGamePerformanceCounts.getMillis());
+	if(this->game) this->game->addPerformanceCount("world unit->tick()",chronoGamePerformanceCounts.getMicros());
 
 	if(showPerfStats) {
 		sprintf(perfBuf,"In [%s::%s] Line: %d took msecs: " MG_I64_SPECIFIER "\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,chronoPerf.getMillis());
@@ -1080,7 +1101,7 @@ void World::tick() {
 			}
 		}
 	}
-	if(this->game) this->game->addPerformanceCount("world faction->setResourceBalance()",chronoGamePerformanceCounts.getMillis());
+	if(this->game) this->game->addPerformanceCount("world faction->setResourceBalance()",chronoGamePerformanceCounts.getMicros());
 
 	if(showPerfStats) {
 		sprintf(perfBuf,"In [%s::%s] Line: %d took msecs: " MG_I64_SPECIFIER "\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,chronoPerf.getMillis());
@@ -2031,6 +2052,7 @@ void World::initSplattedTextures() {
 			sc00->setSurfaceTexture(texture);
 		}
 	}
+	tileset.generateSurfTex();
 	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 }
 
@@ -2548,6 +2570,7 @@ bool World::showWorldForPlayer(int factionIndex, bool excludeFogOfWarCheck) cons
 
 //computes the fog of war texture, contained in the minimap
 void World::computeFow() {
+	PROFILE_ZONE("World::computeFow");
 	if(SystemFlags::VERBOSE_MODE_ENABLED) printf("In [%s::%s] Line: %d in frame: %d\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,getFrameCount());
 
 	Chrono chronoGamePerformanceCounts;
@@ -2555,7 +2578,7 @@ void World::computeFow() {
 
 	minimap.resetFowTex();
 
-	if(this->game) this->game->addPerformanceCount("world minimap.resetFowTex",chronoGamePerformanceCounts.getMillis());
+	if(this->game) this->game->addPerformanceCount("world minimap.resetFowTex",chronoGamePerformanceCounts.getMicros());
 
 	// reset cells
 	if(SystemFlags::VERBOSE_MODE_ENABLED) printf("In [%s::%s] Line: %d in frame: %d\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,getFrameCount());
@@ -2600,65 +2623,20 @@ void World::computeFow() {
 			if(showWorldForFaction == true) {
 				resetFowAlphaFactionCount++;
 			}
-			for(int indexSurfaceW = 0; indexSurfaceW < map.getSurfaceW(); ++indexSurfaceW) {
-				for(int indexSurfaceH = 0; indexSurfaceH < map.getSurfaceH(); ++indexSurfaceH) {
-					// reset fog of ware texture alpha values
-					if(!fogOfWar || (cacheFowAlphaTexture == false &&
-						showWorldForFaction == true &&
-							resetFowAlphaFactionCount <= 1)) {
-						const Vec2i surfPos(indexSurfaceW,indexSurfaceH);
-
-						//compute max alpha
-						float maxAlpha= 0.0f;
-						if(surfPos.x > 1 && surfPos.y > 1 &&
-						   surfPos.x < map.getSurfaceW() - 2 &&
-						   surfPos.y < map.getSurfaceH() - 2) {
-							maxAlpha= 1.f;
-						}
-						else if(surfPos.x > 0 && surfPos.y > 0 &&
-								surfPos.x < map.getSurfaceW() - 1 &&
-								surfPos.y < map.getSurfaceH() - 1){
-							maxAlpha= 0.3f;
-						}
-
-						// compute alpha
-						float alpha = maxAlpha;
-						minimap.incFowTextureAlphaSurface(surfPos, alpha);
-					}
-				}
+			// reset fog of ware texture alpha values
+			if(!fogOfWar || (cacheFowAlphaTexture == false &&
+				showWorldForFaction == true &&
+					resetFowAlphaFactionCount <= 1)) {
+				minimap.incFowTextureAlphaMap(map.getSurfaceW(), map.getSurfaceH());
 			}
 		}
 		// Remove fog of war for factions on my team
 		else if(fogOfWar && (faction->getTeam() == thisTeamIndex)) {
 			bool showWorldForFaction = showWorldForPlayer(factionIndex);
 			//printf("#2 showWorldForFaction thisFactionIndex = %d thisTeamIndex = %d showWorldForFaction = %d\n",thisFactionIndex,thisTeamIndex,showWorldForFaction);
-			if(showWorldForFaction == true) {
-				for(int indexSurfaceW = 0; indexSurfaceW < map.getSurfaceW(); ++indexSurfaceW) {
-					for(int indexSurfaceH = 0; indexSurfaceH < map.getSurfaceH(); ++indexSurfaceH) {
-						// reset fog of ware texture alpha values
-						if(!fogOfWar || (cacheFowAlphaTexture == false &&
-							showWorldForFaction == true)) {
-							const Vec2i surfPos(indexSurfaceW,indexSurfaceH);
-
-							//compute max alpha
-							float maxAlpha= 0.0f;
-							if(surfPos.x > 1 && surfPos.y > 1 &&
-							   surfPos.x < map.getSurfaceW() - 2 &&
-							   surfPos.y < map.getSurfaceH() - 2) {
-								maxAlpha= 1.f;
-							}
-							else if(surfPos.x > 0 && surfPos.y > 0 &&
-									surfPos.x < map.getSurfaceW() - 1 &&
-									surfPos.y < map.getSurfaceH() - 1){
-								maxAlpha= 0.3f;
-							}
-
-							// compute alpha
-							float alpha = maxAlpha;
-							minimap.incFowTextureAlphaSurface(surfPos, alpha);
-						}
-					}
-				}
+			// reset fog of ware texture alpha values
+			if(showWorldForFaction == true && cacheFowAlphaTexture == false) {
+				minimap.incFowTextureAlphaMap(map.getSurfaceW(), map.getSurfaceH());
 			}
 		}
 
@@ -2673,7 +2651,7 @@ void World::computeFow() {
 		minimap.copyFowTexAlphaSurface();
 	}
 
-	if(this->game) this->game->addPerformanceCount("world reset cells",chronoGamePerformanceCounts.getMillis());
+	if(this->game) this->game->addPerformanceCount("world reset cells",chronoGamePerformanceCounts.getMicros());
 
 	if(SystemFlags::VERBOSE_MODE_ENABLED) printf("In [%s::%s] Line: %d in frame: %d\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,getFrameCount());
 
@@ -2725,7 +2703,7 @@ void World::computeFow() {
 		}
 	}
 
-	if(this->game) this->game->addPerformanceCount("world compute cells",chronoGamePerformanceCounts.getMillis());
+	if(this->game) this->game->addPerformanceCount("world compute cells",chronoGamePerformanceCounts.getMicros());
 }
 
 GameSettings * World::getGameSettingsPtr() {
@@ -13,6 +13,8 @@
 #define _SHARED_COMPRESSION_UTIL_CHECKSUM_H_
 
 #include <string>
+#include <vector>
+#include <stdio.h>
 
 using std::string;
 
@@ -23,6 +25,38 @@ bool extractFileFromZIPFile(string inFile, string outFile);
 std::pair<unsigned char *,unsigned long> compressMemoryToMemory(unsigned char *input, unsigned long input_len, int compressionLevel=5);
 std::pair<unsigned char *,unsigned long> extractMemoryToMemory(unsigned char *input, unsigned long input_len, unsigned long max_output_len);
 
+bool isZIPArchive(string archiveFile);
+bool extractZIPArchiveToFolder(string archiveFile, string outputPath, bool cacheFileChecksums=false);
+
+// true when the data starts with a zlib stream header
+bool isDeflateData(const unsigned char *data, size_t size);
+void inflateMemoryToVector(const unsigned char *input, size_t inputLen, std::vector<char> &output);
+
+//
+// Compresses data into a zlib stream file as it is written, so the
+// whole uncompressed content never has to be held in memory
+//
+class DeflateFileWriter {
+private:
+	FILE *file;
+	void *stream;
+	std::vector<unsigned char> outBuffer;
+	string path;
+
+	DeflateFileWriter(const DeflateFileWriter &);
+	void operator =(const DeflateFileWriter &);
+
+	void deflateInput(bool finish);
+
+public:
+	DeflateFileWriter();
+	~DeflateFileWriter();
+
+	void open(const string &path, int compressionLevel=5);
+	void write(const void *data, size_t size);
+	void close();
+};
+
 }};
 
 #endif
@@ -242,7 +242,9 @@ static inline T* readFromFileReaders(vector<FileReader<T> const *>* readers, con
 template <typename T>
 T* FileReader<T>::readPath(const string& filepath) {
 	const string& extension = extractExtension(filepath);
-	vector<FileReader<T> const * >* possibleReaders = (getFileReadersMap())[extension];
+	// find instead of operator[] so texture decode threads never insert into the shared map
+	typename map<string, vector<FileReader<T> const * >* >::const_iterator iterFind = getFileReadersMap().find(extension);
+	vector<FileReader<T> const * >* possibleReaders = (iterFind != getFileReadersMap().end() ? iterFind->second : NULL);
 	if (possibleReaders != NULL) {
 		//Search in these possible readers
 		T* ret = readFromFileReaders(possibleReaders, filepath);
@@ -265,7 +267,9 @@ T* FileReader<T>::readPath(const string& filepath) {
 template <typename T>
 T* FileReader<T>::readPath(const string& filepath, T* object) {
 	const string& extension = extractExtension(filepath);
-	vector<FileReader<T> const * >* possibleReaders = (getFileReadersMap())[extension];
+	// find instead of operator[] so texture decode threads never insert into the shared map
+	typename map<string, vector<FileReader<T> const * >* >::const_iterator iterFind = getFileReadersMap().find(extension);
+	vector<FileReader<T> const * >* possibleReaders = (iterFind != getFileReadersMap().end() ? iterFind->second : NULL);
 	if (possibleReaders != NULL) {
 		//Search in these possible readers
 		T* ret = readFromFileReaders(possibleReaders, filepath, object);
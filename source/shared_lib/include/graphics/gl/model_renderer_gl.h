@@ -19,6 +19,24 @@
 
 namespace Shared { namespace Graphics { namespace Gl {
 
+// =====================================================
+//	class ModelPlacement
+//
+/// Placement of one copy of a model drawn by
+/// ModelRendererGl::renderBatch
+// =====================================================
+
+class ModelPlacement {
+public:
+	Vec3f position;
+	// degrees, applied around z, x and then y
+	Vec3f rotation;
+
+	ModelPlacement() {}
+	ModelPlacement(const Vec3f &position, const Vec3f &rotation) :
+		position(position), rotation(rotation) {}
+};
+
 // =====================================================
 //	class ModelRendererGl
 // =====================================================
@@ -37,12 +55,20 @@ public:
 	virtual void render(Model *model,int renderMode=rmNormal);
 	virtual void renderNormalsOnly(Model *model);
 
+	// draws copies of a model that share its current interpolated frame and
+	// mesh callback state, the mesh state is set up once for all of them
+	// and each copy is still its own draw call
+	void renderBatch(Model *model, const ModelPlacement *placements, int placementCount, int renderMode=rmNormal);
+
 	void setDuplicateTexCoords(bool duplicateTexCoords)			{this->duplicateTexCoords= duplicateTexCoords;}
 	void setSecondaryTexCoordUnit(int secondaryTexCoordUnit)	{this->secondaryTexCoordUnit= secondaryTexCoordUnit;}
 
 private:
 	
 	void renderMesh(Mesh *mesh,int renderMode=rmNormal);
+	bool beginMesh(Mesh *mesh,int renderMode);
+	void drawMesh(Mesh *mesh);
+	void endMesh(Mesh *mesh,int renderMode);
 	void renderMeshNormals(Mesh *mesh);
 };
 
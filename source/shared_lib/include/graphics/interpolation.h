@@ -15,41 +15,174 @@
 #include "vec.h"
 #include "model.h"
 #include <map>
+#include <vector>
 #include "leak_dumper.h"
 
+namespace Shared{ namespace PlatformCommon{ class WorkerThreadPool; }}
+namespace Shared{ namespace Platform{ class Mutex; }}
+
 namespace Shared{ namespace Graphics{
 
+using Shared::PlatformCommon::WorkerThreadPool;
+using Shared::Platform::Mutex;
+
 // =====================================================
 //	class InterpolationData
 // =====================================================
 
 class InterpolationData{
 private:
+	// a frame shared through the InterpolationCache, not owned
+	class CachedFrame {
+	public:
+		const Vec3f *data;
+		uint32 generation;
+		float t;
+		bool cycle;
+
+		CachedFrame() : data(NULL), generation(0), t(0), cycle(false) {}
+	};
+
 	const Mesh *mesh;
 
 	Vec3f *vertices;
 	Vec3f *normals;
 
+	mutable CachedFrame cachedVertices;
+	mutable CachedFrame cachedNormals;
+
 	int raw_frame_ofs;
 
 	static bool enableInterpolation;
 	
-	void update(const Vec3f* src, Vec3f* &dest, float t, bool cycle);
+	void update(const Vec3f* src, Vec3f* &dest, CachedFrame &cached, float t, bool cycle);
+	const Vec3f *getFrame(const Vec3f *src, const Vec3f *dest, CachedFrame &cached) const;
 
 public:
 	InterpolationData(const Mesh *mesh);
 	~InterpolationData();
 
 	static void setEnableInterpolation(bool enabled) { enableInterpolation = enabled; }
+	static bool getEnableInterpolation() { return enableInterpolation; }
 
-	const Vec3f *getVertices() const	{return !vertices || !enableInterpolation? mesh->getVertices()+raw_frame_ofs: vertices;}
-	const Vec3f *getNormals() const		{return !normals || !enableInterpolation? mesh->getNormals()+raw_frame_ofs: normals;}
+	static void getFrames(uint32 frameCount, float t, bool cycle,
+			uint32 &prevFrame, uint32 &nextFrame, float &localT);
+	static void interpolate(const Vec3f *src, uint32 frameCount, uint32 vertexCount,
+			float t, bool cycle, Vec3f *dest);
+	static void lerpArray(const Vec3f *prev, const Vec3f *next, float t,
+			Vec3f *dest, uint32 count);
+
+	const Vec3f *getVertices() const	{return getFrame(mesh->getVertices(), vertices, cachedVertices);}
+	const Vec3f *getNormals() const		{return getFrame(mesh->getNormals(), normals, cachedNormals);}
+
+	// the current frame when every user of the mesh at this time sees the
+	// same data, NULL when it was interpolated into this object's own buffer
+	const Vec3f *getSharedVertices() const;
+	const Vec3f *getSharedNormals() const;
 	
 	void update(float t, bool cycle);
 	void updateVertices(float t, bool cycle);
 	void updateNormals(float t, bool cycle);
 };
 
+class InterpolationFillTask;
+
+// =====================================================
+//	class InterpolationCache
+//
+/// Interpolated frames shared by every unit showing the
+/// same mesh at the same (quantized) animation time,
+/// filled in parallel before the units are drawn
+// =====================================================
+
+class InterpolationCache {
+public:
+	class Key {
+	public:
+		const Vec3f *src;
+		uint32 step;
+		bool cycle;
+
+		Key(const Vec3f *src, uint32 step, bool cycle) : src(src), step(step), cycle(cycle) {}
+		bool operator<(const Key &other) const {
+			if(src != other.src) return src < other.src;
+			if(step != other.step) return step < other.step;
+			return cycle < other.cycle;
+		}
+	};
+
+	class Entry {
+	public:
+		Vec3f *data;
+		uint32 vertexCount;
+		int lastUsedFrame;
+
+		Entry() : data(NULL), vertexCount(0), lastUsedFrame(0) {}
+	};
+
+private:
+	typedef std::map<Key, Entry> EntryMap;
+
+	static InterpolationCache *instance;
+
+	Mutex *mutex;
+	EntryMap entries;
+	std::vector<InterpolationFillTask *> queuedTasks;
+	WorkerThreadPool *fillPool;
+
+	uint32 timeSteps;
+	int maxIdleFrames;
+	int frameIndex;
+	uint32 evictionGeneration;
+	uint64 vertexBytes;
+
+	uint64 hitCount;
+	uint64 missCount;
+	int64 fillMicros;
+
+	InterpolationCache();
+
+	Key makeKey(const Vec3f *src, uint32 frameCount, float t, bool cycle, float &quantizedT) const;
+	void removeEntry(EntryMap::iterator iterFind);
+
+public:
+	~InterpolationCache();
+	static InterpolationCache &getInstance();
+
+	// 0 time steps turns the cache off
+	void setTimeSteps(uint32 value);
+	uint32 getTimeSteps() const	{ return timeSteps; }
+	bool isEnabled() const		{ return timeSteps > 0; }
+	void setThreadCount(int threadCount);
+	void setMaxIdleFrames(int value) { maxIdleFrames = value; }
+
+	const Vec3f *get(const Vec3f *src, uint32 frameCount, uint32 vertexCount, float t, bool cycle);
+
+	// the quantized frame shown at t, units with the same step share
+	// their interpolated vertices, 0 when nothing is shared
+	uint32 getFrameStep(uint32 frameCount, float t, bool cycle) const;
+	uint32 getFrameStep(const Model *model, float t, bool cycle) const;
+
+	void queue(const Vec3f *src, uint32 frameCount, uint32 vertexCount, float t, bool cycle);
+	void queue(const Model *model, float t, bool cycle);
+	void fillQueued();
+
+	// bumped whenever cached frames are freed so holders look them up again
+	uint32 getEvictionGeneration() const { return evictionGeneration; }
+
+	void nextFrame();
+	void clear();
+	static void releaseSource(const Vec3f *src);
+
+	uint64 getHitCount() const	{ return hitCount; }
+	uint64 getMissCount() const	{ return missCount; }
+	int64 getFillMicros() const	{ return fillMicros; }
+	int getEntryCount() const	{ return (int)entries.size(); }
+	uint64 getVertexBytes() const { return vertexBytes; }
+	void resetStats();
+	string getStatsString() const;
+};
+
 }}//end namespace
 
 #endif
@@ -0,0 +1,104 @@
+// ==============================================================
+//	This file is part of Glest Shared Library (www.glest.org)
+//
+//	Copyright (C) 2001-2008 Martiño Figueroa
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#ifndef _SHARED_GRAPHICS_LOOSEQUADTREE_H_
+#define _SHARED_GRAPHICS_LOOSEQUADTREE_H_
+
+#include "vec.h"
+#include <vector>
+#include "leak_dumper.h"
+
+namespace Shared{ namespace Graphics{
+
+// =====================================================
+//	class LooseQuadTree
+//
+/// Loose quadtree over the x/z plane of the world used to
+/// cull whole groups of objects against the frustum
+// =====================================================
+
+class LooseQuadTree {
+public:
+	// the six planes of Renderer::ExtractFrustum, inside is positive
+	typedef std::vector<std::vector<float> > Frustum;
+
+private:
+	class Node {
+	public:
+		int parent;
+		std::vector<int> items;
+		// items in this node and all of its children
+		int subtreeItemCount;
+		// bounds of the items of the subtree, only grow until it is empty
+		Vec3f boundsMin;
+		Vec3f boundsMax;
+
+		Node();
+	};
+
+	class Item {
+	public:
+		void *userData;
+		Vec3f center;
+		float radius;
+		int node;
+		// index in the items of the node
+		int slot;
+
+		Item();
+	};
+
+	std::vector<Node> nodes;
+	std::vector<Item> items;
+	std::vector<int> freeItems;
+	int itemCount;
+
+	Vec2f origin;
+	float size;
+	int levels;
+
+	static int getLevelStart(int level);
+	int findNode(const Vec3f &center, float radius) const;
+	void linkItem(int itemIndex, int nodeIndex);
+	void unlinkItem(int itemIndex);
+	void growBounds(int itemIndex);
+
+	void cullNode(int level, int x, int y, const Frustum &frustum, std::vector<int> &result) const;
+	void collectNode(int level, int x, int y, std::vector<int> &result) const;
+
+public:
+	LooseQuadTree();
+
+	// a square of the given size starting at origin, items outside of it
+	// are kept in the border nodes
+	void init(const Vec2f &origin, float size, int levels);
+	void clear();
+
+	int addItem(void *userData, const Vec3f &center, float radius);
+	void moveItem(int item, const Vec3f &center, float radius);
+	void removeItem(int item);
+
+	void *getUserData(int item) const		{return items[item].userData;}
+	const Vec3f &getCenter(int item) const	{return items[item].center;}
+	int getItemCount() const				{return itemCount;}
+	int getNodeCount() const				{return (int)nodes.size();}
+
+	// adds the items whose cube of half size radius is not fully
+	// outside one of the planes, the same test as CubeInFrustum
+	void cull(const Frustum &frustum, std::vector<int> &result) const;
+
+	static bool boxInFrustum(const Frustum &frustum, const Vec3f &boxMin, const Vec3f &boxMax);
+	static bool boxFullyInFrustum(const Frustum &frustum, const Vec3f &boxMin, const Vec3f &boxMax);
+};
+
+}}//end namespace
+
+#endif
@@ -14,6 +14,7 @@
 
 #include "math_wrapper.h"
 #include "vec.h"
+#include "matrix.h"
 #include "data_types.h"
 #include "leak_dumper.h"
 
@@ -278,6 +279,48 @@ inline T radToDeg(T rad){
 	return (rad*360)/(2*pi);
 }
 
+// =====================================================
+//	Vec3f array kernels
+//
+/// Batch operations over packed Vec3f arrays, the SSE2 and
+/// AVX2 versions are picked at runtime and give the same
+/// results as the scalar fallback
+// =====================================================
+
+enum VecArraySimdLevel {
+	vasScalar,
+	vasSSE2,
+	vasAVX2
+};
+
+VecArraySimdLevel getSupportedVecArraySimdLevel();
+VecArraySimdLevel getVecArraySimdLevel();
+// levels above the supported one are lowered to it
+void setVecArraySimdLevel(VecArraySimdLevel level);
+const char *getVecArraySimdLevelName(VecArraySimdLevel level);
+
+// dest[i]= prev[i] + (next[i] - prev[i]) * t
+void lerpVec3fArray(const Vec3f *prev, const Vec3f *next, float t, Vec3f *dest, uint32 count);
+// unlike Vec3f::normalize zero length vectors are left unchanged
+void normalizeVec3fArray(Vec3f *values, uint32 count);
+// dest[i]= matrix * Vec4f(src[i], 1), src and dest may be the same array
+void transformVec3fArray(const Matrix4f &matrix, const Vec3f *src, Vec3f *dest, uint32 count);
+
+// =====================================================
+//	uint8 array kernels
+//
+/// Branch free operations over byte buffers such as one
+/// component pixmaps, dispatched like the Vec3f ones
+// =====================================================
+
+// dest[i]= max(dest[i], src[i])
+void maxUint8Array(const uint8 *src, uint8 *dest, uint32 count);
+// dest[i]= src[i] > dest[i] ? src[i] : min(dest[i], limit)
+void maxOrLimitUint8Array(const uint8 *src, uint8 *dest, uint8 limit, uint32 count);
+// bytes already equal to to[i] are kept, the rest become from[i] + (to[i] - from[i]) * t
+// with t rounded to 1/256 steps
+void lerpChangedUint8Array(const uint8 *from, const uint8 *to, uint8 *dest, float t, uint32 count);
+
 // ====================================================================================================================
 // ====================================================================================================================
 //  Inline implementation
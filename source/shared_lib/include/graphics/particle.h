@@ -13,6 +13,7 @@
 #define _SHARED_GRAPHICS_PARTICLE_H_
 
 #include <list>
+#include <set>
 #include <cassert>
 #include "vec.h"
 #include "pixmap.h"
@@ -26,8 +27,12 @@ using std::list;
 using Shared::Util::RandomGen;
 using Shared::Xml::XmlNode;
 
+namespace Shared{ namespace PlatformCommon{ class WorkerThreadPool; }}
+
 namespace Shared{ namespace Graphics{
 
+using Shared::PlatformCommon::WorkerThreadPool;
+
 class ParticleSystem;
 class FireParticleSystem;
 class UnitParticleSystem;
@@ -75,6 +80,70 @@ public:
 	void loadGame(const XmlNode *rootNode);
 };
 
+// =====================================================
+//	class ParticlePool
+//
+/// Structure of arrays particle storage, every field
+/// is a contiguous float array so the per system
+/// update kernels run as straight loops
+// =====================================================
+
+class ParticlePool {
+public:
+	enum Field {
+		fPosX,
+		fPosY,
+		fPosZ,
+		fLastPosX,
+		fLastPosY,
+		fLastPosZ,
+		fSpeedX,
+		fSpeedY,
+		fSpeedZ,
+		fSpeedUpRelative,
+		fSpeedUpConstantX,
+		fSpeedUpConstantY,
+		fSpeedUpConstantZ,
+		fAccelX,
+		fAccelY,
+		fAccelZ,
+		fColorR,
+		fColorG,
+		fColorB,
+		fColorA,
+		fSize,
+		fEnergyRatio,	// scratch values of the update kernels
+
+		fCount
+	};
+
+private:
+	int capacity;
+	std::vector<float> values;
+	std::vector<int> energy;
+
+public:
+	ParticlePool(int capacity= 0);
+
+	void resize(int capacity);
+	int getCapacity() const								{return capacity;}
+
+	float *getField(Field field)						{return capacity > 0 ? &values[field * capacity] : NULL;}
+	const float *getField(Field field) const			{return capacity > 0 ? &values[field * capacity] : NULL;}
+	int *getEnergyField()								{return capacity > 0 ? &energy[0] : NULL;}
+	const int *getEnergyField() const					{return capacity > 0 ? &energy[0] : NULL;}
+
+	Vec3f getPos(int i) const		{return Vec3f(values[fPosX * capacity + i], values[fPosY * capacity + i], values[fPosZ * capacity + i]);}
+	Vec3f getLastPos(int i) const	{return Vec3f(values[fLastPosX * capacity + i], values[fLastPosY * capacity + i], values[fLastPosZ * capacity + i]);}
+	Vec4f getColor(int i) const		{return Vec4f(values[fColorR * capacity + i], values[fColorG * capacity + i], values[fColorB * capacity + i], values[fColorA * capacity + i]);}
+	float getSize(int i) const		{return values[fSize * capacity + i];}
+	int getEnergy(int i) const		{return energy[i];}
+
+	void getParticle(int i, Particle &particle) const;
+	void setParticle(int i, const Particle &particle);
+	void moveParticle(int from, int to);
+};
+
 // =====================================================
 //	class ParticleObserver
 // =====================================================
@@ -139,7 +208,7 @@ enum ParticleSystemType {
 
 protected:
 	
-	std::vector<Particle> particles;
+	ParticlePool particles;
 	RandomGen random;
 
 	BlendMode blendMode;
@@ -148,6 +217,7 @@ protected:
 	bool visible;
 	int aliveParticleCount;
 	int particleCount;
+	int recycleParticleIndex;
 	
 	string textureFileLoadDeferred;
 	int textureFileLoadDeferredSystemId;
@@ -174,6 +244,17 @@ protected:
 	ParticleObserver *particleObserver;
 	ParticleOwner *particleOwner;
 
+	// particle work of update() left for ParticleManager to run, possibly
+	// on a worker thread, after all systems ran their own update logic
+	bool deferParticleUpdate;
+	bool particleUpdatePending;
+	int pendingEmissionCount;
+
+	// position in the ParticleManager lists, -1 while not managed
+	int managerIndex;
+	int pendingUpdateIndex;
+	friend class ParticleManager;
+
 public:
 	//conmstructor and destructor
 	ParticleSystem(int particleCount);
@@ -182,6 +263,7 @@ public:
 
 	//public
 	virtual void update();
+	void updatePendingParticles();
 	virtual void render(ParticleRenderer *pr, ModelRenderer *mr);
 
 	//get
@@ -189,8 +271,7 @@ public:
 	BlendMode getBlendMode() const				{return blendMode;}
 	Texture *getTexture() const					{return texture;}
 	Vec3f getPos() const						{return pos;}
-	Particle *getParticle(int i)				{return &particles[i];}
-	const Particle *getParticle(int i) const	{return &particles[i];}
+	const ParticlePool &getParticles() const	{return particles;}
 	int getAliveParticleCount() const			{return aliveParticleCount;}
 	bool getActive() const						{return active;}
 	virtual bool getVisible() const				{return visible;}
@@ -245,13 +326,13 @@ public:
 
 protected:
 	//protected
-	Particle *createParticle();
-	void killParticle(Particle *p);
+	int createParticle();
 
 	//virtual protected
+	virtual int emitParticle(int particleIndex);
 	virtual void initParticle(Particle *p, int particleIndex);
-	virtual void updateParticle(Particle *p);
-	virtual bool deathTest(Particle *p);
+	virtual void updateParticles(int first, int last);
+	virtual void killParticles();
 };
 
 // =====================================================
@@ -270,7 +351,7 @@ public:
 
 	//virtual
 	virtual void initParticle(Particle *p, int particleIndex);
-	virtual void updateParticle(Particle *p);
+	virtual void updateParticles(int first, int last);
 
 	//set params
 	void setRadius(float radius);
@@ -404,7 +485,7 @@ public:
 
 	//virtual
 	virtual void initParticle(Particle *p, int particleIndex);
-	virtual void updateParticle(Particle *p);
+	virtual void updateParticles(int first, int last);
 	virtual void update();
 	virtual bool getVisible() const;
 	virtual void fade();
@@ -473,7 +554,7 @@ public:
 	virtual void render(ParticleRenderer *pr, ModelRenderer *mr);
 
 	virtual void initParticle(Particle *p, int particleIndex);
-	virtual bool deathTest(Particle *p);
+	virtual void killParticles();
 
 	void setRadius(float radius);
 	void setWind(float windAngle, float windSpeed);
@@ -498,7 +579,7 @@ public:
 	virtual ParticleSystemType getParticleSystemType() const { return pst_SnowParticleSystem;}
 
 	virtual void initParticle(Particle *p, int particleIndex);
-	virtual bool deathTest(Particle *p);
+	virtual void killParticles();
 
 	void setRadius(float radius);
 	void setWind(float windAngle, float windSpeed);
@@ -582,8 +663,9 @@ public:
 	void link(SplashParticleSystem *particleSystem);
 	
 	virtual void update();
+	virtual int emitParticle(int particleIndex);
 	virtual void initParticle(Particle *p, int particleIndex);
-	virtual void updateParticle(Particle *p);
+	virtual void updateParticles(int first, int last);
 	
 	void setTrajectory(Trajectory trajectory)				{this->trajectory= trajectory;}
 	void setTrajectorySpeed(float trajectorySpeed)			{this->trajectorySpeed= trajectorySpeed;}
@@ -627,7 +709,7 @@ public:
 	
 	virtual void update();
 	virtual void initParticle(Particle *p, int particleIndex);
-	virtual void updateParticle(Particle *p);
+	virtual void updateParticles(int first, int last);
 	
 	virtual void initParticleSystem();
 
@@ -652,10 +734,19 @@ public:
 class ParticleManager {
 private:
 	vector<ParticleSystem *> particleSystems;
+	std::set<const ParticleSystem *> particleSystemLookup;
+	vector<ParticleSystem *> pendingUpdates;
+	WorkerThreadPool *updatePool;
+
+	bool isUpdateSkipped(const ParticleSystem *ps) const;
+	void updatePendingParticles();
+	void eraseParticleSystem(ParticleSystem *ps);
 
 public:
 	ParticleManager();
 	~ParticleManager();
+	void setUpdateThreadCount(int threadCount);
+	int getUpdateThreadCount() const;
 	void update(int renderFps=-1);
 	void render(ParticleRenderer *pr, ModelRenderer *mr) const;	
 	void manage(ParticleSystem *ps);
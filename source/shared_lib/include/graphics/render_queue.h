@@ -0,0 +1,127 @@
+// ==============================================================
+//	This file is part of Glest Shared Library (www.glest.org)
+//
+//	Copyright (C) 2001-2008 Martiño Figueroa
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#ifndef _SHARED_GRAPHICS_RENDERQUEUE_H_
+#define _SHARED_GRAPHICS_RENDERQUEUE_H_
+
+#include "vec.h"
+#include "data_types.h"
+#include <map>
+#include <vector>
+#include "leak_dumper.h"
+
+namespace Shared{ namespace PlatformCommon{ class WorkerThreadPool; }}
+
+namespace Shared{ namespace Graphics{
+
+using Shared::PlatformCommon::WorkerThreadPool;
+using Shared::Platform::uint32;
+using Shared::Platform::uint64;
+
+class Model;
+class Texture;
+
+// =====================================================
+//	class RenderQueueItem
+//
+/// One model to draw and the state it needs, no GL
+/// calls are made while items are built
+// =====================================================
+
+class RenderQueueItem {
+public:
+	uint64 stateKey;
+	// index of the item in the RenderQueueSource
+	int sourceIndex;
+
+	Model *model;
+	const Texture *teamTexture;
+
+	Vec3f position;
+	// degrees, applied around z, x and then y
+	Vec3f rotation;
+	Vec4f color;
+
+	float animProgress;
+	bool cycleAnimation;
+	// quantized interpolation frame, items with the same model and
+	// frame step can be drawn in one batch
+	uint32 frameStep;
+	// faded models are drawn after all the opaque ones
+	bool faded;
+
+	RenderQueueItem();
+};
+
+// =====================================================
+//	class RenderQueueSource
+//
+/// Fills the items of a RenderQueue, fillRenderItem
+/// is called from the build threads
+// =====================================================
+
+class RenderQueueSource {
+public:
+	virtual ~RenderQueueSource() {}
+
+	virtual int getRenderItemCount() const = 0;
+	// returns false when the item is not drawn this frame
+	virtual bool fillRenderItem(int index, RenderQueueItem &item) const = 0;
+};
+
+// =====================================================
+//	class RenderQueue
+//
+/// Builds the draw items of a frame and sorts them by
+/// state so the renderer switches models and team
+/// textures as rarely as possible and units showing
+/// the same frame end up next to each other
+// =====================================================
+
+class RenderQueue {
+private:
+	typedef std::vector<RenderQueueItem> Items;
+	typedef std::map<const void *, uint32> StateIds;
+
+	Items items;
+	std::vector<char> itemUsed;
+	int itemCount;
+	WorkerThreadPool *buildPool;
+
+	StateIds modelIds;
+	StateIds teamTextureIds;
+
+	static uint32 getStateId(StateIds &ids, const void *state);
+
+public:
+	RenderQueue();
+	~RenderQueue();
+
+	void setBuildThreadCount(int threadCount);
+	int getBuildThreadCount() const;
+
+	// drops the items that were not filled and computes the state keys
+	void build(const RenderQueueSource &source);
+	// state key order, items with the same state stay in source order
+	void sort();
+	void clear();
+
+	int getItemCount() const						{return itemCount;}
+	const RenderQueueItem &getItem(int index) const	{return items[index];}
+
+	// faded flag, then 15 bits of team texture, 24 bits of model and
+	// 24 bits of frame step
+	static uint64 makeStateKey(bool faded, uint32 teamTextureId, uint32 modelId, uint32 frameStep);
+};
+
+}}//end namespace
+
+#endif
@@ -13,27 +13,62 @@
 #define _SHARED_GRAPHICS_TEXTUREMANAGER_H_
 
 #include <vector>
+#include <map>
 #include "texture.h"
+#include "simple_threads.h"
 #include "leak_dumper.h"
 
 using std::vector;
+using Shared::PlatformCommon::WorkerThreadPool;
+using Shared::PlatformCommon::WorkerThreadTask;
+using Shared::PlatformCommon::BaseThread;
 
 namespace Shared{ namespace Graphics{
 
+// =====================================================
+//	class TextureDecodeTask
+// =====================================================
+
+//decodes the pixmap of a texture on a worker thread, the GL upload happens
+//later on the thread owning the context
+class TextureDecodeTask : public WorkerThreadTask {
+public:
+	Texture2D *texture;
+	string path;
+	bool deletePixMapAfterLoad;
+
+	TextureDecodeTask(Texture2D *texture, const string &path, bool deletePixMapAfterLoad);
+	virtual void executeTask(BaseThread *callingThread);
+};
+
 // =====================================================
 //	class TextureManager
 // =====================================================
 typedef vector<Texture*> TextureContainer;
+typedef std::map<string,Texture*> TexturePathIndex;
+typedef std::map<Texture*,TextureDecodeTask*> TextureDecodeTaskMap;
 
 //manages textures, creation on request and deletion on destruction
 class TextureManager{
 	
 protected:
 	TextureContainer textures;
-	
+
+	//path lookup for getTexture, textures get their path after creation so
+	//new ones wait in unindexedTextures until they have one
+	TexturePathIndex texturePathIndex;
+	TextureContainer unindexedTextures;
+
 	Texture::Filter textureFilter;
 	int maxAnisotropy;
 
+	WorkerThreadPool *decodePool;
+	TextureDecodeTaskMap pendingDecodes;
+
+	void indexTexturePaths();
+	void removeFromIndex(Texture *texture);
+	void finishTextureDecode(TextureDecodeTask *task);
+
 public:
 	TextureManager();
 	~TextureManager();
@@ -56,7 +91,20 @@ public:
 	Texture3D *newTexture3D();
 	TextureCube *newTextureCube();
 
+	//returns the texture registered for path or creates one and queues its
+	//decode, created is only true when the caller owns the returned texture
+	Texture2D *loadTexture2D(const string &path, bool deletePixMapAfterLoad,
+			bool &created, int channelCount=-1);
+
 	const TextureContainer &getTextures() const {return textures;}
+
+	//background pixmap decoding, disabled when the thread count is 0
+	void setDecodeThreadCount(int threadCount);
+	bool getAsyncDecodeEnabled() const {return decodePool != NULL;}
+	void queueTextureDecode(Texture2D *texture, const string &path, bool deletePixMapAfterLoad);
+	bool isTextureDecodePending(const Texture *texture) const;
+	int getPendingDecodeCount() const {return (int)pendingDecodes.size();}
+	int uploadDecodedTextures(bool waitForPending);
 };
 
 
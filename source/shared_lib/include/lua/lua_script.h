@@ -13,6 +13,8 @@
 #define _SHARED_LUA_LUASCRIPT_H_
 
 #include <string>
+#include <vector>
+#include <map>
 #include <lua.hpp>
 #include "vec.h"
 #include "xml_parser.h"
@@ -46,10 +48,17 @@ private:
 	string sandboxWrapperFunctionName;
 	string sandboxCode;
 
+	// registry references to the functions called by name, so a call
+	// does not look the global up again until new code is loaded
+	std::vector<string> functionNames;
+	std::vector<int> functionRefs;
+	std::map<string,int> functionIds;
+
 	static bool disableSandbox;
 	static bool debugModeEnabled;
 
 	void DumpGlobals();
+	void clearFunctionRefs();
 
 public:
 	LuaScript();
@@ -63,8 +72,12 @@ public:
 	void loadCode(string code, string name);
 
 	void beginCall(string functionName);
+	void beginCall(int functionId);
 	void endCall();
 
+	// a stable id for a function name, for beginCall(int)
+	int getFunctionId(const string &functionName);
+
 	int runCode(const string code);
 	void setSandboxWrapperFunctionName(string name);
 	void setSandboxCode(string code);
@@ -0,0 +1,135 @@
+// ==============================================================
+//	This file is part of Glest (www.glest.org)
+//
+//	Copyright (C) 2001-2008 Martiño Figueroa
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#ifndef _MAPPREVIEW_MAP_INDEX_H_
+#define _MAPPREVIEW_MAP_INDEX_H_
+
+#include "map_preview.h"
+#include "base_thread.h"
+#include <map>
+#include <vector>
+#include <string>
+#include "leak_dumper.h"
+
+using Shared::Platform::uint8;
+using Shared::Platform::uint32;
+using Shared::Platform::int64;
+using Shared::PlatformCommon::BaseThread;
+using Shared::Platform::Mutex;
+
+namespace Shared { namespace Map {
+
+// ===============================================
+//	class MapIndexEntry
+//
+/// Header values and a downsampled preview of one
+/// map file, valid while the file size and
+/// modification time are unchanged
+// ===============================================
+
+class MapIndexEntry {
+public:
+	static const int maxPreviewDimension = 64;
+
+	string path;
+	int64 fileSize;
+	int64 modTime;
+	bool valid;
+
+	string title;
+	string author;
+	string desc;
+	int width;
+	int height;
+	int maxFactions;
+	int heightFactor;
+	int waterLevel;
+	int cliffLevel;
+	int cameraHeight;
+	uint32 crc;
+
+	// preview cells, row major, heights stored in tenths
+	int previewW;
+	int previewH;
+	std::vector<uint8> previewHeights;
+	std::vector<int8> previewSurfaces;
+	std::vector<int8> previewObjects;
+	std::vector<int8> previewResources;
+	std::vector<int> startLocationsX;
+	std::vector<int> startLocationsY;
+
+	MapIndexEntry();
+
+	void setFromMap(const MapPreview &map);
+	void saveToFile(FILE *f) const;
+	bool loadFromFile(FILE *f);
+};
+
+// ===============================================
+//	class MapIndexRefreshThread
+// ===============================================
+
+class MapIndexRefreshThread : public BaseThread {
+protected:
+	std::vector<string> pathList;
+
+public:
+	MapIndexRefreshThread(const std::vector<string> &pathList);
+	virtual void execute();
+	virtual bool canShutdown(bool deleteSelfIfShutdownDelayed=false);
+};
+
+// ===============================================
+//	class MapIndex
+//
+/// Persistent index of all installed maps so the
+/// game lobby neither reads every map header nor the
+/// whole map to list and preview maps
+// ===============================================
+
+class MapIndex {
+private:
+	typedef std::map<string, MapIndexEntry> EntryMap;
+
+	Mutex *mutexEntries;
+	EntryMap entries;
+	bool loaded;
+	bool changed;
+	string indexFile;
+	MapIndexRefreshThread *refreshThread;
+
+	MapIndex();
+	void loadIndex();
+	bool findCurrentEntry(const string &path, MapIndexEntry &entry);
+
+public:
+	~MapIndex();
+	static MapIndex &getInstance();
+
+	static bool getFileStamp(const string &path, int64 &fileSize, int64 &modTime);
+
+	bool isCurrent(const string &path);
+	bool refreshEntry(const string &path);
+	void removeStaleEntries(const std::vector<string> &existingFiles);
+	void saveIndex();
+
+	bool getMapInfo(const string &path, MapInfo *mapInfo,
+			const string &i18nMaxMapPlayersTitle, const string &i18nMapSizeTitle);
+	bool getMapCRC(const string &path, uint32 &crc);
+	bool loadPreview(const string &path, MapPreview *map);
+
+	void startRefresh(const std::vector<string> &pathList);
+	void stopRefresh();
+};
+
+}}// end namespace
+
+#endif
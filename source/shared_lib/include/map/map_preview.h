@@ -110,11 +110,15 @@ public:
 	}
 };
 
+class MapIndex;
+
 // ===============================================
 //	class Map
 // ===============================================
 
 class MapPreview {
+	friend class MapIndex;
+
 public:
 	static const int maxHeight = 20;
 	static const int minHeight = 0;
@@ -122,22 +122,16 @@ public:
 
 class Chrono {
 private:
-	Uint32 startCount;
-	Uint32 accumCount;
-	Uint32 freq;
+	int64 startNanos;
+	int64 accumNanos;
 	bool stopped;
 
-	Uint32 lastStartCount;
-	Uint32 lastTickCount;
-	int64  lastResult;
-	int64 lastMultiplier;
-	bool lastStopped;
-
 public:
 	Chrono(bool autoStart=false);
 	void start();
 	void stop();
 	void reset();
+	int64 getNanos();
 	int64 getMicros();
 	int64 getMillis();
 	int64 getSeconds();
@@ -145,9 +139,8 @@ public:
 	bool isStarted() const;
     static int64 getCurTicks();
     static int64 getCurMillis();
-
-private:
-	int64 queryCounter(int64 multiplier);
+    // monotonic clock, only differences between two readings are meaningful
+    static int64 getCurNanos();
 };
 
 // =====================================================
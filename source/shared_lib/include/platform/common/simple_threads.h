@@ -13,6 +13,7 @@
 
 #include "base_thread.h"
 #include <vector>
+#include <deque>
 #include <string>
 #include "util.h"
 #include "texture.h"
@@ -169,6 +170,74 @@ public:
     virtual bool canShutdown(bool deleteSelfIfShutdownDelayed=false);
 };
 
+// =====================================================
+//	class WorkerThreadPool
+// =====================================================
+
+//
+// A unit of work handed to a WorkerThreadPool. The pool never deletes tasks,
+// ownership stays with whoever queued them.
+//
+class WorkerThreadTask {
+protected:
+	string errorMessage;
+
+public:
+	virtual ~WorkerThreadTask() {}
+	virtual void executeTask(BaseThread *callingThread) = 0;
+
+	void setErrorMessage(const string &value) { errorMessage = value; }
+	string getErrorMessage() const { return errorMessage; }
+	bool hasError() const { return errorMessage != ""; }
+};
+
+class WorkerThreadPool;
+
+class WorkerThreadPoolThread : public BaseThread
+{
+protected:
+	WorkerThreadPool *pool;
+
+	virtual void setQuitStatus(bool value);
+
+public:
+	explicit WorkerThreadPoolThread(WorkerThreadPool *pool);
+	virtual ~WorkerThreadPoolThread();
+	virtual void execute();
+	virtual bool canShutdown(bool deleteSelfIfShutdownDelayed=false);
+};
+
+class WorkerThreadPool {
+protected:
+	Mutex *mutexTasks;
+	Semaphore semTaskQueued;
+	Semaphore semTaskCompleted;
+	std::deque<WorkerThreadTask *> pendingTasks;
+	vector<WorkerThreadTask *> completedTasks;
+	int unfinishedTaskCount;
+	vector<WorkerThreadPoolThread *> workerThreads;
+	string poolName;
+
+	friend class WorkerThreadPoolThread;
+	WorkerThreadTask * popPendingTask();
+	void runTask(WorkerThreadTask *task, BaseThread *callingThread);
+
+public:
+	WorkerThreadPool(string poolName, int threadCount);
+	~WorkerThreadPool();
+
+	int getThreadCount() const { return (int)workerThreads.size(); }
+	string getPoolName() const { return poolName; }
+
+	// With no worker threads the task runs right away on the calling thread
+	void queueTask(WorkerThreadTask *task);
+	vector<WorkerThreadTask *> popCompletedTasks();
+	int getUnfinishedTaskCount();
+
+	// The calling thread helps drain the queue while it waits
+	bool waitForAllTasks(int waitMilliseconds=-1);
+};
+
 }}//end namespace
 
 #endif
@@ -118,6 +118,9 @@ protected:
     string fileArchiveExtractCommandParameters;
     int fileArchiveExtractCommandSuccessResult;
 
+    bool canExtractArchive(const string &remotePath);
+    bool extractArchive(const string &archiveFile, const string &destRootArchiveFolder, bool useShellCallback);
+
     pair<FTP_Client_ResultType,string> getFileFromServer(FTP_Client_CallbackType downloadType,
     		pair<string,string> fileNameTitle,
     		string remotePath, string destFileSaveAs, string ftpUser,
@@ -28,6 +28,8 @@ const char  *GAME_ARGS[] = {
 	"--autostart-lastgame",
 	"--load-saved-game",
 	"--auto-test",
+	"--fast-forward",
+	"--replay-start-frame",
 	"--connect",
 	"--connecthost",
 	"--starthost",
@@ -66,6 +68,7 @@ const char  *GAME_ARGS[] = {
 	"--font-path",
 	"--show-ini-settings",
 	"--convert-models",
+	"--convert-replay",
 	"--use-language",
 	"--show-map-crc",
 	"--show-tileset-crc",
@@ -112,6 +115,8 @@ enum GAME_ARG_TYPE {
 	GAME_ARG_AUTOSTART_LASTGAME,
 	GAME_ARG_AUTOSTART_LAST_SAVED_GAME,
 	GAME_ARG_AUTO_TEST,
+	GAME_ARG_FAST_FORWARD,
+	GAME_ARG_REPLAY_START_FRAME,
 	GAME_ARG_CONNECT,
 	GAME_ARG_CLIENT,
 	GAME_ARG_SERVER,
@@ -150,6 +155,7 @@ enum GAME_ARG_TYPE {
 	GAME_ARG_FONT_PATH,
 	GAME_ARG_SHOW_INI_SETTINGS,
 	GAME_ARG_CONVERT_MODELS,
+	GAME_ARG_CONVERT_REPLAY,
 	GAME_ARG_USE_LANGUAGE,
 
 	GAME_ARG_SHOW_MAP_CRC,
@@ -222,6 +228,18 @@ void printParameterHelp(const char *argv0, bool foundInvalidArgs) {
 	printf("\n\n                     \tafter the game is finished or the time runs out. If z is");
 	printf("\n\n                     \tnot specified (or is empty) then auto test continues to cycle.");
 
+	printf("\n\n%s=x,y  \tRun a game headless as fast as possible and exit.",GAME_ARGS[GAME_ARG_FAST_FORWARD]);
+	printf("\n\n                     \tWhere x is an optional replay file or game settings file (.mgg).");
+	printf("\n\n                     \tA game settings file is played with the AI in every slot.");
+	printf("\n\n                     \tIf x is not specified the last game settings you played are used.");
+	printf("\n\n                     \tWhere y is an optional maximum # of frames to play.");
+	printf("\n\n                     \tThe game runs until the replay ends, the game is over or y frames");
+	printf("\n\n                     \tare played, then prints frames/sec, subsystem times and faction CRCs.");
+
+	printf("\n\n%s=x  \tStart a loaded replay at the saved state nearest before frame x.",GAME_ARGS[GAME_ARG_REPLAY_START_FRAME]);
+	printf("\n\n                     \tRequires replay keyframes (ReplayKeyframeSeconds), without them");
+	printf("\n\n                     \tthe replay plays from the start.");
+
 	printf("\n\n%s=x:y  \t\tAuto connect to host server at IP or hostname x using",GAME_ARGS[GAME_ARG_CONNECT]);
 	printf("\n\n                     \t    port y. Shortcut version of using %s and %s.",GAME_ARGS[GAME_ARG_CLIENT],GAME_ARGS[GAME_ARG_USE_PORTS]);
 	printf("\n\n                     \t*NOTE: to automatically connect to the first LAN host you may");
@@ -383,6 +401,14 @@ void printParameterHelp(const char *argv0, bool foundInvalidArgs) {
 	printf("\n\n                     \t%s %s=techs/megapack/factions/tech/",extractFileFromDirectoryPath(argv0).c_str(),GAME_ARGS[GAME_ARG_CONVERT_MODELS]);
 	printf("\n\n                     \tunits/castle/models/castle.g3d=png=keepsmallest");
 
+	printf("\n\n%s=x=y  \tConvert a replay file saved as xml to the binary",GAME_ARGS[GAME_ARG_CONVERT_REPLAY]);
+	printf("\n\n                     \t    replay format.");
+	printf("\n\n                     \tWhere x is the replay file to convert.");
+	printf("\n\n                     \tWhere y is an optional output file (default");
+	printf("\n\n                     \t    replaces x).");
+	printf("\n\n                     \texample:");
+	printf("\n\n                     \t%s %s=saved/mygame.xml.replay",extractFileFromDirectoryPath(argv0).c_str(),GAME_ARGS[GAME_ARG_CONVERT_REPLAY]);
+
 	printf("\n\n%s=x  \tForce the language to be the language specified",GAME_ARGS[GAME_ARG_USE_LANGUAGE]);
 	printf("\n\n                     \t    by x. Where x is a language filename or ISO639-1 code.");
 	printf("\n\n                     \texample: %s %s=english",extractFileFromDirectoryPath(argv0).c_str(),GAME_ARGS[GAME_ARG_USE_LANGUAGE]);
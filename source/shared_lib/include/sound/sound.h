@@ -13,7 +13,9 @@
 #define _SHARED_SOUND_SOUND_H_
 
 #include <string>
+#include <map>
 #include "sound_file_loader.h" 
+#include "thread.h"
 #include "leak_dumper.h"
 
 using namespace std;
@@ -76,21 +78,94 @@ public:
 	string getFileName() 				{return fileName; }
 };
 
+// =====================================================
+//	class StaticSoundData
+//
+/// Decoded PCM of one sound file, shared by every
+/// StaticSound loaded from that file
+// =====================================================
+
+class StaticSoundData {
+private:
+	friend class StaticSoundCache;
+
+	string path;
+	SoundInfo info;
+	int8 *samples;
+	int refCount;
+	uint64 lastUsed;
+	bool loadFailed;
+	bool headerRead;
+
+public:
+	StaticSoundData(const string &path);
+	~StaticSoundData();
+
+	const string &getPath() const		{return path;}
+	const SoundInfo *getInfo() const	{return &info;}
+	int8 *getSamples() const			{return samples;}
+	bool isDecoded() const				{return samples != NULL;}
+};
+
+// =====================================================
+//	class StaticSoundCache
+//
+/// Decodes static sounds on demand and keeps the decoded
+/// PCM within a memory budget, evicting the least recently
+/// played sounds first
+// =====================================================
+
+class StaticSoundCache {
+private:
+	typedef map<string, StaticSoundData*> SoundDataMap;
+
+	Mutex *mutexCache;
+	SoundDataMap soundData;
+	uint64 memoryBudget;
+	uint64 memoryUsed;
+	uint64 useCounter;
+
+	StaticSoundCache();
+	void evictToBudget(StaticSoundData *keep);
+	void freeSamples(StaticSoundData *data);
+	static SoundFileLoader *newLoader(const string &path);
+
+public:
+	~StaticSoundCache();
+	static StaticSoundCache &getInstance();
+
+	StaticSoundData *acquire(const string &path);
+	void release(StaticSoundData *data);
+	void readHeader(StaticSoundData *data);
+	bool decode(StaticSoundData *data);
+	void clearDecoded();
+
+	void setMemoryBudget(uint64 bytes);
+	uint64 getMemoryBudget() const		{return memoryBudget;}
+	uint64 getMemoryUsed() const		{return memoryUsed;}
+};
+
 // =====================================================
 //	class StaticSound
 // =====================================================
 
 class StaticSound: public Sound{
 private:
-	int8 * samples;
+	static bool lazyLoading;
+
+	StaticSoundData *data;
 
 public:
 	StaticSound();
 	virtual ~StaticSound();
 
-	int8 *getSamples() const		{return samples;}
+	static void setLazyLoading(bool value)	{lazyLoading= value;}
+	static bool getLazyLoading()			{return lazyLoading;}
+
+	int8 *getSamples() const		{return (data != NULL ? data->getSamples() : NULL);}
 	
 	void load(const string &path);
+	bool ensureLoaded();
 	void close();
 };
 
@@ -39,6 +39,7 @@ private:
 	static std::map<string,uint32> fileListCache;
 
 	void addSum(uint32 value);
+	void addFileData(const string &path, const char *data, size_t size);
 	bool addFileToSum(const string &path);
 
 public:
@@ -58,6 +59,7 @@ public:
 	void addFile(const string &path);
 
 	static void removeFileFromCache(const string file);
+	static void addFileDataToCache(const string &path, const char *data, size_t size);
 	static void clearFileCache();
 };
 
@@ -18,14 +18,19 @@
 #include "platform_util.h"
 #include "platform_common.h"
 #include <list>
+#include <map>
 #include <string>
+#include <vector>
 #include "leak_dumper.h"
 
 using std::list;
 using std::string;
+using std::vector;
 
 using Shared::PlatformCommon::Chrono;
 
+namespace Shared{ namespace Platform{ class Mutex; }}
+
 namespace Shared{ namespace Util{
 
 #ifdef SL_PROFILE
@@ -80,6 +85,83 @@ public:
 
 #endif //SL_PROFILE
 
+// =====================================================
+//	class FrameProfiler
+//
+/// Records timed zones from every thread for a range of
+/// world frames and writes them as a chrome trace and as
+/// folded stacks for flame graphs
+// =====================================================
+
+class ProfileThreadBuffer;
+
+class FrameProfiler {
+private:
+	static bool recording;
+
+	Shared::Platform::Mutex *mutexThreadBuffers;
+	vector<ProfileThreadBuffer *> threadBuffers;
+	std::map<unsigned long, string> threadNames;
+	unsigned int threadBufferTLS;
+	int eventsPerThread;
+
+	int startFrame;
+	int endFrame;
+	int currentFrame;
+	int64 startNanos;
+	string outputPath;
+
+	FrameProfiler();
+	ProfileThreadBuffer *getThreadBuffer();
+	void writeProfile();
+
+public:
+	~FrameProfiler();
+	static FrameProfiler &getInstance();
+
+	static bool isRecording() { return recording; }
+
+	// records the frames from startFrame to endFrame and writes
+	// outputPath.json and outputPath.folded after the last one
+	void setFrameRange(int startFrame, int endFrame, const string &outputPath);
+	// the ring buffer size, older zones are dropped when it is full
+	void setEventsPerThread(int value) { eventsPerThread = value; }
+	// names the calling thread in the written profile
+	void setThreadName(const string &name);
+
+	void beginFrame(int frame);
+	void stopRecording();
+	void addZone(const char *name, int64 zoneStartNanos, int64 zoneEndNanos);
+};
+
+// =====================================================
+//	class ProfileZone
+//
+/// Times its own scope while the frame profiler records,
+/// the name must be a string literal
+// =====================================================
+
+class ProfileZone {
+private:
+	const char *name;
+	int64 startNanos;
+
+public:
+	explicit ProfileZone(const char *name) {
+		this->name = name;
+		this->startNanos = (FrameProfiler::isRecording() == true ? Chrono::getCurNanos() : 0);
+	}
+	~ProfileZone() {
+		if(startNanos != 0 && FrameProfiler::isRecording() == true) {
+			FrameProfiler::getInstance().addZone(name, startNanos, Chrono::getCurNanos());
+		}
+	}
+};
+
+#define PROFILE_ZONE_VAR_CONCAT(name,line) name##line
+#define PROFILE_ZONE_VAR(name,line) PROFILE_ZONE_VAR_CONCAT(name,line)
+#define PROFILE_ZONE(name) ::Shared::Util::ProfileZone PROFILE_ZONE_VAR(profileZone,__LINE__)(name)
+
 // =====================================================
 //	class funtions
 // =====================================================
@@ -126,6 +126,8 @@ public:
 
 	XmlNode *load(const string &path, const std::map<string,string> &mapTagReplacementValues,bool noValidation=false,bool skipStackTrace=false,bool skipUpdatePathClimbingParts=false);
 	void save(const string &path, const XmlNode *node);
+	// writes the xml text node by node through a deflate stream
+	void saveCompressed(const string &path, const XmlNode *node, int compressionLevel=5);
 };
 
 // =====================================================
@@ -151,7 +153,7 @@ public:
 	void setSkipUpdatePathClimbingParts(bool value);
 	void init(const string &name);
 	void load(const string &path, const std::map<string,string> &mapTagReplacementValues, bool noValidation=false,bool skipStackCheck=false,bool skipStackTrace=false);
-	void save(const string &path);
+	void save(const string &path, bool compressed=false);
 
 	XmlNode *getRootNode() const	{return rootNode;}
 };
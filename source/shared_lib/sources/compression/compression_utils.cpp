@@ -19,13 +19,17 @@
 #include "compression_utils.h"
 #include "miniz/miniz.c"
 #include <limits.h>
+#include <ctype.h>
 #include <string>
 #include <vector>
 #include "conversion.h"
 #include "platform_util.h"
+#include "platform_common.h"
+#include "checksum.h"
 #include "util.h"
 
 using namespace Shared::Util;
+using namespace Shared::PlatformCommon;
 
 namespace Shared{ namespace CompressionUtil{
 
@@ -373,4 +377,269 @@ std::pair<unsigned char *,unsigned long> extractMemoryToMemory(unsigned char *in
 	return make_pair(decompressed_buffer,decompressed_buffer_len);
 }
 
+static size_t zipArchiveFileRead(void *pOpaque, mz_uint64 file_ofs, void *pBuf, size_t n) {
+	FILE *file = (FILE *)pOpaque;
+	if(fseek(file, (long)file_ofs, SEEK_SET) != 0) {
+		return 0;
+	}
+	return fread(pBuf, 1, n, file);
+}
+
+// only relative names without a parent folder component stay inside the
+// output folder, the slashes must already be forward slashes
+static bool isSafeArchiveEntryName(const string &entryName) {
+	if(entryName == "" || entryName[0] == '/') {
+		return false;
+	}
+	if(entryName.length() >= 2 && isalpha((unsigned char)entryName[0]) && entryName[1] == ':') {
+		return false;
+	}
+
+	vector<string> components;
+	Tokenize(entryName, components, "/");
+	for(unsigned int i = 0; i < components.size(); ++i) {
+		if(components[i] == "..") {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool isZIPArchive(string archiveFile) {
+#ifdef WIN32
+	FILE *file = _wfopen(utf8_decode(archiveFile).c_str(), L"rb");
+#else
+	FILE *file = fopen(archiveFile.c_str(), "rb");
+#endif
+	if(file == NULL) {
+		return false;
+	}
+	unsigned char signature[4] = { 0, 0, 0, 0 };
+	size_t readBytes = fread(signature, 1, 4, file);
+	fclose(file);
+
+	return (readBytes == 4 && signature[0] == 'P' && signature[1] == 'K' &&
+			signature[2] == 3 && signature[3] == 4);
+}
+
+bool extractZIPArchiveToFolder(string archiveFile, string outputPath, bool cacheFileChecksums) {
+#ifdef WIN32
+	FILE *file = _wfopen(utf8_decode(archiveFile).c_str(), L"rb");
+#else
+	FILE *file = fopen(archiveFile.c_str(), "rb");
+#endif
+	if(file == NULL) {
+		SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] cannot open archive [%s]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,archiveFile.c_str());
+		return false;
+	}
+	fseek(file, 0, SEEK_END);
+	long archiveSize = ftell(file);
+
+	mz_zip_archive zip;
+	memset(&zip, 0, sizeof(zip));
+	zip.m_pRead = zipArchiveFileRead;
+	zip.m_pIO_opaque = file;
+	if(archiveSize <= 0 || mz_zip_reader_init(&zip, archiveSize, 0) == MZ_FALSE) {
+		SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] invalid zip archive [%s]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,archiveFile.c_str());
+		fclose(file);
+		return false;
+	}
+
+	endPathWithSlash(outputPath);
+
+	bool result = true;
+	mz_uint fileCount = mz_zip_reader_get_num_files(&zip);
+	for(mz_uint index = 0; index < fileCount && result == true; ++index) {
+		mz_zip_archive_file_stat fileStat;
+		if(mz_zip_reader_file_stat(&zip, index, &fileStat) == MZ_FALSE) {
+			result = false;
+			break;
+		}
+
+		string entryName = fileStat.m_filename;
+		replaceAll(entryName, "\\", "/");
+		// never write outside of the output folder
+		if(isSafeArchiveEntryName(entryName) == false) {
+			SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] skipping archive entry [%s] in [%s]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,entryName.c_str(),archiveFile.c_str());
+			continue;
+		}
+
+		string outputFile = outputPath + entryName;
+		if(mz_zip_reader_is_file_a_directory(&zip, index) == MZ_TRUE) {
+			createDirectoryPaths(outputFile);
+			continue;
+		}
+		createDirectoryPaths(extractDirectoryPathFromFile(outputFile));
+
+		size_t dataSize = 0;
+		void *data = mz_zip_reader_extract_to_heap(&zip, index, &dataSize, 0);
+		if(data == NULL) {
+			SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] cannot extract [%s] from [%s]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,entryName.c_str(),archiveFile.c_str());
+			result = false;
+			break;
+		}
+
+#ifdef WIN32
+		FILE *outFile = _wfopen(utf8_decode(outputFile).c_str(), L"wb");
+#else
+		FILE *outFile = fopen(outputFile.c_str(), "wb");
+#endif
+		if(outFile == NULL || (dataSize > 0 && fwrite(data, dataSize, 1, outFile) != 1)) {
+			SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] cannot write [%s]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,outputFile.c_str());
+			result = false;
+		}
+		if(outFile != NULL) {
+			fclose(outFile);
+		}
+
+		// the data is already in memory, so seed the file CRC cache instead
+		// of reading every extracted file back for the content checksums
+		if(result == true && cacheFileChecksums == true) {
+			Checksum::addFileDataToCache(outputFile, (const char *)data, dataSize);
+		}
+		mz_free(data);
+	}
+
+	mz_zip_reader_end(&zip);
+	fclose(file);
+
+	if(SystemFlags::VERBOSE_MODE_ENABLED) printf("Extracted %u entries from [%s] to [%s] result = %d\n",fileCount,archiveFile.c_str(),outputPath.c_str(),result);
+
+	return result;
+}
+
+bool isDeflateData(const unsigned char *data, size_t size) {
+	// CMF byte with the deflate method and a header check that divides by 31
+	return (size >= 2 && (data[0] & 0x0F) == 8 && (data[0] >> 4) <= 7 &&
+			((data[0] << 8) | data[1]) % 31 == 0);
+}
+
+void inflateMemoryToVector(const unsigned char *input, size_t inputLen, std::vector<char> &output) {
+	output.clear();
+
+	z_stream stream;
+	memset(&stream, 0, sizeof(stream));
+	if(inflateInit(&stream) != Z_OK) {
+		throw megaglest_runtime_error("inflateInit() failed!");
+	}
+	stream.next_in = input;
+	stream.avail_in = (mz_uint32)inputLen;
+
+	const size_t chunkSize = 256 * 1024;
+	int status = Z_OK;
+	while(status == Z_OK) {
+		size_t outputSize = output.size();
+		output.resize(outputSize + chunkSize);
+		stream.next_out = (unsigned char *)&output[outputSize];
+		stream.avail_out = (mz_uint32)chunkSize;
+
+		status = inflate(&stream, Z_SYNC_FLUSH);
+		output.resize(outputSize + chunkSize - stream.avail_out);
+	}
+	inflateEnd(&stream);
+
+	if(status != Z_STREAM_END) {
+		throw megaglest_runtime_error("Invalid inflate return value: " + intToStr(status));
+	}
+}
+
+// =====================================================
+//	class DeflateFileWriter
+// =====================================================
+
+DeflateFileWriter::DeflateFileWriter() {
+	file = NULL;
+	stream = NULL;
+}
+
+DeflateFileWriter::~DeflateFileWriter() {
+	if(stream != NULL) {
+		deflateEnd((z_stream *)stream);
+		delete (z_stream *)stream;
+		stream = NULL;
+	}
+	if(file != NULL) {
+		fclose(file);
+		file = NULL;
+	}
+}
+
+void DeflateFileWriter::open(const string &path, int compressionLevel) {
+	if(file != NULL) {
+		throw megaglest_runtime_error("Deflate file [" + this->path + "] is already open");
+	}
+	this->path = path;
+#ifdef WIN32
+	file = _wfopen(utf8_decode(path).c_str(), L"wb");
+#else
+	file = fopen(path.c_str(), "wb");
+#endif
+	if(file == NULL) {
+		throw megaglest_runtime_error("Can not open file: [" + path + "]");
+	}
+
+	z_stream *zStream = new z_stream;
+	memset(zStream, 0, sizeof(z_stream));
+	if(deflateInit(zStream, compressionLevel) != Z_OK) {
+		delete zStream;
+		throw megaglest_runtime_error("deflateInit() failed for file: [" + path + "]");
+	}
+	stream = zStream;
+	outBuffer.resize(256 * 1024);
+}
+
+void DeflateFileWriter::deflateInput(bool finish) {
+	z_stream *zStream = (z_stream *)stream;
+	for(;;) {
+		zStream->next_out = &outBuffer[0];
+		zStream->avail_out = (mz_uint32)outBuffer.size();
+
+		int status = deflate(zStream, (finish == true ? Z_FINISH : Z_NO_FLUSH));
+		if(status != Z_OK && status != Z_STREAM_END && status != Z_BUF_ERROR) {
+			throw megaglest_runtime_error("Invalid deflate return value: " + intToStr(status) + " for file: [" + path + "]");
+		}
+
+		size_t compressedSize = outBuffer.size() - zStream->avail_out;
+		if(compressedSize > 0 && fwrite(&outBuffer[0], 1, compressedSize, file) != compressedSize) {
+			throw megaglest_runtime_error("Failed writing to file: [" + path + "]");
+		}
+		if(finish == true ? status == Z_STREAM_END : zStream->avail_in == 0 && zStream->avail_out > 0) {
+			break;
+		}
+	}
+}
+
+void DeflateFileWriter::write(const void *data, size_t size) {
+	if(stream == NULL) {
+		throw megaglest_runtime_error("Deflate file is not open");
+	}
+	if(size == 0) {
+		return;
+	}
+	z_stream *zStream = (z_stream *)stream;
+	zStream->next_in = (const unsigned char *)data;
+	zStream->avail_in = (mz_uint32)size;
+	deflateInput(false);
+}
+
+void DeflateFileWriter::close() {
+	if(stream == NULL) {
+		return;
+	}
+	z_stream *zStream = (z_stream *)stream;
+	zStream->next_in = NULL;
+	zStream->avail_in = 0;
+	deflateInput(true);
+
+	deflateEnd(zStream);
+	delete zStream;
+	stream = NULL;
+
+	int result = fclose(file);
+	file = NULL;
+	if(result != 0) {
+		throw megaglest_runtime_error("Failed writing to file: [" + path + "]");
+	}
+}
+
 }}
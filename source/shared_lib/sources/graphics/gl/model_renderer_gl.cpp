@@ -139,6 +139,44 @@ void ModelRendererGl::render(Model *model,int renderMode) {
 	assertGl();
 }
 
+void ModelRendererGl::renderBatch(Model *model, const ModelPlacement *placements,
+		int placementCount, int renderMode) {
+	//assertions
+	assert(rendering);
+	assertGl();
+
+	for(uint32 i = 0;  i < model->getMeshCount(); ++i) {
+		Mesh *mesh= model->getMeshPtr(i);
+		if(beginMesh(mesh, renderMode) == false) {
+			continue;
+		}
+
+		glMatrixMode(GL_MODELVIEW);
+		for(int placementIndex = 0; placementIndex < placementCount; ++placementIndex) {
+			const ModelPlacement &placement= placements[placementIndex];
+
+			glPushMatrix();
+			glTranslatef(placement.position.x, placement.position.y, placement.position.z);
+			if(placement.rotation.z != 0.f) {
+				glRotatef(placement.rotation.z, 0.f, 0.f, 1.f);
+			}
+			if(placement.rotation.x != 0.f) {
+				glRotatef(placement.rotation.x, 1.f, 0.f, 0.f);
+			}
+			glRotatef(placement.rotation.y, 0.f, 1.f, 0.f);
+
+			drawMesh(mesh);
+
+			glPopMatrix();
+		}
+
+		endMesh(mesh, renderMode);
+	}
+
+	//assertions
+	assertGl();
+}
+
 void ModelRendererGl::renderNormalsOnly(Model *model) {
 	//assertions
 	assert(rendering);
@@ -158,10 +196,17 @@ void ModelRendererGl::renderNormalsOnly(Model *model) {
 // ===================== PRIVATE =======================
 
 void ModelRendererGl::renderMesh(Mesh *mesh,int renderMode) {
+	if(beginMesh(mesh, renderMode) == true) {
+		drawMesh(mesh);
+		endMesh(mesh, renderMode);
+	}
+}
+
+bool ModelRendererGl::beginMesh(Mesh *mesh,int renderMode) {
 
 	if(renderMode==rmSelection && mesh->getNoSelect()==true)
 	{// don't render this and do nothing
-		return;
+		return false;
 	}
 	//assertions
 	assertGl();
@@ -214,10 +259,6 @@ void ModelRendererGl::renderMesh(Mesh *mesh,int renderMode) {
 		}
 	}
 
-	//misc vars
-	uint32 vertexCount= mesh->getVertexCount();
-	uint32 indexCount= mesh->getIndexCount();
-
 	//assertions
 	assertGl();
 
@@ -311,13 +352,23 @@ void ModelRendererGl::renderMesh(Mesh *mesh,int renderMode) {
 		}
 	}
 
+	if(getVBOSupported() == true && mesh->getFrameCount() == 1) {
+		glBindBufferARB( GL_ELEMENT_ARRAY_BUFFER_ARB, mesh->getVBOIndexes() );
+	}
+
+	//assertions
+	assertGl();
+	return true;
+}
+
+void ModelRendererGl::drawMesh(Mesh *mesh) {
+	uint32 vertexCount= mesh->getVertexCount();
+	uint32 indexCount= mesh->getIndexCount();
+
 	if(getVBOSupported() == true && mesh->getFrameCount() == 1) {
 		assertGl();
 
-		glBindBufferARB( GL_ELEMENT_ARRAY_BUFFER_ARB, mesh->getVBOIndexes() );
 		glDrawRangeElements(GL_TRIANGLES, 0, vertexCount-1, indexCount, GL_UNSIGNED_INT, (char *)NULL);
-		glBindBufferARB( GL_ELEMENT_ARRAY_BUFFER_ARB, 0 );
-		glBindBufferARB( GL_ARRAY_BUFFER_ARB, 0 );
 
 		//glDrawRangeElements(GL_TRIANGLES, 0, vertexCount-1, indexCount, GL_UNSIGNED_INT, mesh->getIndices());
 
@@ -329,6 +380,13 @@ void ModelRendererGl::renderMesh(Mesh *mesh,int renderMode) {
 
 		glDrawRangeElements(GL_TRIANGLES, 0, vertexCount-1, indexCount, GL_UNSIGNED_INT, mesh->getIndices());
 	}
+}
+
+void ModelRendererGl::endMesh(Mesh *mesh,int renderMode) {
+	if(getVBOSupported() == true && mesh->getFrameCount() == 1) {
+		glBindBufferARB( GL_ELEMENT_ARRAY_BUFFER_ARB, 0 );
+		glBindBufferARB( GL_ARRAY_BUFFER_ARB, 0 );
+	}
 
 	// glow
 	if(renderMode==rmNormal && mesh->getGlow()==true){
@@ -108,12 +108,12 @@ void ParticleRendererGl::renderSystem(ParticleSystem *ps){
 
 	//fill vertex buffer with billboards
 	int bufferIndex= 0;
+	const ParticlePool &particles= ps->getParticles();
 
 	for(int i=0; i<ps->getAliveParticleCount(); ++i){
-		const Particle *particle= ps->getParticle(i);
-		float size= particle->getSize()/2.0f;
-		Vec3f pos= particle->getPos();
-		Vec4f color= particle->getColor();
+		float size= particles.getSize(i)/2.0f;
+		Vec3f pos= particles.getPos(i);
+		Vec4f color= particles.getColor(i);
 
 		vertexBuffer[bufferIndex] = pos - (rightVector - upVector) * size;
 		vertexBuffer[bufferIndex+1] = pos - (rightVector + upVector) * size;
@@ -143,7 +143,7 @@ void ParticleRendererGl::renderSystemLine(ParticleSystem *ps){
 	assert(rendering);
 
 	if(!ps->isEmpty()){
-		const Particle *particle= ps->getParticle(0);
+		const ParticlePool &particles= ps->getParticles();
 
 		setBlendMode(ps->getBlendMode());
 
@@ -156,14 +156,13 @@ void ParticleRendererGl::renderSystemLine(ParticleSystem *ps){
 		//fill vertex buffer with lines
 		int bufferIndex= 0;
 
-		glLineWidth(particle->getSize());
+		glLineWidth(particles.getSize(0));
 
 		for(int i=0; i<ps->getAliveParticleCount(); ++i){
-			particle= ps->getParticle(i);
-			Vec4f color= particle->getColor();
+			Vec4f color= particles.getColor(i);
 
-			vertexBuffer[bufferIndex] = particle->getPos();
-			vertexBuffer[bufferIndex+1] = particle->getLastPos();
+			vertexBuffer[bufferIndex] = particles.getPos(i);
+			vertexBuffer[bufferIndex+1] = particles.getLastPos(i);
 
 			colorBuffer[bufferIndex]= color;
 			colorBuffer[bufferIndex+1]= color;
@@ -187,7 +186,7 @@ void ParticleRendererGl::renderSystemLineAlpha(ParticleSystem *ps){
 	assert(rendering);
 
 	if(!ps->isEmpty()){
-		const Particle *particle= ps->getParticle(0);
+		const ParticlePool &particles= ps->getParticles();
 
 		setBlendMode(ps->getBlendMode());
 
@@ -200,14 +199,13 @@ void ParticleRendererGl::renderSystemLineAlpha(ParticleSystem *ps){
 		//fill vertex buffer with lines
 		int bufferIndex= 0;
 
-		glLineWidth(particle->getSize());
+		glLineWidth(particles.getSize(0));
 
 		for(int i=0; i<ps->getAliveParticleCount(); ++i){
-			particle= ps->getParticle(i);
-			Vec4f color= particle->getColor();
+			Vec4f color= particles.getColor(i);
 
-			vertexBuffer[bufferIndex] = particle->getPos();
-			vertexBuffer[bufferIndex+1] = particle->getLastPos();
+			vertexBuffer[bufferIndex] = particles.getPos(i);
+			vertexBuffer[bufferIndex+1] = particles.getLastPos(i);
 
 			colorBuffer[bufferIndex]= color;
 			colorBuffer[bufferIndex+1]= color;
@@ -15,14 +15,17 @@
 #include <algorithm>
 
 #include "model.h"
+#include "math_util.h"
 #include "conversion.h"
 #include "util.h"
 #include <stdexcept>
 #include "platform_util.h"
+#include "simple_threads.h"
 #include "leak_dumper.h"
 
 using namespace std;
 using namespace Shared::Util;
+using namespace Shared::PlatformCommon;
 
 namespace Shared{ namespace Graphics{
 
@@ -52,20 +55,85 @@ InterpolationData::~InterpolationData(){
 	normals=NULL;
 }
 
+const Vec3f *InterpolationData::getFrame(const Vec3f *src, const Vec3f *dest, CachedFrame &cached) const {
+	if(enableInterpolation == false) {
+		return src + raw_frame_ofs;
+	}
+	if(cached.data != NULL) {
+		InterpolationCache &cache= InterpolationCache::getInstance();
+		if(cached.generation != cache.getEvictionGeneration()) {
+			// the shared frame was freed since the last update
+			cached.generation= cache.getEvictionGeneration();
+			cached.data= cache.get(src, mesh->getFrameCount(), mesh->getVertexCount(), cached.t, cached.cycle);
+		}
+		if(cached.data != NULL) {
+			return cached.data;
+		}
+	}
+	if(dest != NULL) {
+		return dest;
+	}
+	return src + raw_frame_ofs;
+}
+
+const Vec3f *InterpolationData::getSharedVertices() const {
+	const Vec3f *result= getVertices();
+	return (result == vertices ? NULL : result);
+}
+
+const Vec3f *InterpolationData::getSharedNormals() const {
+	const Vec3f *result= getNormals();
+	return (result == normals ? NULL : result);
+}
+
 void InterpolationData::update(float t, bool cycle){
 	updateVertices(t, cycle);
 	updateNormals(t, cycle);
 }
 
 void InterpolationData::updateVertices(float t, bool cycle) {
-	update(mesh->getVertices(), vertices, t, cycle);
+	update(mesh->getVertices(), vertices, cachedVertices, t, cycle);
 }
 
 void InterpolationData::updateNormals(float t, bool cycle) {
-	update(mesh->getNormals(), normals, t, cycle);
+	update(mesh->getNormals(), normals, cachedNormals, t, cycle);
+}
+
+void InterpolationData::getFrames(uint32 frameCount, float t, bool cycle,
+		uint32 &prevFrame, uint32 &nextFrame, float &localT) {
+	if(cycle == true) {
+		prevFrame= min<uint32>(static_cast<uint32>(t*frameCount), frameCount-1);
+		nextFrame= (prevFrame+1) % frameCount;
+		localT= t*frameCount - prevFrame;
+	}
+	else {
+		prevFrame= min<uint32> (static_cast<uint32> (t * (frameCount-1)), frameCount - 2);
+		nextFrame= min(prevFrame + 1, frameCount - 1);
+		localT= t * (frameCount-1) - prevFrame;
+		//printf(" prevFrame=%d nextFrame=%d localT=%f\n",prevFrame,nextFrame,localT);
+	}
+
+	//assertions
+	assert(prevFrame<frameCount);
+	assert(nextFrame<frameCount);
+}
+
+void InterpolationData::lerpArray(const Vec3f *prev, const Vec3f *next, float t,
+		Vec3f *dest, uint32 count) {
+	lerpVec3fArray(prev, next, t, dest, count);
 }
 
-void InterpolationData::update(const Vec3f* src, Vec3f* &dest, float t, bool cycle) {
+void InterpolationData::interpolate(const Vec3f *src, uint32 frameCount, uint32 vertexCount,
+		float t, bool cycle, Vec3f *dest) {
+	uint32 prevFrame= 0;
+	uint32 nextFrame= 0;
+	float localT= 0;
+	getFrames(frameCount, t, cycle, prevFrame, nextFrame, localT);
+
+	lerpArray(&src[prevFrame*vertexCount], &src[nextFrame*vertexCount], localT, dest, vertexCount);
+}
+
+void InterpolationData::update(const Vec3f* src, Vec3f* &dest, CachedFrame &cached, float t, bool cycle) {
 
 	if(t <0.0f || t>1.0f) {
 		printf("ERROR t = [%f] for cycle [%d] f [%d] v [%d]\n",t,cycle,mesh->getFrameCount(),mesh->getVertexCount());
@@ -80,42 +148,336 @@ void InterpolationData::update(const Vec3f* src, Vec3f* &dest, float t, bool cyc
 	uint32 frameCount= mesh->getFrameCount();
 	uint32 vertexCount= mesh->getVertexCount();
 
+	cached.data= NULL;
 	if(frameCount > 1) {
-		//misc vars
-		uint32 prevFrame;
-		uint32 nextFrame;
-		float localT;
-
-		if(cycle == true) {
-			prevFrame= min<uint32>(static_cast<uint32>(t*frameCount), frameCount-1);
-			nextFrame= (prevFrame+1) % frameCount;
-			localT= t*frameCount - prevFrame;
-		}
-		else {
-			prevFrame= min<uint32> (static_cast<uint32> (t * (frameCount-1)), frameCount - 2);
-			nextFrame= min(prevFrame + 1, frameCount - 1);
-			localT= t * (frameCount-1) - prevFrame;
-			//printf(" prevFrame=%d nextFrame=%d localT=%f\n",prevFrame,nextFrame,localT);
-		}
-
-		uint32 prevFrameBase= prevFrame*vertexCount;
-		uint32 nextFrameBase= nextFrame*vertexCount;
-
-		//assertions
-		assert(prevFrame<frameCount);
-		assert(nextFrame<frameCount);
-		
 		if(enableInterpolation) {
+			InterpolationCache &cache= InterpolationCache::getInstance();
+			if(cache.isEnabled() == true) {
+				cached.generation= cache.getEvictionGeneration();
+				cached.t= t;
+				cached.cycle= cycle;
+				cached.data= cache.get(src, frameCount, vertexCount, t, cycle);
+				if(cached.data != NULL) {
+					return;
+				}
+			}
+
 			if(!dest) { // not previously allocated
 			      dest = new Vec3f[vertexCount];
 			}
-			for(uint32 j=0; j<vertexCount; ++j){
-				dest[j]= src[prevFrameBase+j].lerp(localT, src[nextFrameBase+j]);
-			}
+			interpolate(src, frameCount, vertexCount, t, cycle, dest);
 		} else {
-			raw_frame_ofs = prevFrameBase;
+			uint32 prevFrame= 0;
+			uint32 nextFrame= 0;
+			float localT= 0;
+			getFrames(frameCount, t, cycle, prevFrame, nextFrame, localT);
+
+			raw_frame_ofs = prevFrame*vertexCount;
 		}
 	}
 }
 
+// =====================================================
+//	class InterpolationFillTask
+// =====================================================
+
+class InterpolationFillTask : public WorkerThreadTask {
+public:
+	InterpolationCache::Key key;
+	const Vec3f *src;
+	uint32 frameCount;
+	uint32 vertexCount;
+	float t;
+	Vec3f *result;
+
+	InterpolationFillTask(const InterpolationCache::Key &key, const Vec3f *src,
+			uint32 frameCount, uint32 vertexCount, float t) :
+		key(key), src(src), frameCount(frameCount), vertexCount(vertexCount), t(t), result(NULL) {
+	}
+	virtual ~InterpolationFillTask() {
+		delete [] result;
+	}
+
+	virtual void executeTask(BaseThread *callingThread) {
+		result= new Vec3f[vertexCount];
+		InterpolationData::interpolate(src, frameCount, vertexCount, t, key.cycle, result);
+	}
+};
+
+// =====================================================
+//	class InterpolationCache
+// =====================================================
+
+InterpolationCache *InterpolationCache::instance= NULL;
+
+InterpolationCache::InterpolationCache() : mutex(new Mutex(CODE_AT_LINE)) {
+	fillPool= NULL;
+	timeSteps= 8;
+	maxIdleFrames= 30;
+	frameIndex= 0;
+	evictionGeneration= 0;
+	vertexBytes= 0;
+	resetStats();
+
+	instance= this;
+}
+
+InterpolationCache::~InterpolationCache() {
+	instance= NULL;
+
+	delete fillPool;
+	fillPool= NULL;
+
+	clear();
+
+	delete mutex;
+	mutex= NULL;
+}
+
+InterpolationCache &InterpolationCache::getInstance() {
+	static InterpolationCache cache;
+	return cache;
+}
+
+void InterpolationCache::setTimeSteps(uint32 value) {
+	if(timeSteps != value) {
+		clear();
+		timeSteps= value;
+	}
+}
+
+void InterpolationCache::setThreadCount(int threadCount) {
+	if(fillPool != NULL && fillPool->getThreadCount() == threadCount) {
+		return;
+	}
+	delete fillPool;
+	fillPool= NULL;
+	if(threadCount > 0) {
+		fillPool= new WorkerThreadPool("InterpolationFill",threadCount);
+	}
+}
+
+InterpolationCache::Key InterpolationCache::makeKey(const Vec3f *src, uint32 frameCount,
+		float t, bool cycle, float &quantizedT) const {
+	// timeSteps positions between two key frames
+	const uint32 stepCount= frameCount * timeSteps;
+	uint32 step= static_cast<uint32>(t * stepCount + 0.5f);
+	if(step > stepCount) {
+		step= stepCount;
+	}
+	quantizedT= static_cast<float>(step) / static_cast<float>(stepCount);
+	return Key(src, step, cycle);
+}
+
+void InterpolationCache::removeEntry(EntryMap::iterator iterFind) {
+	evictionGeneration++;
+	vertexBytes -= (uint64)iterFind->second.vertexCount * sizeof(Vec3f);
+	delete [] iterFind->second.data;
+	entries.erase(iterFind);
+}
+
+const Vec3f *InterpolationCache::get(const Vec3f *src, uint32 frameCount, uint32 vertexCount, float t, bool cycle) {
+	if(isEnabled() == false || src == NULL || frameCount <= 1) {
+		return NULL;
+	}
+
+	float quantizedT= t;
+	Key key= makeKey(src, frameCount, t, cycle, quantizedT);
+
+	MutexSafeWrapper safeMutex(mutex,CODE_AT_LINE);
+	Entry &entry= entries[key];
+	entry.lastUsedFrame= frameIndex;
+	if(entry.data != NULL) {
+		hitCount++;
+		return entry.data;
+	}
+
+	missCount++;
+	Chrono chrono;
+	chrono.start();
+
+	entry.data= new Vec3f[vertexCount];
+	entry.vertexCount= vertexCount;
+	vertexBytes += (uint64)vertexCount * sizeof(Vec3f);
+	InterpolationData::interpolate(src, frameCount, vertexCount, quantizedT, cycle, entry.data);
+
+	fillMicros += chrono.getMicros();
+	return entry.data;
+}
+
+uint32 InterpolationCache::getFrameStep(uint32 frameCount, float t, bool cycle) const {
+	if(isEnabled() == false || frameCount <= 1 || t < 0.0f || t > 1.0f) {
+		return 0;
+	}
+
+	float quantizedT= t;
+	Key key= makeKey(NULL, frameCount, t, cycle, quantizedT);
+	return (key.step << 1) | (cycle ? 1 : 0);
+}
+
+uint32 InterpolationCache::getFrameStep(const Model *model, float t, bool cycle) const {
+	if(InterpolationData::getEnableInterpolation() == false || model == NULL) {
+		return 0;
+	}
+
+	// the mesh with the most key frames has the finest steps
+	uint32 frameCount= 0;
+	for(uint32 index = 0; index < model->getMeshCount(); ++index) {
+		const Mesh *mesh= model->getMesh(index);
+		if(mesh->getInterpolationData() != NULL && mesh->getFrameCount() > frameCount) {
+			frameCount= mesh->getFrameCount();
+		}
+	}
+	return getFrameStep(frameCount, t, cycle);
+}
+
+void InterpolationCache::queue(const Vec3f *src, uint32 frameCount, uint32 vertexCount, float t, bool cycle) {
+	if(src == NULL || frameCount <= 1) {
+		return;
+	}
+
+	float quantizedT= t;
+	Key key= makeKey(src, frameCount, t, cycle, quantizedT);
+
+	MutexSafeWrapper safeMutex(mutex,CODE_AT_LINE);
+	EntryMap::iterator iterFind= entries.find(key);
+	if(iterFind != entries.end()) {
+		iterFind->second.lastUsedFrame= frameIndex;
+		if(iterFind->second.data != NULL) {
+			hitCount++;
+		}
+		// otherwise it is queued already
+		return;
+	}
+
+	Entry &entry= entries[key];
+	entry.lastUsedFrame= frameIndex;
+	missCount++;
+	queuedTasks.push_back(new InterpolationFillTask(key, src, frameCount, vertexCount, quantizedT));
+}
+
+void InterpolationCache::queue(const Model *model, float t, bool cycle) {
+	if(isEnabled() == false || InterpolationData::getEnableInterpolation() == false ||
+		model == NULL || t < 0.0f || t > 1.0f) {
+		return;
+	}
+
+	for(uint32 index = 0; index < model->getMeshCount(); ++index) {
+		const Mesh *mesh= model->getMesh(index);
+		if(mesh->getInterpolationData() == NULL) {
+			continue;
+		}
+		queue(mesh->getVertices(), mesh->getFrameCount(), mesh->getVertexCount(), t, cycle);
+		queue(mesh->getNormals(), mesh->getFrameCount(), mesh->getVertexCount(), t, cycle);
+	}
+}
+
+void InterpolationCache::fillQueued() {
+	if(queuedTasks.empty() == true) {
+		return;
+	}
+
+	Chrono chrono;
+	chrono.start();
+
+	vector<InterpolationFillTask *> tasks;
+	tasks.swap(queuedTasks);
+	if(fillPool != NULL && tasks.size() > 1) {
+		for(unsigned int index = 0; index < tasks.size(); ++index) {
+			fillPool->queueTask(tasks[index]);
+		}
+		fillPool->waitForAllTasks();
+		fillPool->popCompletedTasks();
+	}
+	else {
+		for(unsigned int index = 0; index < tasks.size(); ++index) {
+			tasks[index]->executeTask(NULL);
+		}
+	}
+
+	MutexSafeWrapper safeMutex(mutex,CODE_AT_LINE);
+	for(unsigned int index = 0; index < tasks.size(); ++index) {
+		InterpolationFillTask *task= tasks[index];
+		EntryMap::iterator iterFind= entries.find(task->key);
+		if(task->result != NULL && iterFind != entries.end() && iterFind->second.data == NULL) {
+			iterFind->second.data= task->result;
+			iterFind->second.vertexCount= task->vertexCount;
+			vertexBytes += (uint64)task->vertexCount * sizeof(Vec3f);
+			task->result= NULL;
+		}
+		delete task;
+	}
+
+	fillMicros += chrono.getMicros();
+}
+
+void InterpolationCache::nextFrame() {
+	MutexSafeWrapper safeMutex(mutex,CODE_AT_LINE);
+	frameIndex++;
+
+	for(EntryMap::iterator iterMap = entries.begin(); iterMap != entries.end();) {
+		if(frameIndex - iterMap->second.lastUsedFrame > maxIdleFrames) {
+			removeEntry(iterMap++);
+		}
+		else {
+			++iterMap;
+		}
+	}
+}
+
+void InterpolationCache::clear() {
+	MutexSafeWrapper safeMutex(mutex,CODE_AT_LINE);
+	for(unsigned int index = 0; index < queuedTasks.size(); ++index) {
+		delete queuedTasks[index];
+	}
+	queuedTasks.clear();
+
+	for(EntryMap::iterator iterMap = entries.begin(); iterMap != entries.end(); ++iterMap) {
+		delete [] iterMap->second.data;
+	}
+	entries.clear();
+	vertexBytes= 0;
+	evictionGeneration++;
+}
+
+void InterpolationCache::releaseSource(const Vec3f *src) {
+	// meshes may outlive the cache when the program exits
+	if(instance == NULL || src == NULL) {
+		return;
+	}
+
+	MutexSafeWrapper safeMutex(instance->mutex,CODE_AT_LINE);
+	EntryMap &entries= instance->entries;
+	EntryMap::iterator iterMap= entries.lower_bound(Key(src, 0, false));
+	for(; iterMap != entries.end() && iterMap->first.src == src;) {
+		instance->removeEntry(iterMap++);
+	}
+
+	for(unsigned int index = 0; index < instance->queuedTasks.size();) {
+		if(instance->queuedTasks[index]->src == src) {
+			delete instance->queuedTasks[index];
+			instance->queuedTasks.erase(instance->queuedTasks.begin() + index);
+		}
+		else {
+			++index;
+		}
+	}
+}
+
+void InterpolationCache::resetStats() {
+	hitCount= 0;
+	missCount= 0;
+	fillMicros= 0;
+}
+
+string InterpolationCache::getStatsString() const {
+	uint64 lookups= hitCount + missCount;
+	int hitPercent= (lookups > 0 ? (int)(hitCount * 100 / lookups) : 0);
+	char szBuf[512]="";
+	snprintf(szBuf,511,"hits: %d%% of %llu, fill: %lld ms, entries: %d (%llu KB)",
+			hitPercent,(unsigned long long)lookups,(long long)(fillMicros / 1000),
+			(int)entries.size(),(unsigned long long)(vertexBytes / 1024));
+	return szBuf;
+}
+
 }}//end namespace 
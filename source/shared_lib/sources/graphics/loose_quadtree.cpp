@@ -0,0 +1,256 @@
+// ==============================================================
+//	This file is part of Glest Shared Library (www.glest.org)
+//
+//	Copyright (C) 2001-2008 Martiño Figueroa
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include "loose_quadtree.h"
+
+#include <algorithm>
+#include "leak_dumper.h"
+
+using namespace std;
+
+namespace Shared{ namespace Graphics{
+
+// =====================================================
+//	class LooseQuadTree
+// =====================================================
+
+LooseQuadTree::Node::Node() {
+	parent= -1;
+	subtreeItemCount= 0;
+}
+
+LooseQuadTree::Item::Item() {
+	userData= NULL;
+	radius= 0.f;
+	node= -1;
+	slot= -1;
+}
+
+LooseQuadTree::LooseQuadTree() {
+	itemCount= 0;
+	size= 1.f;
+	levels= 1;
+	init(Vec2f(0.f), 1.f, 1);
+}
+
+int LooseQuadTree::getLevelStart(int level) {
+	return ((1 << (2 * level)) - 1) / 3;
+}
+
+void LooseQuadTree::init(const Vec2f &origin, float size, int levels) {
+	this->origin= origin;
+	this->size= max(size, 1.f);
+	this->levels= max(1, min(levels, 10));
+	clear();
+}
+
+void LooseQuadTree::clear() {
+	nodes.assign(getLevelStart(levels), Node());
+	for(int level = 1; level < levels; ++level) {
+		const int side= 1 << level;
+		for(int y = 0; y < side; ++y) {
+			for(int x = 0; x < side; ++x) {
+				nodes[getLevelStart(level) + y * side + x].parent=
+					getLevelStart(level - 1) + (y / 2) * (side / 2) + (x / 2);
+			}
+		}
+	}
+	items.clear();
+	freeItems.clear();
+	itemCount= 0;
+}
+
+int LooseQuadTree::findNode(const Vec3f &center, float radius) const {
+	// the deepest level whose loose bounds, twice the node size,
+	// still hold the item
+	for(int level = levels - 1; level > 0; --level) {
+		const int side= 1 << level;
+		const float nodeSize= size / side;
+		if(radius <= nodeSize * 0.5f) {
+			int x= (int)((center.x - origin.x) / nodeSize);
+			int y= (int)((center.z - origin.y) / nodeSize);
+			x= max(0, min(x, side - 1));
+			y= max(0, min(y, side - 1));
+			return getLevelStart(level) + y * side + x;
+		}
+	}
+	return 0;
+}
+
+void LooseQuadTree::linkItem(int itemIndex, int nodeIndex) {
+	Item &item= items[itemIndex];
+	item.node= nodeIndex;
+	item.slot= (int)nodes[nodeIndex].items.size();
+	nodes[nodeIndex].items.push_back(itemIndex);
+
+	for(int index = nodeIndex; index >= 0; index = nodes[index].parent) {
+		nodes[index].subtreeItemCount++;
+	}
+	growBounds(itemIndex);
+}
+
+void LooseQuadTree::unlinkItem(int itemIndex) {
+	Item &item= items[itemIndex];
+	Node &node= nodes[item.node];
+	const int lastItem= node.items.back();
+	node.items[item.slot]= lastItem;
+	items[lastItem].slot= item.slot;
+	node.items.pop_back();
+
+	for(int index = item.node; index >= 0; index = nodes[index].parent) {
+		nodes[index].subtreeItemCount--;
+	}
+	item.node= -1;
+	item.slot= -1;
+}
+
+void LooseQuadTree::growBounds(int itemIndex) {
+	const Item &item= items[itemIndex];
+	const Vec3f itemMin(item.center.x - item.radius, item.center.y - item.radius, item.center.z - item.radius);
+	const Vec3f itemMax(item.center.x + item.radius, item.center.y + item.radius, item.center.z + item.radius);
+
+	for(int index = item.node; index >= 0; index = nodes[index].parent) {
+		Node &node= nodes[index];
+		if(node.subtreeItemCount == 1) {
+			// the old bounds belonged to items that are gone
+			node.boundsMin= itemMin;
+			node.boundsMax= itemMax;
+		}
+		else {
+			node.boundsMin.x= min(node.boundsMin.x, itemMin.x);
+			node.boundsMin.y= min(node.boundsMin.y, itemMin.y);
+			node.boundsMin.z= min(node.boundsMin.z, itemMin.z);
+			node.boundsMax.x= max(node.boundsMax.x, itemMax.x);
+			node.boundsMax.y= max(node.boundsMax.y, itemMax.y);
+			node.boundsMax.z= max(node.boundsMax.z, itemMax.z);
+		}
+	}
+}
+
+int LooseQuadTree::addItem(void *userData, const Vec3f &center, float radius) {
+	int itemIndex= -1;
+	if(freeItems.empty() == false) {
+		itemIndex= freeItems.back();
+		freeItems.pop_back();
+	}
+	else {
+		itemIndex= (int)items.size();
+		items.push_back(Item());
+	}
+	Item &item= items[itemIndex];
+	item.userData= userData;
+	item.center= center;
+	item.radius= radius;
+	linkItem(itemIndex, findNode(center, radius));
+	itemCount++;
+	return itemIndex;
+}
+
+void LooseQuadTree::moveItem(int itemIndex, const Vec3f &center, float radius) {
+	Item &item= items[itemIndex];
+	if(item.center == center && item.radius == radius) {
+		return;
+	}
+	item.center= center;
+	item.radius= radius;
+
+	const int nodeIndex= findNode(center, radius);
+	if(nodeIndex == item.node) {
+		growBounds(itemIndex);
+	}
+	else {
+		unlinkItem(itemIndex);
+		linkItem(itemIndex, nodeIndex);
+	}
+}
+
+void LooseQuadTree::removeItem(int itemIndex) {
+	unlinkItem(itemIndex);
+	items[itemIndex].userData= NULL;
+	freeItems.push_back(itemIndex);
+	itemCount--;
+}
+
+bool LooseQuadTree::boxInFrustum(const Frustum &frustum, const Vec3f &boxMin, const Vec3f &boxMax) {
+	for(unsigned int p = 0; p < frustum.size(); ++p) {
+		const vector<float> &plane= frustum[p];
+		// the corner furthest along the plane normal
+		float x= (plane[0] >= 0 ? boxMax.x : boxMin.x);
+		float y= (plane[1] >= 0 ? boxMax.y : boxMin.y);
+		float z= (plane[2] >= 0 ? boxMax.z : boxMin.z);
+		if(plane[0] * x + plane[1] * y + plane[2] * z + plane[3] <= 0) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool LooseQuadTree::boxFullyInFrustum(const Frustum &frustum, const Vec3f &boxMin, const Vec3f &boxMax) {
+	for(unsigned int p = 0; p < frustum.size(); ++p) {
+		const vector<float> &plane= frustum[p];
+		// the corner furthest against the plane normal
+		float x= (plane[0] >= 0 ? boxMin.x : boxMax.x);
+		float y= (plane[1] >= 0 ? boxMin.y : boxMax.y);
+		float z= (plane[2] >= 0 ? boxMin.z : boxMax.z);
+		if(plane[0] * x + plane[1] * y + plane[2] * z + plane[3] <= 0) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void LooseQuadTree::collectNode(int level, int x, int y, vector<int> &result) const {
+	const int side= 1 << level;
+	const Node &node= nodes[getLevelStart(level) + y * side + x];
+	if(node.subtreeItemCount == 0) {
+		return;
+	}
+	result.insert(result.end(), node.items.begin(), node.items.end());
+	if(level + 1 < levels) {
+		for(int child = 0; child < 4; ++child) {
+			collectNode(level + 1, x * 2 + (child & 1), y * 2 + (child >> 1), result);
+		}
+	}
+}
+
+void LooseQuadTree::cullNode(int level, int x, int y, const Frustum &frustum, vector<int> &result) const {
+	const int side= 1 << level;
+	const Node &node= nodes[getLevelStart(level) + y * side + x];
+	if(node.subtreeItemCount == 0 ||
+		boxInFrustum(frustum, node.boundsMin, node.boundsMax) == false) {
+		return;
+	}
+	if(boxFullyInFrustum(frustum, node.boundsMin, node.boundsMax) == true) {
+		collectNode(level, x, y, result);
+		return;
+	}
+
+	for(unsigned int i = 0; i < node.items.size(); ++i) {
+		const Item &item= items[node.items[i]];
+		const Vec3f itemMin(item.center.x - item.radius, item.center.y - item.radius, item.center.z - item.radius);
+		const Vec3f itemMax(item.center.x + item.radius, item.center.y + item.radius, item.center.z + item.radius);
+		if(boxInFrustum(frustum, itemMin, itemMax) == true) {
+			result.push_back(node.items[i]);
+		}
+	}
+	if(level + 1 < levels) {
+		for(int child = 0; child < 4; ++child) {
+			cullNode(level + 1, x * 2 + (child & 1), y * 2 + (child >> 1), frustum, result);
+		}
+	}
+}
+
+void LooseQuadTree::cull(const Frustum &frustum, vector<int> &result) const {
+	result.clear();
+	cullNode(0, 0, 0, frustum, result);
+}
+
+}}//end namespace
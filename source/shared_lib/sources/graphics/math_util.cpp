@@ -0,0 +1,569 @@
+// ==============================================================
+//	This file is part of Glest Shared Library (www.glest.org)
+//
+//	Copyright (C) 2001-2008 Martiño Figueroa
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include "math_util.h"
+
+#include <cmath>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+	#include <immintrin.h>
+	#define VEC_ARRAY_SIMD_X86
+	#define VEC_ARRAY_TARGET_SSE2 __attribute__((target("sse2")))
+	#define VEC_ARRAY_TARGET_AVX2 __attribute__((target("avx2")))
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+	#include <intrin.h>
+	#include <immintrin.h>
+	#define VEC_ARRAY_SIMD_X86
+	#define VEC_ARRAY_TARGET_SSE2
+	#define VEC_ARRAY_TARGET_AVX2
+#endif
+
+#include "leak_dumper.h"
+
+namespace Shared{ namespace Graphics{
+
+// =====================================================
+//	Vec3f array kernels
+// =====================================================
+
+// All versions evaluate the same expressions in the same order without
+// fused multiply-add, so every level gives bit identical results.
+
+static inline float vecArraySqrt(float value) {
+#ifdef USE_STREFLOP
+	return static_cast<float>(streflop::sqrt(static_cast<streflop::Simple>(value)));
+#else
+	return std::sqrt(value);
+#endif
+}
+
+// ==================== scalar ====================
+
+static void lerpScalar(const float *a, const float *b, float t, float *out, uint32 floatCount) {
+	for(uint32 i = 0; i < floatCount; ++i) {
+		out[i]= a[i] + (b[i] - a[i]) * t;
+	}
+}
+
+static void normalizeScalar(float *values, uint32 count) {
+	for(uint32 i = 0; i < count; ++i) {
+		float *v= &values[i * 3];
+		float len= vecArraySqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+		if(len > 0.f) {
+			v[0]= v[0] / len;
+			v[1]= v[1] / len;
+			v[2]= v[2] / len;
+		}
+	}
+}
+
+static void transformScalar(const float *m, const float *src, float *dest, uint32 count) {
+	for(uint32 i = 0; i < count; ++i) {
+		const float x= src[i * 3];
+		const float y= src[i * 3 + 1];
+		const float z= src[i * 3 + 2];
+		dest[i * 3]=     m[0] * x + m[1] * y + m[2]  * z + m[3];
+		dest[i * 3 + 1]= m[4] * x + m[5] * y + m[6]  * z + m[7];
+		dest[i * 3 + 2]= m[8] * x + m[9] * y + m[10] * z + m[11];
+	}
+}
+
+// uint8 kernels, the lerp weights always add up to 256 so the sum of the
+// two products fits in 16 bits
+
+static void maxUint8Scalar(const uint8 *src, uint8 *dest, uint32 count) {
+	for(uint32 i = 0; i < count; ++i) {
+		dest[i]= (src[i] > dest[i] ? src[i] : dest[i]);
+	}
+}
+
+static void maxOrLimitUint8Scalar(const uint8 *src, uint8 *dest, uint8 limit, uint32 count) {
+	for(uint32 i = 0; i < count; ++i) {
+		const uint8 limited= (dest[i] < limit ? dest[i] : limit);
+		dest[i]= (src[i] > dest[i] ? src[i] : limited);
+	}
+}
+
+static void lerpChangedUint8Scalar(const uint8 *from, const uint8 *to, uint8 *dest, uint32 t, uint32 count) {
+	for(uint32 i = 0; i < count; ++i) {
+		const uint8 value= static_cast<uint8>((from[i] * (256 - t) + to[i] * t) >> 8);
+		dest[i]= (dest[i] == to[i] ? dest[i] : value);
+	}
+}
+
+#ifdef VEC_ARRAY_SIMD_X86
+
+// ==================== SSE2 ====================
+
+// Four packed Vec3f (a= x0 y0 z0 x1, b= y1 z1 x2 y2, c= z2 x3 y3 z3)
+// to and from one register per component. _mm256_shuffle_ps works per
+// 128 bit lane with the same immediates, so the AVX2 kernels reuse these
+// shuffles on two groups at once.
+#define VEC_ARRAY_DEINTERLEAVE(shuffle, a, b, c, x, y, z) \
+	x= shuffle(shuffle(a, b, _MM_SHUFFLE(2,2,3,0)), shuffle(b, c, _MM_SHUFFLE(1,1,2,2)), _MM_SHUFFLE(2,0,1,0)); \
+	y= shuffle(shuffle(a, b, _MM_SHUFFLE(0,0,1,1)), shuffle(b, c, _MM_SHUFFLE(2,2,3,3)), _MM_SHUFFLE(2,0,2,0)); \
+	z= shuffle(shuffle(a, b, _MM_SHUFFLE(1,1,2,2)), shuffle(c, c, _MM_SHUFFLE(3,3,0,0)), _MM_SHUFFLE(2,0,2,0));
+
+#define VEC_ARRAY_INTERLEAVE(shuffle, x, y, z, a, b, c) \
+	a= shuffle(shuffle(x, y, _MM_SHUFFLE(0,0,0,0)), shuffle(z, x, _MM_SHUFFLE(1,1,0,0)), _MM_SHUFFLE(2,0,2,0)); \
+	b= shuffle(shuffle(y, z, _MM_SHUFFLE(1,1,1,1)), shuffle(x, y, _MM_SHUFFLE(2,2,2,2)), _MM_SHUFFLE(2,0,2,0)); \
+	c= shuffle(shuffle(z, x, _MM_SHUFFLE(3,3,2,2)), shuffle(y, z, _MM_SHUFFLE(3,3,3,3)), _MM_SHUFFLE(2,0,2,0));
+
+VEC_ARRAY_TARGET_SSE2
+static void lerpSSE2(const float *a, const float *b, float t, float *out, uint32 floatCount) {
+	const __m128 tv= _mm_set1_ps(t);
+	uint32 i = 0;
+	for(; i + 4 <= floatCount; i += 4) {
+		const __m128 va= _mm_loadu_ps(a + i);
+		const __m128 vb= _mm_loadu_ps(b + i);
+		_mm_storeu_ps(out + i, _mm_add_ps(va, _mm_mul_ps(_mm_sub_ps(vb, va), tv)));
+	}
+	for(; i < floatCount; ++i) {
+		out[i]= a[i] + (b[i] - a[i]) * t;
+	}
+}
+
+VEC_ARRAY_TARGET_SSE2
+static void normalizeSSE2(float *values, uint32 count) {
+	const __m128 zero= _mm_setzero_ps();
+	uint32 i = 0;
+	for(; i + 4 <= count; i += 4) {
+		float *p= &values[i * 3];
+		const __m128 a= _mm_loadu_ps(p);
+		const __m128 b= _mm_loadu_ps(p + 4);
+		const __m128 c= _mm_loadu_ps(p + 8);
+		__m128 x, y, z;
+		VEC_ARRAY_DEINTERLEAVE(_mm_shuffle_ps, a, b, c, x, y, z)
+
+		const __m128 len= _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z)));
+		const __m128 mask= _mm_cmpgt_ps(len, zero);
+		x= _mm_or_ps(_mm_and_ps(mask, _mm_div_ps(x, len)), _mm_andnot_ps(mask, x));
+		y= _mm_or_ps(_mm_and_ps(mask, _mm_div_ps(y, len)), _mm_andnot_ps(mask, y));
+		z= _mm_or_ps(_mm_and_ps(mask, _mm_div_ps(z, len)), _mm_andnot_ps(mask, z));
+
+		__m128 ra, rb, rc;
+		VEC_ARRAY_INTERLEAVE(_mm_shuffle_ps, x, y, z, ra, rb, rc)
+		_mm_storeu_ps(p, ra);
+		_mm_storeu_ps(p + 4, rb);
+		_mm_storeu_ps(p + 8, rc);
+	}
+	normalizeScalar(&values[i * 3], count - i);
+}
+
+VEC_ARRAY_TARGET_SSE2
+static void transformSSE2(const float *m, const float *src, float *dest, uint32 count) {
+	const __m128 m0= _mm_set1_ps(m[0]), m1= _mm_set1_ps(m[1]), m2= _mm_set1_ps(m[2]), m3= _mm_set1_ps(m[3]);
+	const __m128 m4= _mm_set1_ps(m[4]), m5= _mm_set1_ps(m[5]), m6= _mm_set1_ps(m[6]), m7= _mm_set1_ps(m[7]);
+	const __m128 m8= _mm_set1_ps(m[8]), m9= _mm_set1_ps(m[9]), m10= _mm_set1_ps(m[10]), m11= _mm_set1_ps(m[11]);
+	uint32 i = 0;
+	for(; i + 4 <= count; i += 4) {
+		const __m128 a= _mm_loadu_ps(&src[i * 3]);
+		const __m128 b= _mm_loadu_ps(&src[i * 3 + 4]);
+		const __m128 c= _mm_loadu_ps(&src[i * 3 + 8]);
+		__m128 x, y, z;
+		VEC_ARRAY_DEINTERLEAVE(_mm_shuffle_ps, a, b, c, x, y, z)
+
+		const __m128 rx= _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m0, x), _mm_mul_ps(m1, y)), _mm_mul_ps(m2, z)), m3);
+		const __m128 ry= _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m4, x), _mm_mul_ps(m5, y)), _mm_mul_ps(m6, z)), m7);
+		const __m128 rz= _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m8, x), _mm_mul_ps(m9, y)), _mm_mul_ps(m10, z)), m11);
+
+		__m128 ra, rb, rc;
+		VEC_ARRAY_INTERLEAVE(_mm_shuffle_ps, rx, ry, rz, ra, rb, rc)
+		_mm_storeu_ps(&dest[i * 3], ra);
+		_mm_storeu_ps(&dest[i * 3 + 4], rb);
+		_mm_storeu_ps(&dest[i * 3 + 8], rc);
+	}
+	transformScalar(m, &src[i * 3], &dest[i * 3], count - i);
+}
+
+// ==================== AVX2 ====================
+
+VEC_ARRAY_TARGET_AVX2
+static inline __m256 loadLanes(const float *low, const float *high) {
+	return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(low)), _mm_loadu_ps(high), 1);
+}
+
+VEC_ARRAY_TARGET_AVX2
+static inline void storeLanes(float *low, float *high, __m256 value) {
+	_mm_storeu_ps(low, _mm256_castps256_ps128(value));
+	_mm_storeu_ps(high, _mm256_extractf128_ps(value, 1));
+}
+
+VEC_ARRAY_TARGET_AVX2
+static void lerpAVX2(const float *a, const float *b, float t, float *out, uint32 floatCount) {
+	const __m256 tv= _mm256_set1_ps(t);
+	uint32 i = 0;
+	for(; i + 8 <= floatCount; i += 8) {
+		const __m256 va= _mm256_loadu_ps(a + i);
+		const __m256 vb= _mm256_loadu_ps(b + i);
+		_mm256_storeu_ps(out + i, _mm256_add_ps(va, _mm256_mul_ps(_mm256_sub_ps(vb, va), tv)));
+	}
+	for(; i < floatCount; ++i) {
+		out[i]= a[i] + (b[i] - a[i]) * t;
+	}
+}
+
+VEC_ARRAY_TARGET_AVX2
+static void normalizeAVX2(float *values, uint32 count) {
+	const __m256 zero= _mm256_setzero_ps();
+	uint32 i = 0;
+	for(; i + 8 <= count; i += 8) {
+		float *p= &values[i * 3];
+		const __m256 a= loadLanes(p, p + 12);
+		const __m256 b= loadLanes(p + 4, p + 16);
+		const __m256 c= loadLanes(p + 8, p + 20);
+		__m256 x, y, z;
+		VEC_ARRAY_DEINTERLEAVE(_mm256_shuffle_ps, a, b, c, x, y, z)
+
+		const __m256 len= _mm256_sqrt_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y)), _mm256_mul_ps(z, z)));
+		const __m256 mask= _mm256_cmp_ps(len, zero, _CMP_GT_OQ);
+		x= _mm256_blendv_ps(x, _mm256_div_ps(x, len), mask);
+		y= _mm256_blendv_ps(y, _mm256_div_ps(y, len), mask);
+		z= _mm256_blendv_ps(z, _mm256_div_ps(z, len), mask);
+
+		__m256 ra, rb, rc;
+		VEC_ARRAY_INTERLEAVE(_mm256_shuffle_ps, x, y, z, ra, rb, rc)
+		storeLanes(p, p + 12, ra);
+		storeLanes(p + 4, p + 16, rb);
+		storeLanes(p + 8, p + 20, rc);
+	}
+	normalizeScalar(&values[i * 3], count - i);
+}
+
+VEC_ARRAY_TARGET_AVX2
+static void transformAVX2(const float *m, const float *src, float *dest, uint32 count) {
+	const __m256 m0= _mm256_set1_ps(m[0]), m1= _mm256_set1_ps(m[1]), m2= _mm256_set1_ps(m[2]), m3= _mm256_set1_ps(m[3]);
+	const __m256 m4= _mm256_set1_ps(m[4]), m5= _mm256_set1_ps(m[5]), m6= _mm256_set1_ps(m[6]), m7= _mm256_set1_ps(m[7]);
+	const __m256 m8= _mm256_set1_ps(m[8]), m9= _mm256_set1_ps(m[9]), m10= _mm256_set1_ps(m[10]), m11= _mm256_set1_ps(m[11]);
+	uint32 i = 0;
+	for(; i + 8 <= count; i += 8) {
+		const float *p= &src[i * 3];
+		const __m256 a= loadLanes(p, p + 12);
+		const __m256 b= loadLanes(p + 4, p + 16);
+		const __m256 c= loadLanes(p + 8, p + 20);
+		__m256 x, y, z;
+		VEC_ARRAY_DEINTERLEAVE(_mm256_shuffle_ps, a, b, c, x, y, z)
+
+		const __m256 rx= _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m0, x), _mm256_mul_ps(m1, y)), _mm256_mul_ps(m2, z)), m3);
+		const __m256 ry= _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m4, x), _mm256_mul_ps(m5, y)), _mm256_mul_ps(m6, z)), m7);
+		const __m256 rz= _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m8, x), _mm256_mul_ps(m9, y)), _mm256_mul_ps(m10, z)), m11);
+
+		__m256 ra, rb, rc;
+		VEC_ARRAY_INTERLEAVE(_mm256_shuffle_ps, rx, ry, rz, ra, rb, rc)
+		float *out= &dest[i * 3];
+		storeLanes(out, out + 12, ra);
+		storeLanes(out + 4, out + 16, rb);
+		storeLanes(out + 8, out + 20, rc);
+	}
+	transformScalar(m, &src[i * 3], &dest[i * 3], count - i);
+}
+
+// ==================== SSE2 uint8 ====================
+
+VEC_ARRAY_TARGET_SSE2
+static inline __m128i selectSSE2(__m128i mask, __m128i a, __m128i b) {
+	return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+// mask of the bytes where a > b, unsigned
+VEC_ARRAY_TARGET_SSE2
+static inline __m128i greaterUint8SSE2(__m128i a, __m128i b) {
+	return _mm_andnot_si128(_mm_cmpeq_epi8(a, b), _mm_cmpeq_epi8(_mm_max_epu8(a, b), a));
+}
+
+VEC_ARRAY_TARGET_SSE2
+static void maxUint8SSE2(const uint8 *src, uint8 *dest, uint32 count) {
+	uint32 i = 0;
+	for(; i + 16 <= count; i += 16) {
+		const __m128i s= _mm_loadu_si128((const __m128i *)(src + i));
+		const __m128i d= _mm_loadu_si128((const __m128i *)(dest + i));
+		_mm_storeu_si128((__m128i *)(dest + i), _mm_max_epu8(s, d));
+	}
+	maxUint8Scalar(src + i, dest + i, count - i);
+}
+
+VEC_ARRAY_TARGET_SSE2
+static void maxOrLimitUint8SSE2(const uint8 *src, uint8 *dest, uint8 limit, uint32 count) {
+	const __m128i l= _mm_set1_epi8((char)limit);
+	uint32 i = 0;
+	for(; i + 16 <= count; i += 16) {
+		const __m128i s= _mm_loadu_si128((const __m128i *)(src + i));
+		const __m128i d= _mm_loadu_si128((const __m128i *)(dest + i));
+		_mm_storeu_si128((__m128i *)(dest + i), selectSSE2(greaterUint8SSE2(s, d), s, _mm_min_epu8(d, l)));
+	}
+	maxOrLimitUint8Scalar(src + i, dest + i, limit, count - i);
+}
+
+VEC_ARRAY_TARGET_SSE2
+static inline __m128i lerpUint16SSE2(__m128i from, __m128i to, __m128i tFrom, __m128i tTo) {
+	return _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(from, tFrom), _mm_mullo_epi16(to, tTo)), 8);
+}
+
+VEC_ARRAY_TARGET_SSE2
+static void lerpChangedUint8SSE2(const uint8 *from, const uint8 *to, uint8 *dest, uint32 t, uint32 count) {
+	const __m128i zero= _mm_setzero_si128();
+	const __m128i tFrom= _mm_set1_epi16((short)(256 - t));
+	const __m128i tTo= _mm_set1_epi16((short)t);
+	uint32 i = 0;
+	for(; i + 16 <= count; i += 16) {
+		const __m128i f= _mm_loadu_si128((const __m128i *)(from + i));
+		const __m128i o= _mm_loadu_si128((const __m128i *)(to + i));
+		const __m128i d= _mm_loadu_si128((const __m128i *)(dest + i));
+
+		const __m128i low= lerpUint16SSE2(_mm_unpacklo_epi8(f, zero), _mm_unpacklo_epi8(o, zero), tFrom, tTo);
+		const __m128i high= lerpUint16SSE2(_mm_unpackhi_epi8(f, zero), _mm_unpackhi_epi8(o, zero), tFrom, tTo);
+		const __m128i value= _mm_packus_epi16(low, high);
+		_mm_storeu_si128((__m128i *)(dest + i), selectSSE2(_mm_cmpeq_epi8(d, o), d, value));
+	}
+	lerpChangedUint8Scalar(from + i, to + i, dest + i, t, count - i);
+}
+
+// ==================== AVX2 uint8 ====================
+
+VEC_ARRAY_TARGET_AVX2
+static inline __m256i selectAVX2(__m256i mask, __m256i a, __m256i b) {
+	return _mm256_blendv_epi8(b, a, mask);
+}
+
+VEC_ARRAY_TARGET_AVX2
+static inline __m256i greaterUint8AVX2(__m256i a, __m256i b) {
+	return _mm256_andnot_si256(_mm256_cmpeq_epi8(a, b), _mm256_cmpeq_epi8(_mm256_max_epu8(a, b), a));
+}
+
+VEC_ARRAY_TARGET_AVX2
+static void maxUint8AVX2(const uint8 *src, uint8 *dest, uint32 count) {
+	uint32 i = 0;
+	for(; i + 32 <= count; i += 32) {
+		const __m256i s= _mm256_loadu_si256((const __m256i *)(src + i));
+		const __m256i d= _mm256_loadu_si256((const __m256i *)(dest + i));
+		_mm256_storeu_si256((__m256i *)(dest + i), _mm256_max_epu8(s, d));
+	}
+	maxUint8Scalar(src + i, dest + i, count - i);
+}
+
+VEC_ARRAY_TARGET_AVX2
+static void maxOrLimitUint8AVX2(const uint8 *src, uint8 *dest, uint8 limit, uint32 count) {
+	const __m256i l= _mm256_set1_epi8((char)limit);
+	uint32 i = 0;
+	for(; i + 32 <= count; i += 32) {
+		const __m256i s= _mm256_loadu_si256((const __m256i *)(src + i));
+		const __m256i d= _mm256_loadu_si256((const __m256i *)(dest + i));
+		_mm256_storeu_si256((__m256i *)(dest + i), selectAVX2(greaterUint8AVX2(s, d), s, _mm256_min_epu8(d, l)));
+	}
+	maxOrLimitUint8Scalar(src + i, dest + i, limit, count - i);
+}
+
+VEC_ARRAY_TARGET_AVX2
+static inline __m256i lerpUint16AVX2(__m256i from, __m256i to, __m256i tFrom, __m256i tTo) {
+	return _mm256_srli_epi16(_mm256_add_epi16(_mm256_mullo_epi16(from, tFrom), _mm256_mullo_epi16(to, tTo)), 8);
+}
+
+// unpack and pack work per 128 bit lane, so the byte order comes out unchanged
+VEC_ARRAY_TARGET_AVX2
+static void lerpChangedUint8AVX2(const uint8 *from, const uint8 *to, uint8 *dest, uint32 t, uint32 count) {
+	const __m256i zero= _mm256_setzero_si256();
+	const __m256i tFrom= _mm256_set1_epi16((short)(256 - t));
+	const __m256i tTo= _mm256_set1_epi16((short)t);
+	uint32 i = 0;
+	for(; i + 32 <= count; i += 32) {
+		const __m256i f= _mm256_loadu_si256((const __m256i *)(from + i));
+		const __m256i o= _mm256_loadu_si256((const __m256i *)(to + i));
+		const __m256i d= _mm256_loadu_si256((const __m256i *)(dest + i));
+
+		const __m256i low= lerpUint16AVX2(_mm256_unpacklo_epi8(f, zero), _mm256_unpacklo_epi8(o, zero), tFrom, tTo);
+		const __m256i high= lerpUint16AVX2(_mm256_unpackhi_epi8(f, zero), _mm256_unpackhi_epi8(o, zero), tFrom, tTo);
+		const __m256i value= _mm256_packus_epi16(low, high);
+		_mm256_storeu_si256((__m256i *)(dest + i), selectAVX2(_mm256_cmpeq_epi8(d, o), d, value));
+	}
+	lerpChangedUint8Scalar(from + i, to + i, dest + i, t, count - i);
+}
+
+static VecArraySimdLevel detectVecArraySimdLevel() {
+#if defined(__GNUC__)
+	__builtin_cpu_init();
+	if(__builtin_cpu_supports("avx2")) {
+		return vasAVX2;
+	}
+	if(__builtin_cpu_supports("sse2")) {
+		return vasSSE2;
+	}
+	return vasScalar;
+#else
+	int info[4] = { 0, 0, 0, 0 };
+	__cpuid(info, 0);
+	const int maxLeaf= info[0];
+
+	__cpuid(info, 1);
+	const bool sse2= (info[3] & (1 << 26)) != 0;
+	const bool osxsave= (info[2] & (1 << 27)) != 0;
+	const bool avx= (info[2] & (1 << 28)) != 0;
+	if(maxLeaf >= 7 && osxsave == true && avx == true) {
+		// the OS must save the ymm registers on context switches
+		if((_xgetbv(0) & 0x6) == 0x6) {
+			__cpuidex(info, 7, 0);
+			if((info[1] & (1 << 5)) != 0) {
+				return vasAVX2;
+			}
+		}
+	}
+	return (sse2 == true ? vasSSE2 : vasScalar);
+#endif
+}
+
+#else
+
+static VecArraySimdLevel detectVecArraySimdLevel() {
+	return vasScalar;
+}
+
+#endif
+
+static VecArraySimdLevel supportedVecArraySimdLevel= detectVecArraySimdLevel();
+static VecArraySimdLevel currentVecArraySimdLevel= supportedVecArraySimdLevel;
+
+VecArraySimdLevel getSupportedVecArraySimdLevel() {
+	return supportedVecArraySimdLevel;
+}
+
+VecArraySimdLevel getVecArraySimdLevel() {
+	return currentVecArraySimdLevel;
+}
+
+void setVecArraySimdLevel(VecArraySimdLevel level) {
+	currentVecArraySimdLevel= (level > supportedVecArraySimdLevel ? supportedVecArraySimdLevel : level);
+}
+
+const char *getVecArraySimdLevelName(VecArraySimdLevel level) {
+	switch(level) {
+		case vasSSE2:
+			return "SSE2";
+		case vasAVX2:
+			return "AVX2";
+		default:
+			return "scalar";
+	}
+}
+
+void lerpVec3fArray(const Vec3f *prev, const Vec3f *next, float t, Vec3f *dest, uint32 count) {
+	if(count == 0) {
+		return;
+	}
+	const float *a= prev->ptr();
+	const float *b= next->ptr();
+	float *out= dest->ptr();
+	const uint32 floatCount= count * 3;
+	switch(currentVecArraySimdLevel) {
+#ifdef VEC_ARRAY_SIMD_X86
+		case vasAVX2:
+			lerpAVX2(a, b, t, out, floatCount);
+			break;
+		case vasSSE2:
+			lerpSSE2(a, b, t, out, floatCount);
+			break;
+#endif
+		default:
+			lerpScalar(a, b, t, out, floatCount);
+			break;
+	}
+}
+
+void normalizeVec3fArray(Vec3f *values, uint32 count) {
+	if(count == 0) {
+		return;
+	}
+	float *p= values->ptr();
+	switch(currentVecArraySimdLevel) {
+#ifdef VEC_ARRAY_SIMD_X86
+		case vasAVX2:
+			normalizeAVX2(p, count);
+			break;
+		case vasSSE2:
+			normalizeSSE2(p, count);
+			break;
+#endif
+		default:
+			normalizeScalar(p, count);
+			break;
+	}
+}
+
+void transformVec3fArray(const Matrix4f &matrix, const Vec3f *src, Vec3f *dest, uint32 count) {
+	if(count == 0) {
+		return;
+	}
+	const float *m= matrix.ptr();
+	switch(currentVecArraySimdLevel) {
+#ifdef VEC_ARRAY_SIMD_X86
+		case vasAVX2:
+			transformAVX2(m, src->ptr(), dest->ptr(), count);
+			break;
+		case vasSSE2:
+			transformSSE2(m, src->ptr(), dest->ptr(), count);
+			break;
+#endif
+		default:
+			transformScalar(m, src->ptr(), dest->ptr(), count);
+			break;
+	}
+}
+
+void maxUint8Array(const uint8 *src, uint8 *dest, uint32 count) {
+	switch(currentVecArraySimdLevel) {
+#ifdef VEC_ARRAY_SIMD_X86
+		case vasAVX2:
+			maxUint8AVX2(src, dest, count);
+			break;
+		case vasSSE2:
+			maxUint8SSE2(src, dest, count);
+			break;
+#endif
+		default:
+			maxUint8Scalar(src, dest, count);
+			break;
+	}
+}
+
+void maxOrLimitUint8Array(const uint8 *src, uint8 *dest, uint8 limit, uint32 count) {
+	switch(currentVecArraySimdLevel) {
+#ifdef VEC_ARRAY_SIMD_X86
+		case vasAVX2:
+			maxOrLimitUint8AVX2(src, dest, limit, count);
+			break;
+		case vasSSE2:
+			maxOrLimitUint8SSE2(src, dest, limit, count);
+			break;
+#endif
+		default:
+			maxOrLimitUint8Scalar(src, dest, limit, count);
+			break;
+	}
+}
+
+void lerpChangedUint8Array(const uint8 *from, const uint8 *to, uint8 *dest, float t, uint32 count) {
+	// t in 1/256 steps so t= 1 gives exactly to
+	const float scaled= t * 256.f + 0.5f;
+	const uint32 fixedT= (scaled <= 0.f ? 0 : (scaled >= 256.f ? 256 : static_cast<uint32>(scaled)));
+	switch(currentVecArraySimdLevel) {
+#ifdef VEC_ARRAY_SIMD_X86
+		case vasAVX2:
+			lerpChangedUint8AVX2(from, to, dest, fixedT, count);
+			break;
+		case vasSSE2:
+			lerpChangedUint8SSE2(from, to, dest, fixedT, count);
+			break;
+#endif
+		default:
+			lerpChangedUint8Scalar(from, to, dest, fixedT, count);
+			break;
+	}
+}
+
+}}//end namespace
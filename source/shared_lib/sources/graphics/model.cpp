@@ -16,6 +16,7 @@
 #include <stdexcept>
 
 #include "interpolation.h"
+#include "math_util.h"
 #include "conversion.h"
 #include "util.h"
 #include "platform_common.h"
@@ -279,6 +280,9 @@ void Mesh::init() {
 void Mesh::end() {
 	ReleaseVBOs();
 
+	InterpolationCache::releaseSource(vertices);
+	InterpolationCache::releaseSource(normals);
+
 	delete [] vertices;
 	vertices=NULL;
 	delete [] normals;
@@ -364,6 +368,8 @@ void Mesh::BuildVBOs() {
 			glBindBufferARB(GL_ELEMENT_ARRAY_BUFFER_ARB, 0);
 
 			// Our Copy Of The Data Is No Longer Necessary, It Is Safe In The Graphics Card
+			InterpolationCache::releaseSource(vertices);
+			InterpolationCache::releaseSource(normals);
 			delete [] vertices; vertices = NULL;
 			delete [] texCoords; texCoords = NULL;
 			delete [] normals; normals = NULL;
@@ -480,16 +486,10 @@ void Mesh::loadV2(int meshIndex, const string &dir, FILE *f, TextureManager *tex
 			if(fileExists(texPath) == true) {
 				if(SystemFlags::VERBOSE_MODE_ENABLED) printf("In [%s::%s Line: %d] v2 model texture [%s] meshIndex = %d modelFile [%s]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,texPath.c_str(),meshIndex,modelFile.c_str());
 
-				textures[mtDiffuse]= textureManager->newTexture2D();
-				textures[mtDiffuse]->load(texPath);
-				if(loadedFileList) {
+				textures[mtDiffuse]= textureManager->loadTexture2D(texPath,deletePixMapAfterLoad,texturesOwned[mtDiffuse]);
+				if(texturesOwned[mtDiffuse] == true && loadedFileList) {
 					(*loadedFileList)[texPath].push_back(make_pair(sourceLoader,sourceLoader));
 				}
-				texturesOwned[mtDiffuse]=true;
-				textures[mtDiffuse]->init(textureManager->getTextureFilter(),textureManager->getMaxAnisotropy());
-				if(deletePixMapAfterLoad == true) {
-					textures[mtDiffuse]->deletePixels();
-				}
 			}
 			else {
 				SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] Error v2 model is missing texture [%s] meshIndex = %d modelFile [%s]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,texPath.c_str(),meshIndex,modelFile.c_str());
@@ -623,17 +623,10 @@ void Mesh::loadV3(int meshIndex, const string &dir, FILE *f,
 			if(fileExists(texPath) == true) {
 				if(SystemFlags::VERBOSE_MODE_ENABLED) printf("In [%s::%s Line: %d] v3 model texture [%s] meshIndex = %d modelFile [%s]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,texPath.c_str(),meshIndex,modelFile.c_str());
 
-				textures[mtDiffuse]= textureManager->newTexture2D();
-				textures[mtDiffuse]->load(texPath);
-				if(loadedFileList) {
+				textures[mtDiffuse]= textureManager->loadTexture2D(texPath,deletePixMapAfterLoad,texturesOwned[mtDiffuse]);
+				if(texturesOwned[mtDiffuse] == true && loadedFileList) {
 					(*loadedFileList)[texPath].push_back(make_pair(sourceLoader,sourceLoader));
 				}
-
-				texturesOwned[mtDiffuse]=true;
-				textures[mtDiffuse]->init(textureManager->getTextureFilter(),textureManager->getMaxAnisotropy());
-				if(deletePixMapAfterLoad == true) {
-					textures[mtDiffuse]->deletePixels();
-				}
 			}
 			else {
 				SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] Error v3 model is missing texture [%s] meshHeader.properties = %d meshIndex = %d modelFile [%s]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,texPath.c_str(),meshHeader.properties,meshIndex,modelFile.c_str());
@@ -726,23 +719,16 @@ Texture2D* Mesh::loadMeshTexture(int meshIndex, int textureIndex,
 			if(SystemFlags::VERBOSE_MODE_ENABLED) printf("In [%s] #3 load texture [%s] modelFile [%s]\n",__FUNCTION__,textureFile.c_str(),modelFile.c_str());
 			//if(SystemFlags::VERBOSE_MODE_ENABLED) printf("In [%s] texture exists loading [%s]\n",__FUNCTION__,textureFile.c_str());
 
-			texture = textureManager->newTexture2D();
-			if(textureChannelCount != -1) {
-				texture->getPixmap()->init(textureChannelCount);
-			}
-			texture->load(textureFile);
-			if(loadedFileList) {
+			// decodes on the texture manager's worker threads when enabled,
+			// the upload then waits for TextureManager::uploadDecodedTextures
+			texture = textureManager->loadTexture2D(textureFile,deletePixMapAfterLoad,
+					textureOwned,textureChannelCount);
+			if(textureOwned == true && loadedFileList) {
 				(*loadedFileList)[textureFile].push_back(make_pair(sourceLoader,sourceLoader));
 			}
 
 			//if(SystemFlags::VERBOSE_MODE_ENABLED) printf("In [%s] texture loaded [%s]\n",__FUNCTION__,textureFile.c_str());
 
-			textureOwned = true;
-			texture->init(textureManager->getTextureFilter(),textureManager->getMaxAnisotropy());
-			if(deletePixMapAfterLoad == true) {
-				texture->deletePixels();
-			}
-
 			//if(SystemFlags::VERBOSE_MODE_ENABLED) printf("In [%s] texture inited [%s]\n",__FUNCTION__,textureFile.c_str());
 		}
 		else {
@@ -1069,11 +1055,11 @@ void Mesh::computeTangents(){
 		}
 	}
 
-	for(unsigned int i=0; i<vertexCount; ++i){
-		/*Vec3f binormal= normals[i].cross(tangents[i]);
-		tangents[i]+= binormal.cross(normals[i]);*/
-		tangents[i].normalize();
-	}
+	/*for(unsigned int i=0; i<vertexCount; ++i){
+		Vec3f binormal= normals[i].cross(tangents[i]);
+		tangents[i]+= binormal.cross(normals[i]);
+	}*/
+	normalizeVec3fArray(tangents, vertexCount);
 }
 
 void Mesh::deletePixels() {
@@ -1438,12 +1424,14 @@ public:
 };
 
 void Mesh::setVertices(Vec3f *data, uint32 count) {
+	InterpolationCache::releaseSource(this->vertices);
 	delete [] this->vertices;
 	this->vertices = data;
 
 	this->vertexCount = count;
 }
 void Mesh::setNormals(Vec3f *data, uint32 count) {
+	InterpolationCache::releaseSource(this->normals);
 	delete [] this->normals;
 	this->normals = data;
 
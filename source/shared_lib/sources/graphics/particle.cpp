@@ -24,6 +24,7 @@
 #include "model.h"
 #include "texture.h"
 #include "platform_util.h"
+#include "simple_threads.h"
 #include "leak_dumper.h"
 
 using namespace std;
@@ -88,6 +89,167 @@ void Particle::loadGame(const XmlNode *rootNode) {
 	energy = particleNode->getAttribute("energy")->getIntValue();
 }
 
+// =====================================================
+//	class ParticlePool
+// =====================================================
+
+ParticlePool::ParticlePool(int capacity) {
+	this->capacity= 0;
+	resize(capacity);
+}
+
+void ParticlePool::resize(int capacity) {
+	this->capacity= max(capacity, 0);
+	values.assign(fCount * this->capacity, 0.0f);
+	energy.assign(this->capacity, 0);
+}
+
+void ParticlePool::getParticle(int i, Particle &particle) const {
+	particle.pos= getPos(i);
+	particle.lastPos= getLastPos(i);
+	particle.speed= Vec3f(values[fSpeedX * capacity + i], values[fSpeedY * capacity + i], values[fSpeedZ * capacity + i]);
+	particle.speedUpRelative= values[fSpeedUpRelative * capacity + i];
+	particle.speedUpConstant= Vec3f(values[fSpeedUpConstantX * capacity + i], values[fSpeedUpConstantY * capacity + i], values[fSpeedUpConstantZ * capacity + i]);
+	particle.accel= Vec3f(values[fAccelX * capacity + i], values[fAccelY * capacity + i], values[fAccelZ * capacity + i]);
+	particle.color= getColor(i);
+	particle.size= getSize(i);
+	particle.energy= energy[i];
+}
+
+void ParticlePool::setParticle(int i, const Particle &particle) {
+	values[fPosX * capacity + i]= particle.pos.x;
+	values[fPosY * capacity + i]= particle.pos.y;
+	values[fPosZ * capacity + i]= particle.pos.z;
+	values[fLastPosX * capacity + i]= particle.lastPos.x;
+	values[fLastPosY * capacity + i]= particle.lastPos.y;
+	values[fLastPosZ * capacity + i]= particle.lastPos.z;
+	values[fSpeedX * capacity + i]= particle.speed.x;
+	values[fSpeedY * capacity + i]= particle.speed.y;
+	values[fSpeedZ * capacity + i]= particle.speed.z;
+	values[fSpeedUpRelative * capacity + i]= particle.speedUpRelative;
+	values[fSpeedUpConstantX * capacity + i]= particle.speedUpConstant.x;
+	values[fSpeedUpConstantY * capacity + i]= particle.speedUpConstant.y;
+	values[fSpeedUpConstantZ * capacity + i]= particle.speedUpConstant.z;
+	values[fAccelX * capacity + i]= particle.accel.x;
+	values[fAccelY * capacity + i]= particle.accel.y;
+	values[fAccelZ * capacity + i]= particle.accel.z;
+	values[fColorR * capacity + i]= particle.color.x;
+	values[fColorG * capacity + i]= particle.color.y;
+	values[fColorB * capacity + i]= particle.color.z;
+	values[fColorA * capacity + i]= particle.color.w;
+	values[fSize * capacity + i]= particle.size;
+	energy[i]= particle.energy;
+}
+
+void ParticlePool::moveParticle(int from, int to) {
+	for(int field= 0; field < fCount; ++field) {
+		values[field * capacity + to]= values[field * capacity + from];
+	}
+	energy[to]= energy[from];
+}
+
+// =====================================================
+//	Particle update kernels
+//
+//	Each kernel runs one operation over a field range so
+//	the loops vectorize, the per particle order of the
+//	operations matches the former per particle updates
+// =====================================================
+
+static void copyParticleFields(ParticlePool &pool, ParticlePool::Field dest, ParticlePool::Field src, int fieldCount, int first, int last) {
+	for(int field= 0; field < fieldCount; ++field) {
+		float *d= pool.getField(static_cast<ParticlePool::Field>(dest + field));
+		const float *s= pool.getField(static_cast<ParticlePool::Field>(src + field));
+		for(int i= first; i < last; ++i) {
+			d[i]= s[i];
+		}
+	}
+}
+
+static void addParticleFields(ParticlePool &pool, ParticlePool::Field dest, ParticlePool::Field src, int fieldCount, int first, int last) {
+	for(int field= 0; field < fieldCount; ++field) {
+		float *d= pool.getField(static_cast<ParticlePool::Field>(dest + field));
+		const float *s= pool.getField(static_cast<ParticlePool::Field>(src + field));
+		for(int i= first; i < last; ++i) {
+			d[i]= d[i] + s[i];
+		}
+	}
+}
+
+static void addParticleVector(ParticlePool &pool, ParticlePool::Field dest, const Vec3f &value, int first, int last) {
+	for(int field= 0; field < 3; ++field) {
+		float *d= pool.getField(static_cast<ParticlePool::Field>(dest + field));
+		const float v= value.ptr()[field];
+		for(int i= first; i < last; ++i) {
+			d[i]= d[i] + v;
+		}
+	}
+}
+
+// dest*= (1 + speedUpRelative)
+static void speedUpParticleFields(ParticlePool &pool, ParticlePool::Field dest, int first, int last) {
+	const float *speedUpRelative= pool.getField(ParticlePool::fSpeedUpRelative);
+	for(int field= 0; field < 3; ++field) {
+		float *d= pool.getField(static_cast<ParticlePool::Field>(dest + field));
+		for(int i= first; i < last; ++i) {
+			d[i]= d[i] * (1 + speedUpRelative[i]);
+		}
+	}
+}
+
+static void truncateParticleFields(ParticlePool &pool, ParticlePool::Field dest, int fieldCount, int first, int last) {
+	for(int field= 0; field < fieldCount; ++field) {
+		float *d= pool.getField(static_cast<ParticlePool::Field>(dest + field));
+		for(int i= first; i < last; ++i) {
+			d[i]= truncateDecimal<float>(d[i],6);
+		}
+	}
+}
+
+static void decayParticleEnergy(ParticlePool &pool, int first, int last) {
+	int *energy= pool.getEnergyField();
+	for(int i= first; i < last; ++i) {
+		energy[i]--;
+	}
+}
+
+// energy ratio clamped to [0, 1] of every particle into the scratch field
+static void computeParticleEnergyRatio(ParticlePool &pool, int maxParticleEnergy, bool truncate, int first, int last) {
+	const int *energy= pool.getEnergyField();
+	float *energyRatio= pool.getField(ParticlePool::fEnergyRatio);
+	const float maxEnergy= static_cast<float>(maxParticleEnergy);
+	for(int i= first; i < last; ++i) {
+		energyRatio[i]= clamp(static_cast<float>(energy[i]) / maxEnergy, 0.f, 1.f);
+	}
+	if(truncate == true) {
+		truncateParticleFields(pool, ParticlePool::fEnergyRatio, 1, first, last);
+	}
+}
+
+// color and size fade from the energy to the no energy values
+static void lerpParticleColorAndSize(ParticlePool &pool, const Vec4f &color, const Vec4f &colorNoEnergy,
+		float size, float sizeNoEnergy, int first, int last) {
+	const float *energyRatio= pool.getField(ParticlePool::fEnergyRatio);
+	for(int field= 0; field < 4; ++field) {
+		float *d= pool.getField(static_cast<ParticlePool::Field>(ParticlePool::fColorR + field));
+		const float c= color.ptr()[field];
+		const float n= colorNoEnergy.ptr()[field];
+		for(int i= first; i < last; ++i) {
+			d[i]= c * energyRatio[i] + n * (1.0f - energyRatio[i]);
+		}
+	}
+
+	float *d= pool.getField(ParticlePool::fSize);
+	for(int i= first; i < last; ++i) {
+		d[i]= size * energyRatio[i] + sizeNoEnergy * (1.0f - energyRatio[i]);
+	}
+	truncateParticleFields(pool, ParticlePool::fSize, 1, first, last);
+}
+
+// =====================================================
+//	class ParticleSystem
+// =====================================================
+
 ParticleSystem::ParticleSystem(int particleCount) {
 	if(checkMemory) {
 		printf("++ Create ParticleSystem [%p]\n",this);
@@ -101,13 +263,11 @@ ParticleSystem::ParticleSystem(int particleCount) {
 
 	//init particle vector
 	blendMode= bmOne;
-	//particles= new Particle[particleCount];
-	particles.clear();
-	//particles.reserve(particleCount);
 	particles.resize(particleCount);
 
 	state= sPlay;
 	aliveParticleCount= 0;
+	recycleParticleIndex= 0;
 	active= true;
 	visible= true;
 
@@ -136,6 +296,12 @@ ParticleSystem::ParticleSystem(int particleCount) {
 
 	this->particleOwner = NULL;
 	this->particleSize = 0.0f;
+
+	deferParticleUpdate= false;
+	particleUpdatePending= false;
+	pendingEmissionCount= 0;
+	managerIndex= -1;
+	pendingUpdateIndex= -1;
 }
 
 ParticleSystem::~ParticleSystem() {
@@ -145,9 +311,6 @@ ParticleSystem::~ParticleSystem() {
 		assert(memoryObjectList[this] == 0);
 	}
 
-	//delete [] particles;
-	particles.clear();
-
 	delete particleObserver;
 	particleObserver = NULL;
 }
@@ -199,39 +362,45 @@ Checksum ParticleSystem::getCRC() {
 
 //updates all living particles and creates new ones
 void ParticleSystem::update() {
-	if(aliveParticleCount > (int) particles.size()) {
-		throw megaglest_runtime_error("aliveParticleCount >= particles.size()");
+	if(aliveParticleCount > particles.getCapacity()) {
+		throw megaglest_runtime_error("aliveParticleCount >= particles.getCapacity()");
 	}
+	updatePendingParticles();
+
     if(particleSystemStartDelay > 0) {
     	particleSystemStartDelay--;
     }
     else if(state != sPause) {
-		for(int i= 0; i < aliveParticleCount; ++i) {
-			updateParticle(&particles[i]);
-
-			if(deathTest(&particles[i])) {
-
-				//kill the particle
-				killParticle(&particles[i]);
-
-				//maintain alive particles at front of the array
-				if(aliveParticleCount > 0) {
-					particles[i]= particles[aliveParticleCount];
-				}
-			}
-		}
-
+		pendingEmissionCount= 0;
 		if(state != ParticleSystem::sFade) {
 			emissionState= emissionState + emissionRate;
 			int emissionIntValue= (int) emissionState;
-			for(int i= 0; i < emissionIntValue; i++){
-				Particle *p= createParticle();
-				initParticle(p, i);
-			}
+			pendingEmissionCount= emissionIntValue;
 			emissionState = emissionState - (float) emissionIntValue;
 			emissionState = truncateDecimal<float>(emissionState,6);
 		}
+
+		particleUpdatePending= true;
+		if(deferParticleUpdate == false) {
+			updatePendingParticles();
+		}
+	}
+}
+
+// only touches this system, so systems may run this in parallel
+void ParticleSystem::updatePendingParticles() {
+	if(particleUpdatePending == false) {
+		return;
+	}
+	particleUpdatePending= false;
+
+	updateParticles(0, aliveParticleCount);
+	killParticles();
+
+	for(int i= 0; i < pendingEmissionCount; i++){
+		emitParticle(i);
 	}
+	pendingEmissionCount= 0;
 }
 
 void ParticleSystem::render(ParticleRenderer *pr, ModelRenderer *mr){
@@ -335,7 +504,7 @@ void ParticleSystem::setVisible(bool visible){
 string ParticleSystem::toString() const {
 	string result = "ParticleSystem ";
 
-	result += "particles = " + intToStr(particles.size());
+	result += "particles = " + intToStr(particles.getCapacity());
 
 //	for(unsigned int i = 0; i < particles.size(); ++i) {
 //		Particle &particle = particles[i];
@@ -470,8 +639,8 @@ void ParticleSystem::loadGame(const XmlNode *rootNode) {
 //		particle.saveGame(particleSystemNode);
 //	}
 
-	particles.clear();
 	particles.resize(particleCount);
+	recycleParticleIndex= 0;
 
 //	vector<XmlNode *> particleNodeList = particleSystemNode->getChildList("Particle");
 //	for(unsigned int i = 0; i < particleNodeList.size(); ++i) {
@@ -581,27 +750,31 @@ int ParticleSystem::isEmpty() const {
 
 // =============== PROTECTED =========================
 
-// if there is one dead particle it returns it else, return the particle with 
-// less energy
-Particle * ParticleSystem::createParticle() {
+// alive particles are kept at the front of the pool so the first dead one is
+// the free slot, if all are alive the slots are recycled round robin
+int ParticleSystem::createParticle() {
 
 	//if any dead particles
 	if(aliveParticleCount < particleCount) {
 		++aliveParticleCount;
-		return &particles[aliveParticleCount - 1];
+		return aliveParticleCount - 1;
 	}
 
 	//if not
-	int minEnergy= particles[0].energy;
-	int minEnergyParticle= 0;
+	int index= recycleParticleIndex;
+	recycleParticleIndex= (recycleParticleIndex + 1) % particleCount;
+	return index;
+}
 
-	for(int i= 0; i < particleCount; ++i){
-		if(particles[i].energy < minEnergy){
-			minEnergy= particles[i].energy;
-			minEnergyParticle= i;
-		}
-	}
-	return &particles[minEnergyParticle];
+int ParticleSystem::emitParticle(int particleIndex) {
+	int index= createParticle();
+
+	Particle particle;
+	particles.getParticle(index, particle);
+	initParticle(&particle, particleIndex);
+	particles.setParticle(index, particle);
+
+	return index;
 }
 
 void ParticleSystem::initParticle(Particle *p, int particleIndex) {
@@ -615,19 +788,25 @@ void ParticleSystem::initParticle(Particle *p, int particleIndex) {
 	p->energy= maxParticleEnergy + random.randRange(-varParticleEnergy, varParticleEnergy);
 }
 
-void ParticleSystem::updateParticle(Particle *p) {
-	p->lastPos= p->pos;
-	p->pos= p->pos + p->speed;
-	p->speed= p->speed + p->accel;
-	p->energy--;
-}
-
-bool ParticleSystem::deathTest(Particle *p) {
-	return p->energy <= 0;
+void ParticleSystem::updateParticles(int first, int last) {
+	copyParticleFields(particles, ParticlePool::fLastPosX, ParticlePool::fPosX, 3, first, last);
+	addParticleFields(particles, ParticlePool::fPosX, ParticlePool::fSpeedX, 3, first, last);
+	addParticleFields(particles, ParticlePool::fSpeedX, ParticlePool::fAccelX, 3, first, last);
+	decayParticleEnergy(particles, first, last);
 }
 
-void ParticleSystem::killParticle(Particle *p) {
-	aliveParticleCount--;
+void ParticleSystem::killParticles() {
+	const int *energy= particles.getEnergyField();
+	for(int i= 0; i < aliveParticleCount;) {
+		if(energy[i] <= 0) {
+			//maintain alive particles at front of the pool
+			aliveParticleCount--;
+			particles.moveParticle(aliveParticleCount, i);
+		}
+		else {
+			++i;
+		}
+	}
 }
 
 void ParticleSystem::setFactionColor(Vec3f factionColor){
@@ -697,23 +876,24 @@ void FireParticleSystem::initParticle(Particle *p, int particleIndex){
 
 }
 
-void FireParticleSystem::updateParticle(Particle *p){
-	p->lastPos= p->pos;
-	p->pos= p->pos + p->speed;
-	p->energy--;
-
-	if(p->color.x > 0.0f)
-		p->color.x*= 0.98f;
-	if(p->color.y > 0.0f)
-		p->color.y*= 0.98f;
-	if(p->color.w > 0.0f)
-		p->color.w*= 0.98f;
+void FireParticleSystem::updateParticles(int first, int last){
+	copyParticleFields(particles, ParticlePool::fLastPosX, ParticlePool::fPosX, 3, first, last);
+	addParticleFields(particles, ParticlePool::fPosX, ParticlePool::fSpeedX, 3, first, last);
+	decayParticleEnergy(particles, first, last);
 
-	p->speed.x*= 1.001f;
-	p->speed.x = truncateDecimal<float>(p->speed.x,6);
-	p->speed.y = truncateDecimal<float>(p->speed.y,6);
-	p->speed.z = truncateDecimal<float>(p->speed.z,6);
+	const ParticlePool::Field fadeFields[]= { ParticlePool::fColorR, ParticlePool::fColorG, ParticlePool::fColorA };
+	for(int field= 0; field < 3; ++field) {
+		float *color= particles.getField(fadeFields[field]);
+		for(int i= first; i < last; ++i) {
+			color[i]= (color[i] > 0.0f ? color[i] * 0.98f : color[i]);
+		}
+	}
 
+	float *speedX= particles.getField(ParticlePool::fSpeedX);
+	for(int i= first; i < last; ++i) {
+		speedX[i]*= 1.001f;
+	}
+	truncateParticleFields(particles, ParticlePool::fSpeedX, 3, first, last);
 }
 
 string FireParticleSystem::toString() const {
@@ -1265,80 +1445,77 @@ void UnitParticleSystem::update(){
 	ParticleSystem::update();
 }
 
-void UnitParticleSystem::updateParticle(Particle *p){
-	float energyRatio;
+void UnitParticleSystem::updateParticles(int first, int last){
 	if(alternations > 0){
+		const int *energy= particles.getEnergyField();
+		float *energyRatio= particles.getField(ParticlePool::fEnergyRatio);
 		int interval= (maxParticleEnergy / alternations);
-		float moduloValue= (float)((int)(static_cast<float> (p->energy)) % interval);
 		float floatInterval=static_cast<float> (interval);
 
-		if(moduloValue < floatInterval / 2.0f){
-			energyRatio= (floatInterval - moduloValue) / floatInterval;
-		}
-		else{
-			energyRatio= moduloValue / floatInterval;
+		for(int i= first; i < last; ++i) {
+			float moduloValue= (float)((int)(static_cast<float> (energy[i])) % interval);
+
+			if(moduloValue < floatInterval / 2.0f){
+				energyRatio[i]= (floatInterval - moduloValue) / floatInterval;
+			}
+			else{
+				energyRatio[i]= moduloValue / floatInterval;
+			}
+			energyRatio[i]= clamp(energyRatio[i], 0.f, 1.f);
 		}
-		energyRatio= clamp(energyRatio, 0.f, 1.f);
+		truncateParticleFields(particles, ParticlePool::fEnergyRatio, 1, first, last);
 	}
 	else{
-		energyRatio= clamp(static_cast<float> (p->energy) / static_cast<float> (maxParticleEnergy), 0.f, 1.f);
+		computeParticleEnergyRatio(particles, maxParticleEnergy, true, first, last);
 	}
 
-	energyRatio = truncateDecimal<float>(energyRatio,6);
+	addParticleFields(particles, ParticlePool::fLastPosX, ParticlePool::fSpeedX, 3, first, last);
+	truncateParticleFields(particles, ParticlePool::fLastPosX, 3, first, last);
 
-	p->lastPos += p->speed;
-	p->lastPos.x = truncateDecimal<float>(p->lastPos.x,6);
-	p->lastPos.y = truncateDecimal<float>(p->lastPos.y,6);
-	p->lastPos.z = truncateDecimal<float>(p->lastPos.z,6);
-
-	p->pos += p->speed;
-	p->pos.x = truncateDecimal<float>(p->pos.x,6);
-	p->pos.y = truncateDecimal<float>(p->pos.y,6);
-	p->pos.z = truncateDecimal<float>(p->pos.z,6);
+	addParticleFields(particles, ParticlePool::fPosX, ParticlePool::fSpeedX, 3, first, last);
+	truncateParticleFields(particles, ParticlePool::fPosX, 3, first, last);
 
 	if(fixed) {
-		p->lastPos += fixedAddition;
-		p->lastPos.x = truncateDecimal<float>(p->lastPos.x,6);
-		p->lastPos.y = truncateDecimal<float>(p->lastPos.y,6);
-		p->lastPos.z = truncateDecimal<float>(p->lastPos.z,6);
+		addParticleVector(particles, ParticlePool::fLastPosX, fixedAddition, first, last);
+		truncateParticleFields(particles, ParticlePool::fLastPosX, 3, first, last);
 
-		p->pos += fixedAddition;
-		p->pos.x = truncateDecimal<float>(p->pos.x,6);
-		p->pos.y = truncateDecimal<float>(p->pos.y,6);
-		p->pos.z = truncateDecimal<float>(p->pos.z,6);
+		addParticleVector(particles, ParticlePool::fPosX, fixedAddition, first, last);
+		truncateParticleFields(particles, ParticlePool::fPosX, 3, first, last);
 	}
-	p->speed += p->accel;
-	p->speed += p->speedUpConstant;
-	p->speed=p->speed*(1+p->speedUpRelative);
-	p->speed.x = truncateDecimal<float>(p->speed.x,6);
-	p->speed.y = truncateDecimal<float>(p->speed.y,6);
-	p->speed.z = truncateDecimal<float>(p->speed.z,6);
+	addParticleFields(particles, ParticlePool::fSpeedX, ParticlePool::fAccelX, 3, first, last);
+	addParticleFields(particles, ParticlePool::fSpeedX, ParticlePool::fSpeedUpConstantX, 3, first, last);
+	speedUpParticleFields(particles, ParticlePool::fSpeedX, first, last);
+	truncateParticleFields(particles, ParticlePool::fSpeedX, 3, first, last);
 
-	p->color= color * energyRatio + colorNoEnergy * (1.0f - energyRatio);
+	lerpParticleColorAndSize(particles, color, colorNoEnergy, particleSize, sizeNoEnergy, first, last);
 	if(isDaylightAffected==true) {
-		p->color.x=p->color.x*lightColor.x;
-		p->color.y=p->color.y*lightColor.y;
-		p->color.z=p->color.z*lightColor.z;
+		for(int field= 0; field < 3; ++field) {
+			float *d= particles.getField(static_cast<ParticlePool::Field>(ParticlePool::fColorR + field));
+			const float light= lightColor.ptr()[field];
+			for(int i= first; i < last; ++i) {
+				d[i]= d[i] * light;
+			}
+		}
 	}
-	p->size= particleSize * energyRatio + sizeNoEnergy * (1.0f - energyRatio);
-	p->size = truncateDecimal<float>(p->size,6);
 
 	if(state == ParticleSystem::sFade || staticParticleCount < 1){
-		p->energy--;
+		decayParticleEnergy(particles, first, last);
 	}
-	else{
-		if(maxParticleEnergy > 2){
+	else if(maxParticleEnergy > 2){
+		// the direction flips while walking the particles so this stays serial
+		int *energy= particles.getEnergyField();
+		for(int i= first; i < last; ++i) {
 			if(energyUp){
-				p->energy++;
+				energy[i]++;
 			}
 			else{
-				p->energy--;
+				energy[i]--;
 			}
 
-			if(p->energy == 1){
+			if(energy[i] == 1){
 				energyUp= true;
 			}
-			if(p->energy == maxParticleEnergy){
+			if(energy[i] == maxParticleEnergy){
 				energyUp= false;
 			}
 		}
@@ -1588,8 +1765,17 @@ void RainParticleSystem::initParticle(Particle *p, int particleIndex){
 	p->speed.z = truncateDecimal<float>(p->speed.z,6);
 }
 
-bool RainParticleSystem::deathTest(Particle *p){
-	return p->pos.y < 0;
+void RainParticleSystem::killParticles(){
+	const float *posY= particles.getField(ParticlePool::fPosY);
+	for(int i= 0; i < aliveParticleCount;) {
+		if(posY[i] < 0) {
+			aliveParticleCount--;
+			particles.moveParticle(aliveParticleCount, i);
+		}
+		else {
+			++i;
+		}
+	}
 }
 
 void RainParticleSystem::setRadius(float radius) {
@@ -1667,8 +1853,17 @@ void SnowParticleSystem::initParticle(Particle *p, int particleIndex){
 	p->speed.z = truncateDecimal<float>(p->speed.z,6);
 }
 
-bool SnowParticleSystem::deathTest(Particle *p){
-	return p->pos.y < 0;
+void SnowParticleSystem::killParticles(){
+	const float *posY= particles.getField(ParticlePool::fPosY);
+	for(int i= 0; i < aliveParticleCount;) {
+		if(posY[i] < 0) {
+			aliveParticleCount--;
+			particles.moveParticle(aliveParticleCount, i);
+		}
+		else {
+			++i;
+		}
+	}
 }
 
 void SnowParticleSystem::setRadius(float radius){
@@ -1946,33 +2141,30 @@ void ProjectileParticleSystem::initParticle(Particle *p, int particleIndex){
 	p->accel.x = truncateDecimal<float>(p->accel.x,6);
 	p->accel.y = truncateDecimal<float>(p->accel.y,6);
 	p->accel.z = truncateDecimal<float>(p->accel.z,6);
+}
+
+int ProjectileParticleSystem::emitParticle(int particleIndex){
+	int index= ParticleSystem::emitParticle(particleIndex);
 
-	updateParticle(p);
+	//new particles start one step along their path
+	updateParticles(index, index + 1);
+	return index;
 }
 
-void ProjectileParticleSystem::updateParticle(Particle *p){
-	float energyRatio= clamp(static_cast<float> (p->energy) / maxParticleEnergy, 0.f, 1.f);
-	energyRatio = truncateDecimal<float>(energyRatio,6);
+void ProjectileParticleSystem::updateParticles(int first, int last){
+	computeParticleEnergyRatio(particles, maxParticleEnergy, true, first, last);
 
-	p->lastPos += p->speed;
-	p->lastPos.x = truncateDecimal<float>(p->lastPos.x,6);
-	p->lastPos.y = truncateDecimal<float>(p->lastPos.y,6);
-	p->lastPos.z = truncateDecimal<float>(p->lastPos.z,6);
+	addParticleFields(particles, ParticlePool::fLastPosX, ParticlePool::fSpeedX, 3, first, last);
+	truncateParticleFields(particles, ParticlePool::fLastPosX, 3, first, last);
 
-	p->pos += p->speed;
-	p->pos.x = truncateDecimal<float>(p->pos.x,6);
-	p->pos.y = truncateDecimal<float>(p->pos.y,6);
-	p->pos.z = truncateDecimal<float>(p->pos.z,6);
+	addParticleFields(particles, ParticlePool::fPosX, ParticlePool::fSpeedX, 3, first, last);
+	truncateParticleFields(particles, ParticlePool::fPosX, 3, first, last);
 
-	p->speed += p->accel;
-	p->speed.x = truncateDecimal<float>(p->speed.x,6);
-	p->speed.y = truncateDecimal<float>(p->speed.y,6);
-	p->speed.z = truncateDecimal<float>(p->speed.z,6);
+	addParticleFields(particles, ParticlePool::fSpeedX, ParticlePool::fAccelX, 3, first, last);
+	truncateParticleFields(particles, ParticlePool::fSpeedX, 3, first, last);
 
-	p->color= color * energyRatio + colorNoEnergy * (1.0f - energyRatio);
-	p->size = particleSize * energyRatio + sizeNoEnergy * (1.0f - energyRatio);
-	p->size = truncateDecimal<float>(p->size,6);
-	p->energy--;
+	lerpParticleColorAndSize(particles, color, colorNoEnergy, particleSize, sizeNoEnergy, first, last);
+	decayParticleEnergy(particles, first, last);
 }
 
 void ProjectileParticleSystem::setPath(Vec3f startPos, Vec3f endPos) {
@@ -2270,26 +2462,20 @@ void SplashParticleSystem::initParticle(Particle *p, int particleIndex){
 	p->speedUpConstant= Vec3f(speedUpConstant)*p->speed;
 }
 
-void SplashParticleSystem::updateParticle(Particle *p){
-	float energyRatio= clamp(static_cast<float> (p->energy) / maxParticleEnergy, 0.f, 1.f);
+void SplashParticleSystem::updateParticles(int first, int last){
+	computeParticleEnergyRatio(particles, maxParticleEnergy, false, first, last);
 
-	p->lastPos= p->pos;
-	p->pos= p->pos + p->speed;
-	p->pos.x = truncateDecimal<float>(p->pos.x,6);
-	p->pos.y = truncateDecimal<float>(p->pos.y,6);
-	p->pos.z = truncateDecimal<float>(p->pos.z,6);
+	copyParticleFields(particles, ParticlePool::fLastPosX, ParticlePool::fPosX, 3, first, last);
+	addParticleFields(particles, ParticlePool::fPosX, ParticlePool::fSpeedX, 3, first, last);
+	truncateParticleFields(particles, ParticlePool::fPosX, 3, first, last);
 
-	p->speed += p->speedUpConstant;
-	p->speed=p->speed*(1+p->speedUpRelative);
-	p->speed= p->speed + p->accel;
-	p->speed.x = truncateDecimal<float>(p->speed.x,6);
-	p->speed.y = truncateDecimal<float>(p->speed.y,6);
-	p->speed.z = truncateDecimal<float>(p->speed.z,6);
+	addParticleFields(particles, ParticlePool::fSpeedX, ParticlePool::fSpeedUpConstantX, 3, first, last);
+	speedUpParticleFields(particles, ParticlePool::fSpeedX, first, last);
+	addParticleFields(particles, ParticlePool::fSpeedX, ParticlePool::fAccelX, 3, first, last);
+	truncateParticleFields(particles, ParticlePool::fSpeedX, 3, first, last);
 
-	p->energy--;
-	p->color= color * energyRatio + colorNoEnergy * (1.0f - energyRatio);
-	p->size= particleSize * energyRatio + sizeNoEnergy * (1.0f - energyRatio);
-	p->size = truncateDecimal<float>(p->size,6);
+	decayParticleEnergy(particles, first, last);
+	lerpParticleColorAndSize(particles, color, colorNoEnergy, particleSize, sizeNoEnergy, first, last);
 }
 
 void SplashParticleSystem::saveGame(XmlNode *rootNode) {
@@ -2373,15 +2559,63 @@ string SplashParticleSystem::toString() const {
 	return result;
 }
 
+// ===========================================================================
+//  ParticleUpdateTask
+// ===========================================================================
+
+class ParticleUpdateTask : public WorkerThreadTask {
+public:
+	ParticleSystem * const *systems;
+	int count;
+
+	ParticleUpdateTask(ParticleSystem * const *systems, int count) :
+		systems(systems), count(count) {
+	}
+
+	virtual void executeTask(BaseThread *callingThread) {
+		for(int i= 0; i < count; ++i) {
+			systems[i]->updatePendingParticles();
+		}
+	}
+};
+
 // ===========================================================================
 //  ParticleManager
 // ===========================================================================
 
 ParticleManager::ParticleManager() {
+	updatePool= NULL;
 }
 
 ParticleManager::~ParticleManager() {
 	end();
+
+	delete updatePool;
+	updatePool= NULL;
+}
+
+void ParticleManager::setUpdateThreadCount(int threadCount) {
+	if(getUpdateThreadCount() == threadCount) {
+		return;
+	}
+	delete updatePool;
+	updatePool= NULL;
+	if(threadCount > 0) {
+		updatePool= new WorkerThreadPool("ParticleUpdate",threadCount);
+	}
+}
+
+int ParticleManager::getUpdateThreadCount() const {
+	return (updatePool != NULL ? updatePool->getThreadCount() : 0);
+}
+
+// unit and fire systems are only updated while visible or fading out
+bool ParticleManager::isUpdateSkipped(const ParticleSystem *ps) const {
+	ParticleSystem::ParticleSystemType type= ps->getParticleSystemType();
+	if(type == ParticleSystem::pst_UnitParticleSystem || type == ParticleSystem::pst_FireParticleSystem) {
+		return (ps->getVisible() == false && ps->getState() != ParticleSystem::sFade);
+	}
+	return false;
 }
 
 void ParticleManager::render(ParticleRenderer *pr, ModelRenderer *mr) const{
@@ -2396,28 +2630,12 @@ void ParticleManager::render(ParticleRenderer *pr, ModelRenderer *mr) const{
 bool ParticleManager::hasActiveParticleSystem(ParticleSystem::ParticleSystemType type) const{
 	bool result= false;
 
-	//size_t particleSystemCount= particleSystems.size();
-	//int currentParticleCount= 0;
-
-	//vector<ParticleSystem *> cleanupParticleSystemsList;
 	for(unsigned int i= 0; i < particleSystems.size(); i++){
 		ParticleSystem *ps= particleSystems[i];
-		if(ps != NULL){
-			//currentParticleCount+= ps->getAliveParticleCount();
-
-			bool showParticle= true;
-			if(dynamic_cast<UnitParticleSystem *> (ps) != NULL ||
-			   dynamic_cast<FireParticleSystem *> (ps) != NULL) {
-				showParticle= ps->getVisible() || (ps->getState() == ParticleSystem::sFade);
-			}
-			if(showParticle == true){
-				//printf("Looking for [%d] current id [%d] i = %d\n",type,ps->getParticleSystemType(),i);
-
-				if(type == ParticleSystem::pst_All || type == ps->getParticleSystemType()){
-					//printf("FOUND particle system type match for [%d] current id [%d] i = %d\n",type,ps->getParticleSystemType(),i);
-					result= true;
-					break;
-				}
+		if(ps != NULL && isUpdateSkipped(ps) == false){
+			if(type == ParticleSystem::pst_All || type == ps->getParticleSystemType()){
+				result= true;
+				break;
 			}
 		}
 	}
@@ -2432,35 +2650,88 @@ void ParticleManager::update(int renderFps){
 	size_t particleSystemCount= particleSystems.size();
 	int currentParticleCount= 0;
 
-	vector<ParticleSystem *> cleanupParticleSystemsList;
+	// system logic, and with it every observer callback, runs here in list
+	// order, the particle work it leaves pending is done afterwards
+	vector<ParticleSystem *> updatedParticleSystems;
 	for(unsigned int i= 0; i < particleSystems.size(); i++){
 		ParticleSystem *ps= particleSystems[i];
 		if(ps != NULL) {
 			currentParticleCount+= ps->getAliveParticleCount();
 
-			bool showParticle= true;
-			if( dynamic_cast<UnitParticleSystem *> (ps) != NULL ||
-				dynamic_cast<FireParticleSystem *> (ps) != NULL) {
-				showParticle = ps->getVisible() || (ps->getState() == ParticleSystem::sFade);
-			}
-			if(showParticle == true){
+			if(isUpdateSkipped(ps) == false){
 				ps->update();
-				if(ps->isEmpty() && ps->getState() == ParticleSystem::sFade) {
-					cleanupParticleSystemsList.push_back(ps);
+				if(ps->particleUpdatePending == true && ps->pendingUpdateIndex < 0) {
+					ps->pendingUpdateIndex= (int)pendingUpdates.size();
+					pendingUpdates.push_back(ps);
 				}
+				updatedParticleSystems.push_back(ps);
 			}
 		}
 	}
-	//particleSystems.remove(NULL);
+	updatePendingParticles();
+
+	vector<ParticleSystem *> cleanupParticleSystemsList;
+	for(unsigned int i= 0; i < updatedParticleSystems.size(); i++){
+		ParticleSystem *ps= updatedParticleSystems[i];
+		// an observer may have removed systems updated before it
+		if(validateParticleSystemStillExists(ps) == true &&
+			ps->isEmpty() && ps->getState() == ParticleSystem::sFade) {
+			cleanupParticleSystemsList.push_back(ps);
+		}
+	}
 	cleanupParticleSystems(cleanupParticleSystemsList);
 
 	if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0)
-		SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld, particleSystemCount = %d, currentParticleCount = %d\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis(),particleSystemCount,currentParticleCount);
+		SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took usecs: %lld, particleSystemCount = %d, currentParticleCount = %d\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMicros(),particleSystemCount,currentParticleCount);
+}
+
+void ParticleManager::updatePendingParticles() {
+	vector<ParticleSystem *> systems;
+	for(unsigned int i= 0; i < pendingUpdates.size(); i++){
+		ParticleSystem *ps= pendingUpdates[i];
+		if(ps != NULL) {
+			ps->pendingUpdateIndex= -1;
+			systems.push_back(ps);
+		}
+	}
+	pendingUpdates.clear();
+
+	if(updatePool != NULL && systems.size() > 1) {
+		// a few chunks per thread so one heavy system does not stall the rest
+		const int taskCount= min((int)systems.size(), updatePool->getThreadCount() * 4);
+		const int chunkSize= ((int)systems.size() + taskCount - 1) / taskCount;
+
+		vector<ParticleUpdateTask *> tasks;
+		for(int first= 0; first < (int)systems.size(); first+= chunkSize) {
+			int count= min(chunkSize, (int)systems.size() - first);
+			tasks.push_back(new ParticleUpdateTask(&systems[first], count));
+			updatePool->queueTask(tasks.back());
+		}
+		updatePool->waitForAllTasks();
+		updatePool->popCompletedTasks();
+
+		string errorMessage;
+		for(unsigned int i= 0; i < tasks.size(); i++){
+			if(tasks[i]->hasError() == true && errorMessage == "") {
+				errorMessage= tasks[i]->getErrorMessage();
+			}
+			delete tasks[i];
+		}
+		if(errorMessage != "") {
+			throw megaglest_runtime_error(errorMessage);
+		}
+	}
+	else {
+		for(unsigned int i= 0; i < systems.size(); i++){
+			systems[i]->updatePendingParticles();
+		}
+	}
 }
 
 bool ParticleManager::validateParticleSystemStillExists(ParticleSystem * particleSystem) const{
-	int index= findParticleSystems(particleSystem, this->particleSystems);
-	return (index >= 0);
+	// the pointer may be stale so it is only looked up, never dereferenced
+	return (particleSystem != NULL &&
+			particleSystemLookup.find(particleSystem) != particleSystemLookup.end());
 }
 
 void ParticleManager::removeParticleSystemsForParticleOwner(ParticleOwner *particleOwner) {
@@ -2480,6 +2751,10 @@ void ParticleManager::removeParticleSystemsForParticleOwner(ParticleOwner *parti
 }
 
 int ParticleManager::findParticleSystems(ParticleSystem *psFind, const vector<ParticleSystem *> &particleSystems) const{
+	if(&particleSystems == &this->particleSystems) {
+		return (validateParticleSystemStillExists(psFind) == true ? psFind->managerIndex : -1);
+	}
+
 	int result= -1;
 	for(unsigned int i= 0; i < particleSystems.size(); i++){
 		ParticleSystem *ps= particleSystems[i];
@@ -2491,28 +2766,33 @@ int ParticleManager::findParticleSystems(ParticleSystem *psFind, const vector<Pa
 	return result;
 }
 
-void ParticleManager::cleanupParticleSystems(ParticleSystem *ps) {
-
-	int index= findParticleSystems(ps, this->particleSystems);
-	if(ps != NULL && index >= 0) {
-//		printf("-- Delete cleanupParticleSystems [%p]\n",ps);
-//		static map<void *,int> deleteList;
-//		if(deleteList.find(ps) != deleteList.end()) {
-//			assert(deleteList.find(ps) == deleteList.end());
-//		}
-//		deleteList[ps]++;
+void ParticleManager::eraseParticleSystem(ParticleSystem *ps) {
+	int index= ps->managerIndex;
+	if(index >= 0 && index < (int)particleSystems.size() && particleSystems[index] == ps) {
+		particleSystems.erase(particleSystems.begin() + index);
+		for(unsigned int i= index; i < particleSystems.size(); i++){
+			particleSystems[i]->managerIndex= i;
+		}
+	}
+	if(ps->pendingUpdateIndex >= 0) {
+		pendingUpdates[ps->pendingUpdateIndex]= NULL;
+		ps->pendingUpdateIndex= -1;
+	}
+	particleSystemLookup.erase(ps);
+	ps->managerIndex= -1;
+}
 
+void ParticleManager::cleanupParticleSystems(ParticleSystem *ps) {
+	if(validateParticleSystemStillExists(ps) == true) {
 		// This code causes segfault on game end, no need to fade, just delete
 		//if(ps->getState() != ParticleSystem::sFade) {
 		//	ps->fade();
 		//}
 
-		if(ps != NULL) {
-			ps->callParticleOwnerEnd(ps);
-		}
+		ps->callParticleOwnerEnd(ps);
 
+		eraseParticleSystem(ps);
 		delete ps;
-		this->particleSystems.erase(this->particleSystems.begin() + index);
 	}
 }
 
@@ -2538,8 +2818,11 @@ void ParticleManager::cleanupUnitParticleSystems(vector<UnitParticleSystem *> &c
 }
 
 void ParticleManager::manage(ParticleSystem *ps){
-	assert((std::find(particleSystems.begin(),particleSystems.end(),ps) == particleSystems.end()) && "particle cannot be added twice");
+	assert(validateParticleSystemStillExists(ps) == false && "particle cannot be added twice");
+	ps->managerIndex= (int)particleSystems.size();
+	ps->deferParticleUpdate= true;
 	particleSystems.push_back(ps);
+	particleSystemLookup.insert(ps);
 	for(int i = ps->getChildCount() - 1; i >= 0; i--) {
 		manage(ps->getChild(i));
 	}
@@ -2549,19 +2832,15 @@ void ParticleManager::end(){
 	while(particleSystems.empty() == false){
 		ParticleSystem *ps = particleSystems.back();
 
-//		printf("-- Delete end() [%p]\n",ps);
-//		static map<void *,int> deleteList;
-//		if(deleteList.find(ps) != deleteList.end()) {
-//			assert(deleteList.find(ps) == deleteList.end());
-//		}
-//		deleteList[ps]++;
-
 		if(ps != NULL) {
 			ps->callParticleOwnerEnd(ps);
 		}
+		particleSystemLookup.erase(ps);
 		delete ps;
 		particleSystems.pop_back();
 	}
+	particleSystemLookup.clear();
+	pendingUpdates.clear();
 }
 
 }
@@ -1313,23 +1313,21 @@ void Pixmap2D::splat(const Pixmap2D *leftUp, const Pixmap2D *rightUp, const Pixm
 		throw megaglest_runtime_error("Pixmap2D::splat: pixmap dimensions don't agree");
 	}
 
+	// the distances are squared, x * x gives the same result as std::pow(x, 2)
+	const float avgDist= (w+h)/2.f;
+	const float avg= avgDist * avgDist;
+
 	for(int i=0; i<w; ++i){
 		for(int j=0; j<h; ++j){
-
-			float avg= (w+h)/2.f;
-
 			float distLu= splatDist(Vec2i(i, j), Vec2i(0, 0));
 			float distRu= splatDist(Vec2i(i, j), Vec2i(w, 0));
 			float distLd= splatDist(Vec2i(i, j), Vec2i(0, h));
 			float distRd= splatDist(Vec2i(i, j), Vec2i(w, h));
 
-			const float powFactor= 2.0f;
-
-			distLu	= std::pow(distLu, powFactor);
-			distRu	= std::pow(distRu, powFactor);
-			distLd	= std::pow(distLd, powFactor);
-			distRd	= std::pow(distRd, powFactor);
-			avg		= std::pow(avg, powFactor);
+			distLu	= distLu * distLu;
+			distRu	= distRu * distRu;
+			distLd	= distLd * distLd;
+			distRd	= distRd * distRd;
 
 			float lu= distLu>avg? 0: ((avg-distLu))*random.randRange(0.5f, 1.0f);
 			float ru= distRu>avg? 0: ((avg-distRu))*random.randRange(0.5f, 1.0f);
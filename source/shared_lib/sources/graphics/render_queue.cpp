@@ -0,0 +1,195 @@
+// ==============================================================
+//	This file is part of Glest Shared Library (www.glest.org)
+//
+//	Copyright (C) 2001-2008 Martiño Figueroa
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include "render_queue.h"
+
+#include <algorithm>
+
+#include "util.h"
+#include "platform_util.h"
+#include "simple_threads.h"
+#include "leak_dumper.h"
+
+using namespace std;
+using namespace Shared::Util;
+using namespace Shared::PlatformCommon;
+
+namespace Shared{ namespace Graphics{
+
+// =====================================================
+//	class RenderQueueItem
+// =====================================================
+
+RenderQueueItem::RenderQueueItem() {
+	stateKey= 0;
+	sourceIndex= -1;
+	model= NULL;
+	teamTexture= NULL;
+	color= Vec4f(1.f, 1.f, 1.f, 1.f);
+	animProgress= 0.f;
+	cycleAnimation= true;
+	frameStep= 0;
+	faded= false;
+}
+
+// =====================================================
+//	class RenderQueueBuildTask
+// =====================================================
+
+class RenderQueueBuildTask : public WorkerThreadTask {
+public:
+	const RenderQueueSource *source;
+	RenderQueueItem *items;
+	char *itemUsed;
+	int first;
+	int last;
+
+	RenderQueueBuildTask() : source(NULL), items(NULL), itemUsed(NULL), first(0), last(0) {}
+
+	virtual void executeTask(BaseThread *callingThread) {
+		for(int index = first; index < last; ++index) {
+			items[index]= RenderQueueItem();
+			items[index].sourceIndex= index;
+			itemUsed[index]= (source->fillRenderItem(index, items[index]) ? 1 : 0);
+		}
+	}
+};
+
+static bool compareRenderQueueItems(const RenderQueueItem &a, const RenderQueueItem &b) {
+	if(a.stateKey != b.stateKey) {
+		return a.stateKey < b.stateKey;
+	}
+	return a.sourceIndex < b.sourceIndex;
+}
+
+// =====================================================
+//	class RenderQueue
+// =====================================================
+
+RenderQueue::RenderQueue() {
+	itemCount= 0;
+	buildPool= NULL;
+}
+
+RenderQueue::~RenderQueue() {
+	delete buildPool;
+	buildPool= NULL;
+}
+
+void RenderQueue::setBuildThreadCount(int threadCount) {
+	if(buildPool != NULL && buildPool->getThreadCount() == threadCount) {
+		return;
+	}
+	delete buildPool;
+	buildPool= NULL;
+	if(threadCount > 0) {
+		buildPool= new WorkerThreadPool("RenderQueueBuild",threadCount);
+	}
+}
+
+int RenderQueue::getBuildThreadCount() const {
+	return (buildPool != NULL ? buildPool->getThreadCount() : 0);
+}
+
+uint64 RenderQueue::makeStateKey(bool faded, uint32 teamTextureId, uint32 modelId, uint32 frameStep) {
+	return	(static_cast<uint64>(faded ? 1 : 0) << 63) |
+			(static_cast<uint64>(teamTextureId & 0x7fff) << 48) |
+			(static_cast<uint64>(modelId & 0xffffff) << 24) |
+			static_cast<uint64>(frameStep & 0xffffff);
+}
+
+uint32 RenderQueue::getStateId(StateIds &ids, const void *state) {
+	// ids follow first use so the order does not depend on addresses
+	StateIds::iterator iterFind= ids.find(state);
+	if(iterFind != ids.end()) {
+		return iterFind->second;
+	}
+	uint32 id= (uint32)ids.size();
+	ids[state]= id;
+	return id;
+}
+
+void RenderQueue::build(const RenderQueueSource &source) {
+	const int count= source.getRenderItemCount();
+	itemCount= 0;
+	if(count <= 0) {
+		return;
+	}
+	if((int)items.size() < count) {
+		items.resize(count);
+		itemUsed.resize(count);
+	}
+
+	int taskCount= 1;
+	if(buildPool != NULL) {
+		taskCount= min(count, buildPool->getThreadCount() * 4);
+	}
+	vector<RenderQueueBuildTask> tasks(taskCount);
+	for(int index = 0; index < taskCount; ++index) {
+		RenderQueueBuildTask &task= tasks[index];
+		task.source= &source;
+		task.items= &items[0];
+		task.itemUsed= &itemUsed[0];
+		task.first= (int)((int64)count * index / taskCount);
+		task.last= (int)((int64)count * (index + 1) / taskCount);
+	}
+
+	if(buildPool != NULL && taskCount > 1) {
+		for(int index = 0; index < taskCount; ++index) {
+			buildPool->queueTask(&tasks[index]);
+		}
+		buildPool->waitForAllTasks();
+		buildPool->popCompletedTasks();
+	}
+	else {
+		tasks[0].executeTask(NULL);
+	}
+
+	for(int index = 0; index < taskCount; ++index) {
+		if(tasks[index].hasError() == true) {
+			throw megaglest_runtime_error("Error building render queue: " + tasks[index].getErrorMessage());
+		}
+	}
+
+	// compact in source order and assign the state keys
+	modelIds.clear();
+	teamTextureIds.clear();
+	for(int index = 0; index < count; ++index) {
+		if(itemUsed[index] == 0) {
+			continue;
+		}
+		RenderQueueItem &item= items[itemCount];
+		if(itemCount != index) {
+			item= items[index];
+		}
+		item.stateKey= makeStateKey(item.faded,
+				getStateId(teamTextureIds, item.teamTexture),
+				getStateId(modelIds, item.model),
+				item.frameStep);
+		itemCount++;
+	}
+}
+
+void RenderQueue::sort() {
+	if(itemCount > 1) {
+		std::sort(items.begin(), items.begin() + itemCount, compareRenderQueueItems);
+	}
+}
+
+void RenderQueue::clear() {
+	items.clear();
+	itemUsed.clear();
+	itemCount= 0;
+	modelIds.clear();
+	teamTextureIds.clear();
+}
+
+}}//end namespace
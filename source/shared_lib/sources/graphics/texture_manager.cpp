@@ -26,6 +26,20 @@ using namespace Shared::Platform;
 
 namespace Shared{ namespace Graphics{
 
+// =====================================================
+//	class TextureDecodeTask
+// =====================================================
+
+TextureDecodeTask::TextureDecodeTask(Texture2D *texture, const string &path, bool deletePixMapAfterLoad) {
+	this->texture = texture;
+	this->path = path;
+	this->deletePixMapAfterLoad = deletePixMapAfterLoad;
+}
+
+void TextureDecodeTask::executeTask(BaseThread *callingThread) {
+	texture->load(path);
+}
+
 // =====================================================
 //	class TextureManager
 // =====================================================
@@ -38,10 +52,13 @@ TextureManager::TextureManager() {
 
 	textureFilter= Texture::fBilinear;
 	maxAnisotropy= 1;
+	decodePool= NULL;
 }
 
 TextureManager::~TextureManager(){
 	end();
+	delete decodePool;
+	decodePool= NULL;
 }
 
 void TextureManager::initTexture(Texture *texture) {
@@ -52,6 +69,11 @@ void TextureManager::initTexture(Texture *texture) {
 
 void TextureManager::endTexture(Texture *texture,bool mustExistInList) {
 	if(texture != NULL) {
+		if(isTextureDecodePending(texture) == true) {
+			uploadDecodedTextures(true);
+		}
+		removeFromIndex(texture);
+
 		bool found = false;
 		for(unsigned int idx = 0; idx < textures.size(); idx++) {
 			Texture *curTexture = textures[idx];
@@ -75,6 +97,10 @@ void TextureManager::endLastTexture(bool mustExistInList) {
 		found = true;
 		int index = (int)textures.size()-1;
 		Texture *curTexture = textures[index];
+		if(isTextureDecodePending(curTexture) == true) {
+			uploadDecodedTextures(true);
+		}
+		removeFromIndex(curTexture);
 		textures.erase(textures.begin() + index);
 
 		curTexture->end();
@@ -86,6 +112,8 @@ void TextureManager::endLastTexture(bool mustExistInList) {
 }
 
 void TextureManager::init(bool forceInit) {
+	uploadDecodedTextures(true);
+
 	for(unsigned int i=0; i<textures.size(); ++i){
 		Texture *texture = textures[i];
 		if(texture == NULL) {
@@ -102,6 +130,18 @@ void TextureManager::init(bool forceInit) {
 }
 
 void TextureManager::end(){
+	if(decodePool != NULL) {
+		decodePool->waitForAllTasks();
+		decodePool->popCompletedTasks();
+	}
+	for(TextureDecodeTaskMap::iterator iterMap = pendingDecodes.begin();
+		iterMap != pendingDecodes.end(); ++iterMap) {
+		delete iterMap->second;
+	}
+	pendingDecodes.clear();
+	texturePathIndex.clear();
+	unindexedTextures.clear();
+
 	for(unsigned int i=0; i<textures.size(); ++i){
 		if(textures[i] != NULL) {
 			textures[i]->end();
@@ -119,18 +159,59 @@ void TextureManager::setMaxAnisotropy(int maxAnisotropy){
 	this->maxAnisotropy= maxAnisotropy;
 }
 
-Texture *TextureManager::getTexture(const string &path){
-	for(unsigned int i=0; i<textures.size(); ++i){
-		if(textures[i]->getPath()==path){
-			return textures[i];
+void TextureManager::indexTexturePaths() {
+	for(unsigned int i = 0; i < unindexedTextures.size();) {
+		Texture *texture = unindexedTextures[i];
+		string path = texture->getPath();
+		if(path != "") {
+			if(texturePathIndex.find(path) == texturePathIndex.end()) {
+				texturePathIndex[path] = texture;
+			}
+			unindexedTextures.erase(unindexedTextures.begin() + i);
+		}
+		else {
+			++i;
 		}
 	}
-	return NULL;
+}
+
+void TextureManager::removeFromIndex(Texture *texture) {
+	for(TexturePathIndex::iterator iterMap = texturePathIndex.begin();
+		iterMap != texturePathIndex.end(); ++iterMap) {
+		if(iterMap->second == texture) {
+			texturePathIndex.erase(iterMap);
+			break;
+		}
+	}
+	for(unsigned int i = 0; i < unindexedTextures.size(); ++i) {
+		if(unindexedTextures[i] == texture) {
+			unindexedTextures.erase(unindexedTextures.begin() + i);
+			break;
+		}
+	}
+}
+
+Texture *TextureManager::getTexture(const string &path){
+	indexTexturePaths();
+
+	TexturePathIndex::iterator iterFind = texturePathIndex.find(path);
+	if(iterFind == texturePathIndex.end()) {
+		return NULL;
+	}
+	Texture *texture = iterFind->second;
+	// a decoding texture does not report its path until the worker is done
+	if(isTextureDecodePending(texture) == false && texture->getPath() != path) {
+		texturePathIndex.erase(iterFind);
+		unindexedTextures.push_back(texture);
+		return getTexture(path);
+	}
+	return texture;
 }
 
 Texture1D *TextureManager::newTexture1D(){
 	Texture1D *texture1D= GraphicsInterface::getInstance().getFactory()->newTexture1D();
 	textures.push_back(texture1D);
+	unindexedTextures.push_back(texture1D);
 
 	return texture1D;
 }
@@ -138,6 +219,7 @@ Texture1D *TextureManager::newTexture1D(){
 Texture2D *TextureManager::newTexture2D(){
 	Texture2D *texture2D= GraphicsInterface::getInstance().getFactory()->newTexture2D();
 	textures.push_back(texture2D);
+	unindexedTextures.push_back(texture2D);
 
 	return texture2D;
 }
@@ -145,6 +227,7 @@ Texture2D *TextureManager::newTexture2D(){
 Texture3D *TextureManager::newTexture3D(){
 	Texture3D *texture3D= GraphicsInterface::getInstance().getFactory()->newTexture3D();
 	textures.push_back(texture3D);
+	unindexedTextures.push_back(texture3D);
 
 	return texture3D;
 }
@@ -153,8 +236,113 @@ Texture3D *TextureManager::newTexture3D(){
 TextureCube *TextureManager::newTextureCube(){
 	TextureCube *textureCube= GraphicsInterface::getInstance().getFactory()->newTextureCube();
 	textures.push_back(textureCube);
+	unindexedTextures.push_back(textureCube);
 
 	return textureCube;
 }
 
+Texture2D *TextureManager::loadTexture2D(const string &path, bool deletePixMapAfterLoad,
+		bool &created, int channelCount) {
+	created = false;
+
+	Texture2D *texture = dynamic_cast<Texture2D *>(getTexture(path));
+	if(texture != NULL) {
+		return texture;
+	}
+
+	texture = newTexture2D();
+	if(texture == NULL) {
+		return NULL;
+	}
+	if(channelCount != -1) {
+		texture->getPixmap()->init(channelCount);
+	}
+	queueTextureDecode(texture,path,deletePixMapAfterLoad);
+	created = true;
+
+	return texture;
+}
+
+void TextureManager::setDecodeThreadCount(int threadCount) {
+	if(decodePool != NULL) {
+		uploadDecodedTextures(true);
+		delete decodePool;
+		decodePool = NULL;
+	}
+	if(threadCount > 0) {
+		decodePool = new WorkerThreadPool("TextureDecode",threadCount);
+	}
+}
+
+void TextureManager::queueTextureDecode(Texture2D *texture, const string &path, bool deletePixMapAfterLoad) {
+	if(texture == NULL) {
+		return;
+	}
+	removeFromIndex(texture);
+	if(texturePathIndex.find(path) == texturePathIndex.end()) {
+		texturePathIndex[path] = texture;
+	}
+
+	TextureDecodeTask *task = new TextureDecodeTask(texture,path,deletePixMapAfterLoad);
+	if(decodePool == NULL) {
+		task->executeTask(NULL);
+		finishTextureDecode(task);
+		return;
+	}
+	pendingDecodes[texture] = task;
+	decodePool->queueTask(task);
+}
+
+bool TextureManager::isTextureDecodePending(const Texture *texture) const {
+	return pendingDecodes.find(const_cast<Texture *>(texture)) != pendingDecodes.end();
+}
+
+void TextureManager::finishTextureDecode(TextureDecodeTask *task) {
+	auto_ptr<TextureDecodeTask> taskOwner(task);
+	if(task->hasError() == true) {
+		throw megaglest_runtime_error("Error decoding texture [" + task->path + "] " + task->getErrorMessage());
+	}
+
+	Texture2D *texture = task->texture;
+	texture->init(textureFilter,maxAnisotropy);
+	if(task->deletePixMapAfterLoad == true) {
+		texture->deletePixels();
+	}
+}
+
+int TextureManager::uploadDecodedTextures(bool waitForPending) {
+	if(decodePool == NULL || pendingDecodes.empty() == true) {
+		return 0;
+	}
+	if(waitForPending == true) {
+		decodePool->waitForAllTasks();
+	}
+
+	// uploads happen in queue order so repeated loads give the same GL ids
+	vector<WorkerThreadTask *> completed = decodePool->popCompletedTasks();
+	vector<TextureDecodeTask *> finished;
+	for(unsigned int i = 0; i < completed.size(); ++i) {
+		TextureDecodeTask *task = static_cast<TextureDecodeTask *>(completed[i]);
+		pendingDecodes.erase(task->texture);
+		finished.push_back(task);
+	}
+
+	int uploadCount = 0;
+	for(unsigned int i = 0; i < textures.size() && finished.empty() == false; ++i) {
+		for(unsigned int j = 0; j < finished.size(); ++j) {
+			if(finished[j]->texture == textures[i]) {
+				TextureDecodeTask *task = finished[j];
+				finished.erase(finished.begin() + j);
+				finishTextureDecode(task);
+				uploadCount++;
+				break;
+			}
+		}
+	}
+	for(unsigned int j = 0; j < finished.size(); ++j) {
+		delete finished[j];
+	}
+	return uploadCount;
+}
+
 }}//end namespace
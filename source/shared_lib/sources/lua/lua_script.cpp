@@ -429,6 +429,9 @@ void LuaScript::saveGame(XmlNode *rootNode) {
 void LuaScript::loadGame(const XmlNode *rootNode) {
 	if(LuaScript::debugModeEnabled) printf("START [%s::%s] Line: %d\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
 
+	// restored globals may replace the functions
+	clearFunctionRefs();
+
 	vector<XmlNode *> luaScriptNodeList = rootNode->getChildList("LuaScript");
 
 	if(LuaScript::debugModeEnabled) printf("luaScriptNodeList.size(): %d\n",(int)luaScriptNodeList.size());
@@ -532,12 +535,37 @@ LuaScript::~LuaScript() {
 
 	//DumpGlobals();
 
+	clearFunctionRefs();
 	lua_close(luaState);
 }
 
+void LuaScript::clearFunctionRefs() {
+	for(unsigned int i = 0; i < functionRefs.size(); ++i) {
+		if(functionRefs[i] != LUA_NOREF) {
+			luaL_unref(luaState, LUA_REGISTRYINDEX, functionRefs[i]);
+			functionRefs[i]= LUA_NOREF;
+		}
+	}
+}
+
+int LuaScript::getFunctionId(const string &functionName) {
+	std::map<string,int>::const_iterator iterFind= functionIds.find(functionName);
+	if(iterFind != functionIds.end()) {
+		return iterFind->second;
+	}
+	int functionId= (int)functionNames.size();
+	functionNames.push_back(functionName);
+	functionRefs.push_back(LUA_NOREF);
+	functionIds[functionName]= functionId;
+	return functionId;
+}
+
 void LuaScript::loadCode(string code, string name){
 	Lua_STREFLOP_Wrapper streflopWrapper;
 
+	// the code may define the functions again
+	clearFunctionRefs();
+
 	//printf("Code [%s]\nName [%s]\n",code.c_str(),name.c_str());
 
 	int errorCode= luaL_loadbuffer(luaState, code.c_str(), code.length(), name.c_str());
@@ -580,13 +608,20 @@ void LuaScript::setSandboxCode(string code) {
 int LuaScript::runCode(string code) {
 	Lua_STREFLOP_Wrapper streflopWrapper;
 
+	clearFunctionRefs();
+
 	int errorCode = luaL_dostring(luaState,code.c_str());
 	return errorCode;
 }
 
 void LuaScript::beginCall(string functionName) {
+	beginCall(getFunctionId(functionName));
+}
+
+void LuaScript::beginCall(int functionId) {
 	Lua_STREFLOP_Wrapper streflopWrapper;
 
+	const string &functionName= functionNames[functionId];
 	currentLuaFunction = functionName;
 
 	if(SystemFlags::getSystemSettingType(SystemFlags::debugLUA).enabled) SystemFlags::OutputDebug(SystemFlags::debugLUA,"In [%s::%s Line: %d] functionName [%s]\n",__FILE__,__FUNCTION__,__LINE__,functionName.c_str());
@@ -600,9 +635,19 @@ void LuaScript::beginCall(string functionName) {
 //		}
 //		//functionName = sandboxWrapperFunctionName;
 //	}
-	lua_getglobal(luaState, functionName.c_str());
+	if(functionRefs[functionId] != LUA_NOREF) {
+		lua_rawgeti(luaState, LUA_REGISTRYINDEX, functionRefs[functionId]);
+		currentLuaFunctionIsValid = true;
+	}
+	else {
+		lua_getglobal(luaState, functionName.c_str());
 
-	currentLuaFunctionIsValid = lua_isfunction(luaState,lua_gettop(luaState));
+		currentLuaFunctionIsValid = lua_isfunction(luaState,lua_gettop(luaState));
+		if(currentLuaFunctionIsValid == true) {
+			lua_pushvalue(luaState, -1);
+			functionRefs[functionId]= luaL_ref(luaState, LUA_REGISTRYINDEX);
+		}
+	}
 
 	//printf("currentLuaFunctionIsValid = %d functionName [%s]\n",currentLuaFunctionIsValid,functionName.c_str());
 	argumentCount= 0;
@@ -0,0 +1,558 @@
+// ==============================================================
+//	This file is part of Glest (www.glest.org)
+//
+//	Copyright (C) 2001-2008 Martiño Figueroa
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include "map_index.h"
+
+#include <set>
+#include <algorithm>
+#include <iterator>
+#include <sys/stat.h>
+#include "checksum.h"
+#include "platform_util.h"
+#include "conversion.h"
+#include "util.h"
+#include "leak_dumper.h"
+
+using namespace Shared::Util;
+using namespace Shared::PlatformCommon;
+using namespace std;
+
+namespace Shared { namespace Map {
+
+static const char *MAP_INDEX_FILE 	= "map_index.bin";
+static const int32 MAP_INDEX_MAGIC 	= 0x4d474d49;
+static const int32 MAP_INDEX_VERSION= 1;
+
+static void writeIndexInt(FILE *f, int64 value) {
+	fwrite(&value, sizeof(int64), 1, f);
+}
+
+static bool readIndexInt(FILE *f, int64 &value) {
+	return (fread(&value, sizeof(int64), 1, f) == 1);
+}
+
+static void writeIndexString(FILE *f, const string &value) {
+	writeIndexInt(f, (int64)value.size());
+	if(value.empty() == false) {
+		fwrite(value.c_str(), value.size(), 1, f);
+	}
+}
+
+static bool readIndexString(FILE *f, string &value) {
+	int64 size = 0;
+	if(readIndexInt(f, size) == false || size < 0 || size > 8096) {
+		return false;
+	}
+	value.resize((size_t)size);
+	return (size == 0 || fread(&value[0], (size_t)size, 1, f) == 1);
+}
+
+template<typename T>
+static void writeIndexVector(FILE *f, const vector<T> &value) {
+	writeIndexInt(f, (int64)value.size());
+	if(value.empty() == false) {
+		fwrite(&value[0], sizeof(T), value.size(), f);
+	}
+}
+
+template<typename T>
+static bool readIndexVector(FILE *f, vector<T> &value) {
+	int64 size = 0;
+	if(readIndexInt(f, size) == false || size < 0 ||
+		size > MapIndexEntry::maxPreviewDimension * MapIndexEntry::maxPreviewDimension) {
+		return false;
+	}
+	value.resize((size_t)size);
+	return (size == 0 || fread(&value[0], sizeof(T), (size_t)size, f) == (size_t)size);
+}
+
+// ===============================================
+//	class MapIndexEntry
+// ===============================================
+
+MapIndexEntry::MapIndexEntry() {
+	fileSize	= 0;
+	modTime		= 0;
+	valid		= false;
+	width		= 0;
+	height		= 0;
+	maxFactions	= 0;
+	heightFactor= 0;
+	waterLevel	= 0;
+	cliffLevel	= 0;
+	cameraHeight= 0;
+	crc			= 0;
+	previewW	= 0;
+	previewH	= 0;
+}
+
+void MapIndexEntry::setFromMap(const MapPreview &map) {
+	title			= map.getTitle();
+	author			= map.getAuthor();
+	desc			= map.getDesc();
+	width			= map.getW();
+	height			= map.getH();
+	maxFactions		= map.getMaxFactions();
+	heightFactor	= map.getHeightFactor();
+	waterLevel		= map.getWaterLevel();
+	cliffLevel		= map.getCliffLevel();
+	cameraHeight	= map.getCameraHeight();
+
+	int step = 1;
+	while(width / step > maxPreviewDimension || height / step > maxPreviewDimension) {
+		step++;
+	}
+	previewW = width / step;
+	previewH = height / step;
+
+	previewHeights.resize(previewW * previewH);
+	previewSurfaces.resize(previewW * previewH);
+	previewObjects.resize(previewW * previewH);
+	previewResources.resize(previewW * previewH);
+	for(int y = 0; y < previewH; ++y) {
+		for(int x = 0; x < previewW; ++x) {
+			int index = y * previewW + x;
+			float cellHeight = map.getHeight(x * step, y * step);
+			previewHeights[index]	= (uint8)std::max(0.f, std::min(cellHeight * 10.f + 0.5f, 255.f));
+			previewSurfaces[index]	= (int8)map.getSurface(x * step, y * step);
+			previewObjects[index]	= (int8)map.getObject(x * step, y * step);
+			previewResources[index]= (int8)map.getResource(x * step, y * step);
+		}
+	}
+
+	startLocationsX.resize(maxFactions);
+	startLocationsY.resize(maxFactions);
+	for(int i = 0; i < maxFactions; ++i) {
+		startLocationsX[i] = map.getStartLocationX(i) / step;
+		startLocationsY[i] = map.getStartLocationY(i) / step;
+	}
+}
+
+void MapIndexEntry::saveToFile(FILE *f) const {
+	writeIndexString(f, path);
+	writeIndexInt(f, fileSize);
+	writeIndexInt(f, modTime);
+	writeIndexInt(f, valid);
+	writeIndexString(f, title);
+	writeIndexString(f, author);
+	writeIndexString(f, desc);
+	writeIndexInt(f, width);
+	writeIndexInt(f, height);
+	writeIndexInt(f, maxFactions);
+	writeIndexInt(f, heightFactor);
+	writeIndexInt(f, waterLevel);
+	writeIndexInt(f, cliffLevel);
+	writeIndexInt(f, cameraHeight);
+	writeIndexInt(f, crc);
+	writeIndexInt(f, previewW);
+	writeIndexInt(f, previewH);
+	writeIndexVector(f, previewHeights);
+	writeIndexVector(f, previewSurfaces);
+	writeIndexVector(f, previewObjects);
+	writeIndexVector(f, previewResources);
+	writeIndexVector(f, startLocationsX);
+	writeIndexVector(f, startLocationsY);
+}
+
+bool MapIndexEntry::loadFromFile(FILE *f) {
+	int64 values[12];
+	bool result = readIndexString(f, path) &&
+		readIndexInt(f, fileSize) &&
+		readIndexInt(f, modTime) &&
+		readIndexInt(f, values[0]) &&
+		readIndexString(f, title) &&
+		readIndexString(f, author) &&
+		readIndexString(f, desc);
+	for(int i = 1; result == true && i < 12; ++i) {
+		result = readIndexInt(f, values[i]);
+	}
+	if(result == false) {
+		return false;
+	}
+	valid		= (values[0] != 0);
+	width		= (int)values[1];
+	height		= (int)values[2];
+	maxFactions	= (int)values[3];
+	heightFactor= (int)values[4];
+	waterLevel	= (int)values[5];
+	cliffLevel	= (int)values[6];
+	cameraHeight= (int)values[7];
+	crc			= (uint32)values[8];
+	previewW	= (int)values[9];
+	previewH	= (int)values[10];
+
+	result = readIndexVector(f, previewHeights) &&
+		readIndexVector(f, previewSurfaces) &&
+		readIndexVector(f, previewObjects) &&
+		readIndexVector(f, previewResources) &&
+		readIndexVector(f, startLocationsX) &&
+		readIndexVector(f, startLocationsY);
+
+	int previewSize = previewW * previewH;
+	return (result == true &&
+			(int)previewHeights.size() == previewSize &&
+			(int)previewSurfaces.size() == previewSize &&
+			(int)previewObjects.size() == previewSize &&
+			(int)previewResources.size() == previewSize &&
+			(int)startLocationsX.size() == (valid ? maxFactions : 0) &&
+			startLocationsX.size() == startLocationsY.size());
+}
+
+// ===============================================
+//	class MapIndexRefreshThread
+// ===============================================
+
+MapIndexRefreshThread::MapIndexRefreshThread(const vector<string> &pathList) : BaseThread() {
+	this->pathList = pathList;
+	uniqueID = "MapIndexRefreshThread";
+}
+
+bool MapIndexRefreshThread::canShutdown(bool deleteSelfIfShutdownDelayed) {
+	bool ret = (getExecutingTask() == false);
+	if(ret == false && deleteSelfIfShutdownDelayed == true) {
+		setDeleteSelfOnExecutionDone(deleteSelfIfShutdownDelayed);
+		deleteSelfIfRequired();
+		signalQuit();
+	}
+	return ret;
+}
+
+void MapIndexRefreshThread::execute() {
+	RunningStatusSafeWrapper runningStatus(this);
+	try {
+		ExecutingTaskSafeWrapper safeExecutingTaskMutex(this);
+
+		if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d] uniqueID [%s]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,this->getUniqueID().c_str());
+
+		set<string> allMaps;
+		vector<string> results;
+		findAll(pathList, "*.gbm", results, false, false);
+		copy(results.begin(), results.end(), std::inserter(allMaps, allMaps.begin()));
+		results.clear();
+		findAll(pathList, "*.mgm", results, false, false);
+		copy(results.begin(), results.end(), std::inserter(allMaps, allMaps.begin()));
+
+		MapIndex &mapIndex = MapIndex::getInstance();
+		vector<string> mapFiles;
+		int refreshedCount = 0;
+		for(set<string>::iterator iterMap = allMaps.begin();
+			iterMap != allMaps.end() && getQuitStatus() == false; ++iterMap) {
+			string file = MapPreview::getMapPath(pathList, *iterMap, "", false);
+			if(file == "") {
+				continue;
+			}
+			mapFiles.push_back(file);
+			if(mapIndex.isCurrent(file) == false) {
+				mapIndex.refreshEntry(file);
+				refreshedCount++;
+			}
+		}
+
+		if(getQuitStatus() == false) {
+			mapIndex.removeStaleEntries(mapFiles);
+		}
+		mapIndex.saveIndex();
+
+		if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d] maps: %d refreshed: %d\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,(int)mapFiles.size(),refreshedCount);
+	}
+	catch(const exception &ex) {
+		SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] Error [%s]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,ex.what());
+	}
+	catch(...) {
+		SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] UNKNOWN Error\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
+	}
+}
+
+// ===============================================
+//	class MapIndex
+// ===============================================
+
+MapIndex::MapIndex() : mutexEntries(new Mutex(CODE_AT_LINE)) {
+	loaded			= false;
+	changed			= false;
+	refreshThread	= NULL;
+}
+
+MapIndex::~MapIndex() {
+	stopRefresh();
+
+	delete mutexEntries;
+	mutexEntries = NULL;
+}
+
+MapIndex &MapIndex::getInstance() {
+	static MapIndex mapIndex;
+	return mapIndex;
+}
+
+bool MapIndex::getFileStamp(const string &path, int64 &fileSize, int64 &modTime) {
+#ifdef WIN32
+  #if defined(__MINGW32__)
+	struct _stat stbuf;
+  #else
+	struct _stat64i32 stbuf;
+  #endif
+	if(_wstat(utf8_decode(path).c_str(), &stbuf) != -1) {
+#else
+	struct stat stbuf;
+	if(stat(path.c_str(), &stbuf) != -1) {
+#endif
+		fileSize	= stbuf.st_size;
+		modTime		= stbuf.st_mtime;
+		return true;
+	}
+	return false;
+}
+
+void MapIndex::loadIndex() {
+	// callers hold mutexEntries
+	if(loaded == true) {
+		return;
+	}
+	loaded = true;
+	if(getCRCCacheFilePath() == "") {
+		return;
+	}
+	indexFile = getCRCCacheFilePath() + MAP_INDEX_FILE;
+
+#ifdef WIN32
+	FILE *f = _wfopen(utf8_decode(indexFile).c_str(), L"rb");
+#else
+	FILE *f = fopen(indexFile.c_str(), "rb");
+#endif
+	if(f == NULL) {
+		return;
+	}
+
+	int32 header[2] = { 0, 0 };
+	if(fread(header, sizeof(header), 1, f) == 1 &&
+		header[0] == MAP_INDEX_MAGIC && header[1] == MAP_INDEX_VERSION) {
+		for(;;) {
+			MapIndexEntry entry;
+			if(entry.loadFromFile(f) == false) {
+				break;
+			}
+			entries[entry.path] = entry;
+		}
+	}
+	fclose(f);
+
+	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d] loaded %d map index entries from [%s]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,(int)entries.size(),indexFile.c_str());
+}
+
+void MapIndex::saveIndex() {
+	MutexSafeWrapper safeMutex(mutexEntries,CODE_AT_LINE);
+	if(changed == false || indexFile == "") {
+		return;
+	}
+
+#ifdef WIN32
+	FILE *f = _wfopen(utf8_decode(indexFile).c_str(), L"wb");
+#else
+	FILE *f = fopen(indexFile.c_str(), "wb");
+#endif
+	if(f == NULL) {
+		SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] cannot write map index [%s]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,indexFile.c_str());
+		return;
+	}
+
+	int32 header[2] = { MAP_INDEX_MAGIC, MAP_INDEX_VERSION };
+	fwrite(header, sizeof(header), 1, f);
+	for(EntryMap::const_iterator iterMap = entries.begin();
+		iterMap != entries.end(); ++iterMap) {
+		iterMap->second.saveToFile(f);
+	}
+	fclose(f);
+	changed = false;
+}
+
+bool MapIndex::findCurrentEntry(const string &path, MapIndexEntry &entry) {
+	int64 fileSize	= 0;
+	int64 modTime	= 0;
+	if(getFileStamp(path, fileSize, modTime) == false) {
+		return false;
+	}
+
+	MutexSafeWrapper safeMutex(mutexEntries,CODE_AT_LINE);
+	loadIndex();
+
+	EntryMap::const_iterator iterFind = entries.find(path);
+	if(iterFind == entries.end() ||
+		iterFind->second.fileSize != fileSize ||
+		iterFind->second.modTime != modTime) {
+		return false;
+	}
+	entry = iterFind->second;
+	return true;
+}
+
+bool MapIndex::isCurrent(const string &path) {
+	int64 fileSize	= 0;
+	int64 modTime	= 0;
+	if(getFileStamp(path, fileSize, modTime) == false) {
+		return false;
+	}
+
+	MutexSafeWrapper safeMutex(mutexEntries,CODE_AT_LINE);
+	loadIndex();
+
+	EntryMap::const_iterator iterFind = entries.find(path);
+	return (iterFind != entries.end() &&
+			iterFind->second.fileSize == fileSize &&
+			iterFind->second.modTime == modTime);
+}
+
+bool MapIndex::refreshEntry(const string &path) {
+	MapIndexEntry entry;
+	entry.path = path;
+	if(getFileStamp(path, entry.fileSize, entry.modTime) == false) {
+		return false;
+	}
+
+	// the expensive part runs without holding the lock
+	try {
+		MapInfo mapInfo;
+		if(MapPreview::loadMapInfo(path, &mapInfo, "", "", false) == true) {
+			MapPreview map;
+			map.loadFromFile(path);
+			entry.setFromMap(map);
+
+			Checksum checksum;
+			checksum.addFile(path);
+			entry.crc = checksum.getSum();
+			entry.valid = true;
+		}
+	}
+	catch(const exception &ex) {
+		SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] Error [%s] indexing map [%s]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,ex.what(),path.c_str());
+		entry.valid = false;
+	}
+
+	MutexSafeWrapper safeMutex(mutexEntries,CODE_AT_LINE);
+	loadIndex();
+	entries[path] = entry;
+	changed = true;
+
+	return entry.valid;
+}
+
+void MapIndex::removeStaleEntries(const vector<string> &existingFiles) {
+	set<string> existing(existingFiles.begin(), existingFiles.end());
+
+	MutexSafeWrapper safeMutex(mutexEntries,CODE_AT_LINE);
+	loadIndex();
+
+	for(EntryMap::iterator iterMap = entries.begin(); iterMap != entries.end();) {
+		if(existing.find(iterMap->first) == existing.end()) {
+			entries.erase(iterMap++);
+			changed = true;
+		}
+		else {
+			++iterMap;
+		}
+	}
+}
+
+bool MapIndex::getMapInfo(const string &path, MapInfo *mapInfo,
+		const string &i18nMaxMapPlayersTitle, const string &i18nMapSizeTitle) {
+	MapIndexEntry entry;
+	if(findCurrentEntry(path, entry) == false || entry.valid == false) {
+		return false;
+	}
+
+	mapInfo->size.x			= entry.width;
+	mapInfo->size.y			= entry.height;
+	mapInfo->players		= entry.maxFactions;
+	mapInfo->hardMaxPlayers	= mapInfo->players;
+
+	mapInfo->desc 	=  i18nMaxMapPlayersTitle 	+ ": " + intToStr(mapInfo->players) + "\n";
+	mapInfo->desc 	+= i18nMapSizeTitle 		+ ": " + intToStr(mapInfo->size.x) + " x " + intToStr(mapInfo->size.y);
+	return true;
+}
+
+bool MapIndex::getMapCRC(const string &path, uint32 &crc) {
+	MapIndexEntry entry;
+	if(findCurrentEntry(path, entry) == false || entry.valid == false) {
+		return false;
+	}
+	crc = entry.crc;
+	return true;
+}
+
+bool MapIndex::loadPreview(const string &path, MapPreview *map) {
+	MapIndexEntry entry;
+	if(findCurrentEntry(path, entry) == false || entry.valid == false ||
+		entry.previewW <= 0 || entry.previewH <= 0) {
+		return false;
+	}
+
+	map->title			= entry.title;
+	map->author			= entry.author;
+	map->desc			= entry.desc;
+	map->heightFactor	= entry.heightFactor;
+	map->waterLevel		= entry.waterLevel;
+	map->cliffLevel		= entry.cliffLevel;
+	map->cameraHeight	= entry.cameraHeight;
+	map->w				= entry.previewW;
+	map->h				= entry.previewH;
+
+	map->maxFactions = entry.maxFactions;
+	map->startLocations.resize(entry.maxFactions);
+	for(int i = 0; i < entry.maxFactions; ++i) {
+		map->startLocations[i].x = entry.startLocationsX[i];
+		map->startLocations[i].y = entry.startLocationsY[i];
+	}
+
+	map->cells.clear();
+	map->cells.resize(entry.previewW);
+	for(int x = 0; x < entry.previewW; ++x) {
+		map->cells[x].resize(entry.previewH);
+		for(int y = 0; y < entry.previewH; ++y) {
+			int index = y * entry.previewW + x;
+			map->cells[x][y].height		= entry.previewHeights[index] / 10.f;
+			map->cells[x][y].surface	= entry.previewSurfaces[index];
+			map->cells[x][y].object		= entry.previewObjects[index];
+			map->cells[x][y].resource	= entry.previewResources[index];
+		}
+	}
+
+	map->fileLoaded		= true;
+	map->mapFileLoaded	= path;
+	map->hasChanged		= false;
+	return true;
+}
+
+void MapIndex::startRefresh(const vector<string> &pathList) {
+	if(refreshThread != NULL) {
+		if(refreshThread->getRunningStatus() == true) {
+			return;
+		}
+		stopRefresh();
+	}
+
+	refreshThread = new MapIndexRefreshThread(pathList);
+	refreshThread->start();
+}
+
+void MapIndex::stopRefresh() {
+	if(refreshThread != NULL) {
+		refreshThread->signalQuit();
+		if(refreshThread->shutdownAndWait() == true) {
+			delete refreshThread;
+		}
+		else {
+			refreshThread->setDeleteSelfOnExecutionDone(true);
+		}
+		refreshThread = NULL;
+	}
+}
+
+}}// end namespace
@@ -11,6 +11,7 @@
 
 
 #include "map_preview.h"
+#include "map_index.h"
 
 #include "math_wrapper.h"
 #include <cstdlib>
@@ -1053,6 +1054,10 @@ void MapPreview::applyNewHeight(float newHeight, int x, int y, int strenght) {
 
 bool MapPreview::loadMapInfo(string file, MapInfo *mapInfo, string i18nMaxMapPlayersTitle,string i18nMapSizeTitle,bool errorOnInvalidMap) {
 	bool validMap = false;
+	if(MapIndex::getInstance().getMapInfo(file, mapInfo, i18nMaxMapPlayersTitle, i18nMapSizeTitle) == true) {
+		return true;
+	}
+
 	FILE *f = NULL;
 	try {
 #ifdef WIN32
@@ -28,6 +28,7 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <unistd.h>
+#include <time.h>
 
 #endif
 
@@ -168,16 +169,9 @@ void PerformanceTimer::reset() {
 // =====================================
 
 Chrono::Chrono(bool autoStart) {
-	freq 			= 1000;
-	stopped			= true;
-	accumCount		= 0;
-
-	lastStartCount 	= 0;
-	lastTickCount 	= 0;
-	lastResult 		= 0;
-	lastMultiplier 	= 0;
-	lastStopped 	= false;
-	startCount 		= 0;
+	stopped		= true;
+	accumNanos	= 0;
+	startNanos	= 0;
 
 	if(autoStart == true) {
 		start();
@@ -190,70 +184,36 @@ bool Chrono::isStarted() const {
 
 void Chrono::start() {
 	stopped		= false;
-	startCount 	= SDL_GetTicks();
+	startNanos 	= getCurNanos();
 }
 
 void Chrono::stop() {
-	Uint32 endCount	= SDL_GetTicks();
-	accumCount 		+= endCount - startCount;
-	stopped			= true;
+	accumNanos 	+= getCurNanos() - startNanos;
+	stopped		= true;
 }
 
 void Chrono::reset() {
-	accumCount 		= 0;
-	lastStartCount 	= 0;
-	lastTickCount 	= 0;
-	lastResult 		= 0;
-	lastMultiplier 	= 0;
+	accumNanos 	= 0;
+	startNanos 	= getCurNanos();
+}
 
-	startCount 		= SDL_GetTicks();
+int64 Chrono::getNanos() {
+	if(stopped == true) {
+		return accumNanos;
+	}
+	return accumNanos + getCurNanos() - startNanos;
 }
 
 int64 Chrono::getMicros() {
-	return queryCounter(1000000);
+	return getNanos() / 1000;
 }
 
 int64 Chrono::getMillis()  {
-	return queryCounter(1000);
+	return getNanos() / 1000000;
 }
 
 int64 Chrono::getSeconds() {
-	return queryCounter(1);
-}
-
-int64 Chrono::queryCounter(int64 multiplier) {
-
-	if(	multiplier == lastMultiplier &&
-		stopped == lastStopped &&
-		lastStartCount == startCount) {
-
-		if(stopped == true) {
-			return lastResult;
-		}
-		else {
-			Uint32 endCount = SDL_GetTicks();
-			if(lastTickCount == endCount) {
-				return lastResult;
-			}
-		}
-	}
-
-	int64 result = 0;
-	if(stopped == true) {
-		result = multiplier * accumCount / freq;
-	}
-	else {
-		Uint32 endCount = SDL_GetTicks();
-		result = multiplier * (accumCount + endCount - startCount) / freq;
-		lastTickCount = endCount;
-	}
-
-	lastStartCount 	= startCount;
-	lastResult 		= result;
-	lastMultiplier 	= multiplier;
-	lastStopped 	= stopped;
-
-	return result;
+	return getNanos() / 1000000000;
 }
 
 int64 Chrono::getCurMillis() {
@@ -262,6 +222,23 @@ int64 Chrono::getCurMillis() {
 int64 Chrono::getCurTicks() {
     return SDL_GetTicks();
 }
+int64 Chrono::getCurNanos() {
+#ifdef WIN32
+	static LARGE_INTEGER frequency = { 0 };
+	if(frequency.QuadPart == 0) {
+		QueryPerformanceFrequency(&frequency);
+	}
+	LARGE_INTEGER counter;
+	QueryPerformanceCounter(&counter);
+	// split to keep the multiplication from overflowing
+	return (counter.QuadPart / frequency.QuadPart) * 1000000000 +
+		(counter.QuadPart % frequency.QuadPart) * 1000000000 / frequency.QuadPart;
+#else
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (int64)now.tv_sec * 1000000000 + now.tv_nsec;
+#endif
+}
 
 
 
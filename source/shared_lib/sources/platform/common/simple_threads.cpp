@@ -788,4 +788,183 @@ void LogFileThread::saveToDisk(bool forceSaveAll,bool logListAlreadyLocked) {
     }
 }
 
+// =====================================================
+//	class WorkerThreadPoolThread
+// =====================================================
+
+WorkerThreadPoolThread::WorkerThreadPoolThread(WorkerThreadPool *pool) : BaseThread() {
+	this->pool = pool;
+	uniqueID = "WorkerThreadPoolThread";
+}
+
+WorkerThreadPoolThread::~WorkerThreadPoolThread() {
+	this->pool = NULL;
+}
+
+void WorkerThreadPoolThread::setQuitStatus(bool value) {
+	BaseThread::setQuitStatus(value);
+	if(value == true && this->pool != NULL) {
+		this->pool->semTaskQueued.signal();
+	}
+}
+
+bool WorkerThreadPoolThread::canShutdown(bool deleteSelfIfShutdownDelayed) {
+	bool ret = (getExecutingTask() == false);
+	if(ret == false && deleteSelfIfShutdownDelayed == true) {
+		setDeleteSelfOnExecutionDone(deleteSelfIfShutdownDelayed);
+		deleteSelfIfRequired();
+		signalQuit();
+	}
+	return ret;
+}
+
+void WorkerThreadPoolThread::execute() {
+	RunningStatusSafeWrapper runningStatus(this);
+	try {
+		if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d] uniqueID [%s]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,this->getUniqueID().c_str());
+
+		for(;this->pool != NULL;) {
+			if(getQuitStatus() == true) {
+				break;
+			}
+
+			this->pool->semTaskQueued.waitTillSignalled();
+
+			if(getQuitStatus() == true) {
+				break;
+			}
+
+			WorkerThreadTask *task = this->pool->popPendingTask();
+			if(task != NULL) {
+				ExecutingTaskSafeWrapper safeExecutingTaskMutex(this);
+				this->pool->runTask(task,this);
+			}
+		}
+
+		if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d] uniqueID [%s] END\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,this->getUniqueID().c_str());
+	}
+	catch(const exception &ex) {
+		SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] Error [%s]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,ex.what());
+		throw megaglest_runtime_error(ex.what());
+	}
+}
+
+// =====================================================
+//	class WorkerThreadPool
+// =====================================================
+
+WorkerThreadPool::WorkerThreadPool(string poolName, int threadCount) :
+	mutexTasks(new Mutex(CODE_AT_LINE)) {
+
+	this->poolName = poolName;
+	this->unfinishedTaskCount = 0;
+
+	for(int index = 0; index < threadCount; ++index) {
+		WorkerThreadPoolThread *worker = new WorkerThreadPoolThread(this);
+		worker->setUniqueID(poolName + "_" + intToStr(index));
+		worker->start();
+		workerThreads.push_back(worker);
+	}
+}
+
+WorkerThreadPool::~WorkerThreadPool() {
+	MutexSafeWrapper safeMutex(mutexTasks,CODE_AT_LINE);
+	unfinishedTaskCount -= (int)pendingTasks.size();
+	pendingTasks.clear();
+	safeMutex.ReleaseLock();
+
+	for(unsigned int index = 0; index < workerThreads.size(); ++index) {
+		workerThreads[index]->signalQuit();
+	}
+	for(unsigned int index = 0; index < workerThreads.size(); ++index) {
+		WorkerThreadPoolThread *worker = workerThreads[index];
+		if(worker->shutdownAndWait() == true) {
+			delete worker;
+		}
+		else {
+			worker->canShutdown(true);
+		}
+	}
+	workerThreads.clear();
+
+	delete mutexTasks;
+	mutexTasks = NULL;
+}
+
+void WorkerThreadPool::queueTask(WorkerThreadTask *task) {
+	if(task == NULL) {
+		return;
+	}
+	MutexSafeWrapper safeMutex(mutexTasks,CODE_AT_LINE);
+	unfinishedTaskCount++;
+	if(workerThreads.empty() == true) {
+		safeMutex.ReleaseLock();
+		runTask(task,NULL);
+		return;
+	}
+	pendingTasks.push_back(task);
+	safeMutex.ReleaseLock();
+
+	semTaskQueued.signal();
+}
+
+WorkerThreadTask * WorkerThreadPool::popPendingTask() {
+	MutexSafeWrapper safeMutex(mutexTasks,CODE_AT_LINE);
+	if(pendingTasks.empty() == true) {
+		return NULL;
+	}
+	WorkerThreadTask *task = pendingTasks.front();
+	pendingTasks.pop_front();
+	return task;
+}
+
+void WorkerThreadPool::runTask(WorkerThreadTask *task, BaseThread *callingThread) {
+	try {
+		task->executeTask(callingThread);
+	}
+	catch(const exception &ex) {
+		SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] pool [%s] Error [%s]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,poolName.c_str(),ex.what());
+		task->setErrorMessage(ex.what());
+	}
+
+	MutexSafeWrapper safeMutex(mutexTasks,CODE_AT_LINE);
+	completedTasks.push_back(task);
+	unfinishedTaskCount--;
+	safeMutex.ReleaseLock();
+
+	semTaskCompleted.signal();
+}
+
+vector<WorkerThreadTask *> WorkerThreadPool::popCompletedTasks() {
+	vector<WorkerThreadTask *> result;
+	MutexSafeWrapper safeMutex(mutexTasks,CODE_AT_LINE);
+	result.swap(completedTasks);
+	return result;
+}
+
+int WorkerThreadPool::getUnfinishedTaskCount() {
+	MutexSafeWrapper safeMutex(mutexTasks,CODE_AT_LINE);
+	return unfinishedTaskCount;
+}
+
+bool WorkerThreadPool::waitForAllTasks(int waitMilliseconds) {
+	Chrono chrono;
+	chrono.start();
+	for(;;) {
+		WorkerThreadTask *task = popPendingTask();
+		if(task != NULL) {
+			runTask(task,NULL);
+			continue;
+		}
+		if(getUnfinishedTaskCount() <= 0) {
+			return true;
+		}
+		if(waitMilliseconds >= 0 && chrono.getMillis() >= waitMilliseconds) {
+			return false;
+		}
+		semTaskCompleted.waitTillSignalled(5);
+	}
+	return true;
+}
+
 }}//end namespace
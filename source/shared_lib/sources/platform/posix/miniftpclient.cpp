@@ -19,9 +19,12 @@
 #include <algorithm>
 #include "conversion.h"
 #include "platform_util.h"
+#include "checksum.h"
+#include "compression_utils.h"
 
 using namespace Shared::Util;
 using namespace Shared::PlatformCommon;
+using namespace Shared::CompressionUtil;
 
 namespace Shared { namespace PlatformCommon {
 
@@ -470,9 +473,7 @@ void FTPClientThread::addTempFileToRequests(string fileName,string URL) {
 }
 
 void FTPClientThread::getTilesetFromServer(pair<string,string> tileSetName) {
-	bool findArchive = executeShellCommand(
-			this->fileArchiveExtractCommand,
-			this->fileArchiveExtractCommandSuccessResult);
+	bool findArchive = canExtractArchive(tileSetName.second);
 
 	pair<FTP_Client_ResultType,string> result = make_pair(ftp_crt_FAIL,"");
 	if(findArchive == true) {
@@ -587,12 +588,6 @@ pair<FTP_Client_ResultType,string> FTPClientThread::getTilesetFromServer(
     	    string destRootArchiveFolder = this->tilesetsPath.second;
    	        endPathWithSlash(destRootArchiveFolder);
 
-			string extractCmd = getFullFileArchiveExtractCommand(
-					this->fileArchiveExtractCommand,
-					this->fileArchiveExtractCommandParameters,
-					destRootArchiveFolder,
-					destRootArchiveFolder + tileSetName.first + this->fileArchiveExtension);
-
 			static string mutexOwnerId = string(__FILE__) + string("_") + intToStr(__LINE__);
 		    MutexSafeWrapper safeMutex(this->getProgressMutex(),mutexOwnerId);
 		    this->getProgressMutex()->setOwnerId(mutexOwnerId);
@@ -606,7 +601,7 @@ pair<FTP_Client_ResultType,string> FTPClientThread::getTilesetFromServer(
 		    }
 		    safeMutex.ReleaseLock();
 
-			if(executeShellCommand(extractCmd,this->fileArchiveExtractCommandSuccessResult,this) == false) {
+			if(extractArchive(destFileSaveAs,destRootArchiveFolder,true) == false) {
 				result.first = ftp_crt_FAIL;
 				result.second = "failed to extract archive!";
 			}
@@ -616,6 +611,7 @@ pair<FTP_Client_ResultType,string> FTPClientThread::getTilesetFromServer(
     	else {
     		if(getFolderContents == true) {
     			removeFile(destFileSaveAs);
+    			Checksum::clearFileCache();
 
     			for(unsigned int i = 0; i < wantDirListOnly.size(); ++i) {
     				string fileFromList = wantDirListOnly[i];
@@ -660,9 +656,7 @@ pair<FTP_Client_ResultType,string> FTPClientThread::getTilesetFromServer(
 
 void FTPClientThread::getTechtreeFromServer(pair<string,string> techtreeName) {
 	pair<FTP_Client_ResultType,string> result = make_pair(ftp_crt_FAIL,"");
-	bool findArchive = executeShellCommand(
-			this->fileArchiveExtractCommand,
-			this->fileArchiveExtractCommandSuccessResult);
+	bool findArchive = canExtractArchive(techtreeName.second);
 	if(findArchive == true) {
 		if(techtreeName.second != "") {
 			result = getTechtreeFromServer(techtreeName, "", "");
@@ -713,12 +707,6 @@ pair<FTP_Client_ResultType,string>  FTPClientThread::getTechtreeFromServer(pair<
 
     // Extract the archive
     if(result.first == ftp_crt_SUCCESS) {
-        string extractCmd = getFullFileArchiveExtractCommand(
-        		this->fileArchiveExtractCommand,
-        		this->fileArchiveExtractCommandParameters,
-        		destRootArchiveFolder,
-        		destRootArchiveFolder + techtreeName.first + this->fileArchiveExtension);
-
 		static string mutexOwnerId = string(__FILE__) + string("_") + intToStr(__LINE__);
 	    MutexSafeWrapper safeMutex(this->getProgressMutex(),mutexOwnerId);
 	    this->getProgressMutex()->setOwnerId(mutexOwnerId);
@@ -731,7 +719,7 @@ pair<FTP_Client_ResultType,string>  FTPClientThread::getTechtreeFromServer(pair<
 	    }
 	    safeMutex.ReleaseLock();
 
-        if(executeShellCommand(extractCmd,this->fileArchiveExtractCommandSuccessResult,this) == false) {
+        if(extractArchive(destFileSaveAs,destRootArchiveFolder,true) == false) {
         	result.first = ftp_crt_FAIL;
         	result.second = "failed to extract archive!";
         }
@@ -743,9 +731,7 @@ pair<FTP_Client_ResultType,string>  FTPClientThread::getTechtreeFromServer(pair<
 
 void FTPClientThread::getScenarioFromServer(pair<string,string> fileName) {
 	pair<FTP_Client_ResultType,string> result = make_pair(ftp_crt_FAIL,"");
-	bool findArchive = executeShellCommand(
-			this->fileArchiveExtractCommand,
-			this->fileArchiveExtractCommandSuccessResult);
+	bool findArchive = canExtractArchive(fileName.second);
 	if(findArchive == true) {
 		result = getScenarioInternalFromServer(fileName);
 	}
@@ -786,12 +772,6 @@ pair<FTP_Client_ResultType,string>  FTPClientThread::getScenarioInternalFromServ
 
     // Extract the archive
     if(result.first == ftp_crt_SUCCESS) {
-        string extractCmd = getFullFileArchiveExtractCommand(
-        		this->fileArchiveExtractCommand,
-        		this->fileArchiveExtractCommandParameters,
-        		destRootArchiveFolder,
-        		destRootArchiveFolder + fileName.first + this->fileArchiveExtension);
-
 		static string mutexOwnerId = string(__FILE__) + string("_") + intToStr(__LINE__);
 	    MutexSafeWrapper safeMutex(this->getProgressMutex(),mutexOwnerId);
 	    this->getProgressMutex()->setOwnerId(mutexOwnerId);
@@ -804,7 +784,7 @@ pair<FTP_Client_ResultType,string>  FTPClientThread::getScenarioInternalFromServ
 	    }
 	    safeMutex.ReleaseLock();
 
-        if(executeShellCommand(extractCmd,this->fileArchiveExtractCommandSuccessResult,this) == false) {
+        if(extractArchive(destFileSaveAs,destRootArchiveFolder,true) == false) {
         	result.first = ftp_crt_FAIL;
         	result.second = "failed to extract archive!";
         }
@@ -852,13 +832,7 @@ pair<FTP_Client_ResultType,string>  FTPClientThread::getFileInternalFromServer(p
     	string ext = extractExtension(destFileSaveAs);
     	if(("." + ext) == fileArchiveExtension) {
     		string destRootArchiveFolder = extractDirectoryPathFromFile(destFileSaveAs);
-			string extractCmd = getFullFileArchiveExtractCommand(
-					this->fileArchiveExtractCommand,
-					this->fileArchiveExtractCommandParameters,
-					destRootArchiveFolder,
-					destFileSaveAs);
-
-			if(executeShellCommand(extractCmd,this->fileArchiveExtractCommandSuccessResult) == false) {
+			if(extractArchive(destFileSaveAs,destRootArchiveFolder,false) == false) {
 				result.first = ftp_crt_FAIL;
 				result.second = "failed to extract archive!";
 			}
@@ -917,13 +891,7 @@ pair<FTP_Client_ResultType,string>  FTPClientThread::getTempFileInternalFromServ
     	string ext = extractExtension(destFileSaveAs);
     	if(("." + ext) == fileArchiveExtension) {
     		string destRootArchiveFolder = extractDirectoryPathFromFile(destFileSaveAs);
-			string extractCmd = getFullFileArchiveExtractCommand(
-					this->fileArchiveExtractCommand,
-					this->fileArchiveExtractCommandParameters,
-					destRootArchiveFolder,
-					destFileSaveAs);
-
-			if(executeShellCommand(extractCmd,this->fileArchiveExtractCommandSuccessResult) == false) {
+			if(extractArchive(destFileSaveAs,destRootArchiveFolder,false) == false) {
 				result.first = ftp_crt_FAIL;
 				result.second = "failed to extract archive!";
 			}
@@ -933,6 +901,35 @@ pair<FTP_Client_ResultType,string>  FTPClientThread::getTempFileInternalFromServ
     return result;
 }
 
+bool FTPClientThread::canExtractArchive(const string &remotePath) {
+	// zip archives are extracted in process, everything else needs the
+	// configured external archive tool
+	if(EndsWith(remotePath, ".zip") == true) {
+		return true;
+	}
+	return executeShellCommand(
+			this->fileArchiveExtractCommand,
+			this->fileArchiveExtractCommandSuccessResult);
+}
+
+bool FTPClientThread::extractArchive(const string &archiveFile,
+		const string &destRootArchiveFolder, bool useShellCallback) {
+	// the content checksums of the extracted files change
+	Checksum::clearFileCache();
+
+	if(isZIPArchive(archiveFile) == true) {
+		return extractZIPArchiveToFolder(archiveFile, destRootArchiveFolder, true);
+	}
+
+	string extractCmd = getFullFileArchiveExtractCommand(
+			this->fileArchiveExtractCommand,
+			this->fileArchiveExtractCommandParameters,
+			destRootArchiveFolder,
+			archiveFile);
+	return executeShellCommand(extractCmd,this->fileArchiveExtractCommandSuccessResult,
+			(useShellCallback == true ? this : NULL));
+}
+
 pair<FTP_Client_ResultType,string>  FTPClientThread::getFileFromServer(FTP_Client_CallbackType downloadType,
 		pair<string,string> fileNameTitle,
 		string remotePath, string destFileSaveAs,
@@ -149,6 +149,11 @@ StaticSoundSource::~StaticSoundSource() {
 void StaticSoundSource::play(StaticSound* sound) {
 	if(SystemFlags::getSystemSettingType(SystemFlags::debugSound).enabled) SystemFlags::OutputDebug(SystemFlags::debugSound,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
+	// lazily loaded sounds are decoded the first time they are played
+	if(sound->ensureLoaded() == false) {
+		return;
+	}
+
 	if(bufferAllocated) {
 		stop();
 		alDeleteBuffers(1, &buffer);
@@ -43,12 +43,207 @@ Sound::Sound() {
 	soundFileLoader = 0;
 }
 
+// =====================================================
+//	class StaticSoundData
+// =====================================================
+
+StaticSoundData::StaticSoundData(const string &path) {
+	this->path= path;
+	samples= NULL;
+	refCount= 0;
+	lastUsed= 0;
+	loadFailed= false;
+	headerRead= false;
+}
+
+StaticSoundData::~StaticSoundData() {
+	delete [] samples;
+	samples= NULL;
+}
+
+// =====================================================
+//	class StaticSoundCache
+// =====================================================
+
+StaticSoundCache::StaticSoundCache() : mutexCache(new Mutex(CODE_AT_LINE)) {
+	memoryBudget= 0;
+	memoryUsed= 0;
+	useCounter= 0;
+}
+
+StaticSoundCache::~StaticSoundCache() {
+	for(SoundDataMap::iterator iterMap = soundData.begin();
+		iterMap != soundData.end(); ++iterMap) {
+		delete iterMap->second;
+	}
+	soundData.clear();
+	memoryUsed= 0;
+
+	delete mutexCache;
+	mutexCache= NULL;
+}
+
+StaticSoundCache &StaticSoundCache::getInstance() {
+	// never freed: static StaticSound members (CoreData) release their
+	// data from their destructors during static teardown
+	static StaticSoundCache *staticSoundCache= new StaticSoundCache();
+	return *staticSoundCache;
+}
+
+SoundFileLoader *StaticSoundCache::newLoader(const string &path) {
+	string ext = (path.empty() == false ? path.substr(path.find_last_of('.')+1) : "");
+	SoundFileLoader *soundFileLoader= SoundFileLoaderFactory::getInstance()->newInstance(ext);
+	if(soundFileLoader == NULL) {
+		throw megaglest_runtime_error("soundFileLoader == NULL");
+	}
+	return soundFileLoader;
+}
+
+StaticSoundData *StaticSoundCache::acquire(const string &path) {
+	MutexSafeWrapper safeMutex(mutexCache,CODE_AT_LINE);
+
+	StaticSoundData *data= NULL;
+	SoundDataMap::iterator iterFind = soundData.find(path);
+	if(iterFind != soundData.end()) {
+		data= iterFind->second;
+	}
+	else {
+		data= new StaticSoundData(path);
+		soundData[path]= data;
+	}
+	data->refCount++;
+	return data;
+}
+
+void StaticSoundCache::readHeader(StaticSoundData *data) {
+	MutexSafeWrapper safeMutex(mutexCache,CODE_AT_LINE);
+
+	if(data->samples != NULL || data->headerRead == true) {
+		return;
+	}
+
+	// only the header, so a missing or broken file is still reported
+	// when the techtree loads and not on its first play
+	SoundFileLoader *soundFileLoader= newLoader(data->path);
+	try {
+		soundFileLoader->open(data->path, &data->info);
+		soundFileLoader->close();
+	}
+	catch(...) {
+		data->loadFailed= true;
+		delete soundFileLoader;
+		throw;
+	}
+	delete soundFileLoader;
+	data->headerRead= true;
+}
+
+void StaticSoundCache::release(StaticSoundData *data) {
+	if(data == NULL) {
+		return;
+	}
+	MutexSafeWrapper safeMutex(mutexCache,CODE_AT_LINE);
+
+	data->refCount--;
+	if(data->refCount <= 0) {
+		freeSamples(data);
+		soundData.erase(data->path);
+		delete data;
+	}
+}
+
+bool StaticSoundCache::decode(StaticSoundData *data) {
+	MutexSafeWrapper safeMutex(mutexCache,CODE_AT_LINE);
+
+	data->lastUsed= ++useCounter;
+	if(data->samples != NULL) {
+		return true;
+	}
+	// don't hit the disk again on every play for a broken file
+	if(data->loadFailed == true) {
+		return false;
+	}
+	data->loadFailed= true;
+
+	const string &path= data->path;
+	SoundFileLoader *soundFileLoader= newLoader(path);
+
+	int8 *samples= NULL;
+	try {
+		soundFileLoader->open(path, &data->info);
+		samples= new int8[data->info.getSize()];
+		soundFileLoader->read(samples, data->info.getSize());
+		soundFileLoader->close();
+	}
+	catch(...) {
+		delete [] samples;
+		delete soundFileLoader;
+		throw;
+	}
+	delete soundFileLoader;
+
+	data->samples= samples;
+	data->loadFailed= false;
+	data->headerRead= true;
+	memoryUsed += data->info.getSize();
+
+	evictToBudget(data);
+	return true;
+}
+
+void StaticSoundCache::freeSamples(StaticSoundData *data) {
+	if(data->samples != NULL) {
+		delete [] data->samples;
+		data->samples= NULL;
+		memoryUsed -= data->info.getSize();
+	}
+}
+
+void StaticSoundCache::evictToBudget(StaticSoundData *keep) {
+	// the sound player copies the samples into its own buffer when
+	// playing, so any decoded sound except the one just requested
+	// can go and will be decoded again the next time it is played
+	while(memoryBudget > 0 && memoryUsed > memoryBudget) {
+		StaticSoundData *oldest= NULL;
+		for(SoundDataMap::iterator iterMap = soundData.begin();
+			iterMap != soundData.end(); ++iterMap) {
+			StaticSoundData *data= iterMap->second;
+			if(data != keep && data->samples != NULL &&
+				(oldest == NULL || data->lastUsed < oldest->lastUsed)) {
+				oldest= data;
+			}
+		}
+		if(oldest == NULL) {
+			break;
+		}
+		freeSamples(oldest);
+	}
+}
+
+void StaticSoundCache::clearDecoded() {
+	MutexSafeWrapper safeMutex(mutexCache,CODE_AT_LINE);
+
+	for(SoundDataMap::iterator iterMap = soundData.begin();
+		iterMap != soundData.end(); ++iterMap) {
+		freeSamples(iterMap->second);
+	}
+}
+
+void StaticSoundCache::setMemoryBudget(uint64 bytes) {
+	MutexSafeWrapper safeMutex(mutexCache,CODE_AT_LINE);
+
+	memoryBudget= bytes;
+	evictToBudget(NULL);
+}
+
 // =====================================================
 //	class StaticSound
 // =====================================================
 
+bool StaticSound::lazyLoading= false;
+
 StaticSound::StaticSound() {
-	samples= NULL;
+	data= NULL;
 	soundFileLoader = NULL;
 	fileName = "";
 }
@@ -58,15 +253,9 @@ StaticSound::~StaticSound() {
 }
 
 void StaticSound::close() {
-	if(samples != NULL) {
-		delete [] samples;
-		samples = NULL;
-	}
-
-	if(soundFileLoader!=NULL){
-		soundFileLoader->close();
-		delete soundFileLoader;
-		soundFileLoader= NULL;
+	if(data != NULL) {
+		StaticSoundCache::getInstance().release(data);
+		data= NULL;
 	}
 }
 
@@ -78,19 +267,29 @@ void StaticSound::load(const string &path) {
 	if(GlobalStaticFlags::getIsNonGraphicalModeEnabled() == true) {
 		return;
 	}
-	string ext = (path.empty() == false ? path.substr(path.find_last_of('.')+1) : "");
-	soundFileLoader= SoundFileLoaderFactory::getInstance()->newInstance(ext);
 
-	if(soundFileLoader == NULL) {
-		throw megaglest_runtime_error("soundFileLoader == NULL");
+	data= StaticSoundCache::getInstance().acquire(path);
+	if(data->isDecoded() == true) {
+		info= *data->getInfo();
 	}
-	soundFileLoader->open(path, &info);
-	samples= new int8[info.getSize()];
-	soundFileLoader->read(samples, info.getSize());
-	soundFileLoader->close();
+	else if(lazyLoading == false) {
+		ensureLoaded();
+	}
+	else {
+		StaticSoundCache::getInstance().readHeader(data);
+		info= *data->getInfo();
+	}
+}
 
-	delete soundFileLoader;
-	soundFileLoader= NULL;
+bool StaticSound::ensureLoaded() {
+	if(data == NULL) {
+		return false;
+	}
+	bool result= StaticSoundCache::getInstance().decode(data);
+	if(result == true) {
+		info= *data->getInfo();
+	}
+	return result;
 }
 
 // =====================================================
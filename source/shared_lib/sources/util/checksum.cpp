@@ -174,6 +174,55 @@ void Checksum::addFile(const string &path) {
 	}
 }
 
+void Checksum::addFileData(const string &path, const char *buf, size_t size) {
+	addString(lastFile(path));
+
+	bool isXMLFile = (EndsWith(path, ".xml") == true);
+
+	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d] size = %d, path [%s], isXMLFile = %d\n",__FILE__,__FUNCTION__,__LINE__,size, path.c_str(),isXMLFile);
+
+	if(isXMLFile == true) {
+		bool inCommentTag=false;
+		for(std::size_t i = 0; i < size; ++i) {
+			// Ignore Spaces in XML files as they are
+			// ONLY for formatting
+			//if(isXMLFile == true) {
+				if(inCommentTag == true) {
+					if(buf[i] == '>' && i >= 3 && buf[i-1] == '-' && buf[i-2] == '-') {
+						inCommentTag = false;
+						//printf("TURNING OFF comment TAG, i = %d [%c]",i,buf[i]);
+						if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d] i = %d\n",__FILE__,__FUNCTION__,__LINE__,i);
+					}
+					else {
+						//printf("SKIPPING XML comment character, i = %d [%c]",i,buf[i]);
+						if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d] i = %d\n",__FILE__,__FUNCTION__,__LINE__,i);
+					}
+					continue;
+				}
+				//else if(buf[i] == '-' && i >= 4 && buf[i-1] == '-' && buf[i-2] == '!' && buf[i-3] == '<') {
+				else if(buf[i] == '<' && i+4 < size && buf[i+1] == '!' && buf[i+2] == '-' && buf[i+3] == '-') {
+					inCommentTag = true;
+					//printf("TURNING ON comment TAG, i = %d [%c]",i,buf[i]);
+					if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d] i = %d\n",__FILE__,__FUNCTION__,__LINE__,i);
+					continue;
+				}
+				else if(buf[i] == ' ' || buf[i] == '\t' || buf[i] == '\n' || buf[i] == '\r') {
+					//printf("SKIPPING special character, i = %d [%c]",i,buf[i]);
+					if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d] i = %d\n",__FILE__,__FUNCTION__,__LINE__,i);
+					continue;
+				}
+			//}
+			uint32 cipher = addByte(buf[i]);
+
+			if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d] %d / %d, cipher = %u\n",__FILE__,__FUNCTION__,__LINE__,i,size, cipher);
+		}
+	}
+	else {
+		uint32 cipher = addBytes(buf,size);
+		if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d] %d, cipher = %u\n",__FILE__,__FUNCTION__,__LINE__,size, cipher);
+	}
+}
+
 bool Checksum::addFileToSum(const string &path) {
 
 // OLD SLOW FILE I/O
@@ -292,9 +341,6 @@ bool Checksum::addFileToSum(const string &path) {
 
     if (ifs) {
         fileExists = true;
-		addString(lastFile(path));
-
-		bool isXMLFile = (EndsWith(path, ".xml") == true);
 
 		// Determine the file length
 		ifs.seekg(0, ios::end);
@@ -305,51 +351,12 @@ bool Checksum::addFileToSum(const string &path) {
 		// Create a vector to store the data
 		std::vector<char> buf(bufSize);
 		// Load the data
-		ifs.read((char*)&buf[0], buf.size());
-
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d] buf.size() = %d, path [%s], isXMLFile = %d\n",__FILE__,__FUNCTION__,__LINE__,buf.size(), path.c_str(),isXMLFile);
-
-		if(isXMLFile == true) {
-			bool inCommentTag=false;
-			for(std::size_t i = 0; i < buf.size(); ++i) {
-				// Ignore Spaces in XML files as they are
-				// ONLY for formatting
-				//if(isXMLFile == true) {
-					if(inCommentTag == true) {
-						if(buf[i] == '>' && i >= 3 && buf[i-1] == '-' && buf[i-2] == '-') {
-							inCommentTag = false;
-							//printf("TURNING OFF comment TAG, i = %d [%c]",i,buf[i]);
-							if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d] i = %d\n",__FILE__,__FUNCTION__,__LINE__,i);
-						}
-						else {
-							//printf("SKIPPING XML comment character, i = %d [%c]",i,buf[i]);
-							if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d] i = %d\n",__FILE__,__FUNCTION__,__LINE__,i);
-						}
-						continue;
-					}
-					//else if(buf[i] == '-' && i >= 4 && buf[i-1] == '-' && buf[i-2] == '!' && buf[i-3] == '<') {
-					else if(buf[i] == '<' && i+4 < bufSize && buf[i+1] == '!' && buf[i+2] == '-' && buf[i+3] == '-') {
-						inCommentTag = true;
-						//printf("TURNING ON comment TAG, i = %d [%c]",i,buf[i]);
-						if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d] i = %d\n",__FILE__,__FUNCTION__,__LINE__,i);
-						continue;
-					}
-					else if(buf[i] == ' ' || buf[i] == '\t' || buf[i] == '\n' || buf[i] == '\r') {
-						//printf("SKIPPING special character, i = %d [%c]",i,buf[i]);
-						if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d] i = %d\n",__FILE__,__FUNCTION__,__LINE__,i);
-						continue;
-					}
-				//}
-				uint32 cipher = addByte(buf[i]);
-
-				if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d] %d / %d, cipher = %u\n",__FILE__,__FUNCTION__,__LINE__,i,buf.size(), cipher);
-			}
-		}
-		else {
-			uint32 cipher = addBytes(&buf[0],buf.size());
-			if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d] %d, cipher = %u\n",__FILE__,__FUNCTION__,__LINE__,buf.size(), cipher);
+		if(buf.empty() == false) {
+			ifs.read((char*)&buf[0], buf.size());
 		}
 
+		addFileData(path, (buf.empty() == false ? &buf[0] : NULL), buf.size());
+
 		// Close the file
 		ifs.close();
     }
@@ -424,6 +431,14 @@ void Checksum::removeFileFromCache(const string file) {
     }
 }
 
+void Checksum::addFileDataToCache(const string &path, const char *data, size_t size) {
+	Checksum fileResult;
+	fileResult.addFileData(path, data, size);
+
+	MutexSafeWrapper safeMutexSocketDestructorFlag(&Checksum::fileListCacheSynchAccessor,string(__FILE__) + "_" + intToStr(__LINE__));
+	Checksum::fileListCache[path] = fileResult.getSum();
+}
+
 void Checksum::clearFileCache() {
 	MutexSafeWrapper safeMutexSocketDestructorFlag(&Checksum::fileListCacheSynchAccessor,string(__FILE__) + "_" + intToStr(__LINE__));
     Checksum::fileListCache.clear();
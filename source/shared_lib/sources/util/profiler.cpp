@@ -11,15 +11,22 @@
 
 #include "profiler.h"
 
-#ifdef SL_PROFILE
-
+#include <SDL.h>
+#include <stdio.h>
+#include <algorithm>
 #include <stdexcept>
+#include "thread.h"
+#include "util.h"
+#include "conversion.h"
 #include "leak_dumper.h"
 
 using namespace std;
+using namespace Shared::Platform;
 
 namespace Shared{ namespace Util{
 
+#ifdef SL_PROFILE
+
 // =====================================================
 //	class Section
 // =====================================================
@@ -124,6 +131,266 @@ void Profiler::sectionEnd(const string &name){
 	}
 }
 
-}};//end namespace
+#endif //SL_PROFILE
 
+// =====================================================
+//	class ProfileThreadBuffer
+// =====================================================
+
+class ProfileThreadBuffer {
+public:
+	struct Event {
+		const char *name;
+		int64 startNanos;
+		int64 endNanos;
+		int frame;
+	};
+
+	unsigned long threadId;
+	vector<Event> events;
+	// count of zones ever added, only the owning thread writes it
+	SDL_atomic_t written;
+
+	ProfileThreadBuffer(unsigned long threadId, int size) : events(size) {
+		this->threadId = threadId;
+		SDL_AtomicSet(&written, 0);
+	}
+};
+
+static bool compareProfileEvents(const ProfileThreadBuffer::Event &a, const ProfileThreadBuffer::Event &b) {
+	// parents before the zones they contain
+	if(a.startNanos != b.startNanos) {
+		return a.startNanos < b.startNanos;
+	}
+	return a.endNanos > b.endNanos;
+}
+
+static void writeJSONString(FILE *f, const string &value) {
+	fputc('"', f);
+	for(unsigned int i = 0; i < value.size(); ++i) {
+		if(value[i] == '"' || value[i] == '\\') {
+			fputc('\\', f);
+		}
+		fputc(value[i], f);
+	}
+	fputc('"', f);
+}
+
+static FILE *openProfileFile(const string &path) {
+#ifdef WIN32
+	return _wfopen(utf8_decode(path).c_str(), L"w");
+#else
+	return fopen(path.c_str(), "w");
 #endif
+}
+
+// =====================================================
+//	class FrameProfiler
+// =====================================================
+
+bool FrameProfiler::recording = false;
+
+FrameProfiler::FrameProfiler() {
+	mutexThreadBuffers = new Mutex(CODE_AT_LINE);
+	threadBufferTLS = SDL_TLSCreate();
+	eventsPerThread = 65536;
+	startFrame = -1;
+	endFrame = -1;
+	currentFrame = 0;
+	startNanos = 0;
+}
+
+FrameProfiler::~FrameProfiler() {
+	recording = false;
+	for(unsigned int i = 0; i < threadBuffers.size(); ++i) {
+		delete threadBuffers[i];
+	}
+	threadBuffers.clear();
+	delete mutexThreadBuffers;
+	mutexThreadBuffers = NULL;
+}
+
+FrameProfiler &FrameProfiler::getInstance() {
+	static FrameProfiler profiler;
+	return profiler;
+}
+
+void FrameProfiler::setFrameRange(int startFrame, int endFrame, const string &outputPath) {
+	stopRecording();
+	this->startFrame = startFrame;
+	this->endFrame = endFrame;
+	this->outputPath = outputPath;
+}
+
+void FrameProfiler::setThreadName(const string &name) {
+	MutexSafeWrapper safeMutex(mutexThreadBuffers,CODE_AT_LINE);
+	threadNames[Thread::getCurrentThreadId()] = name;
+}
+
+ProfileThreadBuffer *FrameProfiler::getThreadBuffer() {
+	ProfileThreadBuffer *buffer = static_cast<ProfileThreadBuffer *>(SDL_TLSGet(threadBufferTLS));
+	if(buffer == NULL) {
+		// once per thread, every later zone goes to the buffer without locking
+		buffer = new ProfileThreadBuffer(Thread::getCurrentThreadId(), eventsPerThread);
+		MutexSafeWrapper safeMutex(mutexThreadBuffers,CODE_AT_LINE);
+		threadBuffers.push_back(buffer);
+		safeMutex.ReleaseLock();
+
+		SDL_TLSSet(threadBufferTLS, buffer, NULL);
+	}
+	return buffer;
+}
+
+void FrameProfiler::addZone(const char *name, int64 zoneStartNanos, int64 zoneEndNanos) {
+	ProfileThreadBuffer *buffer = getThreadBuffer();
+	int index = SDL_AtomicGet(&buffer->written);
+
+	ProfileThreadBuffer::Event &event = buffer->events[index % buffer->events.size()];
+	event.name = name;
+	event.startNanos = zoneStartNanos;
+	event.endNanos = zoneEndNanos;
+	event.frame = currentFrame;
+
+	SDL_AtomicSet(&buffer->written, index + 1);
+}
+
+void FrameProfiler::beginFrame(int frame) {
+	currentFrame = frame;
+	if(startFrame < 0) {
+		return;
+	}
+
+	if(recording == false && frame >= startFrame && frame <= endFrame) {
+		MutexSafeWrapper safeMutex(mutexThreadBuffers,CODE_AT_LINE);
+		for(unsigned int i = 0; i < threadBuffers.size(); ++i) {
+			SDL_AtomicSet(&threadBuffers[i]->written, 0);
+		}
+		safeMutex.ReleaseLock();
+
+		startNanos = Chrono::getCurNanos();
+		recording = true;
+	}
+	else if(frame > endFrame) {
+		stopRecording();
+	}
+}
+
+void FrameProfiler::stopRecording() {
+	if(recording == true) {
+		recording = false;
+		writeProfile();
+	}
+	startFrame = -1;
+	endFrame = -1;
+}
+
+void FrameProfiler::writeProfile() {
+	string traceFile = outputPath + ".json";
+	string foldedFile = outputPath + ".folded";
+
+	FILE *trace = openProfileFile(traceFile);
+	FILE *folded = openProfileFile(foldedFile);
+	if(trace == NULL || folded == NULL) {
+		if(trace != NULL) fclose(trace);
+		if(folded != NULL) fclose(folded);
+		SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] Can not open profile output [%s]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,outputPath.c_str());
+		printf("Can not open profile output [%s]\n",outputPath.c_str());
+		return;
+	}
+
+	MutexSafeWrapper safeMutex(mutexThreadBuffers,CODE_AT_LINE);
+
+	fprintf(trace, "{\"traceEvents\":[\n");
+	bool firstEvent = true;
+	int64 droppedCount = 0;
+	std::map<string, int64> foldedStacks;
+
+	for(unsigned int threadIndex = 0; threadIndex < threadBuffers.size(); ++threadIndex) {
+		ProfileThreadBuffer *buffer = threadBuffers[threadIndex];
+		const int written = SDL_AtomicGet(&buffer->written);
+		const int size = (int)buffer->events.size();
+		const int first = (written > size ? written - size : 0);
+		if(written == 0) {
+			continue;
+		}
+		droppedCount += first;
+
+		string threadName = "thread " + intToStr(threadIndex);
+		if(threadNames.find(buffer->threadId) != threadNames.end()) {
+			threadName = threadNames[buffer->threadId];
+		}
+		else if(buffer->threadId == Thread::getMainThreadId()) {
+			threadName = "main";
+		}
+
+		vector<ProfileThreadBuffer::Event> events;
+		events.reserve(written - first);
+		for(int i = first; i < written; ++i) {
+			events.push_back(buffer->events[i % size]);
+		}
+		std::sort(events.begin(), events.end(), compareProfileEvents);
+
+		fprintf(trace, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":",
+				(firstEvent ? "" : ",\n"), threadIndex);
+		writeJSONString(trace, threadName);
+		fprintf(trace, "}}");
+		firstEvent = false;
+
+		// the zones still open around the current one, for the folded stacks
+		vector<const ProfileThreadBuffer::Event *> openZones;
+		vector<int64> childNanos;
+		for(unsigned int i = 0; i <= events.size(); ++i) {
+			const ProfileThreadBuffer::Event *event = (i < events.size() ? &events[i] : NULL);
+			while(openZones.empty() == false &&
+					(event == NULL || openZones.back()->endNanos <= event->startNanos)) {
+				string stack = threadName;
+				for(unsigned int j = 0; j < openZones.size(); ++j) {
+					stack += ";";
+					stack += openZones[j]->name;
+				}
+				const int64 zoneNanos = openZones.back()->endNanos - openZones.back()->startNanos;
+				foldedStacks[stack] += zoneNanos - childNanos.back();
+
+				openZones.pop_back();
+				childNanos.pop_back();
+				if(childNanos.empty() == false) {
+					childNanos.back() += zoneNanos;
+				}
+			}
+			if(event == NULL) {
+				break;
+			}
+			openZones.push_back(event);
+			childNanos.push_back(0);
+
+			fprintf(trace, ",\n{\"name\":");
+			writeJSONString(trace, event->name);
+			fprintf(trace, ",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u,\"args\":{\"frame\":%d}}",
+					(event->startNanos - startNanos) / 1000.0,
+					(event->endNanos - event->startNanos) / 1000.0,
+					threadIndex, event->frame);
+		}
+	}
+	safeMutex.ReleaseLock();
+
+	fprintf(trace, "\n],\"displayTimeUnit\":\"ns\"}\n");
+	fclose(trace);
+
+	// flame graph tools expect integer counts, the unit is microseconds
+	for(std::map<string, int64>::const_iterator iterMap = foldedStacks.begin();
+		iterMap != foldedStacks.end(); ++iterMap) {
+		if(iterMap->second >= 1000) {
+			fprintf(folded, "%s " MG_I64_SPECIFIER "\n", iterMap->first.c_str(), iterMap->second / 1000);
+		}
+	}
+	fclose(folded);
+
+	const int lastFrame = (currentFrame < endFrame ? currentFrame : endFrame);
+	printf("Profile of frames %d to %d written to [%s] and [%s]", startFrame, lastFrame, traceFile.c_str(), foldedFile.c_str());
+	if(droppedCount > 0) {
+		printf(", " MG_I64_SPECIFIER " older zones were dropped", droppedCount);
+	}
+	printf("\n");
+}
+
+}};//end namespace
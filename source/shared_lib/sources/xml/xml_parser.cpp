@@ -24,6 +24,8 @@
 #include <xercesc/dom/DOM.hpp>
 #include <xercesc/util/PlatformUtils.hpp>
 #include <xercesc/framework/LocalFileFormatTarget.hpp>
+#include <xercesc/framework/MemBufInputSource.hpp>
+#include <xercesc/framework/Wrapper4InputSource.hpp>
 
 #endif
 
@@ -32,6 +34,7 @@
 #include "platform_common.h"
 #include "platform_util.h"
 #include "cache_manager.h"
+#include "compression_utils.h"
 
 #include "rapidxml/rapidxml_print.hpp"
 #include "leak_dumper.h"
@@ -44,6 +47,7 @@ XERCES_CPP_NAMESPACE_USE
 
 using namespace std;
 using namespace Shared::PlatformCommon;
+using namespace Shared::CompressionUtil;
 
 namespace Shared { namespace Xml {
 
@@ -129,13 +133,57 @@ void XmlIo::cleanup() {
 	}
 }
 
+// saved games may be written compressed, xerces only reads them once they
+// are inflated into memory
+static bool loadInflatedXmlFile(const string &path, vector<char> &xml) {
+#ifdef WIN32
+	FILE *fp = _wfopen(utf8_decode(path).c_str(), L"rb");
+#else
+	FILE *fp = fopen(path.c_str(), "rb");
+#endif
+	if(fp == NULL) {
+		return false;
+	}
+
+	vector<unsigned char> data(2);
+	bool deflated = (fread(&data[0], 1, 2, fp) == 2 && isDeflateData(&data[0], 2) == true);
+	if(deflated == true) {
+		unsigned char buffer[8096];
+		size_t readCount = 0;
+		while((readCount = fread(buffer, 1, sizeof(buffer), fp)) > 0) {
+			data.insert(data.end(), buffer, buffer + readCount);
+		}
+	}
+	fclose(fp);
+
+	if(deflated == true) {
+		inflateMemoryToVector(&data[0], data.size(), xml);
+		if(xml.empty() == true) {
+			throw megaglest_runtime_error("Empty compressed xml file: [" + path + "]");
+		}
+	}
+	return deflated;
+}
+
 #if XERCES_VERSION_MAJOR < 3
 	XERCES_CPP_NAMESPACE_QUALIFIER DOMDocument * XmlIo::getRootDOMDocument(const string &path, DOMBuilder *parser, bool noValidation) {
+		vector<char> xml;
+		if(loadInflatedXmlFile(path, xml) == true) {
+			MemBufInputSource source((const XMLByte *)&xml[0], xml.size(), path.c_str(), false);
+			Wrapper4InputSource input(&source, false);
+			return parser->parse(input);
+		}
 		XERCES_CPP_NAMESPACE_QUALIFIER DOMDocument *document= parser->parseURI(path.c_str());
 		return document;
 	}
 #else
 	XERCES_CPP_NAMESPACE_QUALIFIER DOMDocument * XmlIo::getRootDOMDocument(const string &path, DOMLSParser *parser, bool noValidation) {
+		vector<char> xml;
+		if(loadInflatedXmlFile(path, xml) == true) {
+			MemBufInputSource source((const XMLByte *)&xml[0], xml.size(), path.c_str(), false);
+			Wrapper4InputSource input(&source, false);
+			return parser->parse(&input);
+		}
 		XERCES_CPP_NAMESPACE_QUALIFIER DOMDocument *document= parser->parseURI(path.c_str());
 		return document;
 	}
@@ -393,6 +441,17 @@ XmlNode *XmlIoRapid::load(const string &path, const std::map<string,string> &map
         xmlFile.read(&buffer.front(), static_cast<streamsize>(file_size));
         buffer[(unsigned int)file_size] = 0;
 
+        // saved games may be written compressed
+        if(isDeflateData((const unsigned char *)&buffer.front(), (size_t)file_size) == true) {
+        	vector<char> inflated;
+        	inflateMemoryToVector((const unsigned char *)&buffer.front(), (size_t)file_size, inflated);
+        	file_size = (int64)inflated.size();
+        	inflated.resize(inflated.size() + 100, 0);
+        	buffer.swap(inflated);
+
+        	if(showPerfStats) printf("In [%s::%s Line: %d] took msecs: " MG_I64_SPECIFIER " inflated size: " MG_I64_SPECIFIER "\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,chrono.getMillis(),file_size);
+        }
+
         if(showPerfStats) printf("In [%s::%s Line: %d] took msecs: " MG_I64_SPECIFIER "\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,chrono.getMillis());
 
         // This is required because rapidxml seems to choke when we load lua
@@ -511,6 +570,77 @@ void XmlIoRapid::save(const string &path, const XmlNode *node){
 	}
 }
 
+static void appendEscapedXml(string &buffer, const string &value) {
+	for(unsigned int i = 0; i < value.size(); ++i) {
+		switch(value[i]) {
+			case '&':  buffer += "&amp;"; break;
+			case '<':  buffer += "&lt;"; break;
+			case '>':  buffer += "&gt;"; break;
+			case '"':  buffer += "&quot;"; break;
+			case '\'': buffer += "&apos;"; break;
+			default:   buffer += value[i]; break;
+		}
+	}
+}
+
+// Appends the node in the layout rapidxml prints, handing the text to the
+// writer whenever enough of it has piled up
+static void writeCompressedNode(DeflateFileWriter &writer, string &buffer,
+		const XmlNode *node, int depth) {
+	const size_t flushSize = 64 * 1024;
+
+	buffer.append(depth, '\t');
+	buffer += '<';
+	buffer += node->getName();
+	for(unsigned int i = 0; i < node->getAttributeCount(); ++i) {
+		XmlAttribute *attr = node->getAttribute(i);
+		buffer += ' ';
+		buffer += attr->getName();
+		buffer += "=\"";
+		appendEscapedXml(buffer, attr->getValue());
+		buffer += '"';
+	}
+	if(node->getChildCount() == 0) {
+		buffer += "/>\n";
+	}
+	else {
+		buffer += ">\n";
+		for(unsigned int i = 0; i < node->getChildCount(); ++i) {
+			writeCompressedNode(writer, buffer, node->getChild(i), depth + 1);
+		}
+		buffer.append(depth, '\t');
+		buffer += "</";
+		buffer += node->getName();
+		buffer += ">\n";
+	}
+
+	if(buffer.size() >= flushSize) {
+		writer.write(buffer.data(), buffer.size());
+		buffer.clear();
+	}
+}
+
+void XmlIoRapid::saveCompressed(const string &path, const XmlNode *node, int compressionLevel) {
+	try {
+		if(node == NULL) {
+			throw megaglest_runtime_error("node == NULL during save!");
+		}
+
+		DeflateFileWriter writer;
+		writer.open(path, compressionLevel);
+
+		string buffer = "<?xml version=\"1.0\" encoding=\"utf-8\" standalone=\"no\"?>\n";
+		buffer.reserve(128 * 1024);
+		writeCompressedNode(writer, buffer, node, 0);
+		writer.write(buffer.data(), buffer.size());
+		writer.close();
+	}
+	catch(const exception &e){
+		SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] Exception while saving: [%s], %s\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,path.c_str(),e.what());
+		throw megaglest_runtime_error("Exception while saving [" + path + "] msg: " + e.what());
+	}
+}
+
 // =====================================================
 //	class XmlTree
 // =====================================================
@@ -585,7 +715,11 @@ void XmlTree::load(const string &path, const std::map<string,string> &mapTagRepl
 	if(SystemFlags::VERBOSE_MODE_ENABLED) printf("In [%s::%s Line: %d] about to load [%s]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,path.c_str());
 }
 
-void XmlTree::save(const string &path) {
+void XmlTree::save(const string &path, bool compressed) {
+	if(compressed == true) {
+		XmlIoRapid::getInstance().saveCompressed(path, rootNode);
+		return;
+	}
 
 #if defined(WANT_XERCES)
 	if(this->engine_type == XML_XERCES_ENGINE) {
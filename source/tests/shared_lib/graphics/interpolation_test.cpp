@@ -0,0 +1,170 @@
+// ==============================================================
+//	This file is part of MegaGlest Unit Tests (www.megaglest.org)
+//
+//	Copyright (C) 2013 Mark Vejvoda
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <memory>
+#include "interpolation.h"
+
+#ifdef WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+using namespace Shared::Graphics;
+
+//
+// Tests for the shared interpolation cache, these need no GL context
+//
+class InterpolationTest : public CppUnit::TestFixture {
+	// Register the suite of tests for this fixture
+	CPPUNIT_TEST_SUITE( InterpolationTest );
+
+	CPPUNIT_TEST( test_LerpArray );
+	CPPUNIT_TEST( test_CacheHit );
+	CPPUNIT_TEST( test_CacheQuantizedTime );
+	CPPUNIT_TEST( test_CacheQueuedFill );
+	CPPUNIT_TEST( test_CacheEviction );
+
+	CPPUNIT_TEST_SUITE_END();
+	// End of Fixture registration
+
+	static const unsigned int frameCount = 4;
+	static const unsigned int vertexCount = 33;
+
+	Vec3f frames[frameCount * vertexCount];
+
+public:
+
+	void setUp() {
+		for(unsigned int frame = 0; frame < frameCount; ++frame) {
+			for(unsigned int i = 0; i < vertexCount; ++i) {
+				frames[frame * vertexCount + i] = Vec3f((float)i, (float)frame * 2.f, (float)(i * frame));
+			}
+		}
+
+		InterpolationCache &cache = InterpolationCache::getInstance();
+		cache.setThreadCount(0);
+		cache.setTimeSteps(8);
+		cache.setMaxIdleFrames(30);
+		cache.clear();
+		cache.resetStats();
+	}
+
+	void tearDown() {
+		InterpolationCache &cache = InterpolationCache::getInstance();
+		cache.setThreadCount(0);
+		cache.clear();
+	}
+
+	void test_LerpArray() {
+		Vec3f result[vertexCount];
+		InterpolationData::lerpArray(&frames[0], &frames[vertexCount], 0.25f, result, vertexCount);
+
+		for(unsigned int i = 0; i < vertexCount; ++i) {
+			Vec3f expected = frames[i].lerp(0.25f, frames[vertexCount + i]);
+			CPPUNIT_ASSERT_DOUBLES_EQUAL( expected.x, result[i].x, 0.0001 );
+			CPPUNIT_ASSERT_DOUBLES_EQUAL( expected.y, result[i].y, 0.0001 );
+			CPPUNIT_ASSERT_DOUBLES_EQUAL( expected.z, result[i].z, 0.0001 );
+		}
+	}
+
+	void test_CacheHit() {
+		InterpolationCache &cache = InterpolationCache::getInstance();
+
+		const Vec3f *first = cache.get(frames, frameCount, vertexCount, 0.5f, true);
+		CPPUNIT_ASSERT( first != NULL );
+		CPPUNIT_ASSERT_EQUAL( (uint64)0, cache.getHitCount() );
+		CPPUNIT_ASSERT_EQUAL( (uint64)1, cache.getMissCount() );
+
+		const Vec3f *second = cache.get(frames, frameCount, vertexCount, 0.5f, true);
+		CPPUNIT_ASSERT( first == second );
+		CPPUNIT_ASSERT_EQUAL( (uint64)1, cache.getHitCount() );
+
+		// t 0.5 of a 4 frame cycle is exactly frame 2
+		for(unsigned int i = 0; i < vertexCount; ++i) {
+			CPPUNIT_ASSERT_DOUBLES_EQUAL( frames[2 * vertexCount + i].y, second[i].y, 0.0001 );
+		}
+
+		// a non cycling animation uses different frames
+		const Vec3f *noCycle = cache.get(frames, frameCount, vertexCount, 0.5f, false);
+		CPPUNIT_ASSERT( noCycle != first );
+		CPPUNIT_ASSERT_EQUAL( 2, cache.getEntryCount() );
+	}
+
+	void test_CacheQuantizedTime() {
+		InterpolationCache &cache = InterpolationCache::getInstance();
+
+		// 8 steps per key frame, both round to step 16 of 32
+		const Vec3f *first = cache.get(frames, frameCount, vertexCount, 0.5f, true);
+		const Vec3f *second = cache.get(frames, frameCount, vertexCount, 0.501f, true);
+		CPPUNIT_ASSERT( first == second );
+
+		const Vec3f *third = cache.get(frames, frameCount, vertexCount, 0.55f, true);
+		CPPUNIT_ASSERT( first != third );
+
+		cache.setTimeSteps(0);
+		CPPUNIT_ASSERT( cache.get(frames, frameCount, vertexCount, 0.5f, true) == NULL );
+	}
+
+	void test_CacheQueuedFill() {
+		InterpolationCache &cache = InterpolationCache::getInstance();
+		cache.setThreadCount(2);
+
+		const int timeCount = 6;
+		for(int index = 0; index < timeCount; ++index) {
+			cache.queue(frames, frameCount, vertexCount, (float)index / (float)timeCount, true);
+			// the same time queued twice is only filled once
+			cache.queue(frames, frameCount, vertexCount, (float)index / (float)timeCount, true);
+		}
+		cache.fillQueued();
+		CPPUNIT_ASSERT_EQUAL( timeCount, cache.getEntryCount() );
+
+		cache.resetStats();
+		for(int index = 0; index < timeCount; ++index) {
+			float t = (float)index / (float)timeCount;
+			const Vec3f *result = cache.get(frames, frameCount, vertexCount, t, true);
+			CPPUNIT_ASSERT( result != NULL );
+
+			Vec3f expected[vertexCount];
+			float quantizedT = (float)(int)(t * frameCount * 8 + 0.5f) / (float)(frameCount * 8);
+			InterpolationData::interpolate(frames, frameCount, vertexCount, quantizedT, true, expected);
+			for(unsigned int i = 0; i < vertexCount; ++i) {
+				CPPUNIT_ASSERT_DOUBLES_EQUAL( expected[i].z, result[i].z, 0.0001 );
+			}
+		}
+		CPPUNIT_ASSERT_EQUAL( (uint64)timeCount, cache.getHitCount() );
+		CPPUNIT_ASSERT_EQUAL( (uint64)0, cache.getMissCount() );
+	}
+
+	void test_CacheEviction() {
+		InterpolationCache &cache = InterpolationCache::getInstance();
+		cache.setMaxIdleFrames(1);
+
+		cache.get(frames, frameCount, vertexCount, 0.25f, true);
+		uint32 generation = cache.getEvictionGeneration();
+
+		cache.nextFrame();
+		CPPUNIT_ASSERT_EQUAL( 1, cache.getEntryCount() );
+		cache.nextFrame();
+		CPPUNIT_ASSERT_EQUAL( 0, cache.getEntryCount() );
+		CPPUNIT_ASSERT( generation != cache.getEvictionGeneration() );
+
+		cache.get(frames, frameCount, vertexCount, 0.25f, true);
+		CPPUNIT_ASSERT_EQUAL( 1, cache.getEntryCount() );
+		InterpolationCache::releaseSource(frames);
+		CPPUNIT_ASSERT_EQUAL( 0, cache.getEntryCount() );
+	}
+};
+
+// Test Suite Registrations
+CPPUNIT_TEST_SUITE_REGISTRATION( InterpolationTest );
+//
@@ -0,0 +1,288 @@
+// ==============================================================
+//	This file is part of MegaGlest Unit Tests (www.megaglest.org)
+//
+//	Copyright (C) 2013 Mark Vejvoda
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <memory>
+#include <cstdio>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include "loose_quadtree.h"
+#include "platform_common.h"
+
+#ifdef WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+using namespace Shared::Graphics;
+using Shared::PlatformCommon::Chrono;
+
+//
+// The planes of a perspective camera, built the way the game camera
+// looks down at the map
+//
+static LooseQuadTree::Frustum makeCameraFrustum(const Vec3f &eye, const Vec3f &target,
+		float fovDegrees, float aspect, float nearDistance, float farDistance) {
+	Vec3f forward= target - eye;
+	forward.normalize();
+	Vec3f right= forward.cross(Vec3f(0.f, 1.f, 0.f));
+	right.normalize();
+	Vec3f up= right.cross(forward);
+
+	const float halfHeight= std::tan(fovDegrees * 3.14159265f / 360.f);
+	const float halfWidth= halfHeight * aspect;
+	const Vec3f sides[4][2]= {
+		{ forward + right * halfWidth, up },
+		{ forward - right * halfWidth, up },
+		{ forward + up * halfHeight, right },
+		{ forward - up * halfHeight, right }
+	};
+
+	LooseQuadTree::Frustum frustum;
+	for(int i = 0; i < 4; ++i) {
+		Vec3f normal= sides[i][0].cross(sides[i][1]);
+		normal.normalize();
+		if(normal.dot(forward) < 0) {
+			normal= normal * -1.f;
+		}
+		std::vector<float> plane(4);
+		plane[0]= normal.x; plane[1]= normal.y; plane[2]= normal.z;
+		plane[3]= -normal.dot(eye);
+		frustum.push_back(plane);
+	}
+	std::vector<float> nearPlane(4);
+	nearPlane[0]= forward.x; nearPlane[1]= forward.y; nearPlane[2]= forward.z;
+	nearPlane[3]= -forward.dot(eye + forward * nearDistance);
+	frustum.push_back(nearPlane);
+	std::vector<float> farPlane(4);
+	farPlane[0]= -forward.x; farPlane[1]= -forward.y; farPlane[2]= -forward.z;
+	farPlane[3]= forward.dot(eye + forward * farDistance);
+	frustum.push_back(farPlane);
+	return frustum;
+}
+
+//
+// A dense forest tileset with units walking through it and a recorded
+// camera path scrolling over the map
+//
+class ForestScene {
+public:
+	static const int mapSize = 512;
+
+	std::vector<Vec3f> objects;
+	std::vector<Vec3f> units;
+	std::vector<Vec3f> unitSteps;
+	std::vector<LooseQuadTree::Frustum> cameraPath;
+	unsigned int seed;
+
+	ForestScene() : seed(12345) {}
+
+	float random() {
+		seed= seed * 1103515245 + 12345;
+		return (float)((seed >> 8) & 0xffff) / 65536.f;
+	}
+
+	void record(int unitCount, int frameCount) {
+		objects.clear();
+		for(int y = 0; y < mapSize; y += 2) {
+			for(int x = 0; x < mapSize; x += 2) {
+				if(random() < 0.45f) {
+					objects.push_back(Vec3f((float)x, random() * 5.f, (float)y));
+				}
+			}
+		}
+		units.clear();
+		unitSteps.clear();
+		for(int i = 0; i < unitCount; ++i) {
+			units.push_back(Vec3f(random() * mapSize, random() * 5.f, random() * mapSize));
+			unitSteps.push_back(Vec3f(random() * 0.4f - 0.2f, 0.f, random() * 0.4f - 0.2f));
+		}
+		cameraPath.clear();
+		for(int frame = 0; frame < frameCount; ++frame) {
+			// a slow loop around the map with the camera rotating
+			float angle= 6.2831853f * frame / frameCount;
+			Vec3f target(mapSize * (0.5f + 0.35f * std::cos(angle)), 0.f, mapSize * (0.5f + 0.35f * std::sin(angle)));
+			Vec3f eye= target + Vec3f(-12.f * std::sin(angle * 3), 22.f, -12.f * std::cos(angle * 3));
+			cameraPath.push_back(makeCameraFrustum(eye, target, 60.f, 4.f / 3.f, 1.f, 120.f));
+		}
+	}
+
+	void stepUnits() {
+		for(unsigned int i = 0; i < units.size(); ++i) {
+			units[i]= units[i] + unitSteps[i];
+		}
+	}
+};
+
+//
+// Tests for the loose quadtree used to cull objects and units
+//
+class LooseQuadTreeTest : public CppUnit::TestFixture {
+	// Register the suite of tests for this fixture
+	CPPUNIT_TEST_SUITE( LooseQuadTreeTest );
+
+	CPPUNIT_TEST( test_CullMatchesBruteForce );
+	CPPUNIT_TEST( test_MoveAndRemove );
+	CPPUNIT_TEST( test_CameraPathSpeed );
+
+	CPPUNIT_TEST_SUITE_END();
+	// End of Fixture registration
+
+	static void bruteForceCull(const LooseQuadTree &tree, const std::vector<int> &itemIds,
+			const std::vector<float> &radius, const LooseQuadTree::Frustum &frustum, std::vector<int> &result) {
+		result.clear();
+		for(unsigned int i = 0; i < itemIds.size(); ++i) {
+			if(itemIds[i] < 0) {
+				continue;
+			}
+			const Vec3f &center= tree.getCenter(itemIds[i]);
+			const Vec3f boxMin(center.x - radius[i], center.y - radius[i], center.z - radius[i]);
+			const Vec3f boxMax(center.x + radius[i], center.y + radius[i], center.z + radius[i]);
+			if(LooseQuadTree::boxInFrustum(frustum, boxMin, boxMax) == true) {
+				result.push_back(itemIds[i]);
+			}
+		}
+		std::sort(result.begin(), result.end());
+	}
+
+	void buildTree(const ForestScene &scene, LooseQuadTree &tree, std::vector<int> &itemIds, std::vector<float> &radius) {
+		tree.init(Vec2f(0.f), (float)ForestScene::mapSize, 7);
+		itemIds.clear();
+		radius.clear();
+		for(unsigned int i = 0; i < scene.objects.size(); ++i) {
+			itemIds.push_back(tree.addItem(NULL, scene.objects[i], 1.f));
+			radius.push_back(1.f);
+		}
+		for(unsigned int i = 0; i < scene.units.size(); ++i) {
+			float unitRadius= 1.f + (i % 4);
+			itemIds.push_back(tree.addItem(NULL, scene.units[i], unitRadius));
+			radius.push_back(unitRadius);
+		}
+	}
+
+public:
+
+	void test_CullMatchesBruteForce() {
+		ForestScene scene;
+		scene.record(500, 40);
+
+		LooseQuadTree tree;
+		std::vector<int> itemIds;
+		std::vector<float> radius;
+		buildTree(scene, tree, itemIds, radius);
+		CPPUNIT_ASSERT_EQUAL( (int)itemIds.size(), tree.getItemCount() );
+
+		std::vector<int> expected;
+		std::vector<int> result;
+		for(unsigned int frame = 0; frame < scene.cameraPath.size(); ++frame) {
+			bruteForceCull(tree, itemIds, radius, scene.cameraPath[frame], expected);
+			tree.cull(scene.cameraPath[frame], result);
+			std::sort(result.begin(), result.end());
+
+			CPPUNIT_ASSERT( expected.empty() == false );
+			CPPUNIT_ASSERT( expected == result );
+		}
+	}
+
+	void test_MoveAndRemove() {
+		ForestScene scene;
+		scene.record(2000, 40);
+
+		LooseQuadTree tree;
+		std::vector<int> itemIds;
+		std::vector<float> radius;
+		buildTree(scene, tree, itemIds, radius);
+
+		const int firstUnit= (int)scene.objects.size();
+		std::vector<int> expected;
+		std::vector<int> result;
+		for(unsigned int frame = 0; frame < scene.cameraPath.size(); ++frame) {
+			// units walk a long way each frame and some die
+			for(int i = 0; i < 30; ++i) {
+				scene.stepUnits();
+			}
+			for(unsigned int i = 0; i < scene.units.size(); ++i) {
+				int &itemId= itemIds[firstUnit + i];
+				if(itemId < 0) {
+					continue;
+				}
+				if((i + frame) % 97 == 0) {
+					tree.removeItem(itemId);
+					itemId= -1;
+				}
+				else {
+					tree.moveItem(itemId, scene.units[i], radius[firstUnit + i]);
+				}
+			}
+
+			bruteForceCull(tree, itemIds, radius, scene.cameraPath[frame], expected);
+			tree.cull(scene.cameraPath[frame], result);
+			std::sort(result.begin(), result.end());
+			CPPUNIT_ASSERT( expected == result );
+		}
+
+		int liveCount= 0;
+		for(unsigned int i = 0; i < itemIds.size(); ++i) {
+			if(itemIds[i] >= 0) {
+				liveCount++;
+			}
+		}
+		CPPUNIT_ASSERT_EQUAL( liveCount, tree.getItemCount() );
+
+		// freed items are reused
+		int newItem= tree.addItem(NULL, Vec3f(1.f), 1.f);
+		CPPUNIT_ASSERT( newItem < (int)itemIds.size() );
+	}
+
+	void test_CameraPathSpeed() {
+		ForestScene scene;
+		scene.record(3000, 300);
+
+		LooseQuadTree tree;
+		std::vector<int> itemIds;
+		std::vector<float> radius;
+		buildTree(scene, tree, itemIds, radius);
+
+		std::vector<int> result;
+		Chrono chrono;
+		chrono.start();
+		int bruteForceVisible= 0;
+		for(unsigned int frame = 0; frame < scene.cameraPath.size(); ++frame) {
+			bruteForceCull(tree, itemIds, radius, scene.cameraPath[frame], result);
+			bruteForceVisible+= (int)result.size();
+		}
+		int64 bruteForceMillis= chrono.getMillis();
+
+		const int firstUnit= (int)scene.objects.size();
+		chrono.start();
+		int treeVisible= 0;
+		for(unsigned int frame = 0; frame < scene.cameraPath.size(); ++frame) {
+			scene.stepUnits();
+			for(unsigned int i = 0; i < scene.units.size(); ++i) {
+				tree.moveItem(itemIds[firstUnit + i], scene.units[i], radius[firstUnit + i]);
+			}
+			tree.cull(scene.cameraPath[frame], result);
+			treeVisible+= (int)result.size();
+		}
+		int64 treeMillis= chrono.getMillis();
+
+		printf("Culling %d items over %d camera frames: brute force %lld msecs, loose quadtree with unit moves %lld msecs (%d / %d visible)\n",
+				tree.getItemCount(),(int)scene.cameraPath.size(),(long long int)bruteForceMillis,(long long int)treeMillis,
+				treeVisible,bruteForceVisible);
+		CPPUNIT_ASSERT( treeVisible > 0 );
+	}
+};
+
+// Test Suite Registrations
+CPPUNIT_TEST_SUITE_REGISTRATION( LooseQuadTreeTest );
+//
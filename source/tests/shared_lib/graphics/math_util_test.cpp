@@ -11,7 +11,11 @@
 
 #include <cppunit/extensions/HelperMacros.h>
 #include <memory>
+#include <cstring>
+#include <vector>
+#include <cstdio>
 #include "math_util.h"
+#include "platform_common.h"
 
 #ifdef WIN32
 #include <io.h>
@@ -20,6 +24,7 @@
 #endif
 
 using namespace Shared::Graphics;
+using Shared::PlatformCommon::Chrono;
 
 //
 // Tests for math_util
@@ -29,6 +34,14 @@ class MathUtilTest : public CppUnit::TestFixture {
 	CPPUNIT_TEST_SUITE( MathUtilTest );
 
 	CPPUNIT_TEST( test_RoundFloat );
+	CPPUNIT_TEST( test_Vec3fArrayLerp );
+	CPPUNIT_TEST( test_Vec3fArrayNormalize );
+	CPPUNIT_TEST( test_Vec3fArrayTransform );
+	CPPUNIT_TEST( test_Vec3fArrayLargeMatchesScalar );
+	CPPUNIT_TEST( test_Vec3fArraySpeed );
+	CPPUNIT_TEST( test_Uint8ArrayKernels );
+	CPPUNIT_TEST( test_Uint8ArrayLargeMatchesScalar );
+	CPPUNIT_TEST( test_Uint8ArraySpeed );
 
 	CPPUNIT_TEST_SUITE_END();
 	// End of Fixture registration
@@ -60,6 +73,266 @@ public:
 //		value2 = xs_CRoundToInt(1.523456f);
 //		CPPUNIT_ASSERT_EQUAL( (int32)2, value2 );
 	}
+
+	// odd count so every kernel also runs its scalar tail
+	static const uint32 vecCount = 1003;
+
+	void fillVectors(std::vector<Vec3f> &a, std::vector<Vec3f> &b) {
+		a.resize(vecCount);
+		b.resize(vecCount);
+		for(uint32 i = 0; i < vecCount; ++i) {
+			a[i] = Vec3f((float)(i % 97) / 7.f - 6.f, (float)(i % 13) * 3.3f, -(float)(i % 31) / 9.f);
+			b[i] = Vec3f((float)(i % 89) / 11.f, (float)(i % 7) / 3.f, (float)(i % 53) * 0.7f);
+		}
+		a[5] = Vec3f(0.f);
+	}
+
+	Matrix4f getTestMatrix() {
+		float values[16];
+		for(int i = 0; i < 16; ++i) {
+			values[i] = (float)((i * 7) % 5) - 1.5f + (float)i * 0.1f;
+		}
+		return Matrix4f(values);
+	}
+
+	void assertSameBits(const std::vector<Vec3f> &expected, const std::vector<Vec3f> &result) {
+		CPPUNIT_ASSERT_EQUAL( expected.size(), result.size() );
+		CPPUNIT_ASSERT( memcmp(&expected[0], &result[0], expected.size() * sizeof(Vec3f)) == 0 );
+	}
+
+	void test_Vec3fArrayLerp() {
+		std::vector<Vec3f> a, b;
+		fillVectors(a, b);
+
+		std::vector<Vec3f> expected(vecCount);
+		for(uint32 i = 0; i < vecCount; ++i) {
+			expected[i] = a[i].lerp(0.37f, b[i]);
+		}
+
+		VecArraySimdLevel supported = getSupportedVecArraySimdLevel();
+		for(int level = vasScalar; level <= supported; ++level) {
+			setVecArraySimdLevel((VecArraySimdLevel)level);
+			std::vector<Vec3f> result(vecCount);
+			lerpVec3fArray(&a[0], &b[0], 0.37f, &result[0], vecCount);
+			assertSameBits(expected, result);
+		}
+		setVecArraySimdLevel(supported);
+	}
+
+	void test_Vec3fArrayNormalize() {
+		std::vector<Vec3f> a, b;
+		fillVectors(a, b);
+
+		VecArraySimdLevel supported = getSupportedVecArraySimdLevel();
+		setVecArraySimdLevel(vasScalar);
+		std::vector<Vec3f> expected = a;
+		normalizeVec3fArray(&expected[0], vecCount);
+
+		// zero vectors stay zero, the rest are unit length
+		CPPUNIT_ASSERT_EQUAL( 0.f, expected[5].x );
+		for(uint32 i = 0; i < vecCount; ++i) {
+			if(i != 5) {
+				CPPUNIT_ASSERT_DOUBLES_EQUAL( 1.0, expected[i].length(), 0.0001 );
+			}
+		}
+
+		for(int level = vasScalar + 1; level <= supported; ++level) {
+			setVecArraySimdLevel((VecArraySimdLevel)level);
+			std::vector<Vec3f> result = a;
+			normalizeVec3fArray(&result[0], vecCount);
+			assertSameBits(expected, result);
+		}
+		setVecArraySimdLevel(supported);
+	}
+
+	void test_Vec3fArrayTransform() {
+		std::vector<Vec3f> a, b;
+		fillVectors(a, b);
+		Matrix4f matrix = getTestMatrix();
+
+		std::vector<Vec3f> expected(vecCount);
+		for(uint32 i = 0; i < vecCount; ++i) {
+			Vec4f v = matrix * Vec4f(a[i].x, a[i].y, a[i].z, 1.f);
+			expected[i] = Vec3f(v.x, v.y, v.z);
+		}
+
+		VecArraySimdLevel supported = getSupportedVecArraySimdLevel();
+		for(int level = vasScalar; level <= supported; ++level) {
+			setVecArraySimdLevel((VecArraySimdLevel)level);
+			std::vector<Vec3f> result(vecCount);
+			transformVec3fArray(matrix, &a[0], &result[0], vecCount);
+			assertSameBits(expected, result);
+
+			// in place
+			result = a;
+			transformVec3fArray(matrix, &result[0], &result[0], vecCount);
+			assertSameBits(expected, result);
+		}
+		setVecArraySimdLevel(supported);
+	}
+
+	void test_Vec3fArrayLargeMatchesScalar() {
+		// a full frame worth of vertices, fed back through the kernels so
+		// any drift between the levels would accumulate
+		const uint32 count = 65536;
+		const int loops = 8;
+		std::vector<Vec3f> a, b;
+		fillVectors(a, b);
+		a.resize(count, Vec3f(1.f, 2.f, 3.f));
+		b.resize(count, Vec3f(-3.f, 0.5f, 7.f));
+
+		VecArraySimdLevel supported = getSupportedVecArraySimdLevel();
+		std::vector<Vec3f> expected;
+		for(int level = vasScalar; level <= supported; ++level) {
+			setVecArraySimdLevel((VecArraySimdLevel)level);
+			std::vector<Vec3f> result(a);
+			std::vector<Vec3f> next(count);
+			for(int loop = 0; loop < loops; ++loop) {
+				lerpVec3fArray(&result[0], &b[0], (float)loop / (float)loops, &next[0], count);
+				normalizeVec3fArray(&next[0], count);
+				result.swap(next);
+			}
+			if(level == vasScalar) {
+				expected = result;
+			}
+			else {
+				assertSameBits(expected, result);
+			}
+		}
+		setVecArraySimdLevel(supported);
+	}
+
+	void test_Vec3fArraySpeed() {
+		// only reports the times, the results are checked above
+		const uint32 count = 65536;
+		const int loops = 200;
+		std::vector<Vec3f> a(count, Vec3f(1.f, 2.f, 3.f));
+		std::vector<Vec3f> b(count, Vec3f(-3.f, 0.5f, 7.f));
+		std::vector<Vec3f> result(count);
+
+		VecArraySimdLevel supported = getSupportedVecArraySimdLevel();
+		for(int level = vasScalar; level <= supported; ++level) {
+			setVecArraySimdLevel((VecArraySimdLevel)level);
+			Chrono chrono;
+			chrono.start();
+			for(int loop = 0; loop < loops; ++loop) {
+				lerpVec3fArray(&a[0], &b[0], (float)loop / (float)loops, &result[0], count);
+				normalizeVec3fArray(&result[0], count);
+			}
+			printf("Vec3f array kernels [%s] took %lld msecs for %d loops of %u vectors\n",
+					getVecArraySimdLevelName((VecArraySimdLevel)level),(long long int)chrono.getMillis(),loops,count);
+		}
+		setVecArraySimdLevel(supported);
+	}
+
+	void fillBytes(std::vector<uint8> &values, uint32 count, uint32 seed) {
+		values.resize(count);
+		for(uint32 i = 0; i < count; ++i) {
+			seed = seed * 1103515245 + 12345;
+			// plenty of equal values so the masked paths are covered
+			values[i] = (i % 5 == 0 ? 127 : (uint8)(seed >> 16));
+		}
+	}
+
+	void test_Uint8ArrayKernels() {
+		// odd count so every level also runs its scalar tail
+		const uint32 count = 1000 + 13;
+		std::vector<uint8> src, dest, to;
+		fillBytes(src, count, 1);
+		fillBytes(dest, count, 2);
+		fillBytes(to, count, 3);
+		for(uint32 i = 0; i < count; i += 3) {
+			to[i] = dest[i];
+		}
+
+		std::vector<uint8> expectedMax(dest), expectedLimit(dest), expectedLerp(dest);
+		for(uint32 i = 0; i < count; ++i) {
+			expectedMax[i] = (src[i] > dest[i] ? src[i] : dest[i]);
+			expectedLimit[i] = (src[i] > dest[i] ? src[i] : (dest[i] > 127 ? 127 : dest[i]));
+			if(dest[i] != to[i]) {
+				expectedLerp[i] = (uint8)((src[i] * (256 - 64) + to[i] * 64) >> 8);
+			}
+		}
+
+		VecArraySimdLevel supported = getSupportedVecArraySimdLevel();
+		for(int level = vasScalar; level <= supported; ++level) {
+			setVecArraySimdLevel((VecArraySimdLevel)level);
+
+			std::vector<uint8> result(dest);
+			maxUint8Array(&src[0], &result[0], count);
+			CPPUNIT_ASSERT( result == expectedMax );
+
+			result = dest;
+			maxOrLimitUint8Array(&src[0], &result[0], 127, count);
+			CPPUNIT_ASSERT( result == expectedLimit );
+
+			result = dest;
+			lerpChangedUint8Array(&src[0], &to[0], &result[0], 0.25f, count);
+			CPPUNIT_ASSERT( result == expectedLerp );
+
+			// the end of the fade is exactly the target
+			result = dest;
+			lerpChangedUint8Array(&src[0], &to[0], &result[0], 1.f, count);
+			CPPUNIT_ASSERT( result == to );
+		}
+		setVecArraySimdLevel(supported);
+	}
+
+	void test_Uint8ArrayLargeMatchesScalar() {
+		// the fog of war pixmaps of a 512x512 map, reset and faded over
+		// several frames so any drift between the levels accumulates
+		const uint32 count = 512 * 512;
+		const int loops = 8;
+		std::vector<uint8> fow0, fow1, tex;
+		fillBytes(fow0, count, 4);
+		fillBytes(fow1, count, 5);
+		fillBytes(tex, count, 6);
+
+		VecArraySimdLevel supported = getSupportedVecArraySimdLevel();
+		std::vector<uint8> expectedFow, expectedTex;
+		for(int level = vasScalar; level <= supported; ++level) {
+			setVecArraySimdLevel((VecArraySimdLevel)level);
+			std::vector<uint8> fow(fow1), result(tex);
+			for(int loop = 0; loop < loops; ++loop) {
+				maxOrLimitUint8Array(&fow0[0], &fow[0], 127, count);
+				lerpChangedUint8Array(&fow0[0], &fow[0], &result[0], (float)loop / (float)loops, count);
+			}
+			if(level == vasScalar) {
+				expectedFow = fow;
+				expectedTex = result;
+			}
+			else {
+				CPPUNIT_ASSERT( fow == expectedFow );
+				CPPUNIT_ASSERT( result == expectedTex );
+			}
+		}
+		setVecArraySimdLevel(supported);
+	}
+
+	void test_Uint8ArraySpeed() {
+		// the fog of war pixmaps of a 512x512 map, reset and faded each
+		// frame, only the times are reported
+		const uint32 count = 512 * 512;
+		const int loops = 400;
+		std::vector<uint8> fow0, fow1, tex;
+		fillBytes(fow0, count, 4);
+		fillBytes(fow1, count, 5);
+		fillBytes(tex, count, 6);
+
+		VecArraySimdLevel supported = getSupportedVecArraySimdLevel();
+		for(int level = vasScalar; level <= supported; ++level) {
+			setVecArraySimdLevel((VecArraySimdLevel)level);
+			Chrono chrono;
+			chrono.start();
+			for(int loop = 0; loop < loops; ++loop) {
+				maxOrLimitUint8Array(&fow0[0], &fow1[0], 127, count);
+				lerpChangedUint8Array(&fow0[0], &fow1[0], &tex[0], (float)loop / (float)loops, count);
+			}
+			printf("uint8 array kernels [%s] took %lld msecs for %d loops of 512x512\n",
+					getVecArraySimdLevelName((VecArraySimdLevel)level),(long long int)chrono.getMillis(),loops);
+		}
+		setVecArraySimdLevel(supported);
+	}
 };
 
 
@@ -0,0 +1,272 @@
+// ==============================================================
+//	This file is part of MegaGlest Unit Tests (www.megaglest.org)
+//
+//	Copyright (C) 2013 Mark Vejvoda
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <memory>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "render_queue.h"
+#include "interpolation.h"
+#include "platform_common.h"
+
+#ifdef WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+using namespace Shared::Graphics;
+using Shared::PlatformCommon::Chrono;
+
+//
+// A recorded visibility list, models and team textures are only compared
+// by address so no GL context or loaded model is needed
+//
+class RecordedRenderQueueSource : public RenderQueueSource {
+public:
+	static const int modelCount = 24;
+	static const int teamCount = 8;
+	// every recorded model animates over the same key frames
+	static const uint32 frameCount = 3;
+	static const uint32 vertexCount = 4;
+
+	char models[modelCount];
+	char teamTextures[teamCount];
+
+	std::vector<int> itemModel;
+	std::vector<int> itemTeam;
+	std::vector<bool> itemFaded;
+	std::vector<bool> itemHidden;
+
+	void record(int count) {
+		itemModel.resize(count);
+		itemTeam.resize(count);
+		itemFaded.resize(count);
+		itemHidden.resize(count);
+		for(int i = 0; i < count; ++i) {
+			itemModel[i] = (i * 7) % modelCount;
+			itemTeam[i] = (i * 3) % teamCount;
+			itemFaded[i] = (i % 11 == 0);
+			itemHidden[i] = (i % 13 == 0);
+		}
+	}
+
+	Model *getModel(int index) const { return (Model *)&models[itemModel[index]]; }
+	const Texture *getTeamTexture(int index) const { return (const Texture *)&teamTextures[itemTeam[index]]; }
+
+	virtual int getRenderItemCount() const {
+		return (int)itemModel.size();
+	}
+
+	virtual bool fillRenderItem(int index, RenderQueueItem &item) const {
+		if(itemHidden[index] == true) {
+			return false;
+		}
+		item.model = getModel(index);
+		item.teamTexture = getTeamTexture(index);
+		item.position = Vec3f((float)index, 0.f, (float)-index);
+		item.animProgress = (float)(index % 100) / 100.f;
+		item.frameStep = InterpolationCache::getInstance().getFrameStep(frameCount, item.animProgress, item.cycleAnimation);
+		item.faded = itemFaded[index];
+		return true;
+	}
+};
+
+//
+// Tests for the render queue builder
+//
+class RenderQueueTest : public CppUnit::TestFixture {
+	// Register the suite of tests for this fixture
+	CPPUNIT_TEST_SUITE( RenderQueueTest );
+
+	CPPUNIT_TEST( test_BuildSkipsHiddenItems );
+	CPPUNIT_TEST( test_SortByState );
+	CPPUNIT_TEST( test_ParallelBuild );
+	CPPUNIT_TEST( test_BatchedMatchesPerUnit );
+	CPPUNIT_TEST( test_BuildAndSortSpeed );
+
+	CPPUNIT_TEST_SUITE_END();
+	// End of Fixture registration
+
+	RecordedRenderQueueSource source;
+
+public:
+
+	void setUp() {
+		source.record(1000);
+	}
+
+	void test_BuildSkipsHiddenItems() {
+		RenderQueue queue;
+		queue.build(source);
+
+		int visibleCount = 0;
+		for(int i = 0; i < source.getRenderItemCount(); ++i) {
+			if(source.itemHidden[i] == false) {
+				visibleCount++;
+			}
+		}
+		CPPUNIT_ASSERT_EQUAL( visibleCount, queue.getItemCount() );
+
+		// before sorting the items are in source order
+		for(int i = 1; i < queue.getItemCount(); ++i) {
+			CPPUNIT_ASSERT( queue.getItem(i - 1).sourceIndex < queue.getItem(i).sourceIndex );
+		}
+		for(int i = 0; i < queue.getItemCount(); ++i) {
+			const RenderQueueItem &item = queue.getItem(i);
+			CPPUNIT_ASSERT( item.model == source.getModel(item.sourceIndex) );
+			CPPUNIT_ASSERT_DOUBLES_EQUAL( (float)item.sourceIndex, item.position.x, 0.0001 );
+		}
+	}
+
+	void test_SortByState() {
+		RenderQueue queue;
+		queue.build(source);
+		queue.sort();
+
+		bool fadedSeen = false;
+		int stateChanges = 0;
+		for(int i = 0; i < queue.getItemCount(); ++i) {
+			const RenderQueueItem &item = queue.getItem(i);
+			// the faded items come last
+			if(item.faded == true) {
+				fadedSeen = true;
+			}
+			CPPUNIT_ASSERT( item.faded == fadedSeen );
+
+			if(i > 0) {
+				const RenderQueueItem &prev = queue.getItem(i - 1);
+				CPPUNIT_ASSERT( prev.stateKey <= item.stateKey );
+				if(prev.stateKey == item.stateKey) {
+					CPPUNIT_ASSERT( prev.model == item.model );
+					CPPUNIT_ASSERT( prev.teamTexture == item.teamTexture );
+					CPPUNIT_ASSERT( prev.frameStep == item.frameStep );
+					CPPUNIT_ASSERT( prev.sourceIndex < item.sourceIndex );
+				}
+				else {
+					stateChanges++;
+				}
+			}
+		}
+
+		// every team texture, model and frame is drawn in one run per fade state
+		const uint32 frameSteps = 2 * (RecordedRenderQueueSource::frameCount * InterpolationCache::getInstance().getTimeSteps() + 1);
+		CPPUNIT_ASSERT( stateChanges < (int)(2 * RecordedRenderQueueSource::modelCount * RecordedRenderQueueSource::teamCount * frameSteps) );
+		CPPUNIT_ASSERT( RenderQueue::makeStateKey(true, 0, 0, 0) > RenderQueue::makeStateKey(false, 5, 5, 5) );
+		CPPUNIT_ASSERT( RenderQueue::makeStateKey(false, 0, 1, 0) > RenderQueue::makeStateKey(false, 0, 0, 5) );
+	}
+
+	void test_ParallelBuild() {
+		RenderQueue serialQueue;
+		serialQueue.build(source);
+		serialQueue.sort();
+
+		RenderQueue parallelQueue;
+		parallelQueue.setBuildThreadCount(3);
+		CPPUNIT_ASSERT_EQUAL( 3, parallelQueue.getBuildThreadCount() );
+		parallelQueue.build(source);
+		parallelQueue.sort();
+
+		CPPUNIT_ASSERT_EQUAL( serialQueue.getItemCount(), parallelQueue.getItemCount() );
+		for(int i = 0; i < serialQueue.getItemCount(); ++i) {
+			CPPUNIT_ASSERT_EQUAL( serialQueue.getItem(i).sourceIndex, parallelQueue.getItem(i).sourceIndex );
+			CPPUNIT_ASSERT( serialQueue.getItem(i).stateKey == parallelQueue.getItem(i).stateKey );
+		}
+	}
+
+	void test_BatchedMatchesPerUnit() {
+		std::vector<Vec3f> keyFrames(RecordedRenderQueueSource::frameCount * RecordedRenderQueueSource::vertexCount);
+		for(unsigned int i = 0; i < keyFrames.size(); ++i) {
+			keyFrames[i] = Vec3f((float)i, (float)(i * i) * 0.5f, (float)-i);
+		}
+		InterpolationCache &cache = InterpolationCache::getInstance();
+		cache.clear();
+
+		RenderQueue queue;
+		queue.build(source);
+		queue.sort();
+
+		// draw like the renderer, a run of unfaded items with the same state
+		// is one batch showing the frame of its first item
+		std::vector<const Vec3f *> drawnFrame(source.getRenderItemCount(), (const Vec3f *)NULL);
+		int batchedCount = 0;
+		for(int itemIndex = 0; itemIndex < queue.getItemCount(); ) {
+			const RenderQueueItem &item = queue.getItem(itemIndex);
+			const Vec3f *frame = cache.get(&keyFrames[0], RecordedRenderQueueSource::frameCount,
+					RecordedRenderQueueSource::vertexCount, item.animProgress, item.cycleAnimation);
+			int batchCount = 1;
+			if(item.faded == false) {
+				while(itemIndex + batchCount < queue.getItemCount() &&
+					queue.getItem(itemIndex + batchCount).stateKey == item.stateKey) {
+					batchCount++;
+				}
+			}
+			if(batchCount > 1) {
+				batchedCount += batchCount;
+			}
+			for(int batchIndex = 0; batchIndex < batchCount; ++batchIndex) {
+				const RenderQueueItem &batchItem = queue.getItem(itemIndex + batchIndex);
+				CPPUNIT_ASSERT( batchItem.model == item.model );
+				CPPUNIT_ASSERT( batchItem.teamTexture == item.teamTexture );
+				CPPUNIT_ASSERT( drawnFrame[batchItem.sourceIndex] == NULL );
+				drawnFrame[batchItem.sourceIndex] = frame;
+			}
+			itemIndex += batchCount;
+		}
+		CPPUNIT_ASSERT( batchedCount > 0 );
+
+		// and one at a time, every unit must show the same vertices
+		for(int index = 0; index < source.getRenderItemCount(); ++index) {
+			RenderQueueItem item;
+			if(source.fillRenderItem(index, item) == false) {
+				CPPUNIT_ASSERT( drawnFrame[index] == NULL );
+				continue;
+			}
+			const Vec3f *frame = cache.get(&keyFrames[0], RecordedRenderQueueSource::frameCount,
+					RecordedRenderQueueSource::vertexCount, item.animProgress, item.cycleAnimation);
+			CPPUNIT_ASSERT( drawnFrame[index] != NULL );
+			CPPUNIT_ASSERT( memcmp(frame, drawnFrame[index], RecordedRenderQueueSource::vertexCount * sizeof(Vec3f)) == 0 );
+		}
+		cache.clear();
+	}
+
+	void test_BuildAndSortSpeed() {
+		RecordedRenderQueueSource bigSource;
+		bigSource.record(20000);
+		const int loops = 50;
+
+		RenderQueue queue;
+		queue.setBuildThreadCount(2);
+
+		Chrono chrono;
+		chrono.start();
+		for(int loop = 0; loop < loops; ++loop) {
+			queue.build(bigSource);
+		}
+		int64 buildMillis = chrono.getMillis();
+
+		chrono.start();
+		for(int loop = 0; loop < loops; ++loop) {
+			queue.build(bigSource);
+			queue.sort();
+		}
+		int64 totalMillis = chrono.getMillis();
+
+		printf("Render queue of %d items build took %lld msecs, build and sort %lld msecs for %d frames\n",
+				bigSource.getRenderItemCount(),(long long int)buildMillis,(long long int)totalMillis,loops);
+		CPPUNIT_ASSERT( queue.getItemCount() > 0 );
+	}
+};
+
+// Test Suite Registrations
+CPPUNIT_TEST_SUITE_REGISTRATION( RenderQueueTest );
+//
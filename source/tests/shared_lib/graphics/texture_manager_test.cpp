@@ -0,0 +1,162 @@
+// ==============================================================
+//	This file is part of MegaGlest Unit Tests (www.megaglest.org)
+//
+//	Copyright (C) 2013 Mark Vejvoda
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cstring>
+#include "texture_manager.h"
+#include "graphics_interface.h"
+#include "graphics_factory.h"
+#include "ImageReaders.h"
+
+#ifdef WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+using namespace Shared::Graphics;
+
+// texture without a GL context, init only records that the upload happened
+class TestTexture2D : public Texture2D {
+public:
+	int initCount;
+
+	TestTexture2D() : initCount(0) {
+	}
+	virtual void init(Filter filter, int maxAnisotropy) {
+		inited = true;
+		initCount++;
+	}
+	virtual void end(bool deletePixelBuffer) {
+		inited = false;
+	}
+};
+
+class TestTextureFactory : public GraphicsFactory {
+public:
+	int texture2DCount;
+
+	TestTextureFactory() : texture2DCount(0) {
+	}
+	virtual Texture2D *newTexture2D() {
+		texture2DCount++;
+		return new TestTexture2D();
+	}
+};
+
+//
+// Tests for the texture manager's path registry and pixmap decoding
+//
+class TextureManagerTest : public CppUnit::TestFixture {
+	// Register the suite of tests for this fixture
+	CPPUNIT_TEST_SUITE( TextureManagerTest );
+
+	CPPUNIT_TEST( test_decode_loads_pixmap );
+	CPPUNIT_TEST( test_decode_deletes_pixmap_after_load );
+	CPPUNIT_TEST( test_same_path_loaded_once );
+	CPPUNIT_TEST( test_async_decode_same_path_loaded_once );
+
+	CPPUNIT_TEST_SUITE_END();
+	// End of Fixture registration
+
+private:
+	const string imagePath;
+	TestTextureFactory *factory;
+	GraphicsFactory *oldFactory;
+
+public:
+
+	TextureManagerTest() : imagePath("test_texture_manager.tga"),
+		factory(NULL), oldFactory(NULL) {
+	}
+
+	void setUp() {
+		ImageRegisterer::registerImageReaders();
+
+		Pixmap2D pixmap;
+		pixmap.init(4, 4, 3);
+		memset(pixmap.getPixels(), 0x7f, pixmap.getPixelByteCount());
+		pixmap.saveTga(imagePath);
+
+		factory = new TestTextureFactory();
+		oldFactory = GraphicsInterface::getInstance().getFactory();
+		GraphicsInterface::getInstance().setFactory(factory);
+	}
+
+	void tearDown() {
+		GraphicsInterface::getInstance().setFactory(oldFactory);
+		delete factory;
+		factory = NULL;
+		unlink(imagePath.c_str());
+	}
+
+	void test_decode_loads_pixmap() {
+		TextureManager textureManager;
+		bool created = false;
+		Texture2D *texture = textureManager.loadTexture2D(imagePath, false, created);
+
+		CPPUNIT_ASSERT( texture != NULL );
+		CPPUNIT_ASSERT_EQUAL( true, created );
+		CPPUNIT_ASSERT_EQUAL( true, texture->getInited() );
+		CPPUNIT_ASSERT_EQUAL( imagePath, texture->getPath() );
+		CPPUNIT_ASSERT_EQUAL( 4, texture->getPixmapConst()->getW() );
+		CPPUNIT_ASSERT_EQUAL( 4, texture->getPixmapConst()->getH() );
+		CPPUNIT_ASSERT( texture->getPixmapConst()->getPixels() != NULL );
+	}
+
+	void test_decode_deletes_pixmap_after_load() {
+		TextureManager textureManager;
+		bool created = false;
+		Texture2D *texture = textureManager.loadTexture2D(imagePath, true, created);
+
+		CPPUNIT_ASSERT( texture != NULL );
+		CPPUNIT_ASSERT_EQUAL( true, texture->getInited() );
+		CPPUNIT_ASSERT( texture->getPixmapConst()->getPixels() == NULL );
+	}
+
+	void test_same_path_loaded_once() {
+		TextureManager textureManager;
+		bool firstCreated = false;
+		Texture2D *first = textureManager.loadTexture2D(imagePath, true, firstCreated);
+		bool secondCreated = true;
+		Texture2D *second = textureManager.loadTexture2D(imagePath, true, secondCreated);
+
+		CPPUNIT_ASSERT_EQUAL( true, firstCreated );
+		CPPUNIT_ASSERT_EQUAL( false, secondCreated );
+		CPPUNIT_ASSERT( first == second );
+		CPPUNIT_ASSERT_EQUAL( 1, factory->texture2DCount );
+		CPPUNIT_ASSERT_EQUAL( 1, static_cast<TestTexture2D *>(first)->initCount );
+		CPPUNIT_ASSERT_EQUAL( (size_t)1, textureManager.getTextures().size() );
+	}
+
+	void test_async_decode_same_path_loaded_once() {
+		TextureManager textureManager;
+		textureManager.setDecodeThreadCount(2);
+
+		bool firstCreated = false;
+		Texture2D *first = textureManager.loadTexture2D(imagePath, true, firstCreated);
+		// the first decode may still be running on a worker
+		bool secondCreated = true;
+		Texture2D *second = textureManager.loadTexture2D(imagePath, true, secondCreated);
+		textureManager.uploadDecodedTextures(true);
+
+		CPPUNIT_ASSERT( first == second );
+		CPPUNIT_ASSERT_EQUAL( false, secondCreated );
+		CPPUNIT_ASSERT_EQUAL( 1, factory->texture2DCount );
+		CPPUNIT_ASSERT_EQUAL( 0, textureManager.getPendingDecodeCount() );
+		CPPUNIT_ASSERT_EQUAL( true, first->getInited() );
+		CPPUNIT_ASSERT_EQUAL( 1, static_cast<TestTexture2D *>(first)->initCount );
+	}
+};
+
+// Test Suite Registrations
+CPPUNIT_TEST_SUITE_REGISTRATION( TextureManagerTest );
+//
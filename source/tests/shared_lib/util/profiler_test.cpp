@@ -0,0 +1,114 @@
+// ==============================================================
+//	This file is part of MegaGlest Unit Tests (www.megaglest.org)
+//
+//	Copyright (C) 2013 Mark Vejvoda
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include "profiler.h"
+#include "platform_common.h"
+
+#ifdef WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+using namespace Shared::Util;
+using Shared::PlatformCommon::Chrono;
+
+static void busyWaitMicros(int64 micros) {
+	int64 start = Chrono::getCurNanos();
+	while(Chrono::getCurNanos() - start < micros * 1000) {
+	}
+}
+
+static void innerZone() {
+	PROFILE_ZONE("inner");
+	busyWaitMicros(2000);
+}
+
+static void outerZone() {
+	PROFILE_ZONE("outer");
+	busyWaitMicros(2000);
+	innerZone();
+}
+
+static string readFile(const string &path) {
+	std::ifstream in(path.c_str());
+	std::stringstream text;
+	text << in.rdbuf();
+	return text.str();
+}
+
+//
+// Tests for the frame profiler
+//
+class FrameProfilerTest : public CppUnit::TestFixture {
+	// Register the suite of tests for this fixture
+	CPPUNIT_TEST_SUITE( FrameProfilerTest );
+
+	CPPUNIT_TEST( test_records_only_frame_range );
+	CPPUNIT_TEST( test_folded_stacks_nest_zones );
+
+	CPPUNIT_TEST_SUITE_END();
+	// End of Fixture registration
+
+private:
+	const string outputPath;
+
+	void runFrames(int lastFrame) {
+		FrameProfiler &profiler = FrameProfiler::getInstance();
+		profiler.setThreadName("test");
+		profiler.setFrameRange(3, 4, outputPath);
+		for(int frame = 1; frame <= lastFrame; ++frame) {
+			profiler.beginFrame(frame);
+			outerZone();
+		}
+		profiler.stopRecording();
+	}
+
+public:
+
+	FrameProfilerTest() : outputPath("test_frame_profile") {
+	}
+
+	void tearDown() {
+		unlink((outputPath + ".json").c_str());
+		unlink((outputPath + ".folded").c_str());
+	}
+
+	void test_records_only_frame_range() {
+		runFrames(6);
+
+		string trace = readFile(outputPath + ".json");
+		CPPUNIT_ASSERT( trace.find("\"name\":\"test\"") != string::npos );
+		CPPUNIT_ASSERT( trace.find("\"frame\":3") != string::npos );
+		CPPUNIT_ASSERT( trace.find("\"frame\":4") != string::npos );
+		CPPUNIT_ASSERT( trace.find("\"frame\":2") == string::npos );
+		CPPUNIT_ASSERT( trace.find("\"frame\":5") == string::npos );
+	}
+
+	void test_folded_stacks_nest_zones() {
+		// the game ends before the last frame of the range
+		runFrames(3);
+
+		string folded = readFile(outputPath + ".folded");
+		CPPUNIT_ASSERT( folded.find("test;outer ") != string::npos );
+		CPPUNIT_ASSERT( folded.find("test;outer;inner ") != string::npos );
+		CPPUNIT_ASSERT( folded.find("test;inner ") == string::npos );
+	}
+};
+
+// Test Suite Registrations
+CPPUNIT_TEST_SUITE_REGISTRATION( FrameProfilerTest );
+//
@@ -11,6 +11,7 @@
 
 #include <cppunit/extensions/HelperMacros.h>
 #include "util.h"
+#include "platform_common.h"
 #include <memory>
 #include <vector>
 #include <algorithm>
@@ -22,6 +23,7 @@
 #endif
 
 using namespace Shared::Util;
+using Shared::PlatformCommon::Chrono;
 
 //
 // Tests for util classes
@@ -36,6 +38,7 @@ class UtilTest : public CppUnit::TestFixture {
 	CPPUNIT_TEST( test_checkVersionComptability_2_digit_versions );
 	CPPUNIT_TEST( test_checkVersionComptability_3_digit_versions );
 	CPPUNIT_TEST( test_checkVersionComptability_mixed_digit_versions );
+	CPPUNIT_TEST( test_chrono_resolves_below_a_millisecond );
 
 	CPPUNIT_TEST_SUITE_END();
 	// End of Fixture registration
@@ -191,6 +194,27 @@ public:
 		SystemFlags::VERBOSE_MODE_ENABLED = false;
 	}
 
+	void test_chrono_resolves_below_a_millisecond() {
+		Chrono chrono(true);
+		while(chrono.getMicros() < 200) {
+		}
+		chrono.stop();
+
+		int64 nanos = chrono.getNanos();
+		CPPUNIT_ASSERT( nanos >= 200000 );
+		CPPUNIT_ASSERT_EQUAL( nanos / 1000, chrono.getMicros() );
+		CPPUNIT_ASSERT_EQUAL( nanos, chrono.getNanos() );
+
+		// a restart keeps counting on from the stopped time
+		chrono.start();
+		while(chrono.getNanos() <= nanos) {
+		}
+		CPPUNIT_ASSERT( chrono.getNanos() > nanos );
+
+		chrono.reset();
+		CPPUNIT_ASSERT( chrono.getMillis() < 1000 );
+	}
+
 };
 
 
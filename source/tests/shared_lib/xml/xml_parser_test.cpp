@@ -14,6 +14,7 @@
 #include <fstream>
 #include "xml_parser.h"
 #include "platform_util.h"
+#include "conversion.h"
 
 #if defined(WANT_XERCES)
 
@@ -32,6 +33,7 @@
 
 using namespace Shared::Xml;
 using namespace Shared::Platform;
+using Shared::Util::intToStr;
 
 //
 // Utility methods for tests
@@ -171,6 +173,7 @@ class XmlIoRapidTest : public CppUnit::TestFixture {
 	CPPUNIT_TEST_EXCEPTION( test_load_file_malformed_content,  megaglest_runtime_error );
 	CPPUNIT_TEST_EXCEPTION( test_save_file_null_node,  megaglest_runtime_error );
 	CPPUNIT_TEST(test_save_file_valid_node );
+	CPPUNIT_TEST(test_save_compressed_file_valid_node );
 
 	CPPUNIT_TEST_SUITE_END();
 	// End of Fixture registration
@@ -230,6 +233,37 @@ public:
 
 		delete rootNode;
 	}
+
+	void test_save_compressed_file_valid_node() {
+		const string test_filename_save = "xml_test_save_compressed_valid.xml";
+
+		XmlNode rootNode("saved-game");
+		std::map<string,string> mapTagReplacementValues;
+		rootNode.addAttribute("version", "v1 <\"quoted\" & 'escaped'>", mapTagReplacementValues);
+		// enough units for the writer to flush several times
+		for(int i = 0; i < 5000; ++i) {
+			XmlNode *unitNode = rootNode.addChild("unit");
+			unitNode->addAttribute("id", intToStr(i), mapTagReplacementValues);
+			unitNode->addChild("pos")->addAttribute("value", intToStr(i * 3) + "," + intToStr(i * 7), mapTagReplacementValues);
+		}
+
+		XmlIoRapid::getInstance().saveCompressed(test_filename_save,&rootNode);
+		SafeRemoveTestFile deleteFile(test_filename_save);
+
+		std::ifstream compressedFile(test_filename_save.c_str(), std::ios::binary);
+		CPPUNIT_ASSERT_EQUAL( 0x78, compressedFile.get() );
+		compressedFile.close();
+
+		XmlNode *loadedNode = XmlIoRapid::getInstance().load(test_filename_save, std::map<string,string>());
+		CPPUNIT_ASSERT( loadedNode != NULL );
+		CPPUNIT_ASSERT_EQUAL( string("saved-game"), loadedNode->getName() );
+		CPPUNIT_ASSERT_EQUAL( string("v1 <\"quoted\" & 'escaped'>"), loadedNode->getAttribute("version")->getValue() );
+		CPPUNIT_ASSERT_EQUAL( (size_t)5000, loadedNode->getChildCount() );
+		CPPUNIT_ASSERT_EQUAL( string("4999"), loadedNode->getChild(4999)->getAttribute("id")->getValue() );
+		CPPUNIT_ASSERT_EQUAL( string("14997,34993"), loadedNode->getChild(4999)->getChild("pos")->getAttribute("value")->getValue() );
+
+		delete loadedNode;
+	}
 };
 
 //